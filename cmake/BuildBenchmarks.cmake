@@ -0,0 +1,42 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+### microbenchmarks of core code paths, see libminifi/test/benchmarks/Benchmark.h
+
+if (ENABLE_BENCHMARKS AND NOT WIN32)
+  set(BENCHMARK_DIR "${TEST_DIR}/benchmarks")
+  file(GLOB BENCHMARK_SOURCES "${BENCHMARK_DIR}/*.cpp")
+  if (TARGET minifi-expression-language-extensions)
+    file(GLOB EXPRESSION_LANGUAGE_BENCHMARK_SOURCES "${CMAKE_SOURCE_DIR}/extensions/expression-language/tests/benchmarks/*.cpp")
+    list(APPEND BENCHMARK_SOURCES ${EXPRESSION_LANGUAGE_BENCHMARK_SOURCES})
+  endif()
+
+  add_executable(minifi-benchmarks ${BENCHMARK_SOURCES})
+  target_include_directories(minifi-benchmarks BEFORE PRIVATE "${TEST_DIR}")
+  createTests(minifi-benchmarks)
+  if (TARGET minifi-expression-language-extensions)
+    target_include_directories(minifi-benchmarks BEFORE PRIVATE "${CMAKE_SOURCE_DIR}/extensions/expression-language")
+    target_wholearchive_library(minifi-benchmarks minifi-expression-language-extensions)
+    if (NOT DISABLE_CURL)
+      target_link_libraries(minifi-benchmarks CURL::libcurl)
+    endif()
+  endif()
+
+  # runs every benchmark once with a short minimum time, so that the suite keeps working
+  add_test(NAME minifi-benchmarks COMMAND minifi-benchmarks --min-time=0.01 WORKING_DIRECTORY ${TEST_DIR})
+  message("-- Finished building the microbenchmarks...")
+endif()
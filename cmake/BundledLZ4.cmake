@@ -0,0 +1,66 @@
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+function(use_bundled_lz4 SOURCE_DIR BINARY_DIR)
+    message("Using bundled lz4")
+
+    # Define byproduct
+    if (WIN32)
+        set(BYPRODUCT "lib/lz4_static.lib")
+    else()
+        set(BYPRODUCT "lib/liblz4.a")
+    endif()
+
+    # Set build options
+    set(LZ4_BIN_DIR "${BINARY_DIR}/thirdparty/lz4-install" CACHE STRING "" FORCE)
+
+    set(LZ4_CMAKE_ARGS ${PASSTHROUGH_CMAKE_ARGS}
+            "-DCMAKE_INSTALL_PREFIX=${LZ4_BIN_DIR}"
+            -DCMAKE_INSTALL_LIBDIR=lib
+            -DCMAKE_POSITION_INDEPENDENT_CODE=ON
+            -DBUILD_SHARED_LIBS=OFF
+            -DBUILD_STATIC_LIBS=ON
+            -DLZ4_BUILD_CLI=OFF
+            -DLZ4_BUILD_LEGACY_LZ4C=OFF)
+
+    # Build project
+    ExternalProject_Add(
+            lz4-external
+            URL "https://github.com/lz4/lz4/archive/v1.9.2.tar.gz"
+            URL_HASH "SHA256=658ba6191fa44c92280d4aa2c271b0f4fbc0e34d249578dd05e50e76d0e5efcc"
+            SOURCE_DIR "${BINARY_DIR}/thirdparty/lz4-src"
+            SOURCE_SUBDIR contrib/cmake_unofficial
+            LIST_SEPARATOR % # This is needed for passing semicolon-separated lists
+            CMAKE_ARGS ${LZ4_CMAKE_ARGS}
+            BUILD_BYPRODUCTS "${LZ4_BIN_DIR}/${BYPRODUCT}"
+            EXCLUDE_FROM_ALL TRUE
+    )
+
+    # Set variables
+    set(LZ4_FOUND "YES" CACHE STRING "" FORCE)
+    set(LZ4_INCLUDE_DIRS "${LZ4_BIN_DIR}/include" CACHE STRING "" FORCE)
+    set(LZ4_LIBRARIES "${LZ4_BIN_DIR}/${BYPRODUCT}" CACHE STRING "" FORCE)
+
+    # Create imported targets
+    file(MAKE_DIRECTORY ${LZ4_INCLUDE_DIRS})
+
+    add_library(lz4::lz4 STATIC IMPORTED)
+    set_target_properties(lz4::lz4 PROPERTIES IMPORTED_LOCATION "${LZ4_LIBRARIES}")
+    add_dependencies(lz4::lz4 lz4-external)
+    set_property(TARGET lz4::lz4 APPEND PROPERTY INTERFACE_INCLUDE_DIRECTORIES "${LZ4_INCLUDE_DIRS}")
+endfunction(use_bundled_lz4)
@@ -33,9 +33,7 @@ function(use_bundled_libarchive SOURCE_DIR BINARY_DIR)
             -DENABLE_MBEDTLS=OFF
             -DENABLE_NETTLE=OFF
             -DENABLE_LIBB2=OFF
-            -DENABLE_LZ4=OFF
             -DENABLE_LZO=OFF
-            -DENABLE_ZSTD=OFF
             -DENABLE_ZLIB=ON
             -DENABLE_LIBXML2=OFF
             -DENABLE_EXPAT=OFF
@@ -66,6 +64,18 @@ function(use_bundled_libarchive SOURCE_DIR BINARY_DIR)
         list(APPEND LIBARCHIVE_CMAKE_ARGS -DENABLE_BZip2=ON)
     endif()
 
+    if (DISABLE_ZSTD)
+        list(APPEND LIBARCHIVE_CMAKE_ARGS -DENABLE_ZSTD=OFF)
+    else()
+        list(APPEND LIBARCHIVE_CMAKE_ARGS -DENABLE_ZSTD=ON "-DZSTD_INCLUDE_DIR=${ZSTD_INCLUDE_DIRS}" "-DZSTD_LIBRARY=${ZSTD_LIBRARIES}")
+    endif()
+
+    if (DISABLE_LZ4)
+        list(APPEND LIBARCHIVE_CMAKE_ARGS -DENABLE_LZ4=OFF)
+    else()
+        list(APPEND LIBARCHIVE_CMAKE_ARGS -DENABLE_LZ4=ON "-DLZ4_INCLUDE_DIR=${LZ4_INCLUDE_DIRS}" "-DLZ4_LIBRARY=${LZ4_LIBRARIES}")
+    endif()
+
     append_third_party_passthrough_args(LIBARCHIVE_CMAKE_ARGS "${LIBARCHIVE_CMAKE_ARGS}")
 
     # Build project
@@ -92,6 +102,12 @@ function(use_bundled_libarchive SOURCE_DIR BINARY_DIR)
     if (NOT DISABLE_BZIP2)
         add_dependencies(libarchive-external BZip2::BZip2)
     endif()
+    if (NOT DISABLE_ZSTD)
+        add_dependencies(libarchive-external zstd::zstd)
+    endif()
+    if (NOT DISABLE_LZ4)
+        add_dependencies(libarchive-external lz4::lz4)
+    endif()
 
     # Set variables
     set(LIBARCHIVE_FOUND "YES" CACHE STRING "" FORCE)
@@ -113,6 +129,12 @@ function(use_bundled_libarchive SOURCE_DIR BINARY_DIR)
     if (NOT DISABLE_BZIP2)
         set_property(TARGET LibArchive::LibArchive APPEND PROPERTY INTERFACE_LINK_LIBRARIES BZip2::BZip2)
     endif()
+    if (NOT DISABLE_ZSTD)
+        set_property(TARGET LibArchive::LibArchive APPEND PROPERTY INTERFACE_LINK_LIBRARIES zstd::zstd)
+    endif()
+    if (NOT DISABLE_LZ4)
+        set_property(TARGET LibArchive::LibArchive APPEND PROPERTY INTERFACE_LINK_LIBRARIES lz4::lz4)
+    endif()
     file(MAKE_DIRECTORY ${LIBARCHIVE_INCLUDE_DIRS})
     set_property(TARGET LibArchive::LibArchive APPEND PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${LIBARCHIVE_INCLUDE_DIRS})
 	set_property(TARGET LibArchive::LibArchive APPEND PROPERTY INTERFACE_COMPILE_DEFINITIONS "LIBARCHIVE_STATIC=1")
@@ -0,0 +1,69 @@
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+function(use_bundled_zstd SOURCE_DIR BINARY_DIR)
+    message("Using bundled zstd")
+
+    # Define byproduct
+    if (WIN32)
+        set(BYPRODUCT "lib/zstd_static.lib")
+    else()
+        set(BYPRODUCT "lib/libzstd.a")
+    endif()
+
+    # Set build options
+    set(ZSTD_BIN_DIR "${BINARY_DIR}/thirdparty/zstd-install" CACHE STRING "" FORCE)
+
+    set(ZSTD_CMAKE_ARGS ${PASSTHROUGH_CMAKE_ARGS}
+            "-DCMAKE_INSTALL_PREFIX=${ZSTD_BIN_DIR}"
+            -DCMAKE_INSTALL_LIBDIR=lib
+            -DCMAKE_POSITION_INDEPENDENT_CODE=ON
+            -DZSTD_BUILD_PROGRAMS=OFF
+            -DZSTD_BUILD_SHARED=OFF
+            -DZSTD_BUILD_STATIC=ON
+            -DZSTD_BUILD_TESTS=OFF
+            -DZSTD_MULTITHREAD_SUPPORT=ON)
+
+    # Build project
+    ExternalProject_Add(
+            zstd-external
+            URL "https://github.com/facebook/zstd/releases/download/v1.4.4/zstd-1.4.4.tar.gz"
+            URL_HASH "SHA256=59ef70ebb757ffe74a7b3fe9c305e2ba3350021a918d168a046c6300aeea9315"
+            SOURCE_DIR "${BINARY_DIR}/thirdparty/zstd-src"
+            SOURCE_SUBDIR build/cmake
+            LIST_SEPARATOR % # This is needed for passing semicolon-separated lists
+            CMAKE_ARGS ${ZSTD_CMAKE_ARGS}
+            BUILD_BYPRODUCTS "${ZSTD_BIN_DIR}/${BYPRODUCT}"
+            EXCLUDE_FROM_ALL TRUE
+    )
+
+    # Set variables
+    set(ZSTD_FOUND "YES" CACHE STRING "" FORCE)
+    set(ZSTD_INCLUDE_DIRS "${ZSTD_BIN_DIR}/include" CACHE STRING "" FORCE)
+    set(ZSTD_LIBRARIES "${ZSTD_BIN_DIR}/${BYPRODUCT}" CACHE STRING "" FORCE)
+
+    # Create imported targets
+    file(MAKE_DIRECTORY ${ZSTD_INCLUDE_DIRS})
+
+    add_library(zstd::zstd STATIC IMPORTED)
+    set_target_properties(zstd::zstd PROPERTIES IMPORTED_LOCATION "${ZSTD_LIBRARIES}")
+    add_dependencies(zstd::zstd zstd-external)
+    set_property(TARGET zstd::zstd APPEND PROPERTY INTERFACE_INCLUDE_DIRECTORIES "${ZSTD_INCLUDE_DIRS}")
+    # the multithreaded compressor of the static library needs the thread library
+    set_property(TARGET zstd::zstd APPEND PROPERTY INTERFACE_LINK_LIBRARIES Threads::Threads)
+endfunction(use_bundled_zstd)
@@ -0,0 +1,294 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PrometheusMetricsPublisher.h"
+
+#include <cstdlib>
+#include <sstream>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+
+constexpr const char *PrometheusMetricsPublisher::PORT_PROPERTY;
+constexpr const char *PrometheusMetricsPublisher::DEFAULT_PORT;
+constexpr const char *PrometheusMetricsPublisher::METRICS_URI;
+constexpr const char *PrometheusMetricsPublisher::CONTENT_TYPE;
+
+std::string OpenMetricsSerializer::serialize(const std::vector<std::shared_ptr<response::ResponseNode>> &nodes) {
+  families_.clear();
+  family_index_.clear();
+
+  for (const auto &node : nodes) {
+    if (nullptr == node) {
+      continue;
+    }
+    const std::string name = node->getName();
+    const auto serialized = node->serialize();
+    if (name == "QueueMetrics") {
+      serializeQueues(serialized);
+    } else if (name == "RepositoryMetrics") {
+      serializeRepositories(serialized);
+    } else if (name == "ProcessorMetrics") {
+      serializeProcessors(serialized);
+    } else {
+      for (const auto &child : serialized) {
+        serializeGeneric("minifi_" + sanitize(name), child);
+      }
+    }
+  }
+
+  std::stringstream output;
+  for (const auto &family : families_) {
+    output << "# TYPE " << family.name << " " << family.type << "\n";
+    if (!family.help.empty()) {
+      output << "# HELP " << family.name << " " << family.help << "\n";
+    }
+    for (const auto &sample : family.samples) {
+      output << sample << "\n";
+    }
+  }
+  output << "# EOF\n";
+  return output.str();
+}
+
+OpenMetricsSerializer::Family &OpenMetricsSerializer::getFamily(const std::string &name, const std::string &type, const std::string &help) {
+  auto it = family_index_.find(name);
+  if (it != family_index_.end()) {
+    return families_[it->second];
+  }
+  family_index_[name] = families_.size();
+  families_.push_back(Family { name, type, help, { } });
+  return families_.back();
+}
+
+void OpenMetricsSerializer::addSample(Family &family, const std::string &suffix, const Labels &labels, const std::string &value) {
+  std::string sample = family.name + suffix;
+  if (!labels.empty()) {
+    sample += "{";
+    for (size_t i = 0; i < labels.size(); i++) {
+      if (i > 0) {
+        sample += ",";
+      }
+      sample += labels[i].first + "=\"" + escape(labels[i].second) + "\"";
+    }
+    sample += "}";
+  }
+  sample += " " + value;
+  family.samples.push_back(std::move(sample));
+}
+
+void OpenMetricsSerializer::serializeQueues(const std::vector<response::SerializedResponseNode> &connections) {
+  static const std::map<std::string, std::pair<std::string, std::string>> gauges {
+    { "queued", { "minifi_queue_flowfiles", "FlowFiles queued in the connection" } },
+    { "queuedmax", { "minifi_queue_flowfiles_max", "FlowFiles the connection queues before applying back pressure" } },
+    { "datasize", { "minifi_queue_size_bytes", "Bytes of content queued in the connection" } },
+    { "datasizemax", { "minifi_queue_size_max_bytes", "Bytes of content the connection queues before applying back pressure" } }
+  };
+  for (const auto &connection : connections) {
+    const Labels labels { { "connection", connection.name } };
+    for (const auto &child : connection.children) {
+      auto gauge = gauges.find(child.name);
+      std::string value;
+      if (gauge != gauges.end() && toNumber(child.value, value)) {
+        addSample(getFamily(gauge->second.first, "gauge", gauge->second.second), "", labels, value);
+      }
+    }
+  }
+}
+
+void OpenMetricsSerializer::serializeRepositories(const std::vector<response::SerializedResponseNode> &repositories) {
+  static const std::map<std::string, std::pair<std::string, std::string>> gauges {
+    { "running", { "minifi_repository_running", "Whether the repository is running" } },
+    { "full", { "minifi_repository_full", "Whether the repository is full" } },
+    { "size", { "minifi_repository_size_bytes", "Bytes stored by the repository" } }
+  };
+  for (const auto &repository : repositories) {
+    const Labels labels { { "repository", repository.name } };
+    for (const auto &child : repository.children) {
+      auto gauge = gauges.find(child.name);
+      std::string value;
+      if (gauge != gauges.end() && toNumber(child.value, value)) {
+        addSample(getFamily(gauge->second.first, "gauge", gauge->second.second), "", labels, value);
+      }
+    }
+  }
+}
+
+void OpenMetricsSerializer::serializeProcessors(const std::vector<response::SerializedResponseNode> &processors) {
+  static const std::map<std::string, std::pair<std::string, std::string>> counters {
+    { "OnTriggerInvocations", { "minifi_processor_ontrigger_invocations", "Times the processor was triggered" } },
+    { "FlowFilesIn", { "minifi_processor_flowfiles_in", "FlowFiles taken from the incoming connections" } },
+    { "BytesIn", { "minifi_processor_bytes_in", "Bytes of content taken from the incoming connections" } },
+    { "FlowFilesOut", { "minifi_processor_flowfiles_out", "FlowFiles put on the outgoing connections" } },
+    { "BytesOut", { "minifi_processor_bytes_out", "Bytes of content put on the outgoing connections" } }
+  };
+  for (const auto &processor : processors) {
+    // processors are keyed by UUID, as their names need not be unique
+    std::string name;
+    for (const auto &child : processor.children) {
+      if (child.name == "name") {
+        name = child.value.to_string();
+      }
+    }
+    const Labels labels { { "processor", name }, { "id", processor.name } };
+    for (const auto &child : processor.children) {
+      std::string value;
+      auto counter = counters.find(child.name);
+      if (counter != counters.end()) {
+        if (toNumber(child.value, value)) {
+          addSample(getFamily(counter->second.first, "counter", counter->second.second), "_total", labels, value);
+        }
+      } else if (child.name == "OnTriggerMicros") {
+        serializeLatency("minifi_processor_ontrigger_duration_microseconds", "Duration of the onTrigger calls of the processor", labels, child);
+      } else if (child.name == "CommitMicros") {
+        serializeLatency("minifi_processor_commit_duration_microseconds", "Duration of the session commits of the processor", labels, child);
+      }
+    }
+  }
+}
+
+void OpenMetricsSerializer::serializeLatency(const std::string &name, const std::string &help, const Labels &labels, const response::SerializedResponseNode &latency) {
+  static const std::map<std::string, std::string> quantiles { { "p50", "0.5" }, { "p90", "0.9" }, { "p99", "0.99" } };
+  auto &family = getFamily(name, "summary", help);
+  for (const auto &child : latency.children) {
+    std::string value;
+    if (!toNumber(child.value, value)) {
+      continue;
+    }
+    auto quantile = quantiles.find(child.name);
+    if (quantile != quantiles.end()) {
+      Labels quantile_labels = labels;
+      quantile_labels.emplace_back("quantile", quantile->second);
+      addSample(family, "", quantile_labels, value);
+    } else if (child.name == "count" || child.name == "sum") {
+      addSample(family, "_" + child.name, labels, value);
+    }
+  }
+}
+
+void OpenMetricsSerializer::serializeGeneric(const std::string &prefix, const response::SerializedResponseNode &node) {
+  const std::string name = prefix + "_" + sanitize(node.name);
+  if (node.children.empty()) {
+    std::string value;
+    if (toNumber(node.value, value)) {
+      addSample(getFamily(name, "gauge", ""), "", { }, value);
+    }
+    return;
+  }
+  for (const auto &child : node.children) {
+    serializeGeneric(name, child);
+  }
+}
+
+bool OpenMetricsSerializer::toNumber(const response::ValueNode &value, std::string &number) {
+  number = value.to_string();
+  if (number == "true") {
+    number = "1";
+    return true;
+  }
+  if (number == "false") {
+    number = "0";
+    return true;
+  }
+  if (number.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  std::strtod(number.c_str(), &end);
+  return end != nullptr && *end == '\0';
+}
+
+std::string OpenMetricsSerializer::sanitize(const std::string &name) {
+  std::string sanitized;
+  sanitized.reserve(name.size());
+  for (const char c : name) {
+    if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_') {
+      sanitized += c;
+    } else if (c >= 'A' && c <= 'Z') {
+      sanitized += static_cast<char>(c - 'A' + 'a');
+    } else {
+      sanitized += '_';
+    }
+  }
+  return sanitized;
+}
+
+std::string OpenMetricsSerializer::escape(const std::string &label) {
+  std::string escaped;
+  escaped.reserve(label.size());
+  for (const char c : label) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+PrometheusMetricsPublisher::PrometheusMetricsPublisher(const std::string &name, utils::Identifier uuid)
+    : MetricsPublisher(name, uuid),
+      logger_(logging::LoggerFactory<PrometheusMetricsPublisher>::getLogger()) {
+}
+
+PrometheusMetricsPublisher::~PrometheusMetricsPublisher() {
+  // stop serving before the handler goes away
+  server_.reset();
+}
+
+void PrometheusMetricsPublisher::initialize(const std::shared_ptr<Configure> &configuration, const std::shared_ptr<response::NodeReporter> &reporter) {
+  std::string port;
+  if (nullptr == configuration || !configuration->get(PORT_PROPERTY, port) || port.empty()) {
+    port = DEFAULT_PORT;
+  }
+
+  handler_ = std::unique_ptr<MetricsHandler>(new MetricsHandler(reporter));
+  std::vector<std::string> options { "listening_ports", port, "num_threads", "2" };
+  try {
+    server_ = std::unique_ptr<CivetServer>(new CivetServer(options));
+  } catch (const CivetException &exception) {
+    logger_->log_error("Could not serve metrics on port %s: %s", port, exception.what());
+    return;
+  }
+  server_->addHandler(METRICS_URI, handler_.get());
+  logger_->log_info("Serving metrics on port %s at %s", port, METRICS_URI);
+}
+
+bool PrometheusMetricsPublisher::MetricsHandler::handleGet(CivetServer *server, struct mg_connection *conn) {
+  std::vector<std::shared_ptr<response::ResponseNode>> nodes;
+  auto reporter = reporter_.lock();
+  if (nullptr != reporter) {
+    reporter->getMetricsNodes(nodes, 0);
+  }
+
+  const std::string body = OpenMetricsSerializer().serialize(nodes);
+  mg_printf(conn, "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n", CONTENT_TYPE, static_cast<unsigned long>(body.length()));
+  mg_write(conn, body.data(), body.length());
+  return true;
+}
+
+} /* namespace state */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,132 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_CIVETWEB_METRICS_PROMETHEUSMETRICSPUBLISHER_H_
+#define EXTENSIONS_CIVETWEB_METRICS_PROMETHEUSMETRICSPUBLISHER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <CivetServer.h>
+
+#include "core/Resource.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "core/state/MetricsPublisher.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+
+/**
+ * Purpose: Renders metric nodes in the OpenMetrics text exposition format.
+ *
+ * Queue, repository and processor metrics are mapped to metric families labelled by connection,
+ * repository and processor. The numeric values of any other node are exposed as gauges named
+ * after their path in the node.
+ */
+class OpenMetricsSerializer {
+ public:
+  std::string serialize(const std::vector<std::shared_ptr<response::ResponseNode>> &nodes);
+
+ private:
+  typedef std::vector<std::pair<std::string, std::string>> Labels;
+
+  struct Family {
+    std::string name;
+    std::string type;
+    std::string help;
+    std::vector<std::string> samples;
+  };
+
+  Family &getFamily(const std::string &name, const std::string &type, const std::string &help);
+
+  void addSample(Family &family, const std::string &suffix, const Labels &labels, const std::string &value);
+
+  void serializeQueues(const std::vector<response::SerializedResponseNode> &connections);
+
+  void serializeRepositories(const std::vector<response::SerializedResponseNode> &repositories);
+
+  void serializeProcessors(const std::vector<response::SerializedResponseNode> &processors);
+
+  void serializeLatency(const std::string &name, const std::string &help, const Labels &labels, const response::SerializedResponseNode &latency);
+
+  void serializeGeneric(const std::string &prefix, const response::SerializedResponseNode &node);
+
+  static bool toNumber(const response::ValueNode &value, std::string &number);
+
+  static std::string sanitize(const std::string &name);
+
+  static std::string escape(const std::string &label);
+
+  std::vector<Family> families_;
+  std::map<std::string, size_t> family_index_;
+};
+
+/**
+ * Purpose: Serves the metric nodes of the agent on an embedded HTTP endpoint, so that the agent can
+ * be scraped by Prometheus or any other OpenMetrics compatible collector without a C2 server.
+ *
+ * Metrics are read when they are scraped rather than cached, and the metric nodes only read
+ * atomic counters, so a scrape does not contend with the flow.
+ */
+class PrometheusMetricsPublisher : public MetricsPublisher {
+ public:
+  static constexpr const char *PORT_PROPERTY = "nifi.metrics.publisher.prometheus.port";
+  static constexpr const char *DEFAULT_PORT = "9936";
+  static constexpr const char *METRICS_URI = "/metrics";
+  static constexpr const char *CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+  PrometheusMetricsPublisher(const std::string &name, utils::Identifier uuid = utils::Identifier());
+
+  virtual ~PrometheusMetricsPublisher();
+
+  virtual void initialize(const std::shared_ptr<Configure> &configuration, const std::shared_ptr<response::NodeReporter> &reporter) override;
+
+ protected:
+  class MetricsHandler : public CivetHandler {
+   public:
+    explicit MetricsHandler(const std::weak_ptr<response::NodeReporter> &reporter)
+        : reporter_(reporter) {
+    }
+
+    bool handleGet(CivetServer *server, struct mg_connection *conn) override;
+
+   private:
+    std::weak_ptr<response::NodeReporter> reporter_;
+  };
+
+  std::unique_ptr<MetricsHandler> handler_;
+  std::unique_ptr<CivetServer> server_;
+
+ private:
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+REGISTER_RESOURCE(PrometheusMetricsPublisher, "Serves the queue, repository and processor metrics of the agent in the OpenMetrics text format for Prometheus to scrape");
+
+} /* namespace state */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_CIVETWEB_METRICS_PROMETHEUSMETRICSPUBLISHER_H_ */
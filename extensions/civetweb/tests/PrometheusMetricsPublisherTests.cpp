@@ -0,0 +1,152 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestBase.h"
+
+#include "client/HTTPClient.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "core/state/nodes/ProcessorMetrics.h"
+#include "core/state/nodes/QueueMetrics.h"
+#include "metrics/PrometheusMetricsPublisher.h"
+#include "properties/Configure.h"
+
+namespace {
+
+class TestNode : public minifi::state::response::ResponseNode {
+ public:
+  TestNode()
+      : ResponseNode("Test Node") {
+  }
+
+  std::vector<minifi::state::response::SerializedResponseNode> serialize() override {
+    minifi::state::response::SerializedResponseNode parent;
+    parent.name = "memory";
+    minifi::state::response::SerializedResponseNode used;
+    used.name = "used";
+    used.value = uint64_t(42);
+    minifi::state::response::SerializedResponseNode label;
+    label.name = "label";
+    label.value = std::string("not a number");
+    parent.children.push_back(used);
+    parent.children.push_back(label);
+    return { parent };
+  }
+};
+
+class TestReporter : public minifi::state::response::NodeReporter {
+ public:
+  explicit TestReporter(const std::vector<std::shared_ptr<minifi::state::response::ResponseNode>> &nodes)
+      : nodes_(nodes) {
+  }
+
+  int16_t getResponseNodes(std::vector<std::shared_ptr<minifi::state::response::ResponseNode>> &metric_vector, uint16_t metricsClass) override {
+    return 0;
+  }
+
+  int16_t getMetricsNodes(std::vector<std::shared_ptr<minifi::state::response::ResponseNode>> &metric_vector, uint16_t metricsClass) override {
+    metric_vector.insert(metric_vector.end(), nodes_.begin(), nodes_.end());
+    return 0;
+  }
+
+ private:
+  std::vector<std::shared_ptr<minifi::state::response::ResponseNode>> nodes_;
+};
+
+std::shared_ptr<minifi::state::response::QueueMetrics> createQueueMetrics() {
+  auto configuration = std::make_shared<minifi::Configure>();
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  content_repo->initialize(configuration);
+  std::shared_ptr<core::Repository> repo = std::make_shared<TestRepository>();
+  auto connection = std::make_shared<minifi::Connection>(repo, content_repo, "to \"log\"");
+  connection->setMaxQueueSize(1024);
+
+  auto metrics = std::make_shared<minifi::state::response::QueueMetrics>();
+  metrics->addConnection(connection);
+  return metrics;
+}
+
+std::shared_ptr<minifi::state::response::ProcessorMetrics> createProcessorMetrics() {
+  auto processor = std::make_shared<core::Processor>("generator");
+  processor->getStatistics()->recordTrigger(std::chrono::microseconds(10));
+  processor->getStatistics()->recordCommit(std::chrono::microseconds(20), 0, 0, 5, 500);
+
+  auto metrics = std::make_shared<minifi::state::response::ProcessorMetrics>();
+  metrics->addProcessor(processor);
+  return metrics;
+}
+
+bool contains(const std::string &text, const std::string &line) {
+  return text.find(line + "\n") != std::string::npos;
+}
+
+}  // namespace
+
+TEST_CASE("OpenMetricsSerializer renders the metric nodes", "[prometheus]") {
+  std::vector<std::shared_ptr<minifi::state::response::ResponseNode>> nodes { createQueueMetrics(), createProcessorMetrics(), std::make_shared<TestNode>() };
+  const std::string output = minifi::state::OpenMetricsSerializer().serialize(nodes);
+
+  REQUIRE(contains(output, "# TYPE minifi_queue_flowfiles gauge"));
+  REQUIRE(contains(output, "minifi_queue_flowfiles{connection=\"to \\\"log\\\"\"} 0"));
+  REQUIRE(contains(output, "minifi_queue_flowfiles_max{connection=\"to \\\"log\\\"\"} 1024"));
+
+  REQUIRE(contains(output, "# TYPE minifi_processor_ontrigger_invocations counter"));
+  REQUIRE(output.find("minifi_processor_ontrigger_invocations_total{processor=\"generator\",id=\"") != std::string::npos);
+  REQUIRE(output.find("minifi_processor_bytes_out_total{processor=\"generator\"") != std::string::npos);
+  REQUIRE(contains(output, "# TYPE minifi_processor_commit_duration_microseconds summary"));
+  REQUIRE(output.find("minifi_processor_commit_duration_microseconds_count{processor=\"generator\"") != std::string::npos);
+  REQUIRE(output.find(",quantile=\"0.99\"} 20\n") != std::string::npos);
+
+  REQUIRE(contains(output, "minifi_test_node_memory_used 42"));
+  REQUIRE(output.find("label") == std::string::npos);
+
+  REQUIRE(output.size() >= 6);
+  REQUIRE("# EOF\n" == output.substr(output.size() - 6));
+}
+
+TEST_CASE("PrometheusMetricsPublisher serves the metrics of its reporter", "[prometheus]") {
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::state::PrometheusMetricsPublisher::PORT_PROPERTY, "10936");
+
+  std::vector<std::shared_ptr<minifi::state::response::ResponseNode>> nodes { createQueueMetrics() };
+  auto reporter = std::make_shared<TestReporter>(nodes);
+
+  minifi::state::PrometheusMetricsPublisher publisher("PrometheusMetricsPublisher");
+  publisher.initialize(configuration, reporter);
+
+  utils::HTTPClient client;
+  client.initialize("GET", "http://localhost:10936/metrics", nullptr);
+  REQUIRE(client.submit());
+  REQUIRE(200 == client.getResponseCode());
+  const auto &body_chars = client.getResponseBody();
+  std::string body(body_chars.data(), body_chars.size());
+  REQUIRE(contains(body, "minifi_queue_flowfiles_max{connection=\"to \\\"log\\\"\"} 1024"));
+
+  SECTION("nothing but the terminator is served once the reporter is gone") {
+    reporter.reset();
+    utils::HTTPClient second_client;
+    second_client.initialize("GET", "http://localhost:10936/metrics", nullptr);
+    REQUIRE(second_client.submit());
+    const auto &second_chars = second_client.getResponseBody();
+    REQUIRE("# EOF\n" == std::string(second_chars.data(), second_chars.size()));
+  }
+}
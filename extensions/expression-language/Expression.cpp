@@ -29,6 +29,12 @@
 #include <utils/OsUtils.h>
 #include <expression/Expression.h>
 #include <regex>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 #ifndef DISABLE_CURL
 #include <curl/curl.h>
 #endif
@@ -83,11 +89,11 @@ Expression make_dynamic_attr(const std::string &attribute_id) {
     std::string result;
     const auto cur_flow_file = params.flow_file.lock();
     if (cur_flow_file && cur_flow_file->getAttribute(attribute_id, result)) {
-      return Value(result);
+      return Value(std::move(result));
     } else {
       auto registry = params.registry_.lock();
       if ( registry && registry->getConfigurationProperty( attribute_id , result) ) {
-        return Value(result);
+        return Value(std::move(result));
       }
     }
     return Value();
@@ -106,7 +112,29 @@ Value resolve_user_id(const std::vector<Value> &args) {
 	return Value(name);
 }
 
-Value expr_hostname(const std::vector<Value> &args) {
+/**
+ * Resolving the local host takes a name service lookup, so resolved values are reused for
+ * HOST_RESOLUTION_PERIOD instead of being looked up again for every FlowFile.
+ */
+Value get_host_resolution(const std::string &key, const std::function<Value()> &resolve) {
+  static const std::chrono::seconds HOST_RESOLUTION_PERIOD(5);
+  static std::mutex mutex;
+  static std::map<std::string, std::pair<std::chrono::steady_clock::time_point, Value>> resolutions;
+  const auto now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = resolutions.find(key);
+    if (it != resolutions.end() && now - it->second.first < HOST_RESOLUTION_PERIOD) {
+      return it->second.second;
+    }
+  }
+  Value value = resolve();
+  std::lock_guard<std::mutex> lock(mutex);
+  resolutions[key] = std::make_pair(now, value);
+  return value;
+}
+
+Value resolve_hostname(const std::vector<Value> &args) {
   char hostname[1024];
   hostname[1023] = '\0';
   gethostname(hostname, 1023);
@@ -141,7 +169,14 @@ Value expr_hostname(const std::vector<Value> &args) {
   return Value(std::string(hostname));
 }
 
-Value expr_ip(const std::vector<Value> &args) {
+Value expr_hostname(const std::vector<Value> &args) {
+  if (args.size() > 0 && args[0].asBoolean()) {
+    return get_host_resolution("hostname", [&args]() { return resolve_hostname(args); });
+  }
+  return resolve_hostname(args);
+}
+
+Value resolve_ip(const std::vector<Value> &args) {
   char hostname[1024];
   hostname[1023] = '\0';
   gethostname(hostname, 1023);
@@ -174,6 +209,10 @@ Value expr_ip(const std::vector<Value> &args) {
   return Value();
 }
 
+Value expr_ip(const std::vector<Value> &args) {
+  return get_host_resolution("ip", [&args]() { return resolve_ip(args); });
+}
+
 Value expr_uuid(const std::vector<Value> &args) {
   utils::Identifier uuid;
   utils::IdGenerator::getIdGenerator()->generate(uuid);
@@ -718,6 +757,30 @@ Value expr_base64Decode(const std::vector<Value> &args) {
 
 #ifdef EXPRESSION_LANGUAGE_USE_REGEX
 
+/**
+ * Provides the compiled form of a regular expression. Patterns are almost always constant, so they are
+ * compiled once and shared by every evaluation instead of being compiled each time a function is called.
+ */
+std::shared_ptr<const std::regex> get_regex(const std::string &pattern) {
+  static const size_t MAX_CACHED_REGEXES = 256;
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::shared_ptr<const std::regex>> regexes;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = regexes.find(pattern);
+    if (it != regexes.end()) {
+      return it->second;
+    }
+  }
+  auto regex = std::make_shared<const std::regex>(pattern);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (regexes.size() >= MAX_CACHED_REGEXES) {
+    regexes.clear();
+  }
+  regexes.emplace(pattern, regex);
+  return regex;
+}
+
 Value expr_replace(const std::vector<Value> &args) {
   std::string result = args[0].asString();
   const std::string &find = args[1].asString();
@@ -736,16 +799,16 @@ Value expr_replace(const std::vector<Value> &args) {
 
 Value expr_replaceFirst(const std::vector<Value> &args) {
   std::string result = args[0].asString();
-  const std::regex find(args[1].asString());
+  const auto find = get_regex(args[1].asString());
   const std::string &replace = args[2].asString();
-  return Value(std::regex_replace(result, find, replace, std::regex_constants::format_first_only));
+  return Value(std::regex_replace(result, *find, replace, std::regex_constants::format_first_only));
 }
 
 Value expr_replaceAll(const std::vector<Value> &args) {
   std::string result = args[0].asString();
-  const std::regex find(args[1].asString());
+  const auto find = get_regex(args[1].asString());
   const std::string &replace = args[2].asString();
-  return Value(std::regex_replace(result, find, replace));
+  return Value(std::regex_replace(result, *find, replace));
 }
 
 Value expr_replaceNull(const std::vector<Value> &args) {
@@ -758,23 +821,23 @@ Value expr_replaceNull(const std::vector<Value> &args) {
 
 Value expr_replaceEmpty(const std::vector<Value> &args) {
   std::string result = args[0].asString();
-  const std::regex find("^[ \n\r\t]*$");
+  static const std::regex find("^[ \n\r\t]*$");
   const std::string &replace = args[1].asString();
   return Value(std::regex_replace(result, find, replace));
 }
 
 Value expr_matches(const std::vector<Value> &args) {
   const auto &subject = args[0].asString();
-  const std::regex expr = std::regex(args[1].asString());
+  const auto expr = get_regex(args[1].asString());
 
-  return Value(std::regex_match(subject.begin(), subject.end(), expr));
+  return Value(std::regex_match(subject.begin(), subject.end(), *expr));
 }
 
 Value expr_find(const std::vector<Value> &args) {
   const auto &subject = args[0].asString();
-  const std::regex expr = std::regex(args[1].asString());
+  const auto expr = get_regex(args[1].asString());
 
-  return Value(std::regex_search(subject.begin(), subject.end(), expr));
+  return Value(std::regex_search(subject.begin(), subject.end(), *expr));
 }
 
 #endif  // EXPRESSION_LANGUAGE_USE_REGEX
@@ -889,6 +952,15 @@ Value expr_random(const std::vector<Value> &args) {
   return Value(distribution(generator));
 }
 
+/**
+ * Whether the result of the function depends on more than its arguments, which rules out
+ * evaluating it when the expression is compiled.
+ */
+bool is_volatile_function(const std::string &function_name) {
+  static const std::set<std::string> volatile_functions = { "hostname", "ip", "UUID", "random", "now", "resolve_user_id" };
+  return volatile_functions.count(function_name) > 0;
+}
+
 template<Value T(const std::vector<Value> &)>
 Expression make_dynamic_function_incomplete(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args) {
 
@@ -910,8 +982,24 @@ Expression make_dynamic_function_incomplete(const std::string &function_name, co
     },
                                  multi_args);
   } else {
+    bool constant_args = std::none_of(args.begin(), args.end(), [](const Expression &arg) {
+      return arg.is_dynamic();
+    });
+    if (constant_args && !is_volatile_function(function_name)) {
+      // fold functions of constants into a constant; if that fails, the failure is reported when the expression is evaluated
+      try {
+        std::vector<Value> evaluated_args;
+        for (const auto &arg : args) {
+          evaluated_args.emplace_back(arg(Parameters()));
+        }
+        return Expression(T(evaluated_args));
+      } catch (const std::exception &) {
+      }
+    }
+
     return make_dynamic([=](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
       std::vector<Value> evaluated_args;
+      evaluated_args.reserve(args.size());
 
       for (const auto &arg : args) {
         evaluated_args.emplace_back(arg(params));
@@ -1131,7 +1219,7 @@ Expression make_allMatchingAttributes(const std::string &function_name, const st
     std::vector<Expression> out_exprs;
 
     for (const auto &arg : args) {
-      const std::regex attr_regex = std::regex(arg(params).asString());
+      const auto attr_regex = get_regex(arg(params).asString());
       const auto cur_flow_file = params.flow_file.lock();
       std::map<std::string, std::string> attrs;
 
@@ -1140,7 +1228,7 @@ Expression make_allMatchingAttributes(const std::string &function_name, const st
       }
 
       for (const auto &attr : attrs) {
-        if (std::regex_match(attr.first.begin(), attr.first.end(), attr_regex)) {
+        if (std::regex_match(attr.first.begin(), attr.first.end(), *attr_regex)) {
           out_exprs.emplace_back(make_dynamic([=](const Parameters &params,
                       const std::vector<Expression> &sub_exprs) -> Value {
                     std::string attr_val;
@@ -1184,7 +1272,7 @@ Expression make_anyMatchingAttribute(const std::string &function_name, const std
     std::vector<Expression> out_exprs;
 
     for (const auto &arg : args) {
-      const std::regex attr_regex = std::regex(arg(params).asString());
+      const auto attr_regex = get_regex(arg(params).asString());
       const auto cur_flow_file = params.flow_file.lock();
       std::map<std::string, std::string> attrs;
 
@@ -1193,7 +1281,7 @@ Expression make_anyMatchingAttribute(const std::string &function_name, const std
       }
 
       for (const auto &attr : attrs) {
-        if (std::regex_match(attr.first.begin(), attr.first.end(), attr_regex)) {
+        if (std::regex_match(attr.first.begin(), attr.first.end(), *attr_regex)) {
           out_exprs.emplace_back(make_dynamic([=](const Parameters &params,
                       const std::vector<Expression> &sub_exprs) -> Value {
                     std::string attr_val;
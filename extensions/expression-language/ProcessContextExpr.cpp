@@ -17,26 +17,68 @@
 
 #include "ProcessContextExpr.h"
 #include <memory>
+#include <string>
+
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 namespace core {
 
-bool ProcessContextExpr::getProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
-  if (!property.supportsExpressionLangauge()) {
-    return ProcessContext::getProperty(property.getName(), value);
+void ProcessContextExpr::compileExpression(std::map<std::string, expression::Expression> &expressions, const std::string &name, bool dynamic) {
+  std::string expression_str;
+  if (dynamic ? !ProcessContext::getDynamicProperty(name, expression_str) : !ProcessContext::getProperty(name, expression_str)) {
+    return;
+  }
+  try {
+    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
+    expressions.emplace(name, expression::compile(expression_str));
+  } catch (const std::exception &e) {
+    logger_->log_debug("Could not compile expression for %s/%s ahead of use: %s", getProcessorNode()->getName(), name, e.what());
+  }
+}
+
+void ProcessContextExpr::compileExpressions() {
+  auto component = std::dynamic_pointer_cast<ConfigurableComponent>(getProcessorNode()->getProcessor());
+  if (component != nullptr) {
+    for (const auto &property : component->getProperties()) {
+      if (property.second.supportsExpressionLangauge()) {
+        compileExpression(expressions_, property.first, false);
+      }
+    }
+  }
+  for (const auto &name : getDynamicPropertyKeys()) {
+    compileExpression(dynamic_property_expressions_, name, true);
+  }
+}
+
+const expression::Expression &ProcessContextExpr::getExpression(std::map<std::string, expression::Expression> &expressions, const std::string &name, bool dynamic) {
+  std::lock_guard<std::mutex> lock(expressions_mutex_);
+  if (!expressions_compiled_) {
+    expressions_compiled_ = true;
+    compileExpressions();
   }
-  auto name = property.getName();
-  if (expressions_.find(name) == expressions_.end()) {
+  auto it = expressions.find(name);
+  if (it == expressions.end()) {
     std::string expression_str;
-    ProcessContext::getProperty(name, expression_str);
+    if (dynamic) {
+      ProcessContext::getDynamicProperty(name, expression_str);
+    } else {
+      ProcessContext::getProperty(name, expression_str);
+    }
     logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    expressions_.emplace(name, expression::compile(expression_str));
+    it = expressions.emplace(name, expression::compile(expression_str)).first;
   }
+  return it->second;
+}
 
+bool ProcessContextExpr::getProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
+  if (!property.supportsExpressionLangauge()) {
+    return ProcessContext::getProperty(property.getName(), value);
+  }
+  const auto &expression = getExpression(expressions_, property.getName(), false);
   minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = expressions_[name](p).asString();
+  value = expression(p).asString();
   return true;
 }
 
@@ -45,15 +87,20 @@ bool ProcessContextExpr::getDynamicProperty(const Property &property, std::strin
   if (!property.supportsExpressionLangauge()) {
     return ProcessContext::getDynamicProperty(property.getName(), value);
   }
-  auto name = property.getName();
-  if (dynamic_property_expressions_.find(name) == dynamic_property_expressions_.end()) {
-    std::string expression_str;
-    ProcessContext::getDynamicProperty(name, expression_str);
-    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    dynamic_property_expressions_.emplace(name, expression::compile(expression_str));
+  const auto &expression = getExpression(dynamic_property_expressions_, property.getName(), true);
+  minifi::expression::Parameters p(shared_from_this(), flow_file);
+  value = expression(p).asString();
+  return true;
+}
+
+bool ProcessContextExpr::getDynamicProperty(const Property &property, bool &value, const std::shared_ptr<FlowFile> &flow_file) {
+  if (!property.supportsExpressionLangauge()) {
+    return ProcessContext::getDynamicProperty(property, value, flow_file);
   }
+  const auto &expression = getExpression(dynamic_property_expressions_, property.getName(), true);
   minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = dynamic_property_expressions_[name](p).asString();
+  const auto result = expression(p);
+  value = result.isBoolean() ? result.asBoolean() : result.asString() == "true";
   return true;
 }
 
@@ -16,7 +16,10 @@
  */
 
 #include <ProcessContext.h>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <impl/expression/Expression.h>
 
 namespace org {
@@ -62,12 +65,40 @@ class ProcessContextExpr : public core::ProcessContext {
   virtual bool getProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
 
   virtual bool getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
+
+  /**
+   * Evaluates a dynamic property as a predicate, without converting boolean results to strings.
+   */
+  virtual bool getDynamicProperty(const Property &property, bool &value, const std::shared_ptr<FlowFile> &flow_file) override;
  protected:
 
   std::map<std::string, org::apache::nifi::minifi::expression::Expression> expressions_;
   std::map<std::string, org::apache::nifi::minifi::expression::Expression> dynamic_property_expressions_;
 
  private:
+  /**
+   * Provides the compiled expression of a property, compiling it on first use. Compiled expressions
+   * are immutable, so they are evaluated by the concurrent tasks of the processor without locking.
+   */
+  const org::apache::nifi::minifi::expression::Expression &getExpression(std::map<std::string, org::apache::nifi::minifi::expression::Expression> &expressions,
+                                                                         const std::string &name, bool dynamic);
+
+  /**
+   * Compiles the expressions of every expression language property and dynamic property of the
+   * processor, so that no task of the processor compiles while the others wait for it.
+   * Requires expressions_mutex_.
+   */
+  void compileExpressions();
+
+  /**
+   * Compiles the expression of a property if it has a value. Values that are not valid expressions
+   * are left to be compiled, and reported, when the property is used.
+   */
+  void compileExpression(std::map<std::string, org::apache::nifi::minifi::expression::Expression> &expressions, const std::string &name, bool dynamic);
+
+  // guards the compiled expressions maps and expressions_compiled_
+  std::mutex expressions_mutex_;
+  bool expressions_compiled_ = false;
   std::shared_ptr<logging::Logger> logger_;
 };
 
@@ -86,6 +86,10 @@ class Value {
     return is_string_;
   };
 
+  bool isBoolean() const {
+    return is_bool_;
+  };
+
   bool isDecimal() const {
     if (is_long_double_) {
       return true;
@@ -765,6 +765,25 @@ TEST_CASE("Chained call 3", "[expressionChainedCall3]") {  // NOLINT
   REQUIRE("238" == expr( { flow_file_a }).asString());
 }
 
+TEST_CASE("Constant folding", "[expressionConstantFolding]") {  // NOLINT
+  auto expr = expression::compile("${literal(10):multiply(2):plus(1):multiply(2)}");
+  REQUIRE(!expr.is_dynamic());
+  REQUIRE(42 == expr( { }).asSignedLong());
+
+  auto concatenated = expression::compile("a${literal('b'):toUpper():append('c')}d");
+  REQUIRE(!concatenated.is_dynamic());
+  REQUIRE("aBcd" == concatenated( { }).asString());
+
+  REQUIRE(expression::compile("${literal(10):plus(${attr})}").is_dynamic());
+  REQUIRE(expression::compile("${UUID()}").is_dynamic());
+  REQUIRE(expression::compile("${literal(1):plus(${random()})}").is_dynamic());
+
+  // failures are left to evaluation
+  auto failing = expression::compile("${literal('abc'):substring(10)}");
+  REQUIRE(failing.is_dynamic());
+  REQUIRE_THROWS(failing( { }));
+}
+
 TEST_CASE("LiteralBool", "[expressionLiteralBool]") {  // NOLINT
   auto expr = expression::compile("${literal(true)}");
 
@@ -21,6 +21,7 @@
 #include "processors/LogAttribute.h"
 #include "processors/UpdateAttribute.h"
 #include "processors/GenerateFlowFile.h"
+#include "ProcessContextExpr.h"
 
 TEST_CASE("RouteOnAttributeMatchedTest", "[routeOnAttributeMatchedTest]") {
   TestController testController;
@@ -90,3 +91,74 @@ TEST_CASE("RouteOnAttributeUnmatchedTest", "[routeOnAttributeUnmatchedTest]") {
 
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("RouteOnAttributeRoutingStrategyTest", "[routeOnAttributeRoutingStrategyTest]") {
+  TestController testController;
+
+  LogTestController::getInstance().setDebug<minifi::processors::UpdateAttribute>();
+  LogTestController::getInstance().setDebug<minifi::processors::RouteOnAttribute>();
+  LogTestController::getInstance().setDebug<TestPlan>();
+  LogTestController::getInstance().setDebug<minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  const auto &generate_proc = plan->addProcessor("GenerateFlowFile", "generate");
+
+  const auto &update_proc = plan->addProcessor("UpdateAttribute", "update", core::Relationship("success", "description"), true);
+  plan->setProperty(update_proc, "route_condition_attr", "true", true);
+
+  const auto &route_proc = plan->addProcessor("RouteOnAttribute", "route", core::Relationship("success", "description"), true);
+  route_proc->setAutoTerminatedRelationships({ { core::Relationship("unmatched", "description") }, { core::Relationship("route_a", "description") } });
+  plan->setProperty(route_proc, "route_a", "${route_condition_attr}", true);
+  plan->setProperty(route_proc, "route_b", "${route_condition_attr:equals('true')}", true);
+
+  bool expect_route_b = true;
+  SECTION("every matching route gets the FlowFile") {
+  }
+  SECTION("only the first matching route gets the FlowFile") {
+    plan->setProperty(route_proc, minifi::processors::RouteOnAttribute::RoutingStrategy.getName(), minifi::processors::RouteOnAttribute::ROUTE_TO_FIRST_PROPERTY_NAME);
+    expect_route_b = false;
+  }
+
+  const auto &update_matched_proc = plan->addProcessor("UpdateAttribute", "update_matched", core::Relationship("route_b", "description"), true);
+  plan->setProperty(update_matched_proc, "route_check_attr", "good", true);
+
+  const auto &log_proc = plan->addProcessor("LogAttribute", "log", core::Relationship("success", "description"), true);
+
+  testController.runSession(plan, false);  // generate
+  testController.runSession(plan, false);  // update
+  testController.runSession(plan, false);  // route
+  testController.runSession(plan, false);  // update_matched
+  testController.runSession(plan, false);  // log
+
+  REQUIRE(expect_route_b == LogTestController::getInstance().contains("key:route_check_attr value:good", std::chrono::seconds(0)));
+
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("RouteOnAttributeCompilesRoutesBeforeUseTest", "[routeOnAttributeCompilesRoutesBeforeUseTest]") {
+  TestController testController;
+
+  LogTestController::getInstance().setDebug<minifi::processors::RouteOnAttribute>();
+  LogTestController::getInstance().setDebug<core::ProcessContextExpr>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  plan->addProcessor("GenerateFlowFile", "generate");
+
+  const auto &route_proc = plan->addProcessor("RouteOnAttribute", "route", core::Relationship("success", "description"), true);
+  route_proc->setAutoTerminatedRelationships({ { core::Relationship("unmatched", "description") }, { core::Relationship("route_a", "description") },
+      { core::Relationship("route_b", "description") } });
+  plan->setProperty(route_proc, minifi::processors::RouteOnAttribute::RoutingStrategy.getName(), minifi::processors::RouteOnAttribute::ROUTE_TO_FIRST_PROPERTY_NAME);
+  plan->setProperty(route_proc, "route_a", "${literal('true')}", true);
+  plan->setProperty(route_proc, "route_b", "${literal('false')}", true);
+
+  testController.runSession(plan, false);  // generate
+  testController.runSession(plan, false);  // route
+
+  // route_a matches, so route_b is never evaluated, yet it was compiled along with route_a
+  REQUIRE(LogTestController::getInstance().contains("Compiling expression for route/route_a", std::chrono::seconds(0)));
+  REQUIRE(LogTestController::getInstance().contains("Compiling expression for route/route_b", std::chrono::seconds(0)));
+
+  LogTestController::getInstance().reset();
+}
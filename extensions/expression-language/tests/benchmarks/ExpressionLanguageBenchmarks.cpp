@@ -0,0 +1,75 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+
+#include "benchmarks/Benchmark.h"
+#include "TestBase.h"
+#include "core/FlowFile.h"
+#include "impl/expression/Expression.h"
+
+namespace expression = org::apache::nifi::minifi::expression;
+
+namespace {
+
+class BenchmarkFlowFile : public core::FlowFile {
+  void releaseClaim(const std::shared_ptr<minifi::ResourceClaim> claim) override {
+  }
+};
+
+const char * const EXPRESSION = "${filename:toUpper():append('.'):append(${path:substringAfterLast('/')})}-${literal(3):plus(4)}";
+
+class ExpressionCompile : public Benchmark {
+ public:
+  void run(BenchmarkState &state) override {
+    while (state.keepRunning()) {
+      auto expr = expression::compile(EXPRESSION);
+      doNotOptimize(expr);
+    }
+  }
+};
+
+/**
+ * Evaluates an expression compiled once against the attributes of a FlowFile, as processors
+ * do for each FlowFile with the properties they compiled on schedule.
+ */
+class ExpressionEvaluate : public Benchmark {
+ public:
+  void setUp(int threads) override {
+    expr_ = expression::compile(EXPRESSION);
+  }
+
+  void run(BenchmarkState &state) override {
+    auto flow_file = std::make_shared<BenchmarkFlowFile>();
+    flow_file->addAttribute("filename", "benchmark.txt");
+    flow_file->addAttribute("path", "/var/data/benchmark");
+    while (state.keepRunning()) {
+      std::string result = expr_( { flow_file }).asString();
+      doNotOptimize(result);
+    }
+  }
+
+ private:
+  expression::Expression expr_;
+};
+
+}  // namespace
+
+REGISTER_BENCHMARK(ExpressionCompile, 1, 4)
+REGISTER_BENCHMARK(ExpressionEvaluate, 1, 4)
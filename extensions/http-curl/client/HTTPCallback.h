@@ -51,12 +51,20 @@ namespace utils {
  *    by the current buffer
  *  - because of this, all functions that request data at a specific offset are implicit seeks and potentially modify
  *    the current buffer
+ *  - if a maximum number of buffered bytes is given, the producer blocks while the queued, not yet consumed data
+ *    would exceed it, so that streaming a large payload only ever holds a bounded amount of it in memory
+ *  - data produced after close() is rejected, as there is no consumer left to take it
  */
 class HttpStreamingCallback : public ByteInputCallBack {
  public:
-  HttpStreamingCallback()
+  /**
+   * @param max_buffered_bytes upper bound of queued but not yet consumed bytes, 0 means unbounded
+   */
+  explicit HttpStreamingCallback(size_t max_buffered_bytes = 0U)
       : logger_(logging::LoggerFactory<HttpStreamingCallback>::getLogger()),
         is_alive_(true),
+        max_buffered_bytes_(max_buffered_bytes),
+        buffered_bytes_(0U),
         total_bytes_loaded_(0U),
         current_buffer_start_(0U),
         current_pos_(0U),
@@ -89,19 +97,17 @@ class HttpStreamingCallback : public ByteInputCallBack {
     return processInner(std::move(vec));
   }
 
+  /**
+   * The caller reuses its buffer as soon as we return, while libcURL reads the data later from its own thread,
+   * so the data is copied once into the buffer that is queued.
+   */
   virtual int64_t process(const uint8_t* data, size_t size) {
-    std::vector<char> vec;
-    vec.resize(size);
-    memcpy(vec.data(), reinterpret_cast<const char*>(data), size);
-
-    return processInner(std::move(vec));
+    const char *begin = reinterpret_cast<const char*>(data);
+    return processInner(std::vector<char>(begin, begin + size));
   }
 
   void write(std::string content) override {
-    std::vector<char> vec;
-    vec.assign(content.begin(), content.end());
-
-    (void) processInner(std::move(vec));
+    (void) processInner(std::vector<char>(content.begin(), content.end()));
   }
 
   char* getBuffer(size_t pos) override {
@@ -154,6 +160,9 @@ class HttpStreamingCallback : public ByteInputCallBack {
     } else {
       current_vec_ = std::move(byte_arrays_.front());
       byte_arrays_.pop_front();
+      buffered_bytes_ -= current_vec_.size();
+      // wake up a producer waiting for space
+      cv.notify_all();
 
       ptr_ = current_vec_.data();
       current_buffer_start_ = total_bytes_loaded_;
@@ -171,7 +180,7 @@ class HttpStreamingCallback : public ByteInputCallBack {
   /**
    * Common implementation for placing a buffer into the queue
    * @param vec the buffer to be inserted
-   * @return the number of bytes processed (the size of vec)
+   * @return the number of bytes processed (the size of vec), or -1 if we have been closed
    */
   int64_t processInner(std::vector<char>&& vec) {
     size_t size = vec.size();
@@ -183,6 +192,17 @@ class HttpStreamingCallback : public ByteInputCallBack {
     }
 
     std::unique_lock<std::mutex> lock(mutex_);
+    if (max_buffered_bytes_ > 0U) {
+      // a single buffer larger than the limit is still accepted once the queue is drained
+      cv.wait(lock, [&] {
+        return byte_arrays_.empty() || buffered_bytes_ + size <= max_buffered_bytes_ || !is_alive_;
+      });
+    }
+    if (!is_alive_) {
+      logger_->log_debug("processInner() called after close, discarding %zu bytes", size);
+      return -1;
+    }
+    buffered_bytes_ += size;
     byte_arrays_.emplace_back(std::move(vec));
     cv.notify_all();
 
@@ -215,6 +235,8 @@ class HttpStreamingCallback : public ByteInputCallBack {
   std::condition_variable cv;
 
   bool is_alive_;
+  const size_t max_buffered_bytes_;
+  size_t buffered_bytes_;
   size_t total_bytes_loaded_;
   size_t current_buffer_start_;
   size_t current_pos_;
@@ -33,12 +33,16 @@ namespace nifi {
 namespace minifi {
 namespace io {
 
+constexpr size_t HttpStream::MAX_BUFFERED_UPLOAD_BYTES;
+constexpr size_t HttpStream::MAX_BUFFERED_DOWNLOAD_BYTES;
+
 HttpStream::HttpStream(std::shared_ptr<utils::HTTPClient> client)
     : http_client_(client),
       written(0),
-      // given the nature of the stream we don't want to slow libCURL, we will produce
-      // a warning instead allowing us to adjust it server side or through the local configuration.
-      http_read_callback_(66560, true),
+      // bounds the memory held per stream: writers and libcURL's write callback block
+      // once this much data is queued, until the other side catches up
+      http_callback_(MAX_BUFFERED_UPLOAD_BYTES),
+      http_read_callback_(MAX_BUFFERED_DOWNLOAD_BYTES, true),
       started_(false),
       logger_(logging::LoggerFactory<HttpStream>::getLogger()) {
   // submit early on
@@ -75,11 +79,13 @@ int HttpStream::writeData(uint8_t *value, int size) {
         callback_.ptr = &http_callback_;
         callback_.pos = 0;
         http_client_->setUploadCallback(&callback_);
-        http_client_future_ = std::async(std::launch::async, submit_client, http_client_);
+        http_client_future_ = std::async(std::launch::async, submit_upload_client, http_client_, &http_callback_);
         started_ = true;
       }
     }
-    http_callback_.process(value, size);
+    if (http_callback_.process(value, size) < 0) {
+      return -1;
+    }
     return size;
   } else {
     return -1;
@@ -36,6 +36,16 @@ namespace io {
 
 class HttpStream : public io::BaseStream {
  public:
+  /**
+   * Upper bound of the request body we queue up for libcURL before blocking the writer.
+   */
+  static constexpr size_t MAX_BUFFERED_UPLOAD_BYTES = 1024 * 1024;
+
+  /**
+   * Upper bound of the response body we queue up from libcURL before blocking its write callback.
+   */
+  static constexpr size_t MAX_BUFFERED_DOWNLOAD_BYTES = 1024 * 1024;
+
   /**
    * File Stream constructor that accepts an fstream shared pointer.
    * It must already be initialized for read and write.
@@ -127,6 +137,15 @@ class HttpStream : public io::BaseStream {
     return submit_status;
   }
 
+  static bool submit_upload_client(std::shared_ptr<utils::HTTPClient> client, utils::HttpStreamingCallback *callback) {
+    if (client == nullptr)
+      return false;
+    bool submit_status = client->submit();
+    // unblock writers if the request ended before consuming everything we had to send
+    callback->close();
+    return submit_status;
+  }
+
   static bool submit_read_client(std::shared_ptr<utils::HTTPClient> client, utils::ByteOutputCallback *callback) {
     if (client == nullptr)
       return false;
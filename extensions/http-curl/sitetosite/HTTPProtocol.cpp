@@ -213,7 +213,7 @@ std::shared_ptr<minifi::utils::HTTPClient> HttpSiteToSiteClient::openConnectionF
 std::shared_ptr<minifi::utils::HTTPClient> HttpSiteToSiteClient::openConnectionForReceive(const std::shared_ptr<HttpTransaction> &transaction) {
   std::stringstream uri;
   uri << transaction->getTransactionUrl() << "/flow-files";
-  std::shared_ptr<minifi::utils::HTTPClient> client = create_http_client(uri.str(), "GET");
+  std::shared_ptr<minifi::utils::HTTPClient> client = create_http_client(uri.str(), "GET", true);
   return client;
 }
 
@@ -59,6 +59,9 @@ typedef struct Site2SitePeerStatus {
 class HttpSiteToSiteClient : public sitetosite::SiteToSiteClient {
 
   static constexpr char const* PROTOCOL_VERSION_HEADER = "x-nifi-site-to-site-protocol-version";
+  static constexpr char const* BATCH_COUNT_HEADER = "x-nifi-site-to-site-batch-count";
+  static constexpr char const* BATCH_SIZE_HEADER = "x-nifi-site-to-site-batch-size";
+  static constexpr char const* BATCH_DURATION_HEADER = "x-nifi-site-to-site-batch-duration";
  public:
 
   /*!
@@ -164,7 +167,12 @@ class HttpSiteToSiteClient : public sitetosite::SiteToSiteClient {
     http_client_->initialize(method, uri, ssl_context_service_);
     if (setPropertyHeaders) {
       if (_currentVersion >= 5) {
-        // batch count, size, and duratin don't appear to be set through the interfaces.
+        if (_batchCount > 0)
+          http_client_->appendHeader(BATCH_COUNT_HEADER, std::to_string(_batchCount));
+        if (_batchSize > 0)
+          http_client_->appendHeader(BATCH_SIZE_HEADER, std::to_string(_batchSize));
+        if (_batchDuration > 0)
+          http_client_->appendHeader(BATCH_DURATION_HEADER, std::to_string(_batchDuration));
       }
     }
     if (!this->peer_->getInterface().empty()) {
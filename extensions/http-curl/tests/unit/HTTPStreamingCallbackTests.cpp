@@ -16,6 +16,7 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <vector>
@@ -157,3 +158,55 @@ TEST_CASE_METHOD(HttpStreamingCallbackTestsFixture, "HttpStreamingCallback multi
 
   REQUIRE(input == content);
 }
+
+TEST_CASE("HttpStreamingCallback bounded buffering", "[basic]") {
+  utils::HttpStreamingCallback callback(16U);
+  std::atomic<size_t> chunks_processed(0U);
+
+  std::thread producer([&]() {
+    for (size_t i = 0U; i < 4U; i++) {
+      std::string chunk = "abcdefg" + std::to_string(i);
+      if (callback.process(reinterpret_cast<const uint8_t*>(chunk.c_str()), chunk.length()) != 8) {
+        break;
+      }
+      chunks_processed++;
+    }
+    callback.close();
+  });
+
+  // with nobody consuming, the producer has to stop once 16 bytes are queued
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (chunks_processed.load() < 2U && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE(2U == chunks_processed.load());
+  // and stay blocked
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  REQUIRE(2U == chunks_processed.load());
+
+  std::string content;
+  size_t current_pos = 0U;
+  while (true) {
+    size_t buffer_size = callback.getBufferSize();
+    char* ptr = callback.getBuffer(current_pos);
+    if (ptr == nullptr) {
+      break;
+    }
+    content.append(ptr, buffer_size - current_pos);
+    current_pos = buffer_size;
+    callback.seek(current_pos);
+  }
+  producer.join();
+
+  REQUIRE(4U == chunks_processed.load());
+  REQUIRE("abcdefg0abcdefg1abcdefg2abcdefg3" == content);
+}
+
+TEST_CASE("HttpStreamingCallback rejects data after close", "[basic]") {
+  utils::HttpStreamingCallback callback(16U);
+  callback.close();
+
+  std::string input = "foobar";
+  REQUIRE(-1 == callback.process(reinterpret_cast<const uint8_t*>(input.c_str()), input.length()));
+  REQUIRE(nullptr == callback.getBuffer(0U));
+}
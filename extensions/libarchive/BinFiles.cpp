@@ -27,6 +27,7 @@
 #include <map>
 #include <deque>
 #include <utility>
+#include <algorithm>
 #include "utils/TimeUtil.h"
 #include "utils/StringUtils.h"
 #include "core/ProcessContext.h"
@@ -123,114 +124,158 @@ void BinFiles::preprocessFlowFile(core::ProcessContext *context, core::ProcessSe
   }
 }
 
-void BinManager::gatherReadyBins() {
-  std::lock_guard < std::mutex > lock(mutex_);
-  std::vector< std::string > emptyQueue;
-  for (std::map<std::string, std::unique_ptr<std::deque<std::unique_ptr<Bin>>> >::iterator it=groupBinMap_.begin(); it !=groupBinMap_.end(); ++it) {
-    std::unique_ptr < std::deque<std::unique_ptr<Bin>>>&queue = it->second;
-    while (!queue->empty()) {
-      std::unique_ptr<Bin> &bin = queue->front();
-      if (bin->isReadyForMerge() || (binAge_ != ULLONG_MAX && bin->isOlderThan(binAge_))) {
-        readyBin_.push_back(std::move(bin));
-        queue->pop_front();
-        binCount_--;
-        logger_->log_debug("BinManager move bin %s to ready bins for group %s", readyBin_.back()->getUUIDStr(), readyBin_.back()->getGroupId());
-      } else {
-        break;
-      }
-    }
-    if (queue->empty()) {
-      emptyQueue.push_back(it->first);
-    }
+void BinManager::addReadyBin(std::unique_ptr<Bin> bin) {
+  logger_->log_debug("BinManager move bin %s to ready bins for group %s", bin->getUUIDStr(), bin->getGroupId());
+  std::lock_guard<std::mutex> lock(ready_mutex_);
+  readyBin_.push_back(std::move(bin));
+}
+
+void BinManager::moveReadyBins(std::deque<std::unique_ptr<Bin>> &queue) {
+  while (!queue.empty() && queue.front()->isReadyForMerge()) {
+    addReadyBin(std::move(queue.front()));
+    queue.pop_front();
+    binCount_--;
+  }
+}
+
+bool BinManager::moveBin(const BinAge &entry) {
+  Shard &shard = getShard(entry.group);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto search = shard.groupBinMap.find(entry.group);
+  if (search == shard.groupBinMap.end()) {
+    return false;
   }
-  for (auto group : emptyQueue) {
-    // erase from the map if the queue is empty for the group
-    groupBinMap_.erase(group);
+  auto &queue = search->second;
+  auto bin = std::find_if(queue.begin(), queue.end(), [&entry](const std::unique_ptr<Bin> &candidate) {
+    return candidate->getUUIDStr() == entry.uuid;
+  });
+  if (bin == queue.end()) {
+    return false;
   }
-  logger_->log_debug("BinManager groupBinMap size %d", groupBinMap_.size());
+  // the bins in front of it are older
+  auto count = std::distance(queue.begin(), bin) + 1;
+  for (; count > 0; count--) {
+    addReadyBin(std::move(queue.front()));
+    queue.pop_front();
+    binCount_--;
+  }
+  moveReadyBins(queue);
+  if (queue.empty()) {
+    shard.groupBinMap.erase(search);
+  }
+  return true;
 }
 
-void BinManager::removeOldestBin() {
-  std::lock_guard < std::mutex > lock(mutex_);
-  uint64_t olddate = ULLONG_MAX;
-  std::unique_ptr < std::deque<std::unique_ptr<Bin>>>*oldqueue;
-  for (std::map<std::string, std::unique_ptr<std::deque<std::unique_ptr<Bin>>>>::iterator it=groupBinMap_.begin(); it !=groupBinMap_.end(); ++it) {
-    std::unique_ptr < std::deque<std::unique_ptr<Bin>>>&queue = it->second;
-    if (!queue->empty()) {
-      std::unique_ptr<Bin> &bin = queue->front();
-      if (bin->getBinAge() < olddate) {
-        olddate = bin->getBinAge();
-        oldqueue = &queue;
+bool BinManager::isBinQueued(const BinAge &entry) {
+  Shard &shard = getShard(entry.group);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto search = shard.groupBinMap.find(entry.group);
+  if (search == shard.groupBinMap.end()) {
+    return false;
+  }
+  return std::any_of(search->second.begin(), search->second.end(), [&entry](const std::unique_ptr<Bin> &bin) {
+    return bin->getUUIDStr() == entry.uuid;
+  });
+}
+
+void BinManager::pruneBinAges() {
+  if (binAges_.size() <= 2 * static_cast<size_t>(binCount_) + SHARD_COUNT) {
+    return;
+  }
+  BinAgeHeap binAges;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto &group : shard.groupBinMap) {
+      for (const auto &bin : group.second) {
+        binAges.push(BinAge { bin->getBinAge(), binSequence_++, group.first, bin->getUUIDStr() });
       }
     }
   }
-  if (olddate != ULLONG_MAX) {
-    std::unique_ptr<Bin> &remove = (*oldqueue)->front();
-    std::string group = remove->getGroupId();
-    readyBin_.push_back(std::move(remove));
-    (*oldqueue)->pop_front();
-    binCount_--;
-    logger_->log_debug("BinManager move bin %s to ready bins for group %s", readyBin_.back()->getUUIDStr(), readyBin_.back()->getGroupId());
-    if ((*oldqueue)->empty()) {
-      groupBinMap_.erase(group);
+  binAges_.swap(binAges);
+}
+
+void BinManager::gatherReadyBins() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // bins that are ready for merge are moved when the flow file filling them is offered, only the age is checked here
+  uint64_t currentTime = getTimeMillis();
+  while (!binAges_.empty()) {
+    const BinAge &oldest = binAges_.top();
+    if (binAge_ != ULLONG_MAX && currentTime > oldest.created + binAge_) {
+      moveBin(oldest);
+    } else if (isBinQueued(oldest)) {
+      break;
+    }
+    binAges_.pop();
+  }
+  pruneBinAges();
+  logger_->log_debug("BinManager bin count %d", static_cast<int>(binCount_));
+}
+
+void BinManager::removeOldestBin() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!binAges_.empty()) {
+    BinAge oldest = binAges_.top();
+    binAges_.pop();
+    if (moveBin(oldest)) {
+      break;
     }
   }
-  logger_->log_debug("BinManager groupBinMap size %d", groupBinMap_.size());
+  logger_->log_debug("BinManager bin count %d", static_cast<int>(binCount_));
 }
 
 void BinManager::getReadyBin(std::deque<std::unique_ptr<Bin>> &retBins) {
-  std::lock_guard < std::mutex > lock(mutex_);
+  std::lock_guard<std::mutex> lock(ready_mutex_);
   while (!readyBin_.empty()) {
-    std::unique_ptr<Bin> &bin = readyBin_.front();
-    retBins.push_back(std::move(bin));
+    retBins.push_back(std::move(readyBin_.front()));
     readyBin_.pop_front();
   }
 }
 
+bool BinManager::getReadyBin(std::unique_ptr<Bin> &bin) {
+  std::lock_guard<std::mutex> lock(ready_mutex_);
+  if (readyBin_.empty()) {
+    return false;
+  }
+  bin = std::move(readyBin_.front());
+  readyBin_.pop_front();
+  return true;
+}
+
 bool BinManager::offer(const std::string &group, std::shared_ptr<core::FlowFile> flow) {
-  std::lock_guard < std::mutex > lock(mutex_);
   if (flow->getSize() > maxSize_) {
     // could not be added to a bin -- too large by itself, so create a separate bin for just this guy.
     std::unique_ptr<Bin> bin = std::unique_ptr < Bin > (new Bin(0, ULLONG_MAX, 1, INT_MAX, "", group));
     if (!bin->offer(flow))
       return false;
-    readyBin_.push_back(std::move(bin));
-    logger_->log_debug("BinManager move bin %s to ready bins for group %s", readyBin_.back()->getUUIDStr(), group);
+    addReadyBin(std::move(bin));
     return true;
   }
-  auto search = groupBinMap_.find(group);
-  if (search != groupBinMap_.end()) {
-    std::unique_ptr < std::deque<std::unique_ptr<Bin>>>&queue = search->second;
-    if (!queue->empty()) {
-      std::unique_ptr<Bin> &tail = queue->back();
-      if (!tail->offer(flow)) {
-        // last bin can not offer the flow
-        std::unique_ptr<Bin> bin = std::unique_ptr < Bin > (new Bin(minSize_, maxSize_, minEntries_, maxEntries_, fileCount_, group));
-        if (!bin->offer(flow))
-          return false;
-        queue->push_back(std::move(bin));
-        logger_->log_debug("BinManager add bin %s to group %s", queue->back()->getUUIDStr(), group);
-        binCount_++;
-      }
-    } else {
+  std::unique_ptr<BinAge> created;
+  {
+    Shard &shard = getShard(group);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto &queue = shard.groupBinMap[group];
+    if (queue.empty() || !queue.back()->offer(flow)) {
+      // last bin can not offer the flow
       std::unique_ptr<Bin> bin = std::unique_ptr < Bin > (new Bin(minSize_, maxSize_, minEntries_, maxEntries_, fileCount_, group));
-      if (!bin->offer(flow))
+      if (!bin->offer(flow)) {
+        if (queue.empty())
+          shard.groupBinMap.erase(group);
         return false;
-      queue->push_back(std::move(bin));
+      }
+      created = std::unique_ptr<BinAge>(new BinAge { bin->getBinAge(), binSequence_++, group, bin->getUUIDStr() });
+      queue.push_back(std::move(bin));
+      logger_->log_debug("BinManager add bin %s to group %s", queue.back()->getUUIDStr(), group);
       binCount_++;
-      logger_->log_debug("BinManager add bin %s to group %s", queue->back()->getUUIDStr(), group);
     }
-  } else {
-    std::unique_ptr<std::deque<std::unique_ptr<Bin>>> queue = std::unique_ptr<std::deque<std::unique_ptr<Bin>>> (new std::deque<std::unique_ptr<Bin>>());
-    std::unique_ptr<Bin> bin = std::unique_ptr < Bin > (new Bin(minSize_, maxSize_, minEntries_, maxEntries_, fileCount_, group));
-    if (!bin->offer(flow))
-      return false;
-    queue->push_back(std::move(bin));
-    logger_->log_debug("BinManager add bin %s to group %s", queue->back()->getUUIDStr(), group);
-    groupBinMap_.insert(std::make_pair(group, std::move(queue)));
-    binCount_++;
+    moveReadyBins(queue);
+    if (queue.empty())
+      shard.groupBinMap.erase(group);
+  }
+  if (created) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    binAges_.push(*created);
   }
-
   return true;
 }
 
@@ -261,17 +306,13 @@ void BinFiles::onTrigger(const std::shared_ptr<core::ProcessContext> &context, c
     this->binManager_.removeOldestBin();
   }
 
-  // get the ready bin
-  std::deque<std::unique_ptr<Bin>> readyBins;
-  binManager_.getReadyBin(readyBins);
-
-  // process the ready bin
-  if (!readyBins.empty()) {
+  // process the ready bins. Bins are taken one at a time, so that concurrent tasks merge them in parallel
+  size_t pending = binManager_.getReadyBinCount();
+  if (pending > 0) {
     // create session for merge
     core::ProcessSession mergeSession(context);
-    while (!readyBins.empty()) {
-      std::unique_ptr<Bin> bin = std::move(readyBins.front());
-      readyBins.pop_front();
+    std::unique_ptr<Bin> bin;
+    for (; pending > 0 && binManager_.getReadyBin(bin); pending--) {
       // add bin's flows to the session
       this->addFlowsToSession(context.get(), &mergeSession, bin);
       logger_->log_debug("BinFiles start to process bin %s for group %s", bin->getUUIDStr(), bin->getGroupId());
@@ -20,9 +20,17 @@
 #ifndef __BIN_FILES_H__
 #define __BIN_FILES_H__
 
+#include <array>
+#include <atomic>
 #include <climits>
 #include <deque>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
@@ -145,7 +153,11 @@ class Bin {
   std::string uuid_str_;
 };
 
-// BinManager Class
+/**
+ * Purpose: Bins are merged by concurrent tasks, so the BinManager is thread safe. Groups are spread over
+ * shards with a lock each, and the bins are indexed by age in a heap, so that finding the oldest or the
+ * expired bins does not need to visit every group.
+ */
 class BinManager {
  public:
   // Constructor
@@ -159,6 +171,7 @@ class BinManager {
         minEntries_(1),
         binAge_(ULLONG_MAX),
         binCount_(0),
+        binSequence_(0),
         logger_(logging::LoggerFactory<BinManager>::getLogger()) {
   }
   virtual ~BinManager() {
@@ -187,7 +200,15 @@ class BinManager {
   }
   void purge() {
     std::lock_guard<std::mutex> lock(mutex_);
-    groupBinMap_.clear();
+    for (auto &shard : shards_) {
+      std::lock_guard<std::mutex> shard_lock(shard.mutex);
+      shard.groupBinMap.clear();
+    }
+    binAges_ = BinAgeHeap();
+    {
+      std::lock_guard<std::mutex> ready_lock(ready_mutex_);
+      readyBin_.clear();
+    }
     binCount_ = 0;
   }
   // Adds the given flowFile to the first available bin in which it fits for the given group or creates a new bin in the specified group if necessary.
@@ -198,10 +219,49 @@ class BinManager {
   void removeOldestBin();
   // get ready bin from binManager
   void getReadyBin(std::deque<std::unique_ptr<Bin>> &retBins);
+  // take a single ready bin, so that concurrent tasks share the ready bins
+  bool getReadyBin(std::unique_ptr<Bin> &bin);
+  size_t getReadyBinCount() {
+    std::lock_guard<std::mutex> lock(ready_mutex_);
+    return readyBin_.size();
+  }
 
  protected:
 
  private:
+  static constexpr size_t SHARD_COUNT = 16;
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::deque<std::unique_ptr<Bin>>> groupBinMap;
+  };
+
+  // entry of the age index, it goes stale once its bin leaves the group
+  struct BinAge {
+    uint64_t created;
+    uint64_t sequence;
+    std::string group;
+    std::string uuid;
+    bool operator>(const BinAge &other) const {
+      return created > other.created || (created == other.created && sequence > other.sequence);
+    }
+  };
+  typedef std::priority_queue<BinAge, std::vector<BinAge>, std::greater<BinAge>> BinAgeHeap;
+
+  Shard &getShard(const std::string &group) {
+    return shards_[std::hash<std::string>()(group) % SHARD_COUNT];
+  }
+  void addReadyBin(std::unique_ptr<Bin> bin);
+  // moves the bins at the front of the group that are ready for merge, requires the lock of the shard
+  void moveReadyBins(std::deque<std::unique_ptr<Bin>> &queue);
+  // moves the bin of the entry, with any older bin of its group. Returns false for a stale entry.
+  bool moveBin(const BinAge &entry);
+  // whether the bin of the entry is still held by its group
+  bool isBinQueued(const BinAge &entry);
+  // rebuilds the age index once stale entries outnumber the bins, requires mutex_
+  void pruneBinAges();
+
+  // guards binAges_, taken before the lock of a shard
   std::mutex mutex_;
   uint64_t minSize_;
   uint64_t maxSize_;
@@ -210,9 +270,12 @@ class BinManager {
   std::string fileCount_;
   // Bin Age in msec
   uint64_t binAge_;
-  std::map<std::string, std::unique_ptr<std::deque<std::unique_ptr<Bin>>> >groupBinMap_;
+  std::array<Shard, SHARD_COUNT> shards_;
+  BinAgeHeap binAges_;
+  std::mutex ready_mutex_;
   std::deque<std::unique_ptr<Bin>> readyBin_;
-  int binCount_;
+  std::atomic<int> binCount_;
+  std::atomic<uint64_t> binSequence_;
   std::shared_ptr<logging::Logger> logger_;
 };
 
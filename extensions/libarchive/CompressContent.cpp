@@ -24,10 +24,14 @@
 #include <string>
 #include <map>
 #include <set>
+#include <fstream>
+#include <iterator>
+#include <utility>
 #include "utils/TimeUtil.h"
 #include "utils/StringUtils.h"
 #include "core/ProcessContext.h"
 #include "core/ProcessSession.h"
+#include "controllers/ThreadManagementService.h"
 
 namespace org {
 namespace apache {
@@ -36,7 +40,7 @@ namespace minifi {
 namespace processors {
 
 core::Property CompressContent::CompressLevel(
-    core::PropertyBuilder::createProperty("Compression Level")->withDescription("The compression level to use; this is valid only when using GZIP compression.")
+    core::PropertyBuilder::createProperty("Compression Level")->withDescription("The compression level to use; this is valid only when using GZIP, zstd or lz4-framed compression.")
         ->isRequired(false)->withDefaultValue<int>(1)->build());
 core::Property CompressContent::CompressMode(
     core::PropertyBuilder::createProperty("Mode")->withDescription("Indicates whether the processor should compress content or decompress content.")
@@ -49,7 +53,9 @@ core::Property CompressContent::CompressFormat(
           COMPRESSION_FORMAT_GZIP,
           COMPRESSION_FORMAT_BZIP2,
           COMPRESSION_FORMAT_XZ_LZMA2,
-          COMPRESSION_FORMAT_LZMA})->withDefaultValue(COMPRESSION_FORMAT_ATTRIBUTE)->build());
+          COMPRESSION_FORMAT_LZMA,
+          COMPRESSION_FORMAT_ZSTD,
+          COMPRESSION_FORMAT_LZ4})->withDefaultValue(COMPRESSION_FORMAT_ATTRIBUTE)->build());
 core::Property CompressContent::UpdateFileName(
     core::PropertyBuilder::createProperty("Update Filename")->withDescription("Determines if filename extension need to be updated")
         ->isRequired(false)->withDefaultValue<bool>(false)->build());
@@ -60,6 +66,27 @@ core::Property CompressContent::EncapsulateInTar(
                           "If false, on compression the content of the FlowFile simply gets compressed, and on decompression a simple compressed content is expected.\n"
                           "true is the behaviour compatible with older MiNiFi C++ versions, false is the behaviour compatible with NiFi.")
         ->isRequired(false)->withDefaultValue<bool>(true)->build());
+core::Property CompressContent::CompressThreads(
+    core::PropertyBuilder::createProperty("Compression Threads")
+        ->withDescription("The number of threads compressing a FlowFile concurrently. If greater than 1, GZIP content that is not TAR-encapsulated "
+                          "is compressed in independent blocks into a multi-member GZIP stream, and xz-lzma2 content is compressed in multiple xz blocks. "
+                          "When a ThreadPoolManager controller service is configured, the GZIP threads are subject to its limits "
+                          "and the xz-lzma2 threads are capped at its maximum number of threads.")
+        ->isRequired(false)->withDefaultValue<int>(1)->build());
+core::Property CompressContent::CompressBlockSize(
+    core::PropertyBuilder::createProperty("Compression Block Size")
+        ->withDescription("The size of the blocks GZIP content is cut into when it is compressed by multiple threads")
+        ->isRequired(false)->withDefaultValue<core::DataSizeValue>("1 MB")->build());
+core::Property CompressContent::ZstdWindowLog(
+    core::PropertyBuilder::createProperty("Zstd Long Window Log")
+        ->withDescription("If greater than 0, zstd content that is not TAR-encapsulated is compressed with long distance matching over a window of 2^N bytes "
+                          "(e.g. 27 for 128 MB). Decompressing content with a window above 2^27 bytes requires the same setting.")
+        ->isRequired(false)->withDefaultValue<int>(0)->build());
+core::Property CompressContent::ZstdDictionary(
+    core::PropertyBuilder::createProperty("Zstd Dictionary File")
+        ->withDescription("Path of a zstd dictionary used to compress and decompress zstd content that is not TAR-encapsulated. "
+                          "Dictionaries trained on typical records greatly improve the compression of small records.")
+        ->isRequired(false)->build());
 
 core::Relationship CompressContent::Success("success", "FlowFiles will be transferred to the success relationship after successfully being compressed or decompressed");
 core::Relationship CompressContent::Failure("failure", "FlowFiles will be transferred to the failure relationship if they fail to compress/decompress");
@@ -72,6 +99,10 @@ void CompressContent::initialize() {
   properties.insert(CompressFormat);
   properties.insert(UpdateFileName);
   properties.insert(EncapsulateInTar);
+  properties.insert(CompressThreads);
+  properties.insert(CompressBlockSize);
+  properties.insert(ZstdWindowLog);
+  properties.insert(ZstdDictionary);
   setSupportedProperties(properties);
   // Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -87,9 +118,52 @@ void CompressContent::onSchedule(core::ProcessContext *context, core::ProcessSes
   context->getProperty(CompressFormat.getName(), compressFormat_);
   context->getProperty(UpdateFileName.getName(), updateFileName_);
   context->getProperty(EncapsulateInTar.getName(), encapsulateInTar_);
+  compressThreads_ = 1;
+  context->getProperty(CompressThreads.getName(), compressThreads_);
+  if (compressThreads_ < 1) {
+    compressThreads_ = 1;
+  }
+  xzThreads_ = compressThreads_;
+  auto controller_service_provider = context->getControllerServiceProvider();
+  if (xzThreads_ > 1 && controller_service_provider != nullptr) {
+    auto thread_manager = std::dynamic_pointer_cast<controllers::ThreadManagementService>(controller_service_provider->getControllerService("ThreadPoolManager"));
+    if (thread_manager != nullptr) {
+      xzThreads_ = (std::max)(int64_t{1}, (std::min)(xzThreads_, static_cast<int64_t>(thread_manager->getMaxThreads())));
+    }
+  }
+  compressBlockSize_ = 1024 * 1024;
+  uint64_t blockSize;
+  if (context->getProperty(CompressBlockSize.getName(), value) && !value.empty() && core::Property::StringToInt(value, blockSize) && blockSize > 0) {
+    compressBlockSize_ = blockSize;
+  }
+
+  zstdWindowLog_ = 0;
+  context->getProperty(ZstdWindowLog.getName(), zstdWindowLog_);
+#ifdef ZSTD_SUPPORT
+  zstdDictionary_ = nullptr;
+  std::string dictionaryFile;
+  if (context->getProperty(ZstdDictionary.getName(), dictionaryFile) && !dictionaryFile.empty()) {
+    std::ifstream dictionaryStream(dictionaryFile, std::ios::in | std::ios::binary);
+    std::string dictionary((std::istreambuf_iterator<char>(dictionaryStream)), std::istreambuf_iterator<char>());
+    if (!dictionaryStream || dictionary.empty()) {
+      throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Failed to read zstd dictionary " + dictionaryFile);
+    }
+    zstdDictionary_ = std::make_shared<io::ZstdDictionary>(dictionary, compressLevel_);
+  }
+#endif
 
-  logger_->log_info("Compress Content: Mode [%s] Format [%s] Level [%d] UpdateFileName [%d] EncapsulateInTar [%d]",
-      compressMode_, compressFormat_, compressLevel_, updateFileName_, encapsulateInTar_);
+  logger_->log_info("Compress Content: Mode [%s] Format [%s] Level [%d] UpdateFileName [%d] EncapsulateInTar [%d] Threads [%d] xz Threads [%d]",
+      compressMode_, compressFormat_, compressLevel_, updateFileName_, encapsulateInTar_, compressThreads_, xzThreads_);
+
+  if (threadPool_) {
+    threadPool_->shutdown();
+    threadPool_ = nullptr;
+  }
+  if (compressThreads_ > 1 && compressMode_ == MODE_COMPRESS && !encapsulateInTar_) {
+    threadPool_ = std::unique_ptr<utils::ThreadPool<int>>(
+        new utils::ThreadPool<int>(compressThreads_, false, context->getControllerServiceProvider(), "CompressContent"));
+    threadPool_->start();
+  }
 
   // update the mimeTypeMap
   compressionFormatMimeTypeMap_["application/gzip"] = COMPRESSION_FORMAT_GZIP;
@@ -97,10 +171,20 @@ void CompressContent::onSchedule(core::ProcessContext *context, core::ProcessSes
   compressionFormatMimeTypeMap_["application/x-bzip2"] = COMPRESSION_FORMAT_BZIP2;
   compressionFormatMimeTypeMap_["application/x-lzma"] = COMPRESSION_FORMAT_LZMA;
   compressionFormatMimeTypeMap_["application/x-xz"] = COMPRESSION_FORMAT_XZ_LZMA2;
+  compressionFormatMimeTypeMap_["application/zstd"] = COMPRESSION_FORMAT_ZSTD;
+  compressionFormatMimeTypeMap_["application/x-lz4-framed"] = COMPRESSION_FORMAT_LZ4;
   fileExtension_[COMPRESSION_FORMAT_GZIP] = ".gz";
   fileExtension_[COMPRESSION_FORMAT_LZMA] = ".lzma";
   fileExtension_[COMPRESSION_FORMAT_BZIP2] = ".bz2";
   fileExtension_[COMPRESSION_FORMAT_XZ_LZMA2] = ".xz";
+  fileExtension_[COMPRESSION_FORMAT_ZSTD] = ".zst";
+  fileExtension_[COMPRESSION_FORMAT_LZ4] = ".lz4";
+}
+
+void CompressContent::notifyStop() {
+  if (threadPool_) {
+    threadPool_->shutdown();
+  }
 }
 
 void CompressContent::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
@@ -138,6 +222,10 @@ void CompressContent::onTrigger(const std::shared_ptr<core::ProcessContext> &con
     mimeType = "application/x-lzma";
   } else if (compressFormat == COMPRESSION_FORMAT_XZ_LZMA2) {
     mimeType = "application/x-xz";
+  } else if (compressFormat == COMPRESSION_FORMAT_ZSTD) {
+    mimeType = "application/zstd";
+  } else if (compressFormat == COMPRESSION_FORMAT_LZ4) {
+    mimeType = "application/x-lz4-framed";
   } else {
     logger_->log_error("Compress format is invalid %s", compressFormat);
     session->transfer(flowFile, Failure);
@@ -145,11 +233,6 @@ void CompressContent::onTrigger(const std::shared_ptr<core::ProcessContext> &con
   }
 
   // Validate
-  if (!encapsulateInTar_ && compressFormat != COMPRESSION_FORMAT_GZIP) {
-    logger_->log_error("non-TAR encapsulated format only supports GZIP compression");
-    session->transfer(flowFile, Failure);
-    return;
-  }
   if (compressFormat == COMPRESSION_FORMAT_BZIP2 && archive_bzlib_version() == nullptr) {
     logger_->log_error("%s compression format is requested, but the agent was compiled without BZip2 support", compressFormat);
     session->transfer(flowFile, Failure);
@@ -160,6 +243,16 @@ void CompressContent::onTrigger(const std::shared_ptr<core::ProcessContext> &con
     session->transfer(flowFile, Failure);
     return;
   }
+  if (compressFormat == COMPRESSION_FORMAT_ZSTD && archive_libzstd_version() == nullptr) {
+    logger_->log_error("%s compression format is requested, but the agent was compiled without zstd support", compressFormat);
+    session->transfer(flowFile, Failure);
+    return;
+  }
+  if (compressFormat == COMPRESSION_FORMAT_LZ4 && archive_liblz4_version() == nullptr) {
+    logger_->log_error("%s compression format is requested, but the agent was compiled without lz4 support", compressFormat);
+    session->transfer(flowFile, Failure);
+    return;
+  }
 
   std::string fileExtension;
   auto search = fileExtension_.find(compressFormat);
@@ -169,9 +262,28 @@ void CompressContent::onTrigger(const std::shared_ptr<core::ProcessContext> &con
   std::shared_ptr<core::FlowFile> processFlowFile = session->create(flowFile);
   bool success = false;
   if (encapsulateInTar_) {
-    CompressContent::WriteCallback callback(compressMode_, compressLevel_, compressFormat, flowFile, session);
+    CompressContent::WriteCallback callback(compressMode_, compressLevel_, compressFormat, flowFile, session, xzThreads_);
+    session->write(processFlowFile, &callback);
+    success = callback.status_ >= 0;
+  } else if (compressFormat != COMPRESSION_FORMAT_GZIP && compressFormat != COMPRESSION_FORMAT_ZSTD) {
+    CompressContent::WriteCallback callback(compressMode_, compressLevel_, compressFormat, flowFile, session, xzThreads_, false);
+    session->write(processFlowFile, &callback);
+    success = callback.status_ >= 0;
+  } else if (compressFormat == COMPRESSION_FORMAT_ZSTD) {
+#ifdef ZSTD_SUPPORT
+    CompressContent::ZstdWriteCallback callback(compressMode_, compressLevel_, zstdWindowLog_, zstdDictionary_, flowFile, session);
+    session->write(processFlowFile, &callback);
+    success = callback.success_;
+#else
+    CompressContent::WriteCallback callback(compressMode_, compressLevel_, compressFormat, flowFile, session, xzThreads_, false);
     session->write(processFlowFile, &callback);
     success = callback.status_ >= 0;
+#endif
+  } else if (threadPool_ && threadPool_->isRunning() && flowFile->getSize() > compressBlockSize_) {
+    // keep every thread busy while the finished blocks are written out, but bound the memory held by blocks in flight
+    CompressContent::ParallelGzipWriteCallback callback(compressLevel_, compressBlockSize_, 2 * compressThreads_, *threadPool_, flowFile, session);
+    session->write(processFlowFile, &callback);
+    success = callback.success_;
   } else {
     CompressContent::GzipWriteCallback callback(compressMode_, compressLevel_, flowFile, session);
     session->write(processFlowFile, &callback);
@@ -206,6 +318,147 @@ void CompressContent::onTrigger(const std::shared_ptr<core::ProcessContext> &con
   }
 }
 
+#ifdef ZSTD_SUPPORT
+int64_t CompressContent::ZstdWriteCallback::process(std::shared_ptr<io::BaseStream> outputStream) {
+  class ReadCallback : public InputStreamCallback {
+   public:
+    ReadCallback(ZstdWriteCallback &writer, io::BaseStream &filterStream)
+      : writer_(writer)
+      , filterStream_(filterStream) {
+    }
+
+    int64_t process(std::shared_ptr<io::BaseStream> inputStream) override {
+      std::vector<uint8_t> buffer(64 * 1024U);
+      int64_t read_size = 0;
+      while (read_size < writer_.flow_->getSize()) {
+        int ret = inputStream->read(buffer.data(), buffer.size());
+        if (ret < 0) {
+          return -1;
+        } else if (ret == 0) {
+          break;
+        } else {
+          if (filterStream_.writeData(buffer.data(), ret) != ret) {
+            return -1;
+          }
+          read_size += ret;
+        }
+      }
+      filterStream_.closeStream();
+      return read_size;
+    }
+
+    ZstdWriteCallback &writer_;
+    io::BaseStream &filterStream_;
+  };
+
+  try {
+    if (compress_mode_ == MODE_COMPRESS) {
+      io::ZstdCompressStream filterStream(outputStream.get(), compress_level_, window_log_, dictionary_);
+      ReadCallback readCb(*this, filterStream);
+      session_->read(flow_, &readCb);
+      success_ = filterStream.isFinished();
+    } else {
+      io::ZstdDecompressStream filterStream(outputStream.get(), window_log_, dictionary_);
+      ReadCallback readCb(*this, filterStream);
+      session_->read(flow_, &readCb);
+      success_ = filterStream.isFinished();
+    }
+  } catch (const std::exception &exception) {
+    logger_->log_error("zstd processing of %s failed: %s", flow_->getUUIDStr(), exception.what());
+    success_ = false;
+  }
+  return flow_->getSize();
+}
+#endif
+
+int64_t CompressContent::ParallelGzipWriteCallback::process(std::shared_ptr<io::BaseStream> outputStream) {
+  class ReadCallback : public InputStreamCallback {
+   public:
+    ReadCallback(ParallelGzipWriteCallback &writer, io::BaseStream &outputStream)
+      : writer_(writer)
+      , outputStream_(outputStream) {
+    }
+
+    int64_t process(std::shared_ptr<io::BaseStream> inputStream) override {
+      PendingBlocks pending;
+      uint64_t read_size = 0;
+      bool success = true;
+      while (success && read_size < writer_.flow_->getSize()) {
+        auto block = std::make_shared<Block>();
+        block->data.resize(std::min<uint64_t>(writer_.block_size_, writer_.flow_->getSize() - read_size));
+        int ret = inputStream->read(block->data.data(), block->data.size());
+        if (ret <= 0) {
+          success = ret == 0;
+          break;
+        }
+        block->data.resize(ret);
+        read_size += ret;
+        success = writer_.submit(block, pending);
+        while (success && pending.size() >= writer_.max_pending_blocks_) {
+          success = writer_.writeNext(pending, outputStream_);
+        }
+      }
+      while (!pending.empty()) {
+        success = writer_.writeNext(pending, outputStream_) && success;
+      }
+      writer_.success_ = success;
+      return success ? read_size : -1;
+    }
+
+    ParallelGzipWriteCallback &writer_;
+    io::BaseStream &outputStream_;
+  };
+
+  ReadCallback readCb(*this, *outputStream);
+  success_ = false;
+  session_->read(flow_, &readCb);
+  return flow_->getSize();
+}
+
+bool CompressContent::ParallelGzipWriteCallback::submit(const std::shared_ptr<Block> &block, PendingBlocks &pending) {
+  int level = compress_level_;
+  std::function<int()> task = [block, level]() {
+    try {
+      io::ZlibCompressStream compressStream(&block->compressed, io::ZlibCompressionFormat::GZIP, level);
+      if (compressStream.writeData(block->data.data(), block->data.size()) != static_cast<int>(block->data.size())) {
+        return -1;
+      }
+      compressStream.closeStream();
+      return compressStream.isFinished() ? 0 : -1;
+    } catch (const std::exception &) {
+      return -1;
+    }
+  };
+  std::future<int> future;
+  if (!thread_pool_.execute(utils::Worker<int>(task, "CompressContent"), future)) {
+    logger_->log_error("Failed to queue the compression of a block of %s", flow_->getUUIDStr());
+    return false;
+  }
+  pending.emplace_back(std::move(future), block);
+  return true;
+}
+
+bool CompressContent::ParallelGzipWriteCallback::writeNext(PendingBlocks &pending, io::BaseStream &outputStream) {
+  std::shared_ptr<Block> block = pending.front().second;
+  int status = -1;
+  try {
+    status = pending.front().first.get();
+  } catch (const std::future_error &) {
+    // the thread pool was shut down before the block was compressed
+  }
+  pending.pop_front();
+  if (status < 0) {
+    logger_->log_error("Failed to compress a block of %s", flow_->getUUIDStr());
+    return false;
+  }
+  int size = block->compressed.getSize();
+  if (outputStream.writeData(const_cast<uint8_t*>(block->compressed.getBuffer()), size) != size) {
+    logger_->log_error("Failed to write a compressed block of %s", flow_->getUUIDStr());
+    return false;
+  }
+  return true;
+}
+
 } /* namespace processors */
 } /* namespace minifi */
 } /* namespace nifi */
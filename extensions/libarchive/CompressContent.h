@@ -20,6 +20,14 @@
 #ifndef __COMPRESS_CONTENT_H__
 #define __COMPRESS_CONTENT_H__
 
+#include <cinttypes>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "archive_entry.h"
 #include "archive.h"
 
@@ -30,7 +38,12 @@
 #include "core/Resource.h"
 #include "core/Property.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "io/DataStream.h"
 #include "io/ZlibStream.h"
+#include "utils/ThreadPool.h"
+#ifdef ZSTD_SUPPORT
+#include "ZstdStream.h"
+#endif
 
 namespace org {
 namespace apache {
@@ -43,6 +56,8 @@ namespace processors {
 #define COMPRESSION_FORMAT_BZIP2 "bzip2"
 #define COMPRESSION_FORMAT_XZ_LZMA2 "xz-lzma2"
 #define COMPRESSION_FORMAT_LZMA "lzma"
+#define COMPRESSION_FORMAT_ZSTD "zstd"
+#define COMPRESSION_FORMAT_LZ4 "lz4-framed"
 
 #define MODE_COMPRESS "compress"
 #define MODE_DECOMPRESS "decompress"
@@ -58,7 +73,11 @@ public:
     : core::Processor(name, uuid)
     , logger_(logging::LoggerFactory<CompressContent>::getLogger())
     , updateFileName_(false)
-    , encapsulateInTar_(false) {
+    , encapsulateInTar_(false)
+    , compressThreads_(1)
+    , xzThreads_(1)
+    , compressBlockSize_(0)
+    , zstdWindowLog_(0) {
   }
   // Destructor
   virtual ~CompressContent() {
@@ -71,6 +90,10 @@ public:
   static core::Property CompressFormat;
   static core::Property UpdateFileName;
   static core::Property EncapsulateInTar;
+  static core::Property CompressThreads;
+  static core::Property CompressBlockSize;
+  static core::Property ZstdWindowLog;
+  static core::Property ZstdDictionary;
 
   // Supported Relationships
   static core::Relationship Failure;
@@ -151,9 +174,10 @@ public:
   class WriteCallback: public OutputStreamCallback {
   public:
     WriteCallback(std::string &compress_mode, int64_t compress_level, std::string &compress_format,
-        std::shared_ptr<core::FlowFile> &flow, const std::shared_ptr<core::ProcessSession> &session) :
+        std::shared_ptr<core::FlowFile> &flow, const std::shared_ptr<core::ProcessSession> &session, int64_t compress_threads = 1,
+        bool encapsulate_in_tar = true) :
         compress_mode_(compress_mode), compress_level_(compress_level), compress_format_(compress_format),
-        flow_(flow), session_(session),
+        compress_threads_(compress_threads), encapsulate_in_tar_(encapsulate_in_tar), flow_(flow), session_(session),
         logger_(logging::LoggerFactory<CompressContent>::getLogger()),
         readDecompressCb_(flow) {
       size_ = 0;
@@ -166,6 +190,9 @@ public:
     std::string compress_mode_;
     int64_t compress_level_;
     std::string compress_format_;
+    int64_t compress_threads_;
+    // without TAR encapsulation the content is compressed as is, using the raw format of libarchive
+    bool encapsulate_in_tar_;
     std::shared_ptr<core::FlowFile> flow_;
     std::shared_ptr<core::ProcessSession> session_;
     std::shared_ptr<io::BaseStream> stream_;
@@ -220,7 +247,7 @@ public:
           status_ = -1;
           return -1;
         }
-        r = archive_write_set_format_ustar(arch);
+        r = encapsulate_in_tar_ ? archive_write_set_format_ustar(arch) : archive_write_set_format_raw(arch);
         if (r != ARCHIVE_OK) {
           archive_write_log_error_cleanup(arch);
           return -1;
@@ -256,6 +283,39 @@ public:
             archive_write_log_error_cleanup(arch);
             return -1;
           }
+          if (compress_threads_ > 1) {
+            // liblzma splits the input into blocks and compresses them concurrently
+            std::string option = "xz:threads=" + std::to_string(compress_threads_);
+            r = archive_write_set_options(arch, option.c_str());
+            if (r != ARCHIVE_OK) {
+              archive_write_log_error_cleanup(arch);
+              return -1;
+            }
+          }
+        } else if (compress_format_ == COMPRESSION_FORMAT_ZSTD) {
+          r = archive_write_add_filter_zstd(arch);
+          if (r != ARCHIVE_OK) {
+            archive_write_log_error_cleanup(arch);
+            return -1;
+          }
+          std::string option = "zstd:compression-level=" + std::to_string((int) compress_level_);
+          r = archive_write_set_options(arch, option.c_str());
+          if (r != ARCHIVE_OK) {
+            archive_write_log_error_cleanup(arch);
+            return -1;
+          }
+        } else if (compress_format_ == COMPRESSION_FORMAT_LZ4) {
+          r = archive_write_add_filter_lz4(arch);
+          if (r != ARCHIVE_OK) {
+            archive_write_log_error_cleanup(arch);
+            return -1;
+          }
+          std::string option = "lz4:compression-level=" + std::to_string((int) compress_level_);
+          r = archive_write_set_options(arch, option.c_str());
+          if (r != ARCHIVE_OK) {
+            archive_write_log_error_cleanup(arch);
+            return -1;
+          }
         } else {
             archive_write_log_error_cleanup(arch);
             return -1;
@@ -299,7 +359,7 @@ public:
           status_ = -1;
           return -1;
         }
-        r = archive_read_support_format_all(arch);
+        r = encapsulate_in_tar_ ? archive_read_support_format_all(arch) : archive_read_support_format_raw(arch);
         if (r != ARCHIVE_OK) {
           archive_read_log_error_cleanup(arch);
           return -1;
@@ -320,10 +380,12 @@ public:
           archive_read_log_error_cleanup(arch);
           return -1;
         }
-        int entry_size = archive_entry_size(entry);
-        logger_->log_debug("Decompress Content archive entry size %d", entry_size);
+        // the size of raw content is only known once it is decompressed
+        bool entry_size_set = archive_entry_size_is_set(entry);
+        int64_t entry_size = archive_entry_size(entry);
+        logger_->log_debug("Decompress Content archive entry size %" PRId64, entry_size);
         size_ = 0;
-        while (size_ < entry_size) {
+        while (!entry_size_set || size_ < entry_size) {
           char buffer[8192];
           int ret = archive_read_data(arch, buffer, sizeof(buffer));
           if (ret < 0) {
@@ -411,6 +473,80 @@ public:
     }
   };
 
+#ifdef ZSTD_SUPPORT
+  class ZstdWriteCallback : public OutputStreamCallback {
+   public:
+    ZstdWriteCallback(std::string compress_mode, int64_t compress_level, int64_t window_log, std::shared_ptr<io::ZstdDictionary> dictionary,
+                      std::shared_ptr<core::FlowFile> flow, std::shared_ptr<core::ProcessSession> session)
+      : logger_(logging::LoggerFactory<CompressContent>::getLogger())
+      , compress_mode_(std::move(compress_mode))
+      , compress_level_(compress_level)
+      , window_log_(window_log)
+      , dictionary_(std::move(dictionary))
+      , flow_(std::move(flow))
+      , session_(std::move(session)) {
+    }
+
+    int64_t process(std::shared_ptr<io::BaseStream> outputStream) override;
+
+    std::shared_ptr<logging::Logger> logger_;
+    std::string compress_mode_;
+    int64_t compress_level_;
+    int64_t window_log_;
+    std::shared_ptr<io::ZstdDictionary> dictionary_;
+    std::shared_ptr<core::FlowFile> flow_;
+    std::shared_ptr<core::ProcessSession> session_;
+    bool success_{false};
+  };
+#endif
+
+  /**
+   * Compresses the content into a multi-member GZIP stream: the content is cut into blocks, which
+   * are compressed independently on the thread pool and written in their original order. GZIP
+   * decompressors read the concatenated members as a single stream.
+   */
+  class ParallelGzipWriteCallback : public OutputStreamCallback {
+   public:
+    ParallelGzipWriteCallback(int64_t compress_level, uint64_t block_size, size_t max_pending_blocks, utils::ThreadPool<int> &thread_pool,
+                              std::shared_ptr<core::FlowFile> flow, std::shared_ptr<core::ProcessSession> session)
+      : logger_(logging::LoggerFactory<CompressContent>::getLogger())
+      , compress_level_(compress_level)
+      , block_size_(block_size)
+      , max_pending_blocks_(max_pending_blocks)
+      , thread_pool_(thread_pool)
+      , flow_(std::move(flow))
+      , session_(std::move(session)) {
+    }
+
+    int64_t process(std::shared_ptr<io::BaseStream> outputStream) override;
+
+    std::shared_ptr<logging::Logger> logger_;
+    int64_t compress_level_;
+    uint64_t block_size_;
+    size_t max_pending_blocks_;
+    utils::ThreadPool<int> &thread_pool_;
+    std::shared_ptr<core::FlowFile> flow_;
+    std::shared_ptr<core::ProcessSession> session_;
+    bool success_{false};
+
+   private:
+    struct Block {
+      std::vector<uint8_t> data;
+      io::DataStream compressed;
+    };
+    using PendingBlocks = std::deque<std::pair<std::future<int>, std::shared_ptr<Block>>>;
+
+    /**
+     * Queues the compression of a block on the thread pool.
+     */
+    bool submit(const std::shared_ptr<Block> &block, PendingBlocks &pending);
+
+    /**
+     * Waits for the oldest pending block and writes its GZIP member to the output.
+     */
+    bool writeNext(PendingBlocks &pending, io::BaseStream &outputStream);
+  };
+
 public:
   /**
    * Function that's executed when the processor is scheduled.
@@ -427,6 +563,8 @@ public:
   // Initialize, over write by NiFi CompressContent
   virtual void initialize(void);
 
+  void notifyStop() override;
+
 protected:
 
 private:
@@ -436,6 +574,15 @@ private:
   std::string compressFormat_;
   bool updateFileName_;
   bool encapsulateInTar_;
+  int64_t compressThreads_;
+  // liblzma starts its own threads, so their number is bounded by the ThreadPoolManager here
+  int64_t xzThreads_;
+  uint64_t compressBlockSize_;
+  std::unique_ptr<utils::ThreadPool<int>> threadPool_;
+  int64_t zstdWindowLog_;
+#ifdef ZSTD_SUPPORT
+  std::shared_ptr<io::ZstdDictionary> zstdDictionary_;
+#endif
   std::map<std::string, std::string> compressionFormatMimeTypeMap_;
   std::map<std::string, std::string> fileExtension_;
 };
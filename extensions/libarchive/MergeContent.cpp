@@ -32,6 +32,7 @@
 #include "utils/StringUtils.h"
 #include "core/ProcessContext.h"
 #include "core/ProcessSession.h"
+#include "CompressContent.h"
 
 namespace org {
 namespace apache {
@@ -47,6 +48,23 @@ core::Property MergeContent::Header("Header File", "Filename specifying the head
 core::Property MergeContent::Footer("Footer File", "Filename specifying the footer to use", "");
 core::Property MergeContent::Demarcator("Demarcator File", "Filename specifying the demarcator to use", "");
 core::Property MergeContent::KeepPath("Keep Path", "If using the Zip or Tar Merge Format, specifies whether or not the FlowFiles' paths should be included in their entry", "false");
+core::Property MergeContent::BufferSize(
+    core::PropertyBuilder::createProperty("Buffer Size")->withDescription("Size of the buffer the content of the FlowFiles is copied through when they are merged")
+        ->isRequired(false)->withDefaultValue<core::DataSizeValue>("64 KB")->build());
+core::Property MergeContent::CompressFormat(
+    core::PropertyBuilder::createProperty("Compression Format")->withDescription("The format the merged content is compressed with; this is valid only for the TAR Merge Format.")
+        ->isRequired(false)
+        ->withAllowableValues<std::string>({
+          MERGE_COMPRESSION_NONE,
+          COMPRESSION_FORMAT_GZIP,
+          COMPRESSION_FORMAT_BZIP2,
+          COMPRESSION_FORMAT_XZ_LZMA2,
+          COMPRESSION_FORMAT_LZMA,
+          COMPRESSION_FORMAT_ZSTD,
+          COMPRESSION_FORMAT_LZ4})->withDefaultValue(MERGE_COMPRESSION_NONE)->build());
+core::Property MergeContent::CompressLevel(
+    core::PropertyBuilder::createProperty("Compression Level")->withDescription("The compression level to use; this is valid only when using gzip, zstd or lz4-framed compression.")
+        ->isRequired(false)->withDefaultValue<int>(1)->build());
 core::Relationship MergeContent::Merge("merged", "The FlowFile containing the merged content");
 const char *BinaryConcatenationMerge::mimeType = "application/octet-stream";
 const char *TarMerge::mimeType = "application/tar";
@@ -69,6 +87,9 @@ void MergeContent::initialize() {
   properties.insert(Footer);
   properties.insert(Demarcator);
   properties.insert(KeepPath);
+  properties.insert(BufferSize);
+  properties.insert(CompressFormat);
+  properties.insert(CompressLevel);
   setSupportedProperties(properties);
   // Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -125,6 +146,16 @@ void MergeContent::onSchedule(core::ProcessContext *context, core::ProcessSessio
   if (context->getProperty(KeepPath.getName(), value) && !value.empty()) {
     org::apache::nifi::minifi::utils::StringUtils::StringToBool(value, keepPath_);
   }
+  value = "";
+  uint64_t bufferSize;
+  if (context->getProperty(BufferSize.getName(), value) && !value.empty() && core::Property::StringToInt(value, bufferSize) && bufferSize > 0) {
+    this->bufferSize_ = bufferSize;
+  }
+  value = "";
+  if (context->getProperty(CompressFormat.getName(), value) && !value.empty()) {
+    this->compressFormat_ = value;
+  }
+  context->getProperty(CompressLevel.getName(), compressLevel_);
   if (mergeStratgey_ == MERGE_STRATEGY_DEFRAGMENT) {
     binManager_.setFileCount(FRAGMENT_COUNT_ATTRIBUTE);
   }
@@ -221,19 +252,21 @@ bool MergeContent::processBin(core::ProcessContext *context, core::ProcessSessio
       logger_->log_error("Merge Content check defgrament failed");
       return false;
     }
-    // sort the flowfile fragment index
+    // sort the flowfile fragment index, parsing each index once rather than on every comparison
     std::deque<std::shared_ptr<core::FlowFile>> &flows = bin->getFlowFile();
-    std::sort(flows.begin(), flows.end(), [] (const std::shared_ptr<core::FlowFile> &first, const std::shared_ptr<core::FlowFile> &second)
-        {std::string value;
-         first->getAttribute(BinFiles::FRAGMENT_INDEX_ATTRIBUTE, value);
-         int indexFirst = std::stoi(value);
-         second->getAttribute(BinFiles::FRAGMENT_INDEX_ATTRIBUTE, value);
-         int indexSecond = std::stoi(value);
-         if (indexSecond > indexFirst)
-           return true;
-         else
-           return false;
-        });
+    std::vector<std::pair<int, std::shared_ptr<core::FlowFile>>> fragments;
+    fragments.reserve(flows.size());
+    for (const auto &flow : flows) {
+      std::string value;
+      flow->getAttribute(BinFiles::FRAGMENT_INDEX_ATTRIBUTE, value);
+      fragments.push_back(std::make_pair(std::stoi(value), flow));
+    }
+    std::stable_sort(fragments.begin(), fragments.end(), [] (const std::pair<int, std::shared_ptr<core::FlowFile>> &first, const std::pair<int, std::shared_ptr<core::FlowFile>> &second) {
+      return first.first < second.first;
+    });
+    for (size_t i = 0; i < fragments.size(); i++) {
+      flows[i] = std::move(fragments[i].second);
+    }
   }
 
   std::unique_ptr<MergeBin> mergeBin;
@@ -242,11 +275,12 @@ bool MergeContent::processBin(core::ProcessContext *context, core::ProcessSessio
     if (mergeFormat_ == MERGE_FORMAT_CONCAT_VALUE)
       mergeBin = std::unique_ptr < MergeBin > (new BinaryConcatenationMerge());
     else if (mergeFormat_ == MERGE_FORMAT_TAR_VALUE)
-      mergeBin = std::unique_ptr < MergeBin > (new TarMerge());
+      mergeBin = std::unique_ptr < MergeBin > (new TarMerge(compressFormat_, compressLevel_));
     else if (mergeFormat_ == MERGE_FORMAT_ZIP_VALUE)
           mergeBin = std::unique_ptr < MergeBin > (new ZipMerge());
     else
       return false;
+    mergeBin->setBufferSize(bufferSize_);
 
     std::shared_ptr<core::FlowFile> mergeFlow;
     try {
@@ -273,7 +307,7 @@ bool MergeContent::processBin(core::ProcessContext *context, core::ProcessSessio
 std::shared_ptr<core::FlowFile> BinaryConcatenationMerge::merge(core::ProcessContext *context, core::ProcessSession *session,
         std::deque<std::shared_ptr<core::FlowFile>> &flows, std::string &header, std::string &footer, std::string &demarcator) {
   std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast < FlowFileRecord > (session->create());
-  BinaryConcatenationMerge::WriteCallback callback(header, footer, demarcator, flows, session);
+  BinaryConcatenationMerge::WriteCallback callback(header, footer, demarcator, flows, session, buffer_size_);
   session->write(flowFile, &callback);
   session->putAttribute(flowFile, FlowAttributeKey(MIME_TYPE), this->getMergedContentType());
   std::string fileName;
@@ -290,7 +324,7 @@ std::shared_ptr<core::FlowFile> BinaryConcatenationMerge::merge(core::ProcessCon
 std::shared_ptr<core::FlowFile> TarMerge::merge(core::ProcessContext *context, core::ProcessSession *session, std::deque<std::shared_ptr<core::FlowFile>> &flows, std::string &header,
     std::string &footer, std::string &demarcator) {
   std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast < FlowFileRecord > (session->create());
-  ArchiveMerge::WriteCallback callback(std::string(MERGE_FORMAT_TAR_VALUE), flows, session);
+  ArchiveMerge::WriteCallback callback(std::string(MERGE_FORMAT_TAR_VALUE), flows, session, buffer_size_, compress_format_, compress_level_);
   session->write(flowFile, &callback);
   session->putAttribute(flowFile, FlowAttributeKey(MIME_TYPE), this->getMergedContentType());
   std::string fileName;
@@ -302,15 +336,70 @@ std::shared_ptr<core::FlowFile> TarMerge::merge(core::ProcessContext *context, c
   }
   if (!fileName.empty()) {
     fileName += ".tar";
+    if (compress_format_ == COMPRESSION_FORMAT_GZIP) {
+      fileName += ".gz";
+    } else if (compress_format_ == COMPRESSION_FORMAT_BZIP2) {
+      fileName += ".bz2";
+    } else if (compress_format_ == COMPRESSION_FORMAT_XZ_LZMA2) {
+      fileName += ".xz";
+    } else if (compress_format_ == COMPRESSION_FORMAT_LZMA) {
+      fileName += ".lzma";
+    } else if (compress_format_ == COMPRESSION_FORMAT_ZSTD) {
+      fileName += ".zst";
+    } else if (compress_format_ == COMPRESSION_FORMAT_LZ4) {
+      fileName += ".lz4";
+    }
     session->putAttribute(flowFile, FlowAttributeKey(FILENAME), fileName);
   }
   return flowFile;
 }
 
+std::string TarMerge::getMergedContentType() {
+  if (compress_format_ == COMPRESSION_FORMAT_GZIP) {
+    return "application/gzip";
+  } else if (compress_format_ == COMPRESSION_FORMAT_BZIP2) {
+    return "application/bzip2";
+  } else if (compress_format_ == COMPRESSION_FORMAT_XZ_LZMA2) {
+    return "application/x-xz";
+  } else if (compress_format_ == COMPRESSION_FORMAT_LZMA) {
+    return "application/x-lzma";
+  } else if (compress_format_ == COMPRESSION_FORMAT_ZSTD) {
+    return "application/zstd";
+  } else if (compress_format_ == COMPRESSION_FORMAT_LZ4) {
+    return "application/x-lz4-framed";
+  }
+  return mimeType;
+}
+
+int ArchiveMerge::addCompressionFilter(struct archive *arch, const std::string &compress_format, int compress_level) {
+  std::string filter;
+  if (compress_format == COMPRESSION_FORMAT_GZIP) {
+    filter = "gzip";
+  } else if (compress_format == COMPRESSION_FORMAT_BZIP2) {
+    filter = "bzip2";
+  } else if (compress_format == COMPRESSION_FORMAT_XZ_LZMA2) {
+    filter = "xz";
+  } else if (compress_format == COMPRESSION_FORMAT_LZMA) {
+    filter = "lzma";
+  } else if (compress_format == COMPRESSION_FORMAT_ZSTD) {
+    filter = "zstd";
+  } else if (compress_format == COMPRESSION_FORMAT_LZ4) {
+    filter = "lz4";
+  } else {
+    return archive_write_add_filter_none(arch);
+  }
+  int ret = archive_write_add_filter_by_name(arch, filter.c_str());
+  if (ret == ARCHIVE_OK && (filter == "gzip" || filter == "zstd" || filter == "lz4")) {
+    std::string option = filter + ":compression-level=" + std::to_string(compress_level);
+    ret = archive_write_set_options(arch, option.c_str());
+  }
+  return ret;
+}
+
 std::shared_ptr<core::FlowFile> ZipMerge::merge(core::ProcessContext *context, core::ProcessSession *session, std::deque<std::shared_ptr<core::FlowFile>> &flows, std::string &header,
     std::string &footer, std::string &demarcator) {
   std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast < FlowFileRecord > (session->create());
-  ArchiveMerge::WriteCallback callback(std::string(MERGE_FORMAT_ZIP_VALUE), flows, session);
+  ArchiveMerge::WriteCallback callback(std::string(MERGE_FORMAT_ZIP_VALUE), flows, session, buffer_size_);
   session->write(flowFile, &callback);
   session->putAttribute(flowFile, FlowAttributeKey(MIME_TYPE), this->getMergedContentType());
   std::string fileName;
@@ -20,6 +20,13 @@
 #ifndef __MERGE_CONTENT_H__
 #define __MERGE_CONTENT_H__
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "ArchiveCommon.h"
 #include "BinFiles.h"
 #include "archive_entry.h"
@@ -43,18 +50,32 @@ namespace processors {
 #define MERGE_FORMAT_AVRO_VALUE "Avro"
 #define DELIMITER_STRATEGY_FILENAME "Filename"
 #define DELIMITER_STRATEGY_TEXT "Text"
+#define MERGE_COMPRESSION_NONE "none"
 
 // MergeBin Class
 class MergeBin {
 public:
+  static const uint64_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+  MergeBin()
+      : buffer_size_(DEFAULT_BUFFER_SIZE) {
+  }
 
   virtual ~MergeBin(){
   }
 
+  // size of the buffer the content of the flows is copied through
+  void setBufferSize(uint64_t size) {
+    buffer_size_ = size;
+  }
+
   virtual std::string getMergedContentType() = 0;
   // merge the flows in the bin
   virtual std::shared_ptr<core::FlowFile> merge(core::ProcessContext *context, core::ProcessSession *session,
       std::deque<std::shared_ptr<core::FlowFile>> &flows, std::string &header, std::string &footer, std::string &demarcator) = 0;
+
+ protected:
+  uint64_t buffer_size_;
 };
 
 // BinaryConcatenationMerge Class
@@ -69,19 +90,18 @@ public:
   // Nest Callback Class for read stream
   class ReadCallback : public InputStreamCallback {
    public:
-    ReadCallback(uint64_t size, std::shared_ptr<io::BaseStream> stream)
-        : buffer_size_(size), stream_(stream) {
+    ReadCallback(uint64_t size, std::shared_ptr<io::BaseStream> stream, std::vector<uint8_t> &buffer)
+        : buffer_size_(size), stream_(stream), buffer_(buffer) {
     }
     ~ReadCallback() {
     }
     int64_t process(std::shared_ptr<io::BaseStream> stream) {
-      uint8_t buffer[4096U];
       int64_t ret = 0;
       uint64_t read_size = 0;
       while (read_size < buffer_size_) {
-        int readRet = stream->read(buffer, sizeof(buffer));
+        int readRet = stream->read(buffer_.data(), static_cast<int>(std::min<uint64_t>(buffer_.size(), buffer_size_ - read_size)));
         if (readRet > 0) {
-          ret += stream_->write(buffer, readRet);
+          ret += stream_->write(buffer_.data(), readRet);
           read_size += readRet;
         } else {
           break;
@@ -91,18 +111,22 @@ public:
     }
     uint64_t buffer_size_;
     std::shared_ptr<io::BaseStream> stream_;
+    std::vector<uint8_t> &buffer_;
   };
   // Nest Callback Class for write stream
   class WriteCallback: public OutputStreamCallback {
   public:
-    WriteCallback(std::string &header, std::string &footer, std::string &demarcator, std::deque<std::shared_ptr<core::FlowFile>> &flows, core::ProcessSession *session) :
-      header_(header), footer_(footer), demarcator_(demarcator), flows_(flows), session_(session) {
+    WriteCallback(std::string &header, std::string &footer, std::string &demarcator, std::deque<std::shared_ptr<core::FlowFile>> &flows, core::ProcessSession *session,
+                  uint64_t buffer_size = DEFAULT_BUFFER_SIZE) :
+      header_(header), footer_(footer), demarcator_(demarcator), flows_(flows), session_(session), buffer_(buffer_size) {
     }
     std::string &header_;
     std::string &footer_;
     std::string &demarcator_;
     std::deque<std::shared_ptr<core::FlowFile>> &flows_;
     core::ProcessSession *session_;
+    // reused for the content of every flow
+    std::vector<uint8_t> buffer_;
     int64_t process(std::shared_ptr<io::BaseStream> stream) {
       int64_t ret = 0;
       if (!header_.empty()) {
@@ -119,7 +143,7 @@ public:
             return len;
           ret += len;
         }
-        ReadCallback readCb(flow->getSize(), stream);
+        ReadCallback readCb(flow->getSize(), stream, buffer_);
         session_->read(flow, &readCb);
         ret += flow->getSize();
         isFirst = false;
@@ -142,20 +166,19 @@ public:
   // Nest Callback Class for read stream
   class ReadCallback: public InputStreamCallback {
   public:
-    ReadCallback(uint64_t size, struct archive *arch, struct archive_entry *entry) :
-        buffer_size_(size), arch_(arch), entry_(entry) {
+    ReadCallback(uint64_t size, struct archive *arch, struct archive_entry *entry, std::vector<uint8_t> &buffer) :
+        buffer_size_(size), arch_(arch), entry_(entry), buffer_(buffer) {
     }
     ~ReadCallback() {
     }
     int64_t process(std::shared_ptr<io::BaseStream> stream) {
-      uint8_t buffer[4096U];
       int64_t ret = 0;
       uint64_t read_size = 0;
       ret = archive_write_header(arch_, entry_);
       while (read_size < buffer_size_) {
-        int readRet = stream->read(buffer, sizeof(buffer));
+        int readRet = stream->read(buffer_.data(), static_cast<int>(std::min<uint64_t>(buffer_.size(), buffer_size_ - read_size)));
         if (readRet > 0) {
-          ret += archive_write_data(arch_, buffer, readRet);
+          ret += archive_write_data(arch_, buffer_.data(), readRet);
           read_size += readRet;
         }
         else {
@@ -167,13 +190,22 @@ public:
     uint64_t buffer_size_;
     struct archive *arch_;
     struct archive_entry *entry_;
+    std::vector<uint8_t> &buffer_;
   };
+  /**
+   * Adds the filter of a CompressContent compression format to the archive.
+   * @return ARCHIVE_OK or the libarchive error
+   */
+  static int addCompressionFilter(struct archive *arch, const std::string &compress_format, int compress_level);
+
   // Nest Callback Class for write stream
   class WriteCallback: public OutputStreamCallback {
   public:
-    WriteCallback(std::string merge_type, std::deque<std::shared_ptr<core::FlowFile>> &flows, core::ProcessSession *session) :
+    WriteCallback(std::string merge_type, std::deque<std::shared_ptr<core::FlowFile>> &flows, core::ProcessSession *session, uint64_t buffer_size = MergeBin::DEFAULT_BUFFER_SIZE,
+                  std::string compress_format = MERGE_COMPRESSION_NONE, int compress_level = 1) :
         merge_type_(merge_type), flows_(flows), session_(session),
-        logger_(logging::LoggerFactory<ArchiveMerge>::getLogger()) {
+        logger_(logging::LoggerFactory<ArchiveMerge>::getLogger()),
+        buffer_(buffer_size), compress_format_(std::move(compress_format)), compress_level_(compress_level) {
       size_ = 0;
       stream_ = nullptr;
     }
@@ -186,6 +218,10 @@ public:
     std::shared_ptr<io::BaseStream> stream_;
     int64_t size_;
     std::shared_ptr<logging::Logger> logger_;
+    // reused for the content of every flow
+    std::vector<uint8_t> buffer_;
+    std::string compress_format_;
+    int compress_level_;
 
     static la_ssize_t archive_write(struct archive *arch, void *context, const void *buff, size_t size) {
       WriteCallback *callback = (WriteCallback *) context;
@@ -206,7 +242,11 @@ public:
         archive_write_set_format_zip(arch); // zip format
       }
       archive_write_set_bytes_per_block(arch, 0);
-      archive_write_add_filter_none(arch);
+      if (addCompressionFilter(arch, compress_format_, compress_level_) != ARCHIVE_OK) {
+        logger_->log_error("Merge Content archive filter error %s", archive_error_string(arch));
+        archive_write_free(arch);
+        return -1;
+      }
       this->stream_ = stream;
       archive_write_open(arch, this, NULL, archive_write, NULL);
 
@@ -229,7 +269,7 @@ public:
             }
           }
         }
-        ReadCallback readCb(flow->getSize(), arch, entry);
+        ReadCallback readCb(flow->getSize(), arch, entry, buffer_);
         session_->read(flow, &readCb);
         archive_entry_free(entry);
       }
@@ -245,11 +285,17 @@ public:
 class TarMerge: public ArchiveMerge, public MergeBin {
 public:
   static const char *mimeType;
+  explicit TarMerge(std::string compress_format = MERGE_COMPRESSION_NONE, int compress_level = 1)
+      : compress_format_(std::move(compress_format)),
+        compress_level_(compress_level) {
+  }
   std::shared_ptr<core::FlowFile> merge(core::ProcessContext *context, core::ProcessSession *session, std::deque<std::shared_ptr<core::FlowFile>> &flows, std::string &header, std::string &footer,
         std::string &demarcator);
-  std::string getMergedContentType() {
-    return mimeType;
-  }
+  std::string getMergedContentType();
+
+ private:
+  std::string compress_format_;
+  int compress_level_;
 };
 
 // ZipMerge Class
@@ -277,6 +323,9 @@ class MergeContent : public processors::BinFiles {
     mergeFormat_ = MERGE_FORMAT_CONCAT_VALUE;
     delimiterStratgey_ = DELIMITER_STRATEGY_FILENAME;
     keepPath_ = false;
+    bufferSize_ = MergeBin::DEFAULT_BUFFER_SIZE;
+    compressFormat_ = MERGE_COMPRESSION_NONE;
+    compressLevel_ = 1;
   }
   // Destructor
   virtual ~MergeContent() {
@@ -292,6 +341,9 @@ class MergeContent : public processors::BinFiles {
   static core::Property Header;
   static core::Property Footer;
   static core::Property Demarcator;
+  static core::Property BufferSize;
+  static core::Property CompressFormat;
+  static core::Property CompressLevel;
 
   // Supported Relationships
   static core::Relationship Merge;
@@ -329,6 +381,9 @@ class MergeContent : public processors::BinFiles {
   std::string headerContent_;
   std::string footerContent_;
   std::string demarcatorContent_;
+  uint64_t bufferSize_;
+  std::string compressFormat_;
+  int compressLevel_;
   // readContent
   std::string readContent(std::string path);
 };
@@ -0,0 +1,184 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ZstdStream.h"
+#include "Exception.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+/* ZstdDictionary */
+
+ZstdDictionary::ZstdDictionary(const std::string &content, int level)
+    : cdict_(ZSTD_createCDict(content.data(), content.size(), level)),
+      ddict_(ZSTD_createDDict(content.data(), content.size())) {
+  if (cdict_ == nullptr || ddict_ == nullptr) {
+    ZSTD_freeCDict(cdict_);
+    ZSTD_freeDDict(ddict_);
+    throw Exception(ExceptionType::GENERAL_EXCEPTION, "Failed to create zstd dictionary");
+  }
+}
+
+ZstdDictionary::~ZstdDictionary() {
+  ZSTD_freeCDict(cdict_);
+  ZSTD_freeDDict(ddict_);
+}
+
+/* ZstdCompressStream */
+
+ZstdCompressStream::ZstdCompressStream(DataStream* other, int level, int window_log, std::shared_ptr<ZstdDictionary> dictionary)
+    : BaseStream(other),
+      cctx_(ZSTD_createCCtx()),
+      dictionary_(std::move(dictionary)),
+      outputBuffer_(ZSTD_CStreamOutSize()) {
+  if (cctx_ == nullptr) {
+    throw Exception(ExceptionType::GENERAL_EXCEPTION, "ZSTD_createCCtx failed");
+  }
+  size_t ret = ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, level);
+  if (!ZSTD_isError(ret) && window_log > 0) {
+    ret = ZSTD_CCtx_setParameter(cctx_, ZSTD_c_enableLongDistanceMatching, 1);
+    if (!ZSTD_isError(ret)) {
+      ret = ZSTD_CCtx_setParameter(cctx_, ZSTD_c_windowLog, window_log);
+    }
+  }
+  if (!ZSTD_isError(ret) && dictionary_ != nullptr) {
+    ret = ZSTD_CCtx_refCDict(cctx_, dictionary_->getCompressionDictionary());
+  }
+  if (ZSTD_isError(ret)) {
+    logger_->log_error("Failed to configure zstd compression: %s", ZSTD_getErrorName(ret));
+    ZSTD_freeCCtx(cctx_);
+    throw Exception(ExceptionType::GENERAL_EXCEPTION, "zstd compression parameters are invalid");
+  }
+}
+
+ZstdCompressStream::~ZstdCompressStream() {
+  ZSTD_freeCCtx(cctx_);
+}
+
+int ZstdCompressStream::writeData(uint8_t* value, int size) {
+  if (state_ != ZstdStreamState::INITIALIZED) {
+    logger_->log_error("writeData called in invalid ZstdCompressStream state, state is %hhu", state_);
+    return -1;
+  }
+  return compress(value, size, ZSTD_e_continue);
+}
+
+void ZstdCompressStream::closeStream() {
+  if (state_ == ZstdStreamState::INITIALIZED) {
+    if (compress(nullptr, 0, ZSTD_e_end) == 0) {
+      state_ = ZstdStreamState::FINISHED;
+    }
+  }
+}
+
+int ZstdCompressStream::compress(uint8_t* value, int size, ZSTD_EndDirective mode) {
+  ZSTD_inBuffer input = { value, static_cast<size_t>(size), 0 };
+  /*
+   * While continuing a frame, ZSTD_compressStream2 has to be called until it consumed the whole input.
+   * When ending the frame, it returns how many bytes it still has to flush, so it has to be called until that is 0.
+   */
+  bool done;
+  do {
+    ZSTD_outBuffer output = { outputBuffer_.data(), outputBuffer_.size(), 0 };
+    size_t ret = ZSTD_compressStream2(cctx_, &output, &input, mode);
+    if (ZSTD_isError(ret)) {
+      logger_->log_error("ZSTD_compressStream2 failed: %s", ZSTD_getErrorName(ret));
+      state_ = ZstdStreamState::ERRORED;
+      return -1;
+    }
+    int output_size = static_cast<int>(output.pos);
+    if (BaseStream::writeData(outputBuffer_.data(), output_size) != output_size) {
+      logger_->log_error("Failed to write to underlying stream");
+      state_ = ZstdStreamState::ERRORED;
+      return -1;
+    }
+    done = mode == ZSTD_e_end ? ret == 0 : input.pos == input.size;
+  } while (!done);
+
+  return size;
+}
+
+/* ZstdDecompressStream */
+
+ZstdDecompressStream::ZstdDecompressStream(DataStream* other, int window_log, std::shared_ptr<ZstdDictionary> dictionary)
+    : BaseStream(other),
+      dctx_(ZSTD_createDCtx()),
+      dictionary_(std::move(dictionary)),
+      outputBuffer_(ZSTD_DStreamOutSize()) {
+  if (dctx_ == nullptr) {
+    throw Exception(ExceptionType::GENERAL_EXCEPTION, "ZSTD_createDCtx failed");
+  }
+  size_t ret = 0;
+  if (window_log > DEFAULT_MAX_WINDOW_LOG) {
+    ret = ZSTD_DCtx_setParameter(dctx_, ZSTD_d_windowLogMax, window_log);
+  }
+  if (!ZSTD_isError(ret) && dictionary_ != nullptr) {
+    ret = ZSTD_DCtx_refDDict(dctx_, dictionary_->getDecompressionDictionary());
+  }
+  if (ZSTD_isError(ret)) {
+    logger_->log_error("Failed to configure zstd decompression: %s", ZSTD_getErrorName(ret));
+    ZSTD_freeDCtx(dctx_);
+    throw Exception(ExceptionType::GENERAL_EXCEPTION, "zstd decompression parameters are invalid");
+  }
+}
+
+ZstdDecompressStream::~ZstdDecompressStream() {
+  ZSTD_freeDCtx(dctx_);
+}
+
+int ZstdDecompressStream::writeData(uint8_t* value, int size) {
+  if (state_ == ZstdStreamState::ERRORED) {
+    logger_->log_error("writeData called in invalid ZstdDecompressStream state, state is %hhu", state_);
+    return -1;
+  }
+
+  /*
+   * ZSTD_decompressStream returns 0 once a frame is complete, and starts decoding the next frame
+   * when it is called again, so concatenated frames are decompressed as a single stream.
+   * When the output buffer is filled, it may hold back data, so it has to be called again.
+   */
+  ZSTD_inBuffer input = { value, static_cast<size_t>(size), 0 };
+  ZSTD_outBuffer output;
+  do {
+    output = { outputBuffer_.data(), outputBuffer_.size(), 0 };
+    size_t ret = ZSTD_decompressStream(dctx_, &output, &input);
+    if (ZSTD_isError(ret)) {
+      logger_->log_error("ZSTD_decompressStream failed: %s", ZSTD_getErrorName(ret));
+      state_ = ZstdStreamState::ERRORED;
+      return -1;
+    }
+    int output_size = static_cast<int>(output.pos);
+    if (BaseStream::writeData(outputBuffer_.data(), output_size) != output_size) {
+      logger_->log_error("Failed to write to underlying stream");
+      state_ = ZstdStreamState::ERRORED;
+      return -1;
+    }
+    state_ = ret == 0 ? ZstdStreamState::FINISHED : ZstdStreamState::INITIALIZED;
+  } while (input.pos < input.size || output.pos == output.size);
+
+  return size;
+}
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
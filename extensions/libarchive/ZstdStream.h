@@ -0,0 +1,138 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXTENSIONS_LIBARCHIVE_ZSTDSTREAM_H_
+#define EXTENSIONS_LIBARCHIVE_ZSTDSTREAM_H_
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <zstd.h>
+
+#include "io/BaseStream.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+enum class ZstdStreamState : uint8_t {
+  INITIALIZED,
+  ERRORED,
+  FINISHED
+};
+
+/**
+ * Zstandard dictionary digested once for compression at a given level and for decompression,
+ * so that streams of small records can share it without loading it again.
+ */
+class ZstdDictionary {
+ public:
+  ZstdDictionary(const std::string &content, int level);
+  ~ZstdDictionary();
+
+  ZstdDictionary(const ZstdDictionary&) = delete;
+  ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+
+  ZSTD_CDict *getCompressionDictionary() const {
+    return cdict_;
+  }
+
+  ZSTD_DDict *getDecompressionDictionary() const {
+    return ddict_;
+  }
+
+ private:
+  ZSTD_CDict *cdict_;
+  ZSTD_DDict *ddict_;
+};
+
+class ZstdCompressStream : public BaseStream {
+ public:
+  /**
+   * @param level compression level
+   * @param window_log if greater than 0, enables long distance matching with a window of 2^window_log bytes
+   * @param dictionary optional dictionary, which must have been created with the same level
+   */
+  explicit ZstdCompressStream(DataStream* other, int level = ZSTD_CLEVEL_DEFAULT, int window_log = 0, std::shared_ptr<ZstdDictionary> dictionary = nullptr);
+
+  ZstdCompressStream(const ZstdCompressStream&) = delete;
+  ZstdCompressStream& operator=(const ZstdCompressStream&) = delete;
+
+  ~ZstdCompressStream() override;
+
+  int writeData(uint8_t* value, int size) override;
+
+  void closeStream() override;
+
+  bool isFinished() const {
+    return state_ == ZstdStreamState::FINISHED;
+  }
+
+ private:
+  int compress(uint8_t* value, int size, ZSTD_EndDirective mode);
+
+  ZstdStreamState state_{ZstdStreamState::INITIALIZED};
+  ZSTD_CCtx *cctx_;
+  std::shared_ptr<ZstdDictionary> dictionary_;
+  std::vector<uint8_t> outputBuffer_;
+  std::shared_ptr<logging::Logger> logger_{logging::LoggerFactory<ZstdCompressStream>::getLogger()};
+};
+
+class ZstdDecompressStream : public BaseStream {
+ public:
+  // frames with windows up to 2^27 bytes are decompressed without raising the window limit
+  static constexpr int DEFAULT_MAX_WINDOW_LOG = 27;
+
+  /**
+   * @param window_log largest window the content may have been compressed with, if above the default limit
+   * @param dictionary optional dictionary the content was compressed with
+   */
+  explicit ZstdDecompressStream(DataStream* other, int window_log = 0, std::shared_ptr<ZstdDictionary> dictionary = nullptr);
+
+  ZstdDecompressStream(const ZstdDecompressStream&) = delete;
+  ZstdDecompressStream& operator=(const ZstdDecompressStream&) = delete;
+
+  ~ZstdDecompressStream() override;
+
+  int writeData(uint8_t *value, int size) override;
+
+  /**
+   * @return whether the content written so far ends with a complete frame
+   */
+  bool isFinished() const {
+    return state_ == ZstdStreamState::FINISHED;
+  }
+
+ private:
+  ZstdStreamState state_{ZstdStreamState::INITIALIZED};
+  ZSTD_DCtx *dctx_;
+  std::shared_ptr<ZstdDictionary> dictionary_;
+  std::vector<uint8_t> outputBuffer_;
+  std::shared_ptr<logging::Logger> logger_{logging::LoggerFactory<ZstdDecompressStream>::getLogger()};
+};
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+#endif /* EXTENSIONS_LIBARCHIVE_ZSTDSTREAM_H_ */
@@ -99,6 +99,8 @@ static SFTPError libssh2_sftp_error_to_sftp_error(unsigned long libssh2_sftp_err
 }
 
 constexpr size_t SFTPClient::MAX_BUFFER_SIZE;
+constexpr size_t SFTPClient::MAX_OUTSTANDING_REQUESTS;
+constexpr size_t SFTPClient::TRANSFER_BUFFER_SIZE;
 
 LastSFTPError::LastSFTPError()
     : sftp_error_set_(false)
@@ -510,7 +512,7 @@ bool SFTPClient::getFile(const std::string& path, io::BaseStream& output, int64_
     libssh2_sftp_close(file_handle);
   });
 
-  const size_t buf_size = expected_size < 0 ? MAX_BUFFER_SIZE : std::min<size_t>(expected_size, MAX_BUFFER_SIZE);
+  const size_t buf_size = expected_size < 0 ? TRANSFER_BUFFER_SIZE : std::min<size_t>(expected_size, TRANSFER_BUFFER_SIZE);
   std::vector<uint8_t> buf(buf_size);
   uint64_t total_read = 0U;
   do {
@@ -562,6 +564,7 @@ bool SFTPClient::putFile(const std::string& path, io::BaseStream& input, bool ov
       libssh2_session_last_error(ssh_session_, &err_msg, nullptr, 0);
       logger_->log_error("Failed to open remote file \"%s\" due to an underlying SSH error: %s", path.c_str(), err_msg);
     }
+    return false;
   }
   utils::ScopeGuard guard([this, &file_handle, &path]() {
     logger_->log_trace("Closing remote file \"%s\"", path.c_str());
@@ -573,17 +576,27 @@ bool SFTPClient::putFile(const std::string& path, io::BaseStream& input, bool ov
     return true;
   }
 
-  const size_t buf_size = expected_size < 0 ? MAX_BUFFER_SIZE : std::min<size_t>(expected_size, MAX_BUFFER_SIZE);
+  const size_t buf_size = expected_size < 0 ? TRANSFER_BUFFER_SIZE : std::min<size_t>(expected_size, TRANSFER_BUFFER_SIZE);
   std::vector<uint8_t> buf(buf_size);
   uint64_t total_read = 0U;
+  bool eof = false;
   do {
-    int read_ret = input.readData(buf.data(), buf.size());
-    if (read_ret < 0) {
-      last_error_ = LIBSSH2_FX_OK;
-      logger_->log_error("Error while reading input");
-      return false;
-    } else if (read_ret == 0) {
-      logger_->log_trace("EOF while reading input");
+    /* Fill the buffer, so that as many write requests as possible are outstanding */
+    int read_ret = 0;
+    while (static_cast<size_t>(read_ret) < buf.size()) {
+      int ret = input.readData(buf.data() + read_ret, static_cast<int>(buf.size() - read_ret));
+      if (ret < 0) {
+        last_error_ = LIBSSH2_FX_OK;
+        logger_->log_error("Error while reading input");
+        return false;
+      } else if (ret == 0) {
+        logger_->log_trace("EOF while reading input");
+        eof = true;
+        break;
+      }
+      read_ret += ret;
+    }
+    if (read_ret == 0) {
       break;
     }
     logger_->log_trace("Read %d bytes", read_ret);
@@ -599,11 +612,11 @@ bool SFTPClient::putFile(const std::string& path, io::BaseStream& input, bool ov
       logger_->log_trace("Wrote %d bytes to remote file \"%s\"", write_ret, path.c_str());
       remaining -= write_ret;
     }
-  } while (true);
+  } while (!eof);
 
   if (expected_size >= 0 && total_read != expected_size) {
     last_error_ = LIBSSH2_FX_OK;
-    logger_->log_error("Input has unexpected size, expected: %ld, actual: %lu", path.c_str(), expected_size, total_read);
+    logger_->log_error("Input for remote file \"%s\" has unexpected size, expected: %ld, actual: %lu", path.c_str(), expected_size, total_read);
     return false;
   }
 
@@ -695,6 +708,14 @@ bool SFTPClient::removeDirectory(const std::string& path) {
 
 bool SFTPClient::listDirectory(const std::string& path, bool follow_symlinks,
     std::vector<std::tuple<std::string /* filename */, std::string /* longentry */, LIBSSH2_SFTP_ATTRIBUTES /* attrs */>>& children_result) {
+  return listDirectory(path, follow_symlinks, [&children_result](std::string&& filename, std::string&& longentry, LIBSSH2_SFTP_ATTRIBUTES&& attrs) {
+    children_result.emplace_back(std::move(filename), std::move(longentry), std::move(attrs));
+    return true;
+  });
+}
+
+bool SFTPClient::listDirectory(const std::string& path, bool follow_symlinks,
+    const std::function<bool(std::string&& /* filename */, std::string&& /* longentry */, LIBSSH2_SFTP_ATTRIBUTES&& /* attrs */)>& callback) {
   LIBSSH2_SFTP_HANDLE *dir_handle = libssh2_sftp_open_ex(sftp_session_,
                                                           path.c_str(),
                                                           path.length(),
@@ -735,7 +756,9 @@ bool SFTPClient::listDirectory(const std::string& path, bool follow_symlinks,
         attrs = orig_attrs;
       }
     }
-    children_result.emplace_back(std::string(filename.data()), std::string(longentry.data()), std::move(attrs));
+    if (!callback(std::string(filename.data()), std::string(longentry.data()), std::move(attrs))) {
+      break;
+    }
   } while (true);
   return true;
 }
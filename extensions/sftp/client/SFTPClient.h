@@ -23,6 +23,7 @@
 #include <libssh2_sftp.h>
 #include <vector>
 #include <iostream>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -128,6 +129,16 @@ class SFTPClient {
   bool listDirectory(const std::string& path, bool follow_symlinks,
       std::vector<std::tuple<std::string /* filename */, std::string /* longentry */, LIBSSH2_SFTP_ATTRIBUTES /* attrs */>>& children_result);
 
+  /**
+   * Lists a remote directory without collecting the entries: each entry is passed to the callback
+   * as soon as it is read from the server.
+   * @param callback is called with the filename, longentry and attributes of every entry,
+   * returning false from it stops the listing
+   * @return false if the directory could not be opened or read
+   */
+  bool listDirectory(const std::string& path, bool follow_symlinks,
+      const std::function<bool(std::string&& /* filename */, std::string&& /* longentry */, LIBSSH2_SFTP_ATTRIBUTES&& /* attrs */)>& callback);
+
   bool stat(const std::string& path, bool follow_symlinks, LIBSSH2_SFTP_ATTRIBUTES& result);
 
   static const uint32_t SFTP_ATTRIBUTE_PERMISSIONS = 0x00000001;
@@ -150,12 +161,19 @@ class SFTPClient {
  protected:
 
   /*
-   * The maximum size libssh2 is willing to read or write in one go is 30000 bytes.
+   * The maximum size libssh2 is willing to read or write in one SFTP request is 30000 bytes.
    * (See MAX_SFTP_OUTGOING_SIZE and MAX_SFTP_READ_SIZE).
-   * So we will choose that as our read-write buffer size.
    */
   static constexpr size_t MAX_BUFFER_SIZE = 30000U;
 
+  /*
+   * libssh2 splits larger reads and writes into MAX_BUFFER_SIZE requests and sends them without
+   * waiting for the previous replies, so the transfer buffer holds this many outstanding requests
+   * instead of waiting a full round trip for each of them.
+   */
+  static constexpr size_t MAX_OUTSTANDING_REQUESTS = 16U;
+  static constexpr size_t TRANSFER_BUFFER_SIZE = MAX_BUFFER_SIZE * MAX_OUTSTANDING_REQUESTS;
+
   std::shared_ptr<logging::Logger> logger_;
 
   const std::string hostname_;
@@ -22,14 +22,17 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <map>
+#include <queue>
 #include <set>
 #include <list>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -48,9 +51,7 @@
 #include "ResourceClaim.h"
 
 #include "rapidjson/document.h"
-#include "rapidjson/ostreamwrapper.h"
 #include "rapidjson/istreamwrapper.h"
-#include "rapidjson/writer.h"
 
 namespace org {
 namespace apache {
@@ -129,6 +130,12 @@ core::Property ListSFTP::StateFile(
     core::PropertyBuilder::createProperty("State File")->withDescription("Specifies the file that should be used for storing state about"
                                                                          " what data has been ingested so that upon restart MiNiFi can resume from where it left off")
         ->isRequired(true)->withDefaultValue("ListSFTP")->build());
+core::Property ListSFTP::ListingBatchSize(
+    core::PropertyBuilder::createProperty("Listing Batch Size")->withDescription("The maximum number of files listed in a single run. "
+                                                                                 "If more new files are found, the rest of them are listed in the following runs. "
+                                                                                 "Only this many files are kept in memory while a directory is listed. "
+                                                                                 "0 means no limit.")
+        ->isRequired(true)->withDefaultValue<uint64_t>(10000)->build());
 
 core::Relationship ListSFTP::Success("success", "All FlowFiles that are received are routed to success");
 
@@ -150,6 +157,42 @@ constexpr char const* ListSFTP::ENTITY_TRACKING_INITIAL_LISTING_TARGET_ALL_AVAIL
 
 constexpr char const* ListSFTP::ProcessorName;
 
+namespace {
+
+constexpr uint32_t TRACKING_ENTITIES_INDEX_VERSION = 1U;
+
+/* 64-bit FNV-1a, which, unlike std::hash, is stable across runs and platforms, so it can be persisted */
+uint64_t hashPath(const std::string& path) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const auto c : path) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+void writeIndexValue(std::ostream& stream, uint64_t value) {
+  char buf[sizeof(uint64_t)];
+  for (size_t i = 0U; i < sizeof(uint64_t); i++) {
+    buf[i] = static_cast<char>((value >> (8U * i)) & 0xFF);
+  }
+  stream.write(buf, sizeof(buf));
+}
+
+bool readIndexValue(std::istream& stream, uint64_t& value) {
+  char buf[sizeof(uint64_t)];
+  if (!stream.read(buf, sizeof(buf))) {
+    return false;
+  }
+  value = 0U;
+  for (size_t i = 0U; i < sizeof(uint64_t); i++) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(buf[i])) << (8U * i);
+  }
+  return true;
+}
+
+}  // namespace
+
 void ListSFTP::initialize() {
   logger_->log_trace("Initializing FetchSFTP");
 
@@ -171,6 +214,7 @@ void ListSFTP::initialize() {
   properties.insert(MinimumFileSize);
   properties.insert(MaximumFileSize);
   properties.insert(StateFile);
+  properties.insert(ListingBatchSize);
   setSupportedProperties(properties);
 
   // Set the supported relationships
@@ -190,6 +234,7 @@ ListSFTP::ListSFTP(std::string name, utils::Identifier uuid /*= utils::Identifie
     , maximum_file_age_(0U)
     , minimum_file_size_(0U)
     , maximum_file_size_(0U)
+    , listing_batch_size_(0U)
     , already_loaded_from_cache_(false)
     , last_listed_latest_entry_timestamp_(0U)
     , last_processed_latest_entry_timestamp_(0U)
@@ -270,6 +315,9 @@ void ListSFTP::onSchedule(const std::shared_ptr<core::ProcessContext> &context,
       logger_->log_error("Maximum File Size attribute is invalid");
     }
   }
+  if (!context->getProperty(ListingBatchSize.getName(), listing_batch_size_)) {
+    logger_->log_error("Listing Batch Size attribute is invalid");
+  }
   context->getProperty(StateFile.getName(), value);
   if (listing_strategy_ == LISTING_STRATEGY_TRACKING_TIMESTAMPS) {
     std::stringstream ss;
@@ -288,8 +336,8 @@ void ListSFTP::onSchedule(const std::shared_ptr<core::ProcessContext> &context,
     std::stringstream ss;
     ss << value << "." << getUUIDStr() << ".TrackingEntities";
     auto new_tracking_entities_state_filename = ss.str();
-    ss << ".json";
-    auto new_tracking_entities_state_json_filename = ss.str();
+    ss << ".index";
+    auto new_tracking_entities_state_index_filename = ss.str();
     if (new_tracking_entities_state_filename != tracking_entities_state_filename_) {
       if (!tracking_entities_state_filename_.empty()) {
         if (unlink(tracking_entities_state_filename_.c_str()) != 0) {
@@ -297,15 +345,15 @@ void ListSFTP::onSchedule(const std::shared_ptr<core::ProcessContext> &context,
                              tracking_entities_state_filename_.c_str());
         }
       }
-      if (!tracking_entities_state_json_filename_.empty()) {
-        if (unlink(tracking_entities_state_json_filename_.c_str()) != 0) {
-          logger_->log_error("Unable to delete old Tracking Entities json state file \"%s\"",
-                             tracking_entities_state_json_filename_.c_str());
+      if (!tracking_entities_state_index_filename_.empty()) {
+        if (unlink(tracking_entities_state_index_filename_.c_str()) != 0) {
+          logger_->log_error("Unable to delete old Tracking Entities index state file \"%s\"",
+                             tracking_entities_state_index_filename_.c_str());
         }
       }
     }
     tracking_entities_state_filename_ = new_tracking_entities_state_filename;
-    tracking_entities_state_json_filename_ = new_tracking_entities_state_json_filename;
+    tracking_entities_state_index_filename_ = new_tracking_entities_state_index_filename;
   } else {
     logger_->log_error("Unknown Listing Strategy: \"%s\"", listing_strategy_.c_str());
   }
@@ -332,19 +380,54 @@ ListSFTP::Child::Child()
   memset(&attrs, 0x00, sizeof(attrs));
 }
 
-ListSFTP::Child::Child(const std::string& parent_path_, std::tuple<std::string /* filename */, std::string /* longentry */, LIBSSH2_SFTP_ATTRIBUTES /* attrs */>&& sftp_child) {
-  parent_path = parent_path_;
-  std::tie(filename, std::ignore, attrs) = std::move(sftp_child);
-  directory = LIBSSH2_SFTP_S_ISDIR(attrs.permissions);
+ListSFTP::Child::Child(const std::string& parent_path_, std::string&& filename_, const LIBSSH2_SFTP_ATTRIBUTES& attrs_)
+    : directory(LIBSSH2_SFTP_S_ISDIR(attrs_.permissions))
+    , parent_path(parent_path_)
+    , filename(std::move(filename_))
+    , attrs(attrs_) {
 }
 
 std::string ListSFTP::Child::getPath() const {
   return utils::file::FileUtils::concat_path(parent_path, filename, true /*force_posix*/);
 }
 
-bool ListSFTP::filter(const std::string& parent_path, const std::tuple<std::string /* filename */, std::string /* longentry */, LIBSSH2_SFTP_ATTRIBUTES /* attrs */>& sftp_child) {
-  const std::string& filename = std::get<0>(sftp_child);
-  const LIBSSH2_SFTP_ATTRIBUTES& attrs = std::get<2>(sftp_child);
+void ListSFTP::listFiles(utils::SFTPClient& client, const std::string& remote_path, const std::function<bool(Child&&)>& callback) {
+  std::deque<Child> directories;
+
+  /* Add initial directory */
+  Child root;
+  std::tie(root.parent_path, root.filename) = utils::file::FileUtils::split_path(remote_path, true /*force_posix*/);
+  root.directory = true;
+  directories.emplace_back(std::move(root));
+
+  /* Process directories */
+  bool stopped = false;
+  while (!directories.empty() && !stopped) {
+    auto directory = std::move(directories.front());
+    directories.pop_front();
+
+    std::string new_parent_path;
+    if (directory.parent_path.empty()) {
+      new_parent_path = directory.filename;
+    } else {
+      new_parent_path = directory.getPath();
+    }
+    client.listDirectory(new_parent_path, follow_symlink_, [&](std::string&& filename, std::string&& /*longentry*/, LIBSSH2_SFTP_ATTRIBUTES&& attrs) {
+      if (!filter(new_parent_path, filename, attrs)) {
+        return true;
+      }
+      Child child(new_parent_path, std::move(filename), attrs);
+      if (child.directory) {
+        directories.emplace_back(std::move(child));
+      } else if (!callback(std::move(child))) {
+        stopped = true;
+      }
+      return !stopped;
+    });
+  }
+}
+
+bool ListSFTP::filter(const std::string& parent_path, const std::string& filename, const LIBSSH2_SFTP_ATTRIBUTES& attrs) {
   /* This should not happen */
   if (filename.empty()) {
     logger_->log_error("Listing directory \"%s\" returned an empty child", parent_path.c_str());
@@ -612,11 +695,11 @@ bool ListSFTP::updateFromTrackingTimestampsCache(const std::string& hostname, co
 void ListSFTP::listByTrackingTimestamps(
     const std::shared_ptr<core::ProcessContext>& context,
     const std::shared_ptr<core::ProcessSession>& session,
+    utils::SFTPClient& client,
     const std::string& hostname,
     uint16_t port,
     const std::string& username,
-    const std::string& remote_path,
-    std::vector<Child>&& files) {
+    const std::string& remote_path) {
   uint64_t min_timestamp_to_list = last_listed_latest_entry_timestamp_;
 
   /* Load state from cache file if needed */
@@ -632,27 +715,63 @@ void ListSFTP::listByTrackingTimestamps(
   std::chrono::time_point<std::chrono::steady_clock> current_run_time = std::chrono::steady_clock::now();
   time_t now = time(nullptr);
 
-  /* Order children by timestamp and try to detect timestamp precision if needed  */
-  std::map<uint64_t /*timestamp*/, std::list<Child>> ordered_files;
+  /*
+   * Only the oldest new files fitting in a batch are kept while listing, ordered by timestamp and path,
+   * so that the remaining ones are picked up by the following runs in the same order.
+   */
+  auto is_older = [](const Child& lhs, const Child& rhs) {
+    return std::tie(lhs.attrs.mtime, lhs.parent_path, lhs.filename) < std::tie(rhs.attrs.mtime, rhs.parent_path, rhs.filename);
+  };
+  std::priority_queue<Child, std::vector<Child>, decltype(is_older)> oldest_files(is_older);
+  bool batch_full = false;
+
+  /* Try to detect timestamp precision if needed, and track whether the files with the latest timestamp have all been processed */
   bool target_system_has_seconds = false;
-  for (auto&& file : files) {
+  bool found_new_files = false;
+  uint64_t latest_listed_entry_timestamp_this_cycle = 0U;
+  bool latest_files_processed = false;
+  listFiles(client, remote_path, [&](Child&& file) {
     uint64_t timestamp = file.attrs.mtime * 1000;
     target_system_has_seconds |= timestamp % 60000 != 0;
 
     bool new_file = min_timestamp_to_list == 0U || (timestamp >= min_timestamp_to_list && timestamp >= last_processed_latest_entry_timestamp_);
-    if (new_file) {
-      auto& files_for_timestamp = ordered_files[timestamp];
-      files_for_timestamp.emplace_back(std::move(file));
-    } else {
+    if (!new_file) {
       logger_->log_trace("Skipping \"%s\", because it is not new.", file.getPath().c_str());
+      return true;
+    }
+
+    bool processed = timestamp == last_processed_latest_entry_timestamp_ && latest_identifiers_processed_.count(file.getPath()) == 1U;
+    if (!found_new_files || timestamp > latest_listed_entry_timestamp_this_cycle) {
+      latest_listed_entry_timestamp_this_cycle = timestamp;
+      latest_files_processed = processed;
+    } else if (timestamp == latest_listed_entry_timestamp_this_cycle) {
+      latest_files_processed &= processed;
     }
+    found_new_files = true;
+
+    /* Filter out previously processed entities. */
+    if (processed) {
+      return true;
+    }
+    oldest_files.push(std::move(file));
+    if (listing_batch_size_ != 0U && oldest_files.size() > listing_batch_size_) {
+      oldest_files.pop();
+      batch_full = true;
+    }
+    return true;
+  });
+
+  /* Order children by timestamp */
+  std::map<uint64_t /*timestamp*/, std::list<Child>> ordered_files;
+  while (!oldest_files.empty()) {
+    /* The elements of a priority_queue can not be moved out, but Child is cheap enough to copy once */
+    const auto& file = oldest_files.top();
+    ordered_files[file.attrs.mtime * 1000].push_front(file);
+    oldest_files.pop();
   }
 
-  uint64_t latest_listed_entry_timestamp_this_cycle = 0U;
   size_t flow_files_created = 0U;
-  if (ordered_files.size() > 0) {
-    latest_listed_entry_timestamp_this_cycle = ordered_files.crbegin()->first;
-
+  if (found_new_files) {
     std::string remote_system_timestamp_precision;
     if (target_system_timestamp_precision_ == TARGET_SYSTEM_TIMESTAMP_PRECISION_AUTO_DETECT) {
       if (target_system_has_seconds) {
@@ -676,7 +795,6 @@ void ListSFTP::listByTrackingTimestamps(
 
     /* If the latest listing time is equal to the last listing time, there are no entries with a newer timestamp than previously seen */
     if (latest_listed_entry_timestamp_this_cycle == last_listed_latest_entry_timestamp_) {
-      const auto& latest_files = ordered_files.at(latest_listed_entry_timestamp_this_cycle);
       uint64_t elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(current_run_time - last_run_time_).count();
       /* If a precision-specific listing lag has not yet elapsed since out last execution, we wait. */
       if (elapsed_time < listing_lag) {
@@ -692,10 +810,7 @@ void ListSFTP::listByTrackingTimestamps(
        * If we have already processed the entities with the newest timestamp,
        * and there are no new entities with that timestamp, there is nothing to do.
        */
-      if (latest_listed_entry_timestamp_this_cycle == last_processed_latest_entry_timestamp_ &&
-          std::all_of(latest_files.begin(), latest_files.end(), [this](const Child& child) {
-            return latest_identifiers_processed_.count(child.getPath()) == 1U;
-          })) {
+      if (latest_listed_entry_timestamp_this_cycle == last_processed_latest_entry_timestamp_ && latest_files_processed) {
         logger_->log_debug("The latest listed entry timestamp is the same as the last listed entry timestamp (%lu) "
                            "and all files for that timestamp has been processed. Yielding.", latest_listed_entry_timestamp_this_cycle);
         context->yield();
@@ -718,17 +833,7 @@ void ListSFTP::listByTrackingTimestamps(
       }
     }
 
-    for (auto& files_for_timestamp : ordered_files) {
-      if (files_for_timestamp.first == last_processed_latest_entry_timestamp_) {
-        /* Filter out previously processed entities. */
-        for (auto it = files_for_timestamp.second.begin(); it != files_for_timestamp.second.end();) {
-          if (latest_identifiers_processed_.count(it->getPath()) != 0U) {
-            it = files_for_timestamp.second.erase(it);
-          } else {
-            ++it;
-          }
-        }
-      }
+    for (const auto& files_for_timestamp : ordered_files) {
       for (const auto& file : files_for_timestamp.second) {
         /* Create the FlowFile for this path */
         if (createAndTransferFlowFileFromChild(session, hostname, port, username, file)) {
@@ -743,7 +848,7 @@ void ListSFTP::listByTrackingTimestamps(
   }
 
   /* If we have a listing timestamp, it is worth persisting the state */
-  if (latest_listed_entry_timestamp_this_cycle != 0U) {
+  if (found_new_files) {
     bool processed_new_files = flow_files_created > 0U;
     if (processed_new_files) {
       auto last_files_it = ordered_files.crbegin();
@@ -760,6 +865,15 @@ void ListSFTP::listByTrackingTimestamps(
 
     last_run_time_ = current_run_time;
 
+    /*
+     * If the batch was full, only the files up to the last processed timestamp have been listed,
+     * the newer ones must remain eligible in the next run.
+     */
+    if (batch_full) {
+      logger_->log_debug("Listing Batch Size (%lu) reached, the rest of the files will be listed in the next run", listing_batch_size_);
+      latest_listed_entry_timestamp_this_cycle = processed_new_files ? last_processed_latest_entry_timestamp_ : last_listed_latest_entry_timestamp_;
+    }
+
     if (latest_listed_entry_timestamp_this_cycle != last_listed_latest_entry_timestamp_ || processed_new_files) {
       last_listed_latest_entry_timestamp_ = latest_listed_entry_timestamp_this_cycle;
       if (!tracking_timestamps_state_filename_.empty()) {
@@ -774,6 +888,33 @@ void ListSFTP::listByTrackingTimestamps(
 }
 
 bool ListSFTP::persistTrackingEntitiesCache(const std::string& hostname, const std::string& username, const std::string& remote_path) {
+  /* The index is written first, so that the state file never references an index that does not exist yet.
+   * It is written to a temporary file, so that a failure can not leave a truncated index behind */
+  const std::string temporary_index_filename = tracking_entities_state_index_filename_ + ".tmp";
+  std::ofstream index_file(temporary_index_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!index_file.is_open()) {
+    logger_->log_error("Failed to store Tracking Entities state to state index file \"%s\"", temporary_index_filename.c_str());
+    return false;
+  }
+
+  writeIndexValue(index_file, TRACKING_ENTITIES_INDEX_VERSION);
+  writeIndexValue(index_file, already_listed_entities_.size());
+  for (const auto& already_listed_entity : already_listed_entities_) {
+    writeIndexValue(index_file, already_listed_entity.first);
+    writeIndexValue(index_file, already_listed_entity.second.timestamp);
+    writeIndexValue(index_file, already_listed_entity.second.size);
+  }
+  index_file.close();
+  if (!index_file) {
+    logger_->log_error("Failed to write Tracking Entities state index file \"%s\"", temporary_index_filename.c_str());
+    return false;
+  }
+
+  if (rename(temporary_index_filename.c_str(), tracking_entities_state_index_filename_.c_str()) != 0) {
+    logger_->log_error("Failed to rename \"%s\" to \"%s\"", temporary_index_filename.c_str(), tracking_entities_state_index_filename_.c_str());
+    return false;
+  }
+
   std::ofstream file(tracking_entities_state_filename_);
   if (!file.is_open()) {
     logger_->log_error("Failed to store Tracking Entities state to state file \"%s\"", tracking_entities_state_filename_.c_str());
@@ -782,27 +923,91 @@ bool ListSFTP::persistTrackingEntitiesCache(const std::string& hostname, const s
   file << "hostname=" << hostname << "\n";
   file << "username=" << username << "\n";
   file << "remote_path=" << remote_path << "\n";
-  file << "json_state_file=" << tracking_entities_state_json_filename_ << "\n";
+  file << "index_state_file=" << tracking_entities_state_index_filename_ << "\n";
   file.close();
 
-  std::ofstream json_file(tracking_entities_state_json_filename_);
-  if (!json_file.is_open()) {
-    logger_->log_error("Failed to store Tracking Entities state to state json file \"%s\"", tracking_entities_state_json_filename_.c_str());
+  return true;
+}
+
+bool ListSFTP::updateFromTrackingEntitiesIndex(const std::string& index_filename) {
+  std::ifstream index_file(index_filename, std::ios::in | std::ios::binary);
+  if (!index_file.is_open()) {
+    logger_->log_error("Failed to open Tracking Entities state index file \"%s\"", index_filename.c_str());
     return false;
   }
 
-  rapidjson::Document entities(rapidjson::kObjectType);
-  rapidjson::Document::AllocatorType& alloc = entities.GetAllocator();
-  for (const auto& already_listed_entity : already_listed_entities_) {
-    rapidjson::Value entity(rapidjson::kObjectType);
-    entity.AddMember("timestamp", already_listed_entity.second.timestamp, alloc);
-    entity.AddMember("size", already_listed_entity.second.size, alloc);
-    entities.AddMember(rapidjson::Value(already_listed_entity.first.c_str(), alloc), std::move(entity), alloc);
+  uint64_t version;
+  uint64_t count;
+  if (!readIndexValue(index_file, version) || !readIndexValue(index_file, count)) {
+    logger_->log_error("Failed to read the header of Tracking Entities state index file \"%s\"", index_filename.c_str());
+    return false;
+  }
+  if (version != TRACKING_ENTITIES_INDEX_VERSION) {
+    logger_->log_error("Unsupported Tracking Entities state index file \"%s\" version: %lu", index_filename.c_str(), version);
+    return false;
   }
 
-  rapidjson::OStreamWrapper osw(json_file);
-  rapidjson::Writer<rapidjson::OStreamWrapper> writer(osw);
-  entities.Accept(writer);
+  std::unordered_map<uint64_t, ListedEntity> new_already_listed_entities;
+  for (uint64_t i = 0U; i < count; i++) {
+    uint64_t path_hash;
+    uint64_t timestamp;
+    uint64_t size;
+    if (!readIndexValue(index_file, path_hash) || !readIndexValue(index_file, timestamp) || !readIndexValue(index_file, size)) {
+      logger_->log_error("Tracking Entities state index file \"%s\" is truncated", index_filename.c_str());
+      return false;
+    }
+    new_already_listed_entities.emplace(path_hash, ListedEntity(timestamp, size));
+  }
+  already_listed_entities_ = std::move(new_already_listed_entities);
+
+  return true;
+}
+
+bool ListSFTP::updateFromTrackingEntitiesJson(const std::string& json_filename) {
+  std::ifstream json_file(json_filename);
+  if (!json_file.is_open()) {
+    logger_->log_error("Failed to open entities Tracking Entities state json file \"%s\"", json_filename.c_str());
+    return false;
+  }
+
+  try {
+    rapidjson::IStreamWrapper isw(json_file);
+    rapidjson::Document d;
+    rapidjson::ParseResult res = d.ParseStream(isw);
+    if (!res) {
+      logger_->log_error("Failed to parse Tracking Entities state json file \"%s\"", json_filename.c_str());
+      return false;
+    }
+    if (!d.IsObject()) {
+      logger_->log_error("Tracking Entities state json file \"%s\" root is not an object", json_filename.c_str());
+      return false;
+    }
+
+    std::unordered_map<uint64_t, ListedEntity> new_already_listed_entities;
+    for (const auto &already_listed_entity : d.GetObject()) {
+      auto it = already_listed_entity.value.FindMember("timestamp");
+      if (it == already_listed_entity.value.MemberEnd() || !it->value.IsUint64()) {
+        logger_->log_error("Tracking Entities state json file \"%s\" timestamp missing or malformatted for entity \"%s\"",
+            json_filename.c_str(),
+            already_listed_entity.name.GetString());
+        continue;
+      }
+      uint64_t timestamp = it->value.GetUint64();
+      it = already_listed_entity.value.FindMember("size");
+      if (it == already_listed_entity.value.MemberEnd() || !it->value.IsUint64()) {
+        logger_->log_error("Tracking Entities state json file \"%s\" size missing or malformatted for entity \"%s\"",
+                           json_filename.c_str(),
+                           already_listed_entity.name.GetString());
+        continue;
+      }
+      uint64_t size = it->value.GetUint64();
+      new_already_listed_entities.emplace(hashPath(already_listed_entity.name.GetString()), ListedEntity(timestamp, size));
+    }
+    already_listed_entities_ = std::move(new_already_listed_entities);
+  } catch (std::exception& e) {
+    logger_->log_error("Exception while parsing Tracking Entities state json file \"%s\": %s", json_filename.c_str(), e.what());
+    return false;
+  }
 
   return true;
 }
@@ -816,6 +1021,7 @@ bool ListSFTP::updateFromTrackingEntitiesCache(const std::string& hostname, cons
   std::string state_hostname;
   std::string state_username;
   std::string state_remote_path;
+  std::string state_index_state_file;
   std::string state_json_state_file;
 
   std::string line;
@@ -833,6 +1039,8 @@ bool ListSFTP::updateFromTrackingEntitiesCache(const std::string& hostname, cons
       state_username = std::move(value);
     } else if (key == "remote_path") {
       state_remote_path = std::move(value);
+    } else if (key == "index_state_file") {
+      state_index_state_file = std::move(value);
     } else if (key == "json_state_file") {
       state_json_state_file = std::move(value);
     } else {
@@ -855,70 +1063,39 @@ bool ListSFTP::updateFromTrackingEntitiesCache(const std::string& hostname, cons
     return false;
   }
 
-  if (state_json_state_file.empty()) {
-    logger_->log_error("Could not found json state file path in Tracking Entities state file \"%s\"", tracking_entities_state_filename_.c_str());
-    return false;
-  }
-
-  std::ifstream json_file(state_json_state_file);
-  if (!json_file.is_open()) {
-    logger_->log_error("Failed to open entities Tracking Entities state json file \"%s\"", state_json_state_file.c_str());
-    return false;
+  if (!state_index_state_file.empty()) {
+    return updateFromTrackingEntitiesIndex(state_index_state_file);
   }
 
-  try {
-    rapidjson::IStreamWrapper isw(json_file);
-    rapidjson::Document d;
-    rapidjson::ParseResult res = d.ParseStream(isw);
-    if (!res) {
-      logger_->log_error("Failed to parse Tracking Entities state json file \"%s\"", state_json_state_file.c_str());
-      return false;
-    }
-    if (!d.IsObject()) {
-      logger_->log_error("Tracking Entities state json file \"%s\" root is not an object", state_json_state_file.c_str());
+  /* State files written by earlier versions reference a json file keyed by full paths, which is converted to the index */
+  if (!state_json_state_file.empty()) {
+    if (!updateFromTrackingEntitiesJson(state_json_state_file)) {
       return false;
     }
-
-    std::unordered_map<std::string, ListedEntity> new_already_listed_entities;
-    for (const auto &already_listed_entity : d.GetObject()) {
-      auto it = already_listed_entity.value.FindMember("timestamp");
-      if (it == already_listed_entity.value.MemberEnd() || !it->value.IsUint64()) {
-        logger_->log_error("Tracking Entities state json file \"%s\" timestamp missing or malformatted for entity \"%s\"",
-            state_json_state_file.c_str(),
-            already_listed_entity.name.GetString());
-        continue;
+    if (persistTrackingEntitiesCache(hostname, username, remote_path)) {
+      logger_->log_info("Converted Tracking Entities state json file \"%s\" to index file \"%s\"",
+                        state_json_state_file.c_str(),
+                        tracking_entities_state_index_filename_.c_str());
+      if (unlink(state_json_state_file.c_str()) != 0) {
+        logger_->log_error("Unable to delete old Tracking Entities json state file \"%s\"", state_json_state_file.c_str());
       }
-      uint64_t timestamp = it->value.GetUint64();
-      it = already_listed_entity.value.FindMember("size");
-      if (it == already_listed_entity.value.MemberEnd() || !it->value.IsUint64()) {
-        logger_->log_error("Tracking Entities state json file \"%s\" size missing or malformatted for entity \"%s\"",
-                           state_json_state_file.c_str(),
-                           already_listed_entity.name.GetString());
-        continue;
-      }
-      uint64_t size = it->value.GetUint64();
-      new_already_listed_entities.emplace(std::piecewise_construct,
-                                          std::forward_as_tuple(already_listed_entity.name.GetString()),
-                                          std::forward_as_tuple(timestamp, size));
     }
-    already_listed_entities_ = std::move(new_already_listed_entities);
-  } catch (std::exception& e) {
-    logger_->log_error("Exception while parsing Tracking Entities state json file \"%s\": %s", state_json_state_file.c_str(), e.what());
-    return false;
+    return true;
   }
 
-  return true;
+  logger_->log_error("Could not found index state file path in Tracking Entities state file \"%s\"", tracking_entities_state_filename_.c_str());
+  return false;
 }
 
 void ListSFTP::listByTrackingEntities(
     const std::shared_ptr<core::ProcessContext>& context,
     const std::shared_ptr<core::ProcessSession>& session,
+    utils::SFTPClient& client,
     const std::string& hostname,
     uint16_t port,
     const std::string& username,
     const std::string& remote_path,
-    uint64_t entity_tracking_time_window,
-    std::vector<Child>&& files) {
+    uint64_t entity_tracking_time_window) {
   /* Load state from cache file if needed */
   if (!already_loaded_from_cache_ && !tracking_entities_state_filename_.empty()) {
     if (updateFromTrackingEntitiesCache(hostname, username, remote_path)) {
@@ -934,57 +1111,54 @@ void ListSFTP::listByTrackingEntities(
   uint64_t min_timestamp_to_list = (!initial_listing_complete_ && entity_tracking_initial_listing_target_ == ENTITY_TRACKING_INITIAL_LISTING_TARGET_ALL_AVAILABLE)
       ? 0U : (now * 1000 - entity_tracking_time_window);
 
-  /* Skip files not in the tracking window */
-  for (auto it = files.begin(); it != files.end(); ) {
-    if (it->attrs.mtime * 1000 < min_timestamp_to_list) {
+  /*
+   * Find files that have been updated while listing. Files not in the tracking window and unchanged files are dropped
+   * as soon as they are read, and once a batch of updated files is found, the listing stops: the rest are found by the next runs.
+   */
+  bool found_files_in_window = false;
+  std::vector<Child> updated_entities;
+  listFiles(client, remote_path, [&](Child&& child) {
+    if (child.attrs.mtime * 1000 < min_timestamp_to_list) {
       logger_->log_trace("Skipping \"%s\" because it has an older timestamp than the minimum timestamp to list: %lu < %lu",
-          it->getPath(), it->attrs.mtime * 1000, min_timestamp_to_list);
-      it = files.erase(it);
+          child.getPath(), child.attrs.mtime * 1000, min_timestamp_to_list);
+      return true;
+    }
+    found_files_in_window = true;
+
+    auto already_listed_it = already_listed_entities_.find(hashPath(child.getPath()));
+    if (already_listed_it == already_listed_entities_.end()) {
+      logger_->log_trace("Found new file \"%s\"", child.getPath());
+    } else if (child.attrs.mtime * 1000 > already_listed_it->second.timestamp) {
+      logger_->log_trace("Found file \"%s\" with newer timestamp: %lu -> %lu",
+          child.getPath(),
+          already_listed_it->second.timestamp,
+          child.attrs.mtime * 1000);
+    } else if (child.attrs.filesize != already_listed_it->second.size) {
+      logger_->log_trace("Found file \"%s\" with different size: %lu -> %lu",
+                         child.getPath(),
+                         already_listed_it->second.size,
+                         child.attrs.filesize);
     } else {
-      ++it;
+      logger_->log_trace("Skipping file \"%s\" because it has not changed", child.getPath());
+      return true;
     }
-  }
 
-  if (files.empty()) {
+    updated_entities.emplace_back(std::move(child));
+    if (listing_batch_size_ != 0U && updated_entities.size() >= listing_batch_size_) {
+      logger_->log_debug("Listing Batch Size (%lu) reached, the rest of the files will be listed in the next run", listing_batch_size_);
+      return false;
+    }
+    return true;
+  });
+
+  if (!found_files_in_window) {
     logger_->log_debug("No entities to list within the tracking time window");
     context->yield();
     return;
   }
 
-  /* Find files that have been updated */
-  std::vector<Child> updated_entities;
-  std::copy_if(std::make_move_iterator(files.begin()),
-               std::make_move_iterator(files.end()),
-               std::back_inserter(updated_entities),
-               [&](const Child& child) {
-     auto already_listed_it = already_listed_entities_.find(child.getPath());
-     if (already_listed_it == already_listed_entities_.end()) {
-       logger_->log_trace("Found new file \"%s\"", child.getPath());
-       return true;
-     }
-
-     if (child.attrs.mtime * 1000 > already_listed_it->second.timestamp) {
-       logger_->log_trace("Found file \"%s\" with newer timestamp: %lu -> %lu",
-           child.getPath(),
-           already_listed_it->second.timestamp,
-           child.attrs.mtime * 1000);
-       return true;
-     }
-
-     if (child.attrs.filesize != already_listed_it->second.size) {
-       logger_->log_trace("Found file \"%s\" with different size: %lu -> %lu",
-                          child.getPath(),
-                          already_listed_it->second.size,
-                          child.attrs.filesize);
-       return true;
-     }
-
-     logger_->log_trace("Skipping file \"%s\" because it has not changed", child.getPath());
-     return false;
-  });
-
   /* Find entities in the tracking cache that are no longer in the tracking window */
-  std::vector<std::string> old_entity_ids;
+  std::vector<uint64_t> old_entity_ids;
   for (const auto& already_listed_entity : already_listed_entities_) {
     if (already_listed_entity.second.timestamp < min_timestamp_to_list) {
       old_entity_ids.emplace_back(already_listed_entity.first);
@@ -1009,7 +1183,7 @@ void ListSFTP::listByTrackingEntities(
       context->yield();
       return;
     }
-    already_listed_entities_[updated_entity.getPath()] = ListedEntity(updated_entity.attrs.mtime * 1000, updated_entity.attrs.filesize);
+    already_listed_entities_[hashPath(updated_entity.getPath())] = ListedEntity(updated_entity.attrs.mtime * 1000, updated_entity.attrs.filesize);
   }
 
   initial_listing_complete_ = true;
@@ -1086,47 +1260,11 @@ void ListSFTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context, c
     addConnectionToCache(connection_cache_key, std::move(client));
   };
 
-  std::deque<Child> directories;
-  std::vector<Child> files;
-
-  /* Add initial directory */
-  Child root;
-  std::tie(root.parent_path, root.filename) = utils::file::FileUtils::split_path(remote_path, true /*force_posix*/);
-  root.directory = true;
-  directories.emplace_back(std::move(root));
-
-  /* Process directories */
-  while (!directories.empty()) {
-    auto directory = std::move(directories.front());
-    directories.pop_front();
-
-    std::string new_parent_path;
-    if (directory.parent_path.empty()) {
-      new_parent_path = directory.filename;
-    } else {
-      new_parent_path = directory.getPath();
-    }
-    std::vector<std::tuple<std::string /* filename */, std::string /* longentry */, LIBSSH2_SFTP_ATTRIBUTES /* attrs */>> dir_children;
-    if (!client->listDirectory(new_parent_path, follow_symlink_, dir_children)) {
-      continue;
-    }
-    for (auto&& dir_child : dir_children) {
-      if (filter(new_parent_path, dir_child)) {
-        Child child(new_parent_path, std::move(dir_child));
-        if (child.directory) {
-          directories.emplace_back(std::move(child));
-        } else {
-          files.emplace_back(std::move(child));
-        }
-      }
-    }
-  }
-
   /* Process the files with the appropriate tracking strategy */
   if (listing_strategy_ == LISTING_STRATEGY_TRACKING_TIMESTAMPS) {
-    listByTrackingTimestamps(context, session, common_properties.hostname, common_properties.port, common_properties.username, remote_path, std::move(files));
+    listByTrackingTimestamps(context, session, *client, common_properties.hostname, common_properties.port, common_properties.username, remote_path);
   } else if (listing_strategy_ == LISTING_STRATEGY_TRACKING_ENTITIES) {
-    listByTrackingEntities(context, session, common_properties.hostname, common_properties.port, common_properties.username, remote_path, entity_tracking_time_window, std::move(files));
+    listByTrackingEntities(context, session, *client, common_properties.hostname, common_properties.port, common_properties.username, remote_path, entity_tracking_time_window);
   } else {
     logger_->log_error("Unknown Listing Strategy: \"%s\"", listing_strategy_.c_str());
     context->yield();
@@ -22,6 +22,7 @@
 #include <map>
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <unordered_map>
 
 #include "SFTPProcessorBase.h"
@@ -82,6 +83,7 @@ class ListSFTP : public SFTPProcessorBase {
   static core::Property MinimumFileSize;
   static core::Property MaximumFileSize;
   static core::Property StateFile;
+  static core::Property ListingBatchSize;
 
   // Supported Relationships
   static core::Relationship Success;
@@ -120,6 +122,7 @@ class ListSFTP : public SFTPProcessorBase {
   uint64_t maximum_file_age_;
   uint64_t minimum_file_size_;
   uint64_t maximum_file_size_;
+  uint64_t listing_batch_size_;
 
   std::string last_listing_strategy_;
   std::string last_hostname_;
@@ -128,7 +131,7 @@ class ListSFTP : public SFTPProcessorBase {
 
   struct Child {
     Child();
-    Child(const std::string& parent_path_, std::tuple<std::string /* filename */, std::string /* longentry */, LIBSSH2_SFTP_ATTRIBUTES /* attrs */>&& sftp_child);
+    Child(const std::string& parent_path_, std::string&& filename_, const LIBSSH2_SFTP_ATTRIBUTES& attrs_);
     std::string getPath() const;
 
     bool directory;
@@ -147,7 +150,7 @@ class ListSFTP : public SFTPProcessorBase {
 
   bool initial_listing_complete_;
   std::string tracking_entities_state_filename_;
-  std::string tracking_entities_state_json_filename_;
+  std::string tracking_entities_state_index_filename_;
   struct ListedEntity {
     uint64_t timestamp;
     uint64_t size;
@@ -155,11 +158,22 @@ class ListSFTP : public SFTPProcessorBase {
     ListedEntity();
     ListedEntity(uint64_t timestamp, uint64_t size);
   };
-  std::unordered_map<std::string, ListedEntity> already_listed_entities_;
+  /*
+   * Already listed entities are keyed by the hash of their path instead of the path itself,
+   * so that tracking a directory with millions of entries stays compact both in memory and in the index file.
+   */
+  std::unordered_map<uint64_t /* path hash */, ListedEntity> already_listed_entities_;
 
   void invalidateCache();
 
-  bool filter(const std::string& parent_path, const std::tuple<std::string /* filename */, std::string /* longentry */, LIBSSH2_SFTP_ATTRIBUTES /* attrs */>& sftp_child);
+  /**
+   * Lists the remote path, recursing into subdirectories if needed. The files that pass the filters are
+   * passed to the callback as they are read from the server instead of being collected first.
+   * Returning false from the callback stops the listing.
+   */
+  void listFiles(utils::SFTPClient& client, const std::string& remote_path, const std::function<bool(Child&&)>& callback);
+
+  bool filter(const std::string& parent_path, const std::string& filename, const LIBSSH2_SFTP_ATTRIBUTES& attrs);
   bool filterFile(const std::string& parent_path, const std::string& filename, const LIBSSH2_SFTP_ATTRIBUTES& attrs);
   bool filterDirectory(const std::string& parent_path, const std::string& filename, const LIBSSH2_SFTP_ATTRIBUTES& attrs);
 
@@ -175,25 +189,27 @@ class ListSFTP : public SFTPProcessorBase {
 
   bool persistTrackingEntitiesCache(const std::string& hostname, const std::string& username, const std::string& remote_path);
   bool updateFromTrackingEntitiesCache(const std::string& hostname, const std::string& username, const std::string& remote_path);
+  bool updateFromTrackingEntitiesIndex(const std::string& index_filename);
+  bool updateFromTrackingEntitiesJson(const std::string& json_filename);
 
   void listByTrackingTimestamps(
       const std::shared_ptr<core::ProcessContext>& context,
       const std::shared_ptr<core::ProcessSession>& session,
+      utils::SFTPClient& client,
       const std::string& hostname,
       uint16_t port,
       const std::string& username,
-      const std::string& remote_path,
-      std::vector<Child>&& files);
+      const std::string& remote_path);
 
   void listByTrackingEntities(
       const std::shared_ptr<core::ProcessContext>& context,
       const std::shared_ptr<core::ProcessSession>& session,
+      utils::SFTPClient& client,
       const std::string& hostname,
       uint16_t port,
       const std::string& username,
       const std::string& remote_path,
-      uint64_t entity_tracking_time_window,
-      std::vector<Child>&& files);
+      uint64_t entity_tracking_time_window);
 };
 
 REGISTER_RESOURCE(ListSFTP, "Performs a listing of the files residing on an SFTP server. "
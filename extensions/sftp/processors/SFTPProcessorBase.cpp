@@ -251,8 +251,11 @@ bool SFTPProcessorBase::ConnectionCacheKey::operator==(const SFTPProcessorBase::
 std::unique_ptr<utils::SFTPClient> SFTPProcessorBase::getConnectionFromCache(const SFTPProcessorBase::ConnectionCacheKey& key) {
   std::lock_guard<std::mutex> lock(connections_mutex_);
 
-  auto it = connections_.find(key);
-  if (it == connections_.end()) {
+  // the most recently used connection is the least likely to have timed out
+  auto lru_it = std::find_if(lru_.begin(), lru_.end(), [&key](const ConnectionCache::iterator& it) {
+    return it->first == key;
+  });
+  if (lru_it == lru_.end()) {
     return nullptr;
   }
 
@@ -261,13 +264,8 @@ std::unique_ptr<utils::SFTPClient> SFTPProcessorBase::getConnectionFromCache(con
                      key.hostname,
                      key.port);
 
-  auto lru_it = std::find(lru_.begin(), lru_.end(), key);
-  if (lru_it == lru_.end()) {
-    logger_->log_trace("Assertion error: can't find key in LRU cache");
-  } else {
-    lru_.erase(lru_it);
-  }
-
+  auto it = *lru_it;
+  lru_.erase(lru_it);
   auto connection = std::move(it->second);
   connections_.erase(it);
   return connection;
@@ -277,12 +275,12 @@ void SFTPProcessorBase::addConnectionToCache(const SFTPProcessorBase::Connection
   std::lock_guard<std::mutex> lock(connections_mutex_);
 
   while (connections_.size() >= SFTPProcessorBase::CONNECTION_CACHE_MAX_SIZE) {
-    const auto& lru_key = lru_.back();
+    auto oldest = lru_.back();
     logger_->log_debug("SFTP connection pool is full, removing %s@%s:%hu",
-                       lru_key.username,
-                       lru_key.hostname,
-                       lru_key.port);
-    connections_.erase(lru_key);
+                       oldest->first.username,
+                       oldest->first.hostname,
+                       oldest->first.port);
+    connections_.erase(oldest);
     lru_.pop_back();
   }
 
@@ -290,8 +288,7 @@ void SFTPProcessorBase::addConnectionToCache(const SFTPProcessorBase::Connection
                      key.username,
                      key.hostname,
                      key.port);
-  connections_.emplace(key, std::move(connection));
-  lru_.push_front(key);
+  lru_.push_front(connections_.emplace(key, std::move(connection)));
   keepalive_cv_.notify_one();
 }
 
@@ -118,8 +118,11 @@ class SFTPProcessorBase : public core::Processor {
     bool operator==(const ConnectionCacheKey& other) const;
   };
   std::mutex connections_mutex_;
-  std::map<ConnectionCacheKey, std::unique_ptr<utils::SFTPClient>> connections_;
-  std::list<ConnectionCacheKey> lru_;
+  // Several connections may be cached for the same key, one for each concurrent task using it.
+  typedef std::multimap<ConnectionCacheKey, std::unique_ptr<utils::SFTPClient>> ConnectionCache;
+  ConnectionCache connections_;
+  // the cached connections, most recently used first
+  std::list<ConnectionCache::iterator> lru_;
   std::unique_ptr<utils::SFTPClient> getConnectionFromCache(const ConnectionCacheKey& key);
   void addConnectionToCache(const ConnectionCacheKey& key, std::unique_ptr<utils::SFTPClient>&& connection);
 
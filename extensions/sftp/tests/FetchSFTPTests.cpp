@@ -221,6 +221,23 @@ TEST_CASE_METHOD(FetchSFTPTestsFixture, "FetchSFTP fetch one file", "[FetchSFTP]
   REQUIRE(LogTestController::getInstance().contains("key:filename value:tstFile.ext"));
 }
 
+TEST_CASE_METHOD(FetchSFTPTestsFixture, "FetchSFTP fetch file larger than the transfer buffer", "[FetchSFTP][basic]") {
+  plan->setProperty(fetch_sftp, "Remote File", "nifi_test/tstFile.ext");
+
+  std::string content(2 * 1024 * 1024 + 12345, '\0');
+  for (size_t i = 0; i < content.size(); i++) {
+    content[i] = static_cast<char>('a' + i % 26);
+  }
+  createFile("nifi_test/tstFile.ext", content);
+
+  testController.runSession(plan, true);
+
+  testFile(IN_SOURCE, "nifi_test/tstFile.ext", content);
+  testFile(IN_DESTINATION, "nifi_test/tstFile.ext", content);
+
+  REQUIRE(LogTestController::getInstance().contains("from FetchSFTP to relationship success"));
+}
+
 TEST_CASE_METHOD(FetchSFTPTestsFixture, "FetchSFTP public key authentication", "[FetchSFTP][basic]") {
   plan->setProperty(fetch_sftp, "Remote File", "nifi_test/tstFile.ext");
   plan->setProperty(fetch_sftp, "Private Key Path", utils::file::FileUtils::concat_path(utils::file::FileUtils::get_executable_dir(), "resources/id_rsa"));
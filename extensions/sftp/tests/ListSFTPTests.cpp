@@ -621,6 +621,31 @@ TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Timestamps changed con
   REQUIRE(LogTestController::getInstance().contains("key:filename value:file2.ext"));
 }
 
+TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Timestamps Listing Batch Size", "[ListSFTP][tracking-timestamps]") {
+  plan->setProperty(list_sftp, "Listing Strategy", "Tracking Timestamps");
+  plan->setProperty(list_sftp, "Listing Batch Size", "2");
+
+  createFileWithModificationTimeDiff("nifi_test/file1.ext", "Test content 1", -300);
+  createFileWithModificationTimeDiff("nifi_test/file2.ext", "Test content 2", -290);
+  createFileWithModificationTimeDiff("nifi_test/file3.ext", "Test content 3", -280);
+
+  testController.runSession(plan, true);
+
+  REQUIRE(LogTestController::getInstance().contains("key:filename value:file1.ext"));
+  REQUIRE(LogTestController::getInstance().contains("key:filename value:file2.ext"));
+  REQUIRE(false == LogTestController::getInstance().contains("key:filename value:file3.ext"));
+  REQUIRE(LogTestController::getInstance().contains("Listing Batch Size (2) reached"));
+
+  plan->reset();
+  LogTestController::getInstance().resetStream(LogTestController::getInstance().log_output);
+
+  testController.runSession(plan, true);
+
+  REQUIRE(false == LogTestController::getInstance().contains("key:filename value:file1.ext"));
+  REQUIRE(false == LogTestController::getInstance().contains("key:filename value:file2.ext"));
+  REQUIRE(LogTestController::getInstance().contains("key:filename value:file3.ext"));
+}
+
 TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Entities one file", "[ListSFTP][tracking-entities]") {
   plan->setProperty(list_sftp, "Listing Strategy", "Tracking Entities");
 
@@ -798,6 +823,33 @@ TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Entities one file size
   REQUIRE(LogTestController::getInstance().contains("Skipping file \"nifi_test/file1.ext\" because it has not changed"));
 }
 
+TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Entities Listing Batch Size", "[ListSFTP][tracking-entities]") {
+  plan->setProperty(list_sftp, "Listing Strategy", "Tracking Entities");
+  plan->setProperty(list_sftp, "Listing Batch Size", "1");
+
+  createFileWithModificationTimeDiff("nifi_test/file1.ext", "Test content 1");
+  createFileWithModificationTimeDiff("nifi_test/file2.ext", "Test content 2");
+
+  testController.runSession(plan, true);
+
+  REQUIRE(LogTestController::getInstance().contains("from ListSFTP to relationship success"));
+  REQUIRE(LogTestController::getInstance().contains("Listing Batch Size (1) reached"));
+
+  plan->reset();
+  LogTestController::getInstance().resetStream(LogTestController::getInstance().log_output);
+
+  testController.runSession(plan, true);
+
+  REQUIRE(LogTestController::getInstance().contains("from ListSFTP to relationship success"));
+
+  plan->reset();
+  LogTestController::getInstance().resetStream(LogTestController::getInstance().log_output);
+
+  testController.runSession(plan, true);
+
+  REQUIRE(false == LogTestController::getInstance().contains("from ListSFTP to relationship success"));
+}
+
 TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Entities restore state", "[ListSFTP][tracking-entities]") {
   plan->setProperty(list_sftp, "Listing Strategy", "Tracking Entities");
 
@@ -823,6 +875,61 @@ TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Entities restore state
   REQUIRE(LogTestController::getInstance().contains("key:filename value:file2.ext"));
 }
 
+TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Entities restore json state", "[ListSFTP][tracking-entities]") {
+  plan->setProperty(list_sftp, "Listing Strategy", "Tracking Entities");
+
+  const uint64_t mtime = time(nullptr) - 300;
+  createFile("nifi_test/file1.ext", "Test content 1", mtime);
+  createFileWithModificationTimeDiff("nifi_test/file2.ext", "Test content 2", -240 /* 4 minutes ago */);
+
+  /* State written by earlier versions, keyed by full paths in a json file */
+  const std::string state_filename = std::string(src_dir) + "/state." + list_sftp->getUUIDStr() + ".TrackingEntities";
+  const std::string json_filename = state_filename + ".json";
+  {
+    std::ofstream json_file(json_filename);
+    json_file << "{\"nifi_test/file1.ext\": {\"timestamp\": " << mtime * 1000 << ", \"size\": 14}}";
+  }
+  {
+    std::ofstream state_file(state_filename);
+    state_file << "hostname=localhost\n";
+    state_file << "username=nifiuser\n";
+    state_file << "remote_path=nifi_test\n";
+    state_file << "json_state_file=" << json_filename << "\n";
+  }
+
+  testController.runSession(plan, true);
+
+  REQUIRE(LogTestController::getInstance().contains("Converted Tracking Entities state json file"));
+  REQUIRE(LogTestController::getInstance().contains("Successfully loaded Tracking Entities state file"));
+  REQUIRE(LogTestController::getInstance().contains("Skipping file \"nifi_test/file1.ext\" because it has not changed"));
+  REQUIRE(false == LogTestController::getInstance().contains("key:filename value:file1.ext"));
+  REQUIRE(LogTestController::getInstance().contains("key:filename value:file2.ext"));
+
+  /* The json file is replaced by the index, which the state file now references */
+  struct stat st;
+  REQUIRE(stat(json_filename.c_str(), &st) != 0);
+  REQUIRE(stat((state_filename + ".index").c_str(), &st) == 0);
+  std::ifstream state_file(state_filename);
+  std::string state((std::istreambuf_iterator<char>(state_file)), std::istreambuf_iterator<char>());
+  REQUIRE(state.find("index_state_file=" + state_filename + ".index") != std::string::npos);
+  REQUIRE(state.find("json_state_file") == std::string::npos);
+
+  /* A restart restores both entities from the index */
+  utils::Identifier list_sftp_uuid;
+  REQUIRE(true == list_sftp->getUUID(list_sftp_uuid));
+  createPlan(&list_sftp_uuid);
+  plan->setProperty(list_sftp, "Listing Strategy", "Tracking Entities");
+  LogTestController::getInstance().resetStream(LogTestController::getInstance().log_output);
+
+  testController.runSession(plan, true);
+
+  REQUIRE(LogTestController::getInstance().contains("Successfully loaded Tracking Entities state file"));
+  REQUIRE(false == LogTestController::getInstance().contains("Converted Tracking Entities state json file"));
+  REQUIRE(LogTestController::getInstance().contains("Skipping file \"nifi_test/file1.ext\" because it has not changed"));
+  REQUIRE(LogTestController::getInstance().contains("Skipping file \"nifi_test/file2.ext\" because it has not changed"));
+  REQUIRE(false == LogTestController::getInstance().contains("from ListSFTP to relationship success"));
+}
+
 TEST_CASE_METHOD(ListSFTPTestsFixture, "ListSFTP Tracking Entities restore state changed configuration", "[ListSFTP][tracking-entities]") {
   plan->setProperty(list_sftp, "Listing Strategy", "Tracking Entities");
 
@@ -230,6 +230,18 @@ TEST_CASE_METHOD(PutSFTPTestsFixture, "PutSFTP put two files", "[PutSFTP][basic]
   testFile("nifi_test/tstFile2.ext", "content 2");
 }
 
+TEST_CASE_METHOD(PutSFTPTestsFixture, "PutSFTP put file larger than the transfer buffer", "[PutSFTP][basic]") {
+  std::string content(2 * 1024 * 1024 + 12345, '\0');
+  for (size_t i = 0; i < content.size(); i++) {
+    content[i] = static_cast<char>('a' + i % 26);
+  }
+  createFile(src_dir, "tstFile.ext", content);
+
+  testController.runSession(plan, true);
+
+  testFile("nifi_test/tstFile.ext", content);
+}
+
 TEST_CASE_METHOD(PutSFTPTestsFixture, "PutSFTP bad password", "[PutSFTP][authentication]") {
   plan->setProperty(put, "Password", "badpassword");
   createFile(src_dir, "tstFile.ext", "tempFile");
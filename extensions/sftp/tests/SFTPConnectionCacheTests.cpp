@@ -0,0 +1,100 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "TestBase.h"
+#include "processors/FetchSFTP.h"
+
+namespace {
+
+// exposes the connection cache shared by the SFTP processors
+class ConnectionCacheTestProcessor : public processors::FetchSFTP {
+ public:
+  explicit ConnectionCacheTestProcessor(const std::string& name)
+      : FetchSFTP(name) {
+  }
+
+  using FetchSFTP::ConnectionCacheKey;
+  using FetchSFTP::CONNECTION_CACHE_MAX_SIZE;
+  using FetchSFTP::getConnectionFromCache;
+  using FetchSFTP::addConnectionToCache;
+};
+
+ConnectionCacheTestProcessor::ConnectionCacheKey createKey(const std::string& hostname) {
+  ConnectionCacheTestProcessor::ConnectionCacheKey key;
+  key.hostname = hostname;
+  key.port = 22;
+  key.username = "nifiuser";
+  key.proxy_type = processors::FetchSFTP::PROXY_TYPE_DIRECT;
+  key.proxy_port = 0;
+  return key;
+}
+
+// the cache does not use the connections, so they are not connected
+utils::SFTPClient* addConnection(ConnectionCacheTestProcessor& processor, const ConnectionCacheTestProcessor::ConnectionCacheKey& key) {
+  std::unique_ptr<utils::SFTPClient> connection(new utils::SFTPClient(key.hostname, key.port, key.username));
+  utils::SFTPClient* added = connection.get();
+  processor.addConnectionToCache(key, std::move(connection));
+  return added;
+}
+
+}  // namespace
+
+TEST_CASE("SFTP connection cache holds a connection for each concurrent task", "[SFTPConnectionCache]") {
+  ConnectionCacheTestProcessor processor("cache");
+  const auto key = createKey("localhost");
+
+  utils::SFTPClient* first = addConnection(processor, key);
+  utils::SFTPClient* second = addConnection(processor, key);
+
+  // the most recently cached connection is handed out first
+  auto taken_by_first_task = processor.getConnectionFromCache(key);
+  auto taken_by_second_task = processor.getConnectionFromCache(key);
+  REQUIRE(taken_by_first_task.get() == second);
+  REQUIRE(taken_by_second_task.get() == first);
+  REQUIRE(processor.getConnectionFromCache(key) == nullptr);
+  REQUIRE(processor.getConnectionFromCache(createKey("otherhost")) == nullptr);
+}
+
+TEST_CASE("SFTP connection cache evicts the least recently used connection", "[SFTPConnectionCache]") {
+  ConnectionCacheTestProcessor processor("cache");
+  const auto key = createKey("localhost");
+
+  addConnection(processor, key);
+  utils::SFTPClient* second = addConnection(processor, key);
+  auto taken = processor.getConnectionFromCache(key);
+  REQUIRE(taken.get() == second);
+  const auto other_key = createKey("otherhost");
+  utils::SFTPClient* other = addConnection(processor, other_key);
+  // returning a connection makes it the most recently used one, even though its key was cached first
+  processor.addConnectionToCache(key, std::move(taken));
+
+  // fill the cache
+  for (size_t i = 4; i <= ConnectionCacheTestProcessor::CONNECTION_CACHE_MAX_SIZE; i++) {
+    addConnection(processor, createKey("host" + std::to_string(i)));
+  }
+  // the first connection of key is evicted, not the one returned to the cache
+  addConnection(processor, createKey("newhost"));
+
+  REQUIRE(processor.getConnectionFromCache(key).get() == second);
+  REQUIRE(processor.getConnectionFromCache(key) == nullptr);
+  REQUIRE(processor.getConnectionFromCache(other_key).get() == other);
+}
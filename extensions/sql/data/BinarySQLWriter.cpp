@@ -0,0 +1,137 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BinarySQLWriter.h"
+
+#include <cstring>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sql {
+
+constexpr uint8_t BinarySQLWriter::NULL_VALUE;
+constexpr uint8_t BinarySQLWriter::STRING_VALUE;
+constexpr uint8_t BinarySQLWriter::DOUBLE_VALUE;
+constexpr uint8_t BinarySQLWriter::LONG_VALUE;
+constexpr uint8_t BinarySQLWriter::ULONG_VALUE;
+
+BinarySQLWriter::BinarySQLWriter()
+  : headerWritten_(false) {
+}
+
+BinarySQLWriter::~BinarySQLWriter() {}
+
+void BinarySQLWriter::beginOutput(const std::shared_ptr<io::BaseStream>& stream) {
+  buffer_.reset(stream);
+  columnNames_.clear();
+  headerWritten_ = false;
+}
+
+size_t BinarySQLWriter::endOutput() {
+  writeHeader();
+  buffer_.Flush();
+
+  return buffer_.getBytesWritten();
+}
+
+void BinarySQLWriter::beginProcessRow() {}
+
+void BinarySQLWriter::endProcessRow() {
+  writeHeader();
+}
+
+void BinarySQLWriter::processColumnName(const std::string& name) {
+  columnNames_.push_back(name);
+}
+
+void BinarySQLWriter::processColumn(const std::string& name, const std::string& value) {
+  writeType(STRING_VALUE);
+  writeString(value);
+}
+
+void BinarySQLWriter::processColumn(const std::string& name, double value) {
+  writeType(DOUBLE_VALUE);
+
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint8_t bytes[sizeof(bits)];
+  for (size_t i = 0; i < sizeof(bits); i++) {
+    bytes[i] = static_cast<uint8_t>(bits >> (8 * i));
+  }
+  buffer_.write(bytes, sizeof(bytes));
+}
+
+void BinarySQLWriter::processColumn(const std::string& name, int value) {
+  processColumn(name, static_cast<long long>(value));
+}
+
+void BinarySQLWriter::processColumn(const std::string& name, long long value) {
+  writeType(LONG_VALUE);
+  writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void BinarySQLWriter::processColumn(const std::string& name, unsigned long long value) {
+  writeType(ULONG_VALUE);
+  writeVarint(value);
+}
+
+void BinarySQLWriter::processColumn(const std::string& name, const char* value) {
+  writeType(NULL_VALUE);
+}
+
+void BinarySQLWriter::writeHeader() {
+  if (headerWritten_) {
+    return;
+  }
+
+  writeVarint(columnNames_.size());
+  for (const auto& name : columnNames_) {
+    writeString(name);
+  }
+  headerWritten_ = true;
+}
+
+void BinarySQLWriter::writeType(uint8_t type) {
+  // The column names of an output are known once the first row starts.
+  writeHeader();
+  buffer_.Put(static_cast<char>(type));
+}
+
+void BinarySQLWriter::writeVarint(uint64_t value) {
+  uint8_t bytes[10];
+  size_t size = 0;
+  while (value >= 0x80) {
+    bytes[size++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  bytes[size++] = static_cast<uint8_t>(value);
+  buffer_.write(bytes, size);
+}
+
+void BinarySQLWriter::writeString(const std::string& value) {
+  writeVarint(value.size());
+  buffer_.write(value.data(), value.size());
+}
+
+} /* namespace sql */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
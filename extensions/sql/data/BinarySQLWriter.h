@@ -0,0 +1,86 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SQLWriter.h"
+#include "StreamOutputBuffer.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sql {
+
+/**
+ * Purpose: Serializes rows into a compact binary encoding modelled on Avro's binary encoding.
+ *
+ * The output starts with the column count and the column names, followed by the rows. Each column
+ * value of a row is a type tag byte and the value:
+ *   NULL_VALUE     no value
+ *   STRING_VALUE   varint length and UTF-8 bytes
+ *   DOUBLE_VALUE   8 bytes of IEEE 754 double, little endian
+ *   LONG_VALUE     zig-zag encoded varint
+ *   ULONG_VALUE    varint
+ * Counts and lengths are unsigned LEB128 varints.
+ */
+class BinarySQLWriter: public SQLWriter {
+ public:
+  static constexpr uint8_t NULL_VALUE = 0;
+  static constexpr uint8_t STRING_VALUE = 1;
+  static constexpr uint8_t DOUBLE_VALUE = 2;
+  static constexpr uint8_t LONG_VALUE = 3;
+  static constexpr uint8_t ULONG_VALUE = 4;
+
+  BinarySQLWriter();
+  virtual ~BinarySQLWriter();
+
+  void beginOutput(const std::shared_ptr<io::BaseStream>& stream) override;
+  size_t endOutput() override;
+
+ private:
+  void beginProcessRow() override;
+  void endProcessRow() override;
+  void processColumnName(const std::string& name) override;
+  void processColumn(const std::string& name, const std::string& value) override;
+  void processColumn(const std::string& name, double value) override;
+  void processColumn(const std::string& name, int value) override;
+  void processColumn(const std::string& name, long long value) override;
+  void processColumn(const std::string& name, unsigned long long value) override;
+  void processColumn(const std::string& name, const char* value) override;
+
+  void writeHeader();
+  void writeType(uint8_t type);
+  void writeVarint(uint64_t value);
+  void writeString(const std::string& value);
+
+ private:
+  StreamOutputBuffer buffer_;
+  std::vector<std::string> columnNames_;
+  bool headerWritten_;
+};
+
+} /* namespace sql */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
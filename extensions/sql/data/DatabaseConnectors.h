@@ -20,6 +20,8 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <soci/soci.h>
 
@@ -55,6 +57,82 @@ class Statement {
   soci::session& session_;
 };
 
+/**
+ * Statement prepared once and executed for batches of rows. The positional '?' parameters of the query
+ * are bound to vectors of values, so that a batch is sent to the database in one bulk execution.
+ */
+class BatchStatement {
+ public:
+
+  explicit BatchStatement(soci::session& session, const std::string &query)
+    : statement_(session) {
+    size_t parameterCount = 0;
+    const auto sociQuery = utils::replacePositionalParameters(query, parameterCount);
+
+    values_.resize(parameterCount);
+    indicators_.resize(parameterCount);
+    for (size_t i = 0; i < parameterCount; i++) {
+      statement_.exchange(soci::use(values_[i], indicators_[i]));
+    }
+
+    statement_.alloc();
+    statement_.prepare(sociQuery);
+    statement_.define_and_bind();
+  }
+
+  virtual ~BatchStatement() {
+  }
+
+  size_t getParameterCount() const {
+    return values_.size();
+  }
+
+  /**
+   * Adds a row of parameter values, the first getParameterCount() values are bound.
+   */
+  void addRow(const std::vector<std::string>& values) {
+    for (size_t i = 0; i < values_.size(); i++) {
+      values_[i].push_back(values[i]);
+      indicators_[i].push_back(soci::i_ok);
+    }
+    rowCount_++;
+  }
+
+  /**
+   * Executes the statement for the rows added since the last execution.
+   */
+  void execute() {
+    if (rowCount_ == 0) {
+      return;
+    }
+
+    if (values_.empty()) {
+      // Nothing to bind in bulk, the statement runs once per row.
+      for (size_t i = 0; i < rowCount_; i++) {
+        statement_.execute(true);
+      }
+    } else {
+      statement_.execute(true);
+    }
+
+    clear();
+  }
+
+  void clear() {
+    for (size_t i = 0; i < values_.size(); i++) {
+      values_[i].clear();
+      indicators_[i].clear();
+    }
+    rowCount_ = 0;
+  }
+
+ protected:
+  soci::statement statement_;
+  std::vector<std::vector<std::string>> values_;
+  std::vector<std::vector<soci::indicator>> indicators_;
+  size_t rowCount_{};
+};
+
 class Session {
  public:
 
@@ -91,7 +169,35 @@ class Connection {
   }
   virtual bool connected(std::string& exception) const = 0;
   virtual std::unique_ptr<Statement> prepareStatement(const std::string &query) const = 0;
+  virtual std::unique_ptr<BatchStatement> prepareBatchStatement(const std::string &query) const = 0;
   virtual std::unique_ptr<Session> getSession() const = 0;
+
+  /**
+   * Provides a batch statement prepared on this connection, which is kept for later calls with the same query.
+   * The statement stays valid for the caller when the kept statements are discarded.
+   */
+  virtual std::shared_ptr<BatchStatement> getBatchStatement(const std::string &query) {
+    auto it = batchStatements_.find(query);
+    if (it == batchStatements_.end()) {
+      if (batchStatements_.size() >= MaxBatchStatements) {
+        batchStatements_.clear();
+      }
+      it = batchStatements_.emplace(query, prepareBatchStatement(query)).first;
+    }
+    return it->second;
+  }
+
+  /**
+   * Discards the batch statements kept by getBatchStatement, e.g. after a failed execution.
+   */
+  virtual void clearBatchStatements() {
+    batchStatements_.clear();
+  }
+
+ private:
+  static const size_t MaxBatchStatements = 100;
+
+  std::unordered_map<std::string, std::shared_ptr<BatchStatement>> batchStatements_;
 };
 
 } /* namespace sql */
@@ -18,9 +18,13 @@
 
 #pragma once
 
-#include "rapidjson/document.h"
+#include <memory>
+
+#include "rapidjson/writer.h"
+#include "rapidjson/prettywriter.h"
 
 #include "SQLWriter.h"
+#include "StreamOutputBuffer.h"
 
 namespace org {
 namespace apache {
@@ -33,7 +37,8 @@ class JSONSQLWriter: public SQLWriter {
   explicit JSONSQLWriter(bool pretty);
   virtual ~JSONSQLWriter();
 
-  std::string toString() override;
+  void beginOutput(const std::shared_ptr<io::BaseStream>& stream) override;
+  size_t endOutput() override;
 
 private:
   void beginProcessRow() override;
@@ -46,14 +51,20 @@ private:
   void processColumn(const std::string& name, unsigned long long value) override;
   void processColumn(const std::string& name, const char* value) override;
 
-  void addToJSONRow(const std::string& columnName, rapidjson::Value&& jsonValue);
-
-  rapidjson::Value toJSONString(const std::string& s);
+  template <typename Function>
+  void write(Function function) {
+    if (pretty_) {
+      function(prettyWriter_);
+    } else {
+      function(writer_);
+    }
+  }
 
  private:
   bool pretty_;
-  rapidjson::Document jsonPayload_;
-  rapidjson::Value jsonRow_;
+  StreamOutputBuffer buffer_;
+  rapidjson::Writer<StreamOutputBuffer> writer_;
+  rapidjson::PrettyWriter<StreamOutputBuffer> prettyWriter_;
 };
 
 } /* namespace sql */
@@ -37,6 +37,10 @@ class SQLRowsetProcessor
 
   size_t process(size_t max);
 
+  bool hasRows() const {
+    return iter_ != rowset_.end();
+  }
+
  private:
    void addRow(const soci::row& row, size_t rowCount);
 
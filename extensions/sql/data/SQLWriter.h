@@ -18,11 +18,10 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
-#include <iostream>
-
-#include <soci/soci.h>
 
+#include "io/BaseStream.h"
 #include "SQLRowSubscriber.h"
 
 namespace org {
@@ -33,7 +32,16 @@ namespace sql {
 
 struct SQLWriter: public SQLRowSubscriber
 {
-  virtual std::string toString() = 0;
+  /**
+   * Starts a new output, the rows processed until endOutput are serialized into the stream.
+   */
+  virtual void beginOutput(const std::shared_ptr<io::BaseStream>& stream) = 0;
+
+  /**
+   * Completes the output started by beginOutput.
+   * @return number of bytes written to the stream
+   */
+  virtual size_t endOutput() = 0;
 };
 
 
@@ -0,0 +1,106 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "io/BaseStream.h"
+#include "Exception.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sql {
+
+/**
+ * Purpose: Buffers serialized rows in front of a content stream, so that writers emit their
+ * output while the rowset is iterated instead of building the whole result in memory.
+ * Also usable as the output stream of rapidjson writers.
+ */
+class StreamOutputBuffer {
+ public:
+  typedef char Ch;
+
+  static constexpr size_t BUFFER_SIZE = 8 * 1024;
+
+  StreamOutputBuffer()
+    : bytes_written_(0) {
+    buffer_.reserve(BUFFER_SIZE);
+  }
+
+  void reset(const std::shared_ptr<io::BaseStream>& stream) {
+    stream_ = stream;
+    buffer_.clear();
+    bytes_written_ = 0;
+  }
+
+  void Put(Ch c) {
+    buffer_.push_back(static_cast<uint8_t>(c));
+    if (buffer_.size() >= BUFFER_SIZE) {
+      Flush();
+    }
+  }
+
+  void write(const void* data, size_t size) {
+    if (buffer_.size() + size > BUFFER_SIZE) {
+      Flush();
+    }
+    if (size >= BUFFER_SIZE) {
+      writeToStream(static_cast<const uint8_t*>(data), size);
+      return;
+    }
+    const auto bytes = static_cast<const uint8_t*>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + size);
+  }
+
+  void Flush() {
+    if (buffer_.empty()) {
+      return;
+    }
+    writeToStream(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+
+  /**
+   * Provides the number of bytes written to the stream.
+   */
+  size_t getBytesWritten() const {
+    return bytes_written_;
+  }
+
+ private:
+  void writeToStream(const uint8_t* data, size_t size) {
+    if (!stream_ || stream_->write(const_cast<uint8_t*>(data), static_cast<int>(size)) != static_cast<int>(size)) {
+      throw minifi::Exception(PROCESSOR_EXCEPTION, "StreamOutputBuffer: cannot write to content stream.");
+    }
+    bytes_written_ += size;
+  }
+
+  std::shared_ptr<io::BaseStream> stream_;
+  std::vector<uint8_t> buffer_;
+  size_t bytes_written_;
+};
+
+} /* namespace sql */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -54,6 +54,29 @@ std::vector<std::string> inputStringToList(const std::string& str) {
   return ret;
 }
 
+std::string replacePositionalParameters(const std::string& query, size_t& parameterCount) {
+  std::string ret;
+  ret.reserve(query.size());
+
+  parameterCount = 0;
+  char quote = 0;
+  for (const auto c : query) {
+    if (quote) {
+      if (c == quote) {
+        quote = 0;
+      }
+    } else if (c == '\'' || c == '"') {
+      quote = c;
+    } else if (c == '?') {
+      ret += ":p" + std::to_string(++parameterCount);
+      continue;
+    }
+    ret += c;
+  }
+
+  return ret;
+}
+
 } /* namespace utils */
 } /* namespace minifi */
 } /* namespace nifi */
@@ -30,6 +30,12 @@ namespace utils {
 std::string toLower(const std::string& str);
 std::vector<std::string> inputStringToList(const std::string& str);
 
+/**
+ * Replaces the positional '?' parameters of a query, outside of quoted literals, with soci placeholders.
+ * @param parameterCount number of parameters found
+ */
+std::string replacePositionalParameters(const std::string& query, size_t& parameterCount);
+
 
 } /* namespace utils */
 } /* namespace minifi */
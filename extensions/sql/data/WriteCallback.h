@@ -18,29 +18,41 @@
 
 #pragma once
 
-#include <string>
+#include <memory>
 
 #include "FlowFileRecord.h"
+#include "SQLRowsetProcessor.h"
+#include "SQLWriter.h"
 
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 
+/**
+ * Serializes the next rows of a rowset straight into the content of a FlowFile.
+ */
 class WriteCallback : public OutputStreamCallback {
 public:
-  explicit WriteCallback(const std::string& data)
-    : data_(data) {
+  WriteCallback(sql::SQLRowsetProcessor& rowsetProcessor, sql::SQLWriter& sqlWriter, size_t maxRows)
+    : rowsetProcessor_(rowsetProcessor), sqlWriter_(sqlWriter), maxRows_(maxRows) {
   }
 
- int64_t process(std::shared_ptr<io::BaseStream> stream) {
-    if (data_.empty())
-      return 0;
+  int64_t process(std::shared_ptr<io::BaseStream> stream) override {
+    sqlWriter_.beginOutput(stream);
+    rowCount_ = rowsetProcessor_.process(maxRows_);
+    return sqlWriter_.endOutput();
+  }
 
-    return stream->write(reinterpret_cast<uint8_t*>(const_cast<char*>(data_.c_str())), data_.size());
+  size_t getRowCount() const {
+    return rowCount_;
   }
 
- const std::string& data_;
+private:
+  sql::SQLRowsetProcessor& rowsetProcessor_;
+  sql::SQLWriter& sqlWriter_;
+  size_t maxRows_;
+  size_t rowCount_{};
 };
 
 } /* namespace minifi */
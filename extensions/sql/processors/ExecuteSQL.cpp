@@ -39,7 +39,6 @@
 #include "Exception.h"
 #include "utils/OsUtils.h"
 #include "data/DatabaseConnectors.h"
-#include "data/JSONSQLWriter.h"
 #include "data/SQLRowsetProcessor.h"
 #include "data/WriteCallback.h"
 
@@ -88,32 +87,27 @@ void ExecuteSQL::processOnSchedule(const core::ProcessContext &context) {
   context.getProperty(s_maxRowsPerFlowFile.getName(), max_rows_);
 }
 
-void ExecuteSQL::processOnTrigger(core::ProcessSession &session) {
-  auto statement = connection_->prepareStatement(sqlSelectQuery_);
+void ExecuteSQL::processOnTrigger(core::ProcessContext& /*context*/, core::ProcessSession &session, sql::Connection &connection) {
+  auto statement = connection.prepareStatement(sqlSelectQuery_);
 
   auto rowset = statement->execute();
 
-  int count = 0;
-  size_t rowCount = 0;
-  sql::JSONSQLWriter sqlWriter(isJSONPretty());
-  sql::SQLRowsetProcessor sqlRowsetProcessor(rowset, { &sqlWriter });
-
-  // Process rowset.
-  do {
-    rowCount = sqlRowsetProcessor.process(max_rows_ == 0 ? std::numeric_limits<size_t>::max() : max_rows_);
-    count++;
-    if (rowCount == 0)
-      break;
-
-    const auto output = sqlWriter.toString();
-    if (!output.empty()) {
-      WriteCallback writer(output);
-      auto newflow = session.create();
-      newflow->addAttribute(ResultRowCount, std::to_string(rowCount));
+  auto sqlWriter = createSQLWriter();
+  sql::SQLRowsetProcessor sqlRowsetProcessor(rowset, { sqlWriter.get() });
+
+  // Process rowset, the rows of each flow file are serialized into its content as they are fetched.
+  while (sqlRowsetProcessor.hasRows()) {
+    WriteCallback writer(sqlRowsetProcessor, *sqlWriter, max_rows_ == 0 ? std::numeric_limits<size_t>::max() : max_rows_);
+    auto newflow = session.create();
+    try {
       session.write(newflow, &writer);
-      session.transfer(newflow, s_success);
+    } catch (...) {
+      session.remove(newflow);
+      throw;
     }
-  } while (rowCount > 0);
+    newflow->addAttribute(ResultRowCount, std::to_string(writer.getRowCount()));
+    session.transfer(newflow, s_success);
+  }
 }
 
 } /* namespace processors */
@@ -17,6 +17,9 @@
 
 #include "OutputFormat.h"
 
+#include "data/BinarySQLWriter.h"
+#include "data/JSONSQLWriter.h"
+
 namespace org {
 namespace apache {
 namespace nifi {
@@ -25,14 +28,16 @@ namespace processors {
 
 const std::string s_outputFormatJSON = "JSON";
 const std::string s_outputFormatJSONPretty = "JSON-Pretty";
+const std::string s_outputFormatBinary = "Binary";
 
 const core::Property& OutputFormat::outputFormat() {
   static const core::Property s_outputFormat =
       core::PropertyBuilder::createProperty("Output Format")->
           isRequired(true)->
           withDefaultValue(s_outputFormatJSONPretty)->
-          withAllowableValues<std::string>({ s_outputFormatJSON, s_outputFormatJSONPretty })->
-          withDescription("Set the output format type.")->
+          withAllowableValues<std::string>({ s_outputFormatJSON, s_outputFormatJSONPretty, s_outputFormatBinary })->
+          withDescription("Set the output format type. "
+                          "Binary is a compact row encoding modelled on Avro's binary encoding: the column names followed by type tagged column values.")->
           build();
 
   return s_outputFormat;
@@ -46,6 +51,14 @@ bool OutputFormat::isJSONPretty() const {
   return outputFormat_ == s_outputFormatJSONPretty;
 }
 
+std::unique_ptr<sql::SQLWriter> OutputFormat::createSQLWriter() const {
+  if (outputFormat_ == s_outputFormatBinary) {
+    return std::make_unique<sql::BinarySQLWriter>();
+  }
+
+  return std::make_unique<sql::JSONSQLWriter>(isJSONPretty());
+}
+
 void OutputFormat::initOutputFormat(const core::ProcessContext& context) {
   context.getProperty(outputFormat().getName(), outputFormat_);
 }
@@ -23,8 +23,11 @@
 #include "core/Core.h"
 #include "core/Processor.h"
 
+#include <memory>
 #include <string>
 
+#include "data/SQLWriter.h"
+
 namespace org {
 namespace apache {
 namespace nifi {
@@ -39,6 +42,11 @@ class OutputFormat {
 
   bool isJSONPretty() const;
 
+  /**
+   * Creates the writer serializing result rows in the configured output format.
+   */
+  std::unique_ptr<sql::SQLWriter> createSQLWriter() const;
+
   void initOutputFormat(const core::ProcessContext& context);
 
  protected:
@@ -20,6 +20,7 @@
 
 #include "PutSQL.h"
 
+#include <algorithm>
 #include <vector>
 #include <queue>
 #include <map>
@@ -39,7 +40,6 @@
 #include "Exception.h"
 #include "utils/OsUtils.h"
 #include "data/DatabaseConnectors.h"
-#include "data/JSONSQLWriter.h"
 
 namespace org {
 namespace apache {
@@ -50,13 +50,62 @@ namespace processors {
 const std::string PutSQL::ProcessorName("PutSQL");
 
 const core::Property PutSQL::s_sqlStatements(
-  core::PropertyBuilder::createProperty("SQL statements")->isRequired(true)->withDefaultValue("System")->withDescription(
+  core::PropertyBuilder::createProperty("SQL statements")->isRequired(false)->withDescription(
     "A semicolon-delimited list of SQL statements to execute. The statement can be empty, a constant value, or built from attributes using Expression Language. "
     "If this property is specified, it will be used regardless of the content of incoming flowfiles. "
-    "If this property is empty, the content of the incoming flow file is expected to contain a valid SQL statements, to be issued by the processor to the database.")
+    "If this property is empty, the content of the incoming flow file is expected to contain a valid SQL statement, to be issued by the processor to the database. "
+    "Statements may contain '?' parameters, which are bound to the values of the 'sql.args.N.value' attributes of the incoming flow files, N starting from 1. "
+    "Expression Language is evaluated for each flow file. Consecutive flow files of a batch resulting in the same statements are executed together, "
+    "the statements being prepared once per connection. A batch of flow files is put to the database in one transaction. "
+    "If the processor has no incoming connection, the statements are executed on each trigger.")
     ->supportsExpressionLanguage(true)->build());
 
+const core::Property PutSQL::s_batchSize(
+  core::PropertyBuilder::createProperty("Batch Size")->isRequired(true)->withDefaultValue<uint64_t>(100)->withDescription(
+    "The maximum number of flow files to put to the database in a single transaction.")->build());
+
 const core::Relationship PutSQL::s_success("success", "Database is successfully updated.");
+const core::Relationship PutSQL::s_failure("failure", "Flow files whose statements could not be executed, or which miss parameter attributes.");
+
+namespace {
+
+class ReadCallback : public InputStreamCallback {
+ public:
+  explicit ReadCallback(std::string& content)
+    : content_(content) {
+  }
+
+  int64_t process(std::shared_ptr<io::BaseStream> stream) override {
+    content_.resize(stream->getSize());
+    if (content_.empty())
+      return 0;
+
+    const auto ret = stream->readData(reinterpret_cast<uint8_t*>(&content_[0]), static_cast<int>(content_.size()));
+    if (ret < 0)
+      return ret;
+    content_.resize(ret);
+    return ret;
+  }
+
+ private:
+  std::string& content_;
+};
+
+std::string argumentAttribute(size_t index) {
+  return "sql.args." + std::to_string(index) + ".value";
+}
+
+std::vector<std::string> splitStatements(const std::string& sqlStatements) {
+  std::vector<std::string> statements;
+  for (const auto& statement : utils::StringUtils::split(sqlStatements, ";")) {
+    if (!utils::StringUtils::trim(statement).empty()) {
+      statements.push_back(statement);
+    }
+  }
+  return statements;
+}
+
+}  // namespace
 
 PutSQL::PutSQL(const std::string& name, utils::Identifier uuid)
   : SQLProcessor(name, uuid) {
@@ -67,24 +116,52 @@ PutSQL::~PutSQL() {
 
 void PutSQL::initialize() {
   //! Set the supported properties
-  setSupportedProperties( { dbControllerService(), s_sqlStatements });
+  setSupportedProperties( { dbControllerService(), s_sqlStatements, s_batchSize });
 
   //! Set the supported relationships
-  setSupportedRelationships( { s_success });
+  setSupportedRelationships( { s_success, s_failure });
 }
 
 void PutSQL::processOnSchedule(const core::ProcessContext& context) {
   std::string sqlStatements;
   context.getProperty(s_sqlStatements.getName(), sqlStatements);
-  sqlStatements_ = utils::StringUtils::split(sqlStatements, ";");
+  hasSqlStatements_ = !utils::StringUtils::trim(sqlStatements).empty();
+
+  context.getProperty(s_batchSize.getName(), batchSize_);
+  if (batchSize_ == 0) {
+    batchSize_ = 1;
+  }
+}
+
+void PutSQL::processOnTrigger(core::ProcessContext& context, core::ProcessSession& session, sql::Connection& connection) {
+  if (!hasIncomingConnections()) {
+    executeStatements(context, connection);
+    return;
+  }
+
+  std::vector<std::shared_ptr<core::FlowFile>> flowFiles;
+  while (flowFiles.size() < batchSize_) {
+    auto flowFile = session.get();
+    if (!flowFile)
+      break;
+    flowFiles.push_back(flowFile);
+  }
+
+  if (flowFiles.empty())
+    return;
+
+  processFlowFiles(context, session, connection, flowFiles);
 }
 
-void PutSQL::processOnTrigger(core::ProcessSession& session) {
-  const auto dbSession = connection_->getSession();
+void PutSQL::executeStatements(core::ProcessContext& context, sql::Connection& connection) {
+  std::string sqlStatements;
+  context.getProperty(s_sqlStatements, sqlStatements, nullptr);
+
+  const auto dbSession = connection.getSession();
 
   try {
     dbSession->begin();
-    for (const auto& statement : sqlStatements_) {
+    for (const auto& statement : splitStatements(sqlStatements)) {
       dbSession->execute(statement);
     }
     dbSession->commit();
@@ -95,6 +172,88 @@ void PutSQL::processOnTrigger(core::ProcessSession& session) {
   }
 }
 
+void PutSQL::processFlowFiles(core::ProcessContext& context, core::ProcessSession& session, sql::Connection& connection, const std::vector<std::shared_ptr<core::FlowFile>>& flowFiles) {
+  const auto dbSession = connection.getSession();
+
+  std::vector<std::shared_ptr<core::FlowFile>> batch;
+  try {
+    dbSession->begin();
+
+    // Consecutive flow files with the same statements are executed together, which keeps the order of the statements.
+    // The statements are prepared once per pooled connection and kept by it.
+    std::vector<std::shared_ptr<sql::BatchStatement>> statements;
+    std::string statementsText;
+    for (const auto& flowFile : flowFiles) {
+      std::string text;
+      if (hasSqlStatements_) {
+        context.getProperty(s_sqlStatements, text, flowFile);
+      } else {
+        ReadCallback callback(text);
+        session.read(flowFile, &callback);
+      }
+
+      if (statements.empty() || text != statementsText) {
+        for (const auto& statement : statements) {
+          statement->execute();
+        }
+        statements.clear();
+        for (const auto& statement : hasSqlStatements_ ? splitStatements(text) : std::vector<std::string>{ text }) {
+          statements.push_back(connection.getBatchStatement(statement));
+        }
+        statementsText = text;
+      }
+
+      if (statements.empty()) {
+        logger_->log_error("Flow file %s has no SQL statement to execute", flowFile->getUUIDStr());
+        session.transfer(flowFile, s_failure);
+        continue;
+      }
+
+      size_t parameterCount = 0;
+      for (const auto& statement : statements) {
+        parameterCount = std::max(parameterCount, statement->getParameterCount());
+      }
+
+      std::vector<std::string> values(parameterCount);
+      bool missingParameter = false;
+      for (size_t i = 0; i < parameterCount; i++) {
+        if (!flowFile->getAttribute(argumentAttribute(i + 1), values[i])) {
+          logger_->log_error("Flow file %s has no '%s' attribute", flowFile->getUUIDStr(), argumentAttribute(i + 1));
+          missingParameter = true;
+          break;
+        }
+      }
+      if (missingParameter) {
+        session.transfer(flowFile, s_failure);
+        continue;
+      }
+
+      for (const auto& statement : statements) {
+        statement->addRow(values);
+      }
+      batch.push_back(flowFile);
+    }
+
+    for (const auto& statement : statements) {
+      statement->execute();
+    }
+
+    dbSession->commit();
+  } catch (std::exception& e) {
+    logger_->log_error("SQL statement error: %s", e.what());
+    connection.clearBatchStatements();
+    dbSession->rollback();
+    for (const auto& flowFile : batch) {
+      session.transfer(flowFile, s_failure);
+    }
+    throw;
+  }
+
+  for (const auto& flowFile : batch) {
+    session.transfer(flowFile, s_success);
+  }
+}
+
 } /* namespace processors */
 } /* namespace minifi */
 } /* namespace nifi */
@@ -28,7 +28,10 @@
 #include "services/DatabaseService.h"
 #include "SQLProcessor.h"
 
+#include <memory>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace org {
 namespace apache {
@@ -46,16 +49,25 @@ class PutSQL: public SQLProcessor<PutSQL> {
   static const std::string ProcessorName;
 
   void processOnSchedule(const core::ProcessContext &context);
-  void processOnTrigger(core::ProcessSession &session);
+  void processOnTrigger(core::ProcessContext &context, core::ProcessSession &session, sql::Connection &connection);
   
   void initialize() override;
 
   static const core::Property s_sqlStatements;
+  static const core::Property s_batchSize;
 
   static const core::Relationship s_success;
+  static const core::Relationship s_failure;
 
  private:
-   std::vector<std::string> sqlStatements_;
+   void executeStatements(core::ProcessContext& context, sql::Connection& connection);
+
+   void processFlowFiles(core::ProcessContext& context, core::ProcessSession& session, sql::Connection& connection, const std::vector<std::shared_ptr<core::FlowFile>>& flowFiles);
+
+ private:
+   // whether the statements come from the 'SQL statements' property rather than from the flow file content
+   bool hasSqlStatements_{};
+   uint64_t batchSize_{};
 };
 
 REGISTER_RESOURCE(PutSQL, "PutSQL to execute SQL command via ODBC.");
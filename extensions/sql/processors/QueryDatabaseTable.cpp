@@ -41,7 +41,6 @@
 #include "Exception.h"
 #include "utils/OsUtils.h"
 #include "data/DatabaseConnectors.h"
-#include "data/JSONSQLWriter.h"
 #include "data/SQLRowsetProcessor.h"
 #include "data/WriteCallback.h"
 #include "data/MaxCollector.h"
@@ -366,38 +365,36 @@ void QueryDatabaseTable::processOnSchedule(const core::ProcessContext &context)
   }
 }
 
-void QueryDatabaseTable::processOnTrigger(core::ProcessSession &session) {
+void QueryDatabaseTable::processOnTrigger(core::ProcessContext& /*context*/, core::ProcessSession &session, sql::Connection &connection) {
+  // The maximum values tracked in the state are updated by one task at a time.
+  std::lock_guard<std::mutex> lock(stateMutex_);
+
   const auto& selectQuery = getSelectQuery();
 
   logger_->log_info("QueryDatabaseTable: selectQuery: '%s'", selectQuery.c_str());
 
-  auto statement = connection_->prepareStatement(selectQuery);
+  auto statement = connection.prepareStatement(selectQuery);
 
   auto rowset = statement->execute();
 
-  int count = 0;
-  size_t rowCount = 0;
   sql::MaxCollector maxCollector(selectQuery, maxValueColumnNames_, mapState_);
-  sql::JSONSQLWriter sqlWriter(isJSONPretty());
-  sql::SQLRowsetProcessor sqlRowsetProcessor(rowset, {&sqlWriter, &maxCollector});
-
-  // Process rowset.
-  do {
-    rowCount = sqlRowsetProcessor.process(maxRowsPerFlowFile_ == 0 ? std::numeric_limits<size_t>::max() : maxRowsPerFlowFile_);
-    count++;
-    if (rowCount == 0)
-      break;
-
-    const auto output = sqlWriter.toString();
-    if (!output.empty()) {
-      WriteCallback writer(output);
-      auto newflow = session.create();
-      newflow->addAttribute(ResultRowCount, std::to_string(rowCount));
-      newflow->addAttribute(ResultTableName, tableName_);
+  auto sqlWriter = createSQLWriter();
+  sql::SQLRowsetProcessor sqlRowsetProcessor(rowset, {sqlWriter.get(), &maxCollector});
+
+  // Process rowset, the rows of each flow file are serialized into its content as they are fetched.
+  while (sqlRowsetProcessor.hasRows()) {
+    WriteCallback writer(sqlRowsetProcessor, *sqlWriter, maxRowsPerFlowFile_ == 0 ? std::numeric_limits<size_t>::max() : maxRowsPerFlowFile_);
+    auto newflow = session.create();
+    try {
       session.write(newflow, &writer);
-      session.transfer(newflow, s_success);
+    } catch (...) {
+      session.remove(newflow);
+      throw;
     }
-  } while (rowCount > 0);
+    newflow->addAttribute(ResultRowCount, std::to_string(writer.getRowCount()));
+    newflow->addAttribute(ResultTableName, tableName_);
+    session.transfer(newflow, s_success);
+  }
 
   const auto mapState = mapState_;
   if (maxCollector.updateMapState()) {
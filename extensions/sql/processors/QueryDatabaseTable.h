@@ -29,6 +29,7 @@
 #include "SQLProcessor.h"
 #include "OutputFormat.h"
 
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 
@@ -66,7 +67,7 @@ class QueryDatabaseTable: public SQLProcessor<QueryDatabaseTable>, public Output
   }
 
   void processOnSchedule(const core::ProcessContext& context);
-  void processOnTrigger(core::ProcessSession& session);
+  void processOnTrigger(core::ProcessContext& context, core::ProcessSession& session, sql::Connection& connection);
   
   void initialize() override;
 
@@ -84,6 +85,7 @@ class QueryDatabaseTable: public SQLProcessor<QueryDatabaseTable>, public Output
   std::unordered_map<std::string, std::string> mapState_;
   std::unordered_map<std::string, soci::data_type> mapColumnType_;
   std::unique_ptr<State> pState_;
+  std::mutex stateMutex_;
 };
 
 REGISTER_RESOURCE(QueryDatabaseTable, "QueryDatabaseTable to execute SELECT statement via ODBC.");
@@ -51,35 +51,24 @@ class SQLProcessor: public core::Processor {
   }
 
   void onTrigger(const std::shared_ptr<core::ProcessContext>& context, const std::shared_ptr<core::ProcessSession>& session) override {
-    std::unique_lock<std::mutex> lock(onTriggerMutex_, std::try_to_lock);
-    if (!lock.owns_lock()) {
-      logger_->log_warn("'onTrigger' is called before previous 'onTrigger' call is finished.");
-      context->yield();
-      return;
-    }
-
+    // Each trigger leases its own connection from the pool of the service, so that concurrent tasks run in parallel.
+    std::unique_ptr<sql::Connection> connection;
     try {
-      if (!connection_) {
-        connection_ = dbService_->getConnection();
-      }
-      static_cast<T*>(this)->processOnTrigger(*session);
+      connection = dbService_->getConnection();
+      static_cast<T*>(this)->processOnTrigger(*context, *session, *connection);
     } catch (std::exception& e) {
       logger_->log_error("SQLProcessor: '%s'", e.what());
-      if (connection_) {
+      if (connection) {
         std::string exp;
-        if (!connection_->connected(exp)) {
+        if (!connection->connected(exp)) {
+          // The lease closes the connection instead of returning it to the pool.
           logger_->log_error("SQLProcessor: Connection exception: %s", exp.c_str());
-          connection_.reset();
         }
       }
       context->yield();
     }
   }
 
-  void notifyStop() override {
-    connection_.reset();
-  }
-
  protected:
    static const core::Property& dbControllerService() {
      static const core::Property s_dbControllerService = 
@@ -93,8 +82,6 @@ class SQLProcessor: public core::Processor {
 
    std::shared_ptr<logging::Logger> logger_;
    std::shared_ptr<sql::controllers::DatabaseService> dbService_;
-   std::unique_ptr<sql::Connection> connection_;
-   std::mutex onTriggerMutex_;
 };
 
 } /* namespace processors */
@@ -0,0 +1,159 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConnectionPool.h"
+
+#include "Exception.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sql {
+namespace controllers {
+
+ConnectionPool::ConnectionPool(ConnectionFactory factory, size_t minIdle, size_t maxSize, std::chrono::milliseconds maxIdleTime, bool validateOnBorrow)
+  : factory_(std::move(factory)),
+    min_idle_(minIdle),
+    max_size_(maxSize > 0 ? maxSize : 1),
+    max_idle_time_(maxIdleTime),
+    validate_on_borrow_(validateOnBorrow),
+    size_(0),
+    running_(true),
+    logger_(logging::LoggerFactory<ConnectionPool>::getLogger()) {
+  evictor_ = std::thread(&ConnectionPool::runEvictor, this);
+}
+
+ConnectionPool::~ConnectionPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  evictor_wakeup_.notify_one();
+  evictor_.join();
+}
+
+std::unique_ptr<sql::Connection> ConnectionPool::borrow(std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (!idle_.empty()) {
+      auto connection = std::move(idle_.back().connection);
+      idle_.pop_back();
+      lock.unlock();
+
+      std::string exception;
+      if (validate_on_borrow_ && !connection->connected(exception)) {
+        logger_->log_warn("Closing invalid pooled connection: %s", exception);
+        connection.reset();
+        lock.lock();
+        size_--;
+        available_.notify_one();
+        continue;
+      }
+      return std::unique_ptr<sql::Connection>(new PooledConnection(std::move(connection), shared_from_this()));
+    }
+
+    if (size_ < max_size_) {
+      size_++;
+      lock.unlock();
+
+      std::unique_ptr<sql::Connection> connection;
+      try {
+        connection = factory_();
+      } catch (...) {
+        lock.lock();
+        size_--;
+        available_.notify_one();
+        throw;
+      }
+      logger_->log_debug("Opened pooled connection, %zu connections are open", getSize());
+      return std::unique_ptr<sql::Connection>(new PooledConnection(std::move(connection), shared_from_this()));
+    }
+
+    if (available_.wait_until(lock, deadline) == std::cv_status::timeout && idle_.empty() && size_ >= max_size_) {
+      throw minifi::Exception(PROCESSOR_EXCEPTION, "Timed out waiting for a pooled database connection, all " + std::to_string(max_size_) + " connections are in use");
+    }
+  }
+}
+
+size_t ConnectionPool::getSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+size_t ConnectionPool::getIdleCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return idle_.size();
+}
+
+void ConnectionPool::release(std::unique_ptr<sql::Connection> connection, bool broken) {
+  if (broken) {
+    connection.reset();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (connection) {
+    idle_.push_back({ std::move(connection), std::chrono::steady_clock::now() });
+    if (idle_.size() > min_idle_) {
+      evictor_wakeup_.notify_one();
+    }
+  } else {
+    size_--;
+  }
+  available_.notify_one();
+}
+
+std::vector<std::unique_ptr<sql::Connection>> ConnectionPool::evictIdleConnections() {
+  std::vector<std::unique_ptr<sql::Connection>> expired;
+  const auto now = std::chrono::steady_clock::now();
+  while (idle_.size() > min_idle_ && now - idle_.front().since >= max_idle_time_) {
+    expired.push_back(std::move(idle_.front().connection));
+    idle_.pop_front();
+    size_--;
+  }
+  return expired;
+}
+
+void ConnectionPool::runEvictor() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    auto expired = evictIdleConnections();
+    if (!expired.empty()) {
+      lock.unlock();
+      logger_->log_debug("Closing %zu idle pooled connections", expired.size());
+      expired.clear();
+      lock.lock();
+      continue;
+    }
+
+    if (idle_.size() > min_idle_) {
+      evictor_wakeup_.wait_until(lock, idle_.front().since + max_idle_time_);
+    } else {
+      evictor_wakeup_.wait(lock);
+    }
+  }
+}
+
+} /* namespace controllers */
+} /* namespace sql */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,160 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/logging/LoggerConfiguration.h"
+#include "data/DatabaseConnectors.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sql {
+namespace controllers {
+
+/**
+ * Purpose: Bounded, thread safe pool of database connections shared by the processors using a DatabaseService.
+ *
+ * Connections are leased by borrow and return to the pool when the lease is destroyed. Idle connections
+ * beyond the minimum count are closed by a background thread once they have been idle for longer than
+ * the maximum idle time, so that they are closed even when the pool is not used any more.
+ */
+class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
+ public:
+  using ConnectionFactory = std::function<std::unique_ptr<sql::Connection>()>;
+
+  ConnectionPool(ConnectionFactory factory, size_t minIdle, size_t maxSize, std::chrono::milliseconds maxIdleTime, bool validateOnBorrow);
+
+  ~ConnectionPool();
+
+  /**
+   * Leases a connection, creating one if none is idle and the pool is not full.
+   * Idle connections are validated before being handed out when validation on borrow is enabled.
+   * @param timeout how long to wait for a connection while the pool is full
+   * @return lease of the connection, which is returned to the pool when destroyed
+   */
+  std::unique_ptr<sql::Connection> borrow(std::chrono::milliseconds timeout);
+
+  /**
+   * Provides the number of open connections, either idle or leased.
+   */
+  size_t getSize() const;
+
+  size_t getIdleCount() const;
+
+ private:
+  friend class PooledConnection;
+
+  struct IdleConnection {
+    std::unique_ptr<sql::Connection> connection;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  void release(std::unique_ptr<sql::Connection> connection, bool broken);
+
+  /**
+   * Removes the connections idle for longer than the maximum idle time, which the caller closes once the lock is released.
+   */
+  std::vector<std::unique_ptr<sql::Connection>> evictIdleConnections();
+
+  void runEvictor();
+
+  const ConnectionFactory factory_;
+  const size_t min_idle_;
+  const size_t max_size_;
+  const std::chrono::milliseconds max_idle_time_;
+  const bool validate_on_borrow_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable available_;
+  // most recently released connections are at the back
+  std::deque<IdleConnection> idle_;
+  // idle and leased connections, including the ones being opened
+  size_t size_;
+
+  std::condition_variable evictor_wakeup_;
+  bool running_;
+  std::thread evictor_;
+
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+/**
+ * Lease of a pooled connection. A connection found disconnected by connected() is closed instead of being returned to the pool.
+ */
+class PooledConnection : public sql::Connection {
+ public:
+  PooledConnection(std::unique_ptr<sql::Connection> connection, const std::shared_ptr<ConnectionPool>& pool)
+    : connection_(std::move(connection)), pool_(pool) {
+  }
+
+  ~PooledConnection() override {
+    pool_->release(std::move(connection_), broken_);
+  }
+
+  bool connected(std::string& exception) const override {
+    const bool connected = connection_->connected(exception);
+    if (!connected) {
+      broken_ = true;
+    }
+    return connected;
+  }
+
+  std::unique_ptr<sql::Statement> prepareStatement(const std::string& query) const override {
+    return connection_->prepareStatement(query);
+  }
+
+  std::unique_ptr<sql::BatchStatement> prepareBatchStatement(const std::string& query) const override {
+    return connection_->prepareBatchStatement(query);
+  }
+
+  std::unique_ptr<sql::Session> getSession() const override {
+    return connection_->getSession();
+  }
+
+  std::shared_ptr<sql::BatchStatement> getBatchStatement(const std::string& query) override {
+    return connection_->getBatchStatement(query);
+  }
+
+  void clearBatchStatements() override {
+    connection_->clearBatchStatements();
+  }
+
+ private:
+  std::unique_ptr<sql::Connection> connection_;
+  std::shared_ptr<ConnectionPool> pool_;
+  mutable bool broken_{};
+};
+
+} /* namespace controllers */
+} /* namespace sql */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
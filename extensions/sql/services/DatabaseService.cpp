@@ -23,7 +23,7 @@
 #include <set>
 #include "core/Property.h"
 #include "DatabaseService.h"
-#include "DatabaseService.h"
+#include "Exception.h"
 #include "io/validation.h"
 #include "properties/Configure.h"
 
@@ -40,6 +40,26 @@ static core::Property MaxQueueSize;
 
 core::Property DatabaseService::ConnectionString(core::PropertyBuilder::createProperty("Connection String")->withDescription("Database Connection String")->isRequired(true)->build());
 
+core::Property DatabaseService::MaxPoolSize(
+    core::PropertyBuilder::createProperty("Max Pool Size")->withDescription("The maximum number of connections open at the same time, shared by the processors using the service.")
+        ->isRequired(true)->withDefaultValue<uint64_t>(8)->build());
+
+core::Property DatabaseService::MinIdleConnections(
+    core::PropertyBuilder::createProperty("Min Idle Connections")->withDescription("The number of idle connections kept open regardless of Max Idle Time.")
+        ->isRequired(true)->withDefaultValue<uint64_t>(1)->build());
+
+core::Property DatabaseService::MaxIdleTime(
+    core::PropertyBuilder::createProperty("Max Idle Time")->withDescription("Idle connections are closed after being unused for this long.")
+        ->isRequired(true)->withDefaultValue<core::TimePeriodValue>("5 min")->build());
+
+core::Property DatabaseService::MaxWaitTime(
+    core::PropertyBuilder::createProperty("Max Wait Time")->withDescription("How long a processor waits for a connection while all connections of the pool are in use.")
+        ->isRequired(true)->withDefaultValue<core::TimePeriodValue>("10 sec")->build());
+
+core::Property DatabaseService::ValidateOnBorrow(
+    core::PropertyBuilder::createProperty("Validate On Borrow")->withDescription("Whether idle connections are validated with a test query before being handed to a processor.")
+        ->isRequired(true)->withDefaultValue<bool>(true)->build());
+
 void DatabaseService::initialize() {
   std::lock_guard<std::recursive_mutex> lock(initialization_mutex_);
 
@@ -55,10 +75,46 @@ void DatabaseService::initialize() {
 
 void DatabaseService::onEnable() {
   getProperty(ConnectionString.getName(), connection_string_);
+
+  uint64_t maxPoolSize = 8;
+  getProperty(MaxPoolSize.getName(), maxPoolSize);
+  uint64_t minIdleConnections = 1;
+  getProperty(MinIdleConnections.getName(), minIdleConnections);
+  uint64_t maxIdleTime = 5 * 60 * 1000;
+  getProperty(MaxIdleTime.getName(), maxIdleTime);
+  uint64_t maxWaitTime = 10 * 1000;
+  getProperty(MaxWaitTime.getName(), maxWaitTime);
+  bool validateOnBorrow = true;
+  getProperty(ValidateOnBorrow.getName(), validateOnBorrow);
+
+  auto pool = std::make_shared<ConnectionPool>([this]() {
+    return createConnection();
+  }, minIdleConnections, maxPoolSize, std::chrono::milliseconds(maxIdleTime), validateOnBorrow);
+
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    max_wait_time_ = std::chrono::milliseconds(maxWaitTime);
+    pool_.swap(pool);
+  }
+  // the previous pool is closed here, outside the lock, unless connections leased from it are still in use
+}
+
+std::unique_ptr<sql::Connection> DatabaseService::getConnection() const {
+  std::shared_ptr<ConnectionPool> pool;
+  std::chrono::milliseconds maxWaitTime;
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    pool = pool_;
+    maxWaitTime = max_wait_time_;
+  }
+  if (!pool) {
+    throw minifi::Exception(PROCESSOR_EXCEPTION, "Database service " + getName() + " is not enabled");
+  }
+  return pool->borrow(maxWaitTime);
 }
 
 void DatabaseService::initializeProperties() {
-  setSupportedProperties( { ConnectionString });
+  setSupportedProperties( { ConnectionString, MaxPoolSize, MinIdleConnections, MaxIdleTime, MaxWaitTime, ValidateOnBorrow });
 }
 
 } /* namespace controllers */
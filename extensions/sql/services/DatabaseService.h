@@ -21,7 +21,9 @@
 #include "core/logging/LoggerConfiguration.h"
 #include "core/controller/ControllerService.h"
 #include "data/DatabaseConnectors.h"
+#include "ConnectionPool.h"
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include <soci/soci.h>
@@ -70,6 +72,11 @@ class DatabaseService : public core::controller::ControllerService {
    * Parameters needed.
    */
   static core::Property ConnectionString;
+  static core::Property MaxPoolSize;
+  static core::Property MinIdleConnections;
+  static core::Property MaxIdleTime;
+  static core::Property MaxWaitTime;
+  static core::Property ValidateOnBorrow;
 
   virtual void initialize() override;
 
@@ -87,10 +94,15 @@ class DatabaseService : public core::controller::ControllerService {
 
   virtual void onEnable() override;
 
-  virtual std::unique_ptr<sql::Connection> getConnection() const = 0;
+  /**
+   * Leases a connection from the pool of the service. The connection returns to the pool when the lease is destroyed.
+   */
+  std::unique_ptr<sql::Connection> getConnection() const;
 
  protected:
 
+  virtual std::unique_ptr<sql::Connection> createConnection() const = 0;
+
   void initializeProperties();
 
   // initialization mutex.
@@ -100,6 +112,13 @@ class DatabaseService : public core::controller::ControllerService {
 
   std::string connection_string_;
 
+  // guards the pool and the wait time, which are replaced when the service is enabled again
+  mutable std::mutex pool_mutex_;
+
+  std::shared_ptr<ConnectionPool> pool_;
+
+  std::chrono::milliseconds max_wait_time_{};
+
  private:
 
   std::shared_ptr<logging::Logger> logger_;
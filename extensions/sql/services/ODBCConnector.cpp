@@ -33,7 +33,7 @@ namespace minifi {
 namespace sql {
 namespace controllers {
 
-std::unique_ptr<sql::Connection> ODBCService::getConnection() const {
+std::unique_ptr<sql::Connection> ODBCService::createConnection() const {
   return std::unique_ptr<sql::Connection>(new ODBCConnection(connection_string_));
 }
 
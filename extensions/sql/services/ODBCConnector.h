@@ -66,6 +66,10 @@ class ODBCConnection : public sql::Connection {
     return std::make_unique<sql::Statement>(*session_, query);
   }
 
+  std::unique_ptr<sql::BatchStatement> prepareBatchStatement(const std::string& query) const override {
+    return std::make_unique<sql::BatchStatement>(*session_, query);
+  }
+
   std::unique_ptr<Session> getSession() const override {
     return std::make_unique<sql::Session>(*session_);
   }
@@ -111,7 +115,8 @@ class ODBCService : public DatabaseService {
     initialize();
   }
 
-  virtual std::unique_ptr<sql::Connection> getConnection() const override;
+ protected:
+  std::unique_ptr<sql::Connection> createConnection() const override;
 
  private:
   std::shared_ptr<logging::Logger> logger_;
@@ -0,0 +1,245 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "TestBase.h"
+#include "Exception.h"
+#include "services/ConnectionPool.h"
+
+namespace sql = org::apache::nifi::minifi::sql;
+using org::apache::nifi::minifi::sql::controllers::ConnectionPool;
+
+namespace {
+
+struct ConnectionCounters {
+  std::atomic<int> opened{0};
+  std::atomic<int> closed{0};
+  std::atomic<bool> valid{true};
+  std::function<void()> on_close;
+};
+
+class MockConnection : public sql::Connection {
+ public:
+  explicit MockConnection(ConnectionCounters& counters)
+    : counters_(counters) {
+    counters_.opened++;
+  }
+
+  ~MockConnection() override {
+    if (counters_.on_close) {
+      counters_.on_close();
+    }
+    counters_.closed++;
+  }
+
+  bool connected(std::string& exception) const override {
+    if (!counters_.valid) {
+      exception = "connection lost";
+      return false;
+    }
+    return true;
+  }
+
+  std::unique_ptr<sql::Statement> prepareStatement(const std::string&) const override {
+    return nullptr;
+  }
+
+  std::unique_ptr<sql::BatchStatement> prepareBatchStatement(const std::string&) const override {
+    return nullptr;
+  }
+
+  std::unique_ptr<sql::Session> getSession() const override {
+    return nullptr;
+  }
+
+ private:
+  ConnectionCounters& counters_;
+};
+
+std::shared_ptr<ConnectionPool> createPool(ConnectionCounters& counters, size_t minIdle, size_t maxSize, std::chrono::milliseconds maxIdleTime, bool validateOnBorrow = true) {
+  return std::make_shared<ConnectionPool>([&counters]() {
+    return std::unique_ptr<sql::Connection>(new MockConnection(counters));
+  }, minIdle, maxSize, maxIdleTime, validateOnBorrow);
+}
+
+bool waitFor(const std::function<bool()>& condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST_CASE("ConnectionPool reuses released connections", "[connectionPool]") {
+  ConnectionCounters counters;
+  auto pool = createPool(counters, 1, 2, std::chrono::minutes(5));
+
+  {
+    auto connection = pool->borrow(std::chrono::milliseconds(100));
+    REQUIRE(nullptr != connection);
+    REQUIRE(1 == pool->getSize());
+    REQUIRE(0 == pool->getIdleCount());
+  }
+  REQUIRE(1 == pool->getIdleCount());
+
+  auto connection = pool->borrow(std::chrono::milliseconds(100));
+  REQUIRE(1 == counters.opened);
+  REQUIRE(0 == counters.closed);
+}
+
+TEST_CASE("ConnectionPool does not open more than the maximum number of connections", "[connectionPool]") {
+  ConnectionCounters counters;
+  auto pool = createPool(counters, 1, 2, std::chrono::minutes(5));
+
+  auto first = pool->borrow(std::chrono::milliseconds(100));
+  auto second = pool->borrow(std::chrono::milliseconds(100));
+  REQUIRE(2 == pool->getSize());
+
+  const auto start = std::chrono::steady_clock::now();
+  REQUIRE_THROWS_AS(pool->borrow(std::chrono::milliseconds(200)), org::apache::nifi::minifi::Exception);
+  REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(200));
+  REQUIRE(2 == counters.opened);
+  REQUIRE(2 == pool->getSize());
+}
+
+TEST_CASE("ConnectionPool borrow waits for a connection to be released", "[connectionPool]") {
+  ConnectionCounters counters;
+  auto pool = createPool(counters, 1, 1, std::chrono::minutes(5));
+
+  auto connection = pool->borrow(std::chrono::milliseconds(100));
+
+  std::atomic<bool> borrowed{false};
+  std::thread waiter([&pool, &borrowed]() {
+    auto waiting = pool->borrow(std::chrono::seconds(10));
+    borrowed = nullptr != waiting;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  REQUIRE_FALSE(borrowed);
+
+  connection.reset();
+  waiter.join();
+  REQUIRE(borrowed);
+  REQUIRE(1 == counters.opened);
+  REQUIRE(1 == pool->getSize());
+}
+
+TEST_CASE("ConnectionPool replaces connections failing validation", "[connectionPool]") {
+  ConnectionCounters counters;
+  auto pool = createPool(counters, 1, 1, std::chrono::minutes(5));
+
+  pool->borrow(std::chrono::milliseconds(100));
+  REQUIRE(1 == pool->getIdleCount());
+
+  counters.valid = false;
+  auto connection = pool->borrow(std::chrono::milliseconds(100));
+  REQUIRE(nullptr != connection);
+  REQUIRE(2 == counters.opened);
+  REQUIRE(1 == counters.closed);
+  REQUIRE(1 == pool->getSize());
+  REQUIRE(0 == pool->getIdleCount());
+}
+
+TEST_CASE("ConnectionPool hands the slot of a broken connection to a waiting borrower", "[connectionPool]") {
+  ConnectionCounters counters;
+  auto pool = createPool(counters, 1, 1, std::chrono::minutes(5));
+
+  auto connection = pool->borrow(std::chrono::milliseconds(100));
+  std::string exception;
+  counters.valid = false;
+  // the connection is found broken, so it is closed on release instead of returning to the pool
+  REQUIRE_FALSE(connection->connected(exception));
+
+  std::atomic<bool> borrowed{false};
+  std::thread waiter([&pool, &borrowed]() {
+    auto waiting = pool->borrow(std::chrono::seconds(10));
+    borrowed = nullptr != waiting;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  connection.reset();
+  waiter.join();
+  REQUIRE(borrowed);
+  REQUIRE(2 == counters.opened);
+  REQUIRE(1 == counters.closed);
+  REQUIRE(1 == pool->getSize());
+}
+
+TEST_CASE("ConnectionPool closes idle connections without further use of the pool", "[connectionPool]") {
+  ConnectionCounters counters;
+  auto pool = createPool(counters, 1, 3, std::chrono::milliseconds(100));
+
+  {
+    auto first = pool->borrow(std::chrono::milliseconds(100));
+    auto second = pool->borrow(std::chrono::milliseconds(100));
+    auto third = pool->borrow(std::chrono::milliseconds(100));
+  }
+  REQUIRE(3 == pool->getIdleCount());
+
+  const bool evicted = waitFor([&pool]() { return 1 == pool->getSize(); });
+  REQUIRE(evicted);
+  REQUIRE(1 == pool->getIdleCount());
+  REQUIRE(2 == counters.closed);
+
+  // the minimum number of idle connections stays open
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  REQUIRE(1 == pool->getSize());
+  REQUIRE(2 == counters.closed);
+}
+
+TEST_CASE("ConnectionPool closes connections without holding its lock", "[connectionPool]") {
+  ConnectionCounters counters;
+  std::atomic<int> sizeSeenOnClose{-1};
+  std::shared_ptr<ConnectionPool> pool;
+
+  // closing a connection may take long, so the pool must stay usable meanwhile; closing under the lock would deadlock here
+  counters.on_close = [&pool, &sizeSeenOnClose]() {
+    sizeSeenOnClose = static_cast<int>(pool->getSize());
+  };
+
+  SECTION("Idle connection evicted") {
+    pool = createPool(counters, 0, 2, std::chrono::milliseconds(50));
+    pool->borrow(std::chrono::milliseconds(100));
+    const bool closed = waitFor([&counters]() { return 1 == counters.closed; });
+    REQUIRE(closed);
+    REQUIRE(0 == sizeSeenOnClose);
+  }
+
+  SECTION("Invalid connection found on borrow") {
+    pool = createPool(counters, 0, 2, std::chrono::minutes(5));
+    pool->borrow(std::chrono::milliseconds(100));
+    counters.valid = false;
+    auto connection = pool->borrow(std::chrono::milliseconds(100));
+    REQUIRE(1 == counters.closed);
+    REQUIRE(1 == sizeSeenOnClose);
+  }
+
+  counters.on_close = nullptr;
+  pool.reset();
+}
@@ -0,0 +1,235 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SQLiteTestDatabase.h"
+#include "GenerateFlowFile.h"
+#include "LogAttribute.h"
+#include "processors/PutSQL.h"
+
+using org::apache::nifi::minifi::processors::PutSQL;
+
+namespace {
+
+struct TestFlowFile {
+  std::string content;
+  std::map<std::string, std::string> attributes;
+};
+
+/**
+ * Flow of a generator feeding PutSQL, whose success or failure relationship leads to a processor counting the flow files.
+ */
+class PutSQLTestFlow {
+ public:
+  PutSQLTestFlow(TestController& testController, const SQLiteTestDatabase& database, const core::Relationship& checked) {
+    plan_ = testController.createPlan();
+    addDatabaseService(*plan_, database);
+    plan_->addProcessor("GenerateFlowFile", "generate", processors::GenerateFlowFile::Success);
+    putSQL_ = plan_->addProcessor("PutSQL", "putsql", processors::GenerateFlowFile::Success, true);
+    putSQL_->setAutoTerminatedRelationships({ checked.getName() == PutSQL::s_success.getName() ? PutSQL::s_failure : PutSQL::s_success });
+    plan_->addProcessor("LogAttribute", "check", checked, true);
+    plan_->setProperty(putSQL_, "DB Controller Service", "ODBCService");
+  }
+
+  void setProperty(const std::string& name, const std::string& value) {
+    plan_->setProperty(putSQL_, name, value);
+  }
+
+  void enqueue(const std::vector<TestFlowFile>& flowFiles) {
+    plan_->runNextProcessor([&flowFiles](const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession> session) {
+      for (const auto& testFlowFile : flowFiles) {
+        auto flowFile = session->create();
+        StringOutputCallback callback(testFlowFile.content);
+        session->write(flowFile, &callback);
+        for (const auto& attribute : testFlowFile.attributes) {
+          flowFile->addAttribute(attribute.first, attribute.second);
+        }
+        session->transfer(flowFile, processors::GenerateFlowFile::Success);
+      }
+    });
+  }
+
+  void runPutSQL() {
+    plan_->runNextProcessor();
+  }
+
+  void runPutSQLAgain() {
+    plan_->runCurrentProcessor();
+  }
+
+  size_t countChecked() {
+    return collectFlowFiles(*plan_).size();
+  }
+
+ private:
+  std::shared_ptr<TestPlan> plan_;
+  std::shared_ptr<core::Processor> putSQL_;
+};
+
+TestFlowFile parameters(int id, const std::string& name) {
+  return { "", { { "sql.args.1.value", std::to_string(id) }, { "sql.args.2.value", name } } };
+}
+
+std::vector<std::string> names(size_t count, size_t first = 0) {
+  std::vector<std::string> result;
+  for (size_t i = first; i < first + count; i++) {
+    result.push_back("name" + std::to_string(i));
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST_CASE("PutSQL binds the sql.args attributes to positional parameters", "[putsql]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<PutSQL>();
+  char format[] = "/tmp/gt.XXXXXX";
+  SQLiteTestDatabase database(testController.createTempDirectory(format));
+  database.execute("create table test_table (id integer primary key, name text)");
+
+  PutSQLTestFlow flow(testController, database, PutSQL::s_success);
+  flow.setProperty("SQL statements", "insert into test_table (id, name) values (?, ?)");
+
+  std::vector<TestFlowFile> flowFiles;
+  for (int i = 0; i < 20; i++) {
+    flowFiles.push_back(parameters(i, "name" + std::to_string(i)));
+  }
+  flow.enqueue(flowFiles);
+  flow.runPutSQL();
+
+  REQUIRE(database.queryColumn("select name from test_table order by id") == names(20));
+  REQUIRE(20 == flow.countChecked());
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("PutSQL puts more flow files than the batch size in several transactions", "[putsql]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  SQLiteTestDatabase database(testController.createTempDirectory(format));
+  database.execute("create table test_table (id integer primary key, name text)");
+
+  PutSQLTestFlow flow(testController, database, PutSQL::s_success);
+  flow.setProperty("SQL statements", "insert into test_table (id, name) values (?, ?)");
+
+  std::vector<TestFlowFile> flowFiles;
+  for (int i = 0; i < 150; i++) {
+    flowFiles.push_back(parameters(i, "name" + std::to_string(i)));
+  }
+  flow.enqueue(flowFiles);
+
+  // the default batch size is 100
+  flow.runPutSQL();
+  REQUIRE(database.queryColumn("select name from test_table order by id") == names(100));
+
+  flow.runPutSQLAgain();
+  REQUIRE(database.queryColumn("select name from test_table order by id") == names(150));
+  REQUIRE(150 == flow.countChecked());
+}
+
+TEST_CASE("PutSQL executes the statements of the flow file content", "[putsql]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  SQLiteTestDatabase database(testController.createTempDirectory(format));
+  database.execute("create table test_table (id integer primary key, name text)");
+
+  PutSQLTestFlow flow(testController, database, PutSQL::s_success);
+  flow.setProperty("Batch Size", "200");
+
+  // more distinct statements than a connection keeps prepared
+  std::vector<TestFlowFile> flowFiles;
+  for (int i = 0; i < 120; i++) {
+    flowFiles.push_back({ "insert into test_table (id, name) values (" + std::to_string(i) + ", 'name" + std::to_string(i) + "')", { } });
+  }
+  // consecutive flow files with the same statement are executed in one bulk
+  for (int i = 120; i < 130; i++) {
+    flowFiles.push_back({ "insert into test_table (id, name) values (?, ?)", parameters(i, "name" + std::to_string(i)).attributes });
+  }
+  flow.enqueue(flowFiles);
+  flow.runPutSQL();
+
+  REQUIRE(database.queryColumn("select name from test_table order by id") == names(130));
+  REQUIRE(130 == flow.countChecked());
+}
+
+TEST_CASE("PutSQL rolls back the batch of a failing statement", "[putsql]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  SQLiteTestDatabase database(testController.createTempDirectory(format));
+  database.execute("create table test_table (id integer primary key, name text)");
+  database.execute("insert into test_table (id, name) values (1, 'existing')");
+
+  PutSQLTestFlow flow(testController, database, PutSQL::s_failure);
+  flow.setProperty("SQL statements", "insert into test_table (id, name) values (?, ?)");
+
+  // the fourth flow file violates the primary key
+  flow.enqueue({ parameters(2, "name2"), parameters(3, "name3"), parameters(4, "name4"), parameters(1, "duplicate"), parameters(5, "name5") });
+  flow.runPutSQL();
+
+  const std::vector<std::string> expected{ "existing" };
+  REQUIRE(database.queryColumn("select name from test_table order by id") == expected);
+  REQUIRE(5 == flow.countChecked());
+}
+
+TEST_CASE("PutSQL routes flow files missing parameters to failure", "[putsql]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  SQLiteTestDatabase database(testController.createTempDirectory(format));
+  database.execute("create table test_table (id integer primary key, name text)");
+
+  PutSQLTestFlow flow(testController, database, PutSQL::s_failure);
+  flow.setProperty("SQL statements", "insert into test_table (id, name) values (?, ?)");
+
+  flow.enqueue({ parameters(0, "name0"), { "", { { "sql.args.1.value", "1" } } }, parameters(2, "name2") });
+  flow.runPutSQL();
+
+  const std::vector<std::string> expected{ "name0", "name2" };
+  REQUIRE(database.queryColumn("select name from test_table order by id") == expected);
+  REQUIRE(1 == flow.countChecked());
+}
+
+TEST_CASE("PutSQL evaluates the SQL statements for each flow file", "[putsql]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  SQLiteTestDatabase database(testController.createTempDirectory(format));
+  database.execute("create table first_table (id integer primary key, name text)");
+  database.execute("create table second_table (id integer primary key, name text)");
+  database.execute("create table third_table (id integer primary key, name text)");
+
+  PutSQLTestFlow flow(testController, database, PutSQL::s_success);
+  flow.setProperty("SQL statements", "insert into ${table} (id, name) values (?, ?); insert into second_table (id, name) values (?, 'copy')");
+
+  auto inTable = [](const std::string& table, int id) {
+    auto flowFile = parameters(id, "name" + std::to_string(id));
+    flowFile.attributes["table"] = table;
+    return flowFile;
+  };
+  flow.enqueue({ inTable("first_table", 0), inTable("first_table", 1), inTable("third_table", 2), inTable("first_table", 3) });
+  flow.runPutSQL();
+
+  const std::vector<std::string> first{ "name0", "name1", "name3" };
+  REQUIRE(database.queryColumn("select name from first_table order by id") == first);
+  const std::vector<std::string> third{ "name2" };
+  REQUIRE(database.queryColumn("select name from third_table order by id") == third);
+  const std::vector<std::string> copies(4, "copy");
+  REQUIRE(database.queryColumn("select name from second_table order by id") == copies);
+  REQUIRE(4 == flow.countChecked());
+}
@@ -0,0 +1,245 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rapidjson/document.h"
+
+#include "SQLiteTestDatabase.h"
+#include "LogAttribute.h"
+#include "data/BinarySQLWriter.h"
+#include "processors/ExecuteSQL.h"
+#include "processors/QueryDatabaseTable.h"
+
+using org::apache::nifi::minifi::processors::ExecuteSQL;
+using org::apache::nifi::minifi::processors::QueryDatabaseTable;
+using org::apache::nifi::minifi::sql::BinarySQLWriter;
+
+namespace {
+
+struct Row {
+  long long id;
+  std::string name;
+};
+
+/**
+ * Decodes the output of BinarySQLWriter for rows of an integer and a text column.
+ */
+class BinaryRowReader {
+ public:
+  explicit BinaryRowReader(const std::string& content)
+    : content_(content) {
+  }
+
+  std::vector<std::string> readColumnNames() {
+    std::vector<std::string> names(readVarint());
+    for (auto& name : names) {
+      name = readString();
+    }
+    return names;
+  }
+
+  std::vector<Row> readRows() {
+    std::vector<Row> rows;
+    while (position_ < content_.size()) {
+      Row row;
+      REQUIRE(BinarySQLWriter::LONG_VALUE == readByte());
+      const auto zigzag = readVarint();
+      row.id = static_cast<long long>(zigzag >> 1) ^ -static_cast<long long>(zigzag & 1);
+      REQUIRE(BinarySQLWriter::STRING_VALUE == readByte());
+      row.name = readString();
+      rows.push_back(row);
+    }
+    return rows;
+  }
+
+ private:
+  uint8_t readByte() {
+    REQUIRE(position_ < content_.size());
+    return static_cast<uint8_t>(content_[position_++]);
+  }
+
+  uint64_t readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+      const auto byte = readByte();
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+  }
+
+  std::string readString() {
+    const auto size = readVarint();
+    REQUIRE(position_ + size <= content_.size());
+    const auto value = content_.substr(position_, size);
+    position_ += size;
+    return value;
+  }
+
+  const std::string content_;
+  size_t position_{};
+};
+
+std::vector<Row> readJSONRows(const std::string& content) {
+  rapidjson::Document document;
+  document.Parse(content.c_str(), content.size());
+  REQUIRE(document.IsArray());
+  std::vector<Row> rows;
+  for (const auto& value : document.GetArray()) {
+    rows.push_back({ value["id"].GetInt64(), value["name"].GetString() });
+  }
+  return rows;
+}
+
+void insertRows(SQLiteTestDatabase& database, int first, int count) {
+  for (int id = first; id < first + count; id++) {
+    database.execute("insert into test_table (id, name) values (" + std::to_string(id) + ", 'name" + std::to_string(id) + "')");
+  }
+}
+
+void checkRows(const std::vector<Row>& rows, int first, int count) {
+  REQUIRE(count == rows.size());
+  for (int i = 0; i < count; i++) {
+    REQUIRE(first + i == rows[i].id);
+    REQUIRE("name" + std::to_string(first + i) == rows[i].name);
+  }
+}
+
+std::vector<OutputFlowFile> executeSQL(TestController& testController, SQLiteTestDatabase& database, const std::string& outputFormat, const std::string& maxRows) {
+  auto plan = testController.createPlan();
+  addDatabaseService(*plan, database);
+  auto executeSQL = plan->addProcessor("ExecuteSQL", "executesql");
+  plan->addProcessor("LogAttribute", "check", ExecuteSQL::s_success, true);
+  plan->setProperty(executeSQL, "DB Controller Service", "ODBCService");
+  plan->setProperty(executeSQL, "SQL select query", "select id, name from test_table order by id");
+  plan->setProperty(executeSQL, "Output Format", outputFormat);
+  plan->setProperty(executeSQL, "Max Rows Per Flow File", maxRows);
+
+  plan->runNextProcessor();
+  return collectFlowFiles(*plan);
+}
+
+}  // namespace
+
+TEST_CASE("ExecuteSQL splits the result set on Max Rows Per Flow File", "[executesql]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  SQLiteTestDatabase database(testController.createTempDirectory(format));
+  database.execute("create table test_table (id integer primary key, name text)");
+
+  SECTION("Last flow file is partial") {
+    insertRows(database, 0, 25);
+    const auto output = executeSQL(testController, database, "JSON", "10");
+
+    REQUIRE(3 == output.size());
+    const std::vector<int> counts{ 10, 10, 5 };
+    for (size_t i = 0; i < output.size(); i++) {
+      REQUIRE(std::to_string(counts[i]) == output[i].attributes.at("executesql.row.count"));
+      checkRows(readJSONRows(output[i].content), 10 * i, counts[i]);
+    }
+  }
+
+  SECTION("Result set is a multiple of Max Rows Per Flow File") {
+    insertRows(database, 0, 20);
+    const auto output = executeSQL(testController, database, "JSON", "10");
+
+    REQUIRE(2 == output.size());
+    checkRows(readJSONRows(output[0].content), 0, 10);
+    checkRows(readJSONRows(output[1].content), 10, 10);
+  }
+
+  SECTION("All rows in one flow file") {
+    insertRows(database, 0, 25);
+    const auto output = executeSQL(testController, database, "JSON", "0");
+
+    REQUIRE(1 == output.size());
+    REQUIRE("25" == output[0].attributes.at("executesql.row.count"));
+    checkRows(readJSONRows(output[0].content), 0, 25);
+  }
+}
+
+TEST_CASE("ExecuteSQL writes the result set in the Binary output format", "[executesql]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  SQLiteTestDatabase database(testController.createTempDirectory(format));
+  database.execute("create table test_table (id integer primary key, name text)");
+  insertRows(database, 0, 25);
+
+  const auto output = executeSQL(testController, database, "Binary", "10");
+
+  REQUIRE(3 == output.size());
+  const std::vector<int> counts{ 10, 10, 5 };
+  const std::vector<std::string> columnNames{ "id", "name" };
+  for (size_t i = 0; i < output.size(); i++) {
+    REQUIRE(std::to_string(counts[i]) == output[i].attributes.at("executesql.row.count"));
+    // every flow file starts with the column names
+    BinaryRowReader reader(output[i].content);
+    REQUIRE(columnNames == reader.readColumnNames());
+    checkRows(reader.readRows(), 10 * i, counts[i]);
+  }
+}
+
+TEST_CASE("QueryDatabaseTable splits the new rows on the maximum rows per flow file", "[querydatabasetable]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  const auto directory = testController.createTempDirectory(format);
+  SQLiteTestDatabase database(directory);
+  database.execute("create table test_table (id integer primary key, name text)");
+  insertRows(database, 0, 25);
+
+  auto plan = testController.createPlan();
+  addDatabaseService(*plan, database);
+  auto queryDatabaseTable = plan->addProcessor("QueryDatabaseTable", "querydatabasetable");
+  plan->addProcessor("LogAttribute", "check", QueryDatabaseTable::s_success, true);
+  plan->setProperty(queryDatabaseTable, "DB Controller Service", "ODBCService");
+  plan->setProperty(queryDatabaseTable, "Table Name", "test_table");
+  plan->setProperty(queryDatabaseTable, "Columns to Return", "id, name");
+  plan->setProperty(queryDatabaseTable, "Maximum-value Columns", "id");
+  plan->setProperty(queryDatabaseTable, "Output Format", "Binary");
+  plan->setProperty(queryDatabaseTable, "qdbt-max-rows", "10");
+  plan->setProperty(queryDatabaseTable, "State Directory", directory + "/state");
+
+  plan->runNextProcessor();
+  auto output = collectFlowFiles(*plan);
+
+  REQUIRE(3 == output.size());
+  const std::vector<int> counts{ 10, 10, 5 };
+  for (size_t i = 0; i < output.size(); i++) {
+    REQUIRE(std::to_string(counts[i]) == output[i].attributes.at("querydbtable.row.count"));
+    REQUIRE("test_table" == output[i].attributes.at("tablename"));
+    BinaryRowReader reader(output[i].content);
+    reader.readColumnNames();
+    checkRows(reader.readRows(), 10 * i, counts[i]);
+  }
+
+  // only the rows added since the last query are returned, in one partial flow file
+  insertRows(database, 25, 4);
+  plan->reset();
+  plan->runNextProcessor();
+  output = collectFlowFiles(*plan);
+
+  REQUIRE(1 == output.size());
+  REQUIRE("4" == output[0].attributes.at("querydbtable.row.count"));
+  BinaryRowReader reader(output[0].content);
+  reader.readColumnNames();
+  checkRows(reader.readRows(), 25, 4);
+}
@@ -0,0 +1,202 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestBase.h"
+#include "io/BaseStream.h"
+#include "data/BinarySQLWriter.h"
+#include "data/StreamOutputBuffer.h"
+
+using org::apache::nifi::minifi::sql::BinarySQLWriter;
+using org::apache::nifi::minifi::sql::SQLRowSubscriber;
+using org::apache::nifi::minifi::sql::StreamOutputBuffer;
+
+namespace {
+
+/**
+ * Content stream recording the size of each write.
+ */
+class RecordingStream : public minifi::io::BaseStream {
+ public:
+  int write(uint8_t *value, int len) override {
+    writes.push_back(len);
+    content.append(reinterpret_cast<const char*>(value), len);
+    return len;
+  }
+
+  std::vector<int> writes;
+  std::string content;
+};
+
+std::string bytes(size_t size, char value) {
+  return std::string(size, value);
+}
+
+std::vector<uint8_t> toBytes(const std::string& content) {
+  return std::vector<uint8_t>(content.begin(), content.end());
+}
+
+std::vector<uint8_t> doubleBytes(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  std::vector<uint8_t> result;
+  for (size_t i = 0; i < sizeof(bits); i++) {
+    result.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST_CASE("StreamOutputBuffer keeps small writes until flushed", "[sqlWriter]") {
+  auto stream = std::make_shared<RecordingStream>();
+  StreamOutputBuffer buffer;
+  buffer.reset(stream);
+
+  const auto data = bytes(100, 'a');
+  buffer.write(data.data(), data.size());
+  buffer.Put('b');
+  REQUIRE(stream->writes.empty());
+  REQUIRE(0 == buffer.getBytesWritten());
+
+  buffer.Flush();
+  REQUIRE(std::vector<int>{ 101 } == stream->writes);
+  REQUIRE(data + "b" == stream->content);
+  REQUIRE(101 == buffer.getBytesWritten());
+
+  // nothing is left to flush
+  buffer.Flush();
+  REQUIRE(1 == stream->writes.size());
+}
+
+TEST_CASE("StreamOutputBuffer writes to the stream when the buffer is full", "[sqlWriter]") {
+  auto stream = std::make_shared<RecordingStream>();
+  StreamOutputBuffer buffer;
+  buffer.reset(stream);
+
+  const auto data = bytes(StreamOutputBuffer::BUFFER_SIZE - 1, 'a');
+  buffer.write(data.data(), data.size());
+  REQUIRE(stream->writes.empty());
+
+  buffer.Put('b');
+  REQUIRE(std::vector<int>{ static_cast<int>(StreamOutputBuffer::BUFFER_SIZE) } == stream->writes);
+
+  // the buffered data is written before data not fitting in the buffer
+  const auto more = bytes(10, 'c');
+  buffer.write(more.data(), more.size());
+  buffer.write(data.data(), data.size());
+  buffer.Flush();
+  REQUIRE(3 == stream->writes.size());
+  REQUIRE(10 == stream->writes[1]);
+  REQUIRE(data + "b" + more + data == stream->content);
+  REQUIRE(stream->content.size() == buffer.getBytesWritten());
+}
+
+TEST_CASE("StreamOutputBuffer writes large data directly", "[sqlWriter]") {
+  auto stream = std::make_shared<RecordingStream>();
+  StreamOutputBuffer buffer;
+  buffer.reset(stream);
+
+  const auto small = bytes(10, 'a');
+  const auto large = bytes(2 * StreamOutputBuffer::BUFFER_SIZE, 'b');
+  buffer.write(small.data(), small.size());
+  buffer.write(large.data(), large.size());
+
+  const std::vector<int> expected{ 10, static_cast<int>(large.size()) };
+  REQUIRE(expected == stream->writes);
+  REQUIRE(small + large == stream->content);
+}
+
+TEST_CASE("BinarySQLWriter encodes the column names and the typed values of the rows", "[sqlWriter]") {
+  auto stream = std::make_shared<RecordingStream>();
+  BinarySQLWriter writer;
+  SQLRowSubscriber& subscriber = writer;
+
+  writer.beginOutput(stream);
+
+  subscriber.beginProcessRow();
+  subscriber.processColumnName("id");
+  subscriber.processColumnName("name");
+  subscriber.processColumnName("score");
+  subscriber.processColumnName("extra");
+  subscriber.processColumn("id", 1);
+  subscriber.processColumn("name", std::string("a"));
+  subscriber.processColumn("score", 0.5);
+  subscriber.processColumn("extra", "NULL");
+  subscriber.endProcessRow();
+
+  subscriber.beginProcessRow();
+  subscriber.processColumn("id", -2LL);
+  subscriber.processColumn("name", std::string("bc"));
+  subscriber.processColumn("score", -1.25);
+  subscriber.processColumn("extra", 300ULL);
+  subscriber.endProcessRow();
+
+  const auto size = writer.endOutput();
+
+  std::vector<uint8_t> expected{ 4, 2, 'i', 'd', 4, 'n', 'a', 'm', 'e', 5, 's', 'c', 'o', 'r', 'e', 5, 'e', 'x', 't', 'r', 'a' };
+  // first row
+  expected.insert(expected.end(), { BinarySQLWriter::LONG_VALUE, 2, BinarySQLWriter::STRING_VALUE, 1, 'a', BinarySQLWriter::DOUBLE_VALUE });
+  const auto half = doubleBytes(0.5);
+  expected.insert(expected.end(), half.begin(), half.end());
+  expected.push_back(BinarySQLWriter::NULL_VALUE);
+  // second row, -2 is zig-zag encoded as 3 and 300 is the varint 0xAC 0x02
+  expected.insert(expected.end(), { BinarySQLWriter::LONG_VALUE, 3, BinarySQLWriter::STRING_VALUE, 2, 'b', 'c', BinarySQLWriter::DOUBLE_VALUE });
+  const auto negative = doubleBytes(-1.25);
+  expected.insert(expected.end(), negative.begin(), negative.end());
+  expected.insert(expected.end(), { BinarySQLWriter::ULONG_VALUE, 0xAC, 0x02 });
+
+  REQUIRE(expected == toBytes(stream->content));
+  REQUIRE(expected.size() == size);
+}
+
+TEST_CASE("BinarySQLWriter starts each output with the column names", "[sqlWriter]") {
+  BinarySQLWriter writer;
+  SQLRowSubscriber& subscriber = writer;
+
+  auto first = std::make_shared<RecordingStream>();
+  writer.beginOutput(first);
+  subscriber.beginProcessRow();
+  subscriber.processColumnName("id");
+  subscriber.processColumn("id", 1);
+  subscriber.endProcessRow();
+  writer.endOutput();
+
+  auto second = std::make_shared<RecordingStream>();
+  writer.beginOutput(second);
+  subscriber.beginProcessRow();
+  subscriber.processColumnName("id");
+  subscriber.processColumn("id", 2);
+  subscriber.endProcessRow();
+  writer.endOutput();
+
+  const std::vector<uint8_t> expectedFirst{ 1, 2, 'i', 'd', BinarySQLWriter::LONG_VALUE, 2 };
+  const std::vector<uint8_t> expectedSecond{ 1, 2, 'i', 'd', BinarySQLWriter::LONG_VALUE, 4 };
+  REQUIRE(expectedFirst == toBytes(first->content));
+  REQUIRE(expectedSecond == toBytes(second->content));
+
+  // an output without rows has no columns
+  auto empty = std::make_shared<RecordingStream>();
+  writer.beginOutput(empty);
+  REQUIRE(1 == writer.endOutput());
+  REQUIRE(std::vector<uint8_t>{ 0 } == toBytes(empty->content));
+}
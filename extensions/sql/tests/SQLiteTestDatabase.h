@@ -0,0 +1,130 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestBase.h"
+#include "FlowFileRecord.h"
+#include "services/ODBCConnector.h"
+
+/**
+ * SQLite database accessed through the SQLite ODBC driver found at build time, as the processors access it.
+ */
+class SQLiteTestDatabase {
+ public:
+  explicit SQLiteTestDatabase(const std::string& directory)
+    : connection_string_("Driver=" SQLITE_ODBC_DRIVER ";Database=" + directory + "/minifi-sql-test.db"),
+      connection_(connection_string_) {
+  }
+
+  const std::string& getConnectionString() const {
+    return connection_string_;
+  }
+
+  void execute(const std::string& statement) {
+    connection_.getSession()->execute(statement);
+  }
+
+  /**
+   * Provides the values of the first column, which the query is expected to return as text.
+   */
+  std::vector<std::string> queryColumn(const std::string& query) {
+    std::vector<std::string> values;
+    auto rowset = connection_.prepareStatement(query)->execute();
+    for (const auto& row : rowset) {
+      values.push_back(row.get_indicator(0) == soci::i_null ? "NULL" : row.get<std::string>(0));
+    }
+    return values;
+  }
+
+ private:
+  std::string connection_string_;
+  minifi::sql::controllers::ODBCConnection connection_;
+};
+
+/**
+ * Adds an ODBCService named "ODBCService" connected to the database.
+ */
+inline std::shared_ptr<core::controller::ControllerServiceNode> addDatabaseService(TestPlan& plan, const SQLiteTestDatabase& database) {
+  auto service = plan.addController("ODBCService", "ODBCService");
+  plan.setProperty(service, "Connection String", database.getConnectionString());
+  return service;
+}
+
+class StringOutputCallback : public minifi::OutputStreamCallback {
+ public:
+  explicit StringOutputCallback(const std::string& content)
+    : content_(content) {
+  }
+
+  int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) override {
+    if (content_.empty())
+      return 0;
+    return stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content_.data())), static_cast<int>(content_.size()));
+  }
+
+ private:
+  const std::string content_;
+};
+
+class StringInputCallback : public minifi::InputStreamCallback {
+ public:
+  int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) override {
+    content_.resize(stream->getSize());
+    if (content_.empty())
+      return 0;
+    const auto ret = stream->readData(reinterpret_cast<uint8_t*>(&content_[0]), static_cast<int>(content_.size()));
+    if (ret < 0)
+      return ret;
+    content_.resize(ret);
+    return ret;
+  }
+
+  const std::string& getContent() const {
+    return content_;
+  }
+
+ private:
+  std::string content_;
+};
+
+struct OutputFlowFile {
+  std::string content;
+  std::map<std::string, std::string> attributes;
+};
+
+/**
+ * Runs the next processor of the plan as a sink, which removes and returns the flow files queued for it.
+ */
+inline std::vector<OutputFlowFile> collectFlowFiles(TestPlan& plan) {
+  std::vector<OutputFlowFile> output;
+  plan.runNextProcessor([&output](const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession> session) {
+    while (auto flowFile = session->get()) {
+      StringInputCallback callback;
+      session->read(flowFile, &callback);
+      output.push_back({ callback.getContent(), flowFile->getAttributes() });
+      session->remove(flowFile);
+    }
+  });
+  return output;
+}
@@ -99,6 +99,32 @@ void ExtractText::initialize() {
   setSupportedRelationships(relationships);
 }
 
+void ExtractText::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  regexes_.clear();
+  bool regex_mode = false;
+  context->getProperty(RegexMode.getName(), regex_mode);
+  if (!regex_mode) {
+    return;
+  }
+
+  std::vector<utils::Regex::Mode> rgx_mode;
+  bool insensitive;
+  if (context->getProperty(InsensitiveMatch.getName(), insensitive) && insensitive) {
+    rgx_mode.push_back(utils::Regex::Mode::ICASE);
+  }
+
+  for (const auto& k : context->getDynamicPropertyKeys()) {
+    std::string value;
+    context->getDynamicProperty(k, value);
+    try {
+      regexes_.emplace_back(k, utils::Regex(value, rgx_mode));
+    } catch (const Exception &e) {
+      logger_->log_error("%s error encountered when trying to construct regular expression from property (key: %s) value: %s",
+                         e.what(), k, value);
+    }
+  }
+}
+
 void ExtractText::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
   std::shared_ptr<core::FlowFile> flowFile = session->get();
 
@@ -106,7 +132,7 @@ void ExtractText::onTrigger(core::ProcessContext *context, core::ProcessSession
     return;
   }
 
-  ReadCallback cb(flowFile, context, logger_);
+  ReadCallback cb(flowFile, context, regexes_, logger_);
   session->read(flowFile, &cb);
   session->transfer(flowFile, Success);
 }
@@ -127,7 +153,9 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
   else if (sizeLimitStr != "0")
     size_limit = std::stoi(sizeLimitStr);
 
-  std::ostringstream contentStream;
+  // the content is matched in place, so it is read straight into the string the regexes run over
+  std::string contentStr;
+  contentStr.reserve(std::min<uint64_t>(size_limit, flowFile_->getSize()));
 
   while (read_size < size_limit) {
     // Don't read more than config limit or the size of the buffer
@@ -139,21 +167,11 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
       break;  // End of stream, no more data
     }
 
-    contentStream.write(reinterpret_cast<const char*>(buffer_.data()), ret);
+    contentStr.append(reinterpret_cast<const char*>(buffer_.data()), ret);
     read_size += ret;
-    if (contentStream.fail()) {
-      return -1;
-    }
   }
 
   if (regex_mode) {
-    std::vector<utils::Regex::Mode> rgx_mode;
-
-    bool insensitive;
-    if (ctx_->getProperty(InsensitiveMatch.getName(), insensitive) && insensitive) {
-      rgx_mode.push_back(utils::Regex::Mode::ICASE);
-    }
-
     bool ignoregroupzero;
     ctx_->getProperty(IgnoreCaptureGroupZero.getName(), ignoregroupzero);
 
@@ -163,43 +181,36 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
     int maxCaptureSize;
     ctx_->getProperty(MaxCaptureGroupLen.getName(), maxCaptureSize);
 
-    std::string contentStr = contentStream.str();
-
     std::map<std::string, std::string> regexAttributes;
+    std::vector<std::string> matches;
 
-    for (const auto& k : ctx_->getDynamicPropertyKeys()) {
-      std::string value;
-      ctx_->getDynamicProperty(k, value);
-
-      std::string workStr = contentStr;
-
+    for (const auto& regex : regexes_) {
+      const std::string &k = regex.first;
       int matchcount = 0;
+      size_t offset = 0;
+      size_t match_end = 0;
+
+      while (regex.second.search(contentStr, offset, matches, match_end)) {
+        size_t i = ignoregroupzero ? 1 : 0;
 
-      try {
-        utils::Regex rgx(value, rgx_mode);
-        while (rgx.match(workStr)) {
-          const std::vector<std::string> &matches = rgx.getResult();
-          size_t i = ignoregroupzero ? 1 : 0;
-
-          for (; i < matches.size(); ++i, ++matchcount) {
-            std::string attributeValue = matches[i];
-            if (attributeValue.length() > maxCaptureSize) {
-              attributeValue = attributeValue.substr(0, maxCaptureSize);
-            }
-            if (matchcount == 0) {
-              regexAttributes[k] = attributeValue;
-            }
-            regexAttributes[k + '.' + std::to_string(matchcount)] = attributeValue;
+        for (; i < matches.size(); ++i, ++matchcount) {
+          std::string attributeValue = matches[i];
+          if (attributeValue.length() > maxCaptureSize) {
+            attributeValue = attributeValue.substr(0, maxCaptureSize);
           }
-          if (!repeatingcapture) {
-            break;
+          if (matchcount == 0) {
+            regexAttributes[k] = attributeValue;
           }
-          workStr = rgx.getSuffix();
+          regexAttributes[k + '.' + std::to_string(matchcount)] = attributeValue;
+        }
+        if (!repeatingcapture) {
+          break;
+        }
+        // an empty match would be found again at the same position
+        offset = match_end > offset ? match_end : offset + 1;
+        if (offset > contentStr.size()) {
+          break;
         }
-      } catch (const Exception &e) {
-        logger_->log_error("%s error encountered when trying to construct regular expression from property (key: %s) value: %s",
-                           e.what(), k, value);
-        continue;
       }
     }
 
@@ -207,14 +218,16 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
       flowFile_->setAttribute(kv.first, kv.second);
     }
   } else {
-    flowFile_->setAttribute(attrKey, contentStream.str());
+    flowFile_->setAttribute(attrKey, contentStr);
   }
   return read_size;
 }
 
-ExtractText::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ctx,  std::shared_ptr<logging::Logger> lgr)
+ExtractText::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ctx,
+                                        const std::vector<std::pair<std::string, utils::Regex>> &regexes, std::shared_ptr<logging::Logger> lgr)
     : flowFile_(std::move(flowFile)),
       ctx_(ctx),
+      regexes_(regexes),
       logger_(std::move(lgr)) {
   buffer_.resize(std::min<uint64_t>(flowFile_->getSize(), MAX_BUFFER_SIZE));
 }
@@ -24,7 +24,10 @@
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
 #include "core/Resource.h"
+#include "utils/RegexUtils.h"
 
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace org {
@@ -62,6 +65,8 @@ public:
     //! Default maximum bytes to read into an attribute
     static constexpr int DEFAULT_SIZE_LIMIT = 2 * 1024 * 1024;
 
+    //! OnSchedule method, compiles the regular expressions of the dynamic properties
+    void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
     //! OnTrigger method, implemented by NiFi ExtractText
     void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
     //! Initialize, over write by NiFi ExtractText
@@ -73,13 +78,15 @@ public:
 
     class ReadCallback : public InputStreamCallback {
     public:
-        ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ct, std::shared_ptr<logging::Logger> lgr);
+        ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ct, const std::vector<std::pair<std::string, utils::Regex>> &regexes,
+                     std::shared_ptr<logging::Logger> lgr);
         ~ReadCallback() {}
         int64_t process(std::shared_ptr<io::BaseStream> stream);
 
     private:
         std::shared_ptr<core::FlowFile> flowFile_;
         core::ProcessContext *ctx_;
+        const std::vector<std::pair<std::string, utils::Regex>> &regexes_;
         std::vector<uint8_t> buffer_;
         std::shared_ptr<logging::Logger> logger_;
     };
@@ -89,6 +96,8 @@ protected:
 private:
     //! Logger
     std::shared_ptr<logging::Logger> logger_;
+    //! Compiled regular expressions of the dynamic properties, shared by the concurrent tasks
+    std::vector<std::pair<std::string, utils::Regex>> regexes_;
 };
 
 REGISTER_RESOURCE(ExtractText,"Extracts the content of a FlowFile and places it into an attribute.");
@@ -92,6 +92,13 @@ core::Property GetFile::Recurse(
 core::Property GetFile::FileFilter(
     core::PropertyBuilder::createProperty("File Filter")->withDescription("Only files whose names match the given regular expression will be picked up")->withDefaultValue("[^\\.].*")->build());
 
+core::Property GetFile::WatchDirectory(
+    core::PropertyBuilder::createProperty("Watch Directory")->withDescription("If true and Keep Source File is false, the directory is listed once and then only the files reported as "
+                                                                             "changed by file system notifications, and the files that were not consumed yet, are checked, instead of "
+                                                                             "listing the whole directory on every poll. Notifications are not available on all platforms and file "
+                                                                             "systems, e.g. for changes made by other hosts to network file systems.")
+        ->withDefaultValue<bool>(true)->build());
+
 core::Relationship GetFile::Success("success", "All files are routed to success");
 
 void GetFile::initialize() {
@@ -108,6 +115,7 @@ void GetFile::initialize() {
   properties.insert(PollInterval);
   properties.insert(Recurse);
   properties.insert(FileFilter);
+  properties.insert(WatchDirectory);
   setSupportedProperties(properties);
   // Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -146,6 +154,25 @@ void GetFile::onSchedule(core::ProcessContext *context, core::ProcessSessionFact
   if (context->getProperty(FileFilter.getName(), value)) {
     request_.fileFilter = value;
   }
+  request_.fileFilterRegex = std::make_shared<utils::Regex>(request_.fileFilter);
+
+  if (context->getProperty(WatchDirectory.getName(), value)) {
+    org::apache::nifi::minifi::utils::StringUtils::StringToBool(value, request_.watchDirectory);
+  }
+
+  std::lock_guard<std::mutex> lock(watcher_mutex_);
+  watcher_.reset();
+  watcher_listed_ = false;
+  pending_files_.clear();
+  // kept files are listed again on every poll, so only consumed files can be watched
+  std::string directory;
+  if (request_.watchDirectory && !request_.keepSourceFile && context->getProperty(Directory, directory, nullptr)) {
+    watcher_ = std::unique_ptr<utils::file::FileWatcher>(new utils::file::FileWatcher(directory, request_.recursive));
+    if (!watcher_->start()) {
+      logger_->log_info("Cannot watch %s, the directory will be listed on every poll", directory);
+      watcher_.reset();
+    }
+  }
 }
 
 void GetFile::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
@@ -160,7 +187,7 @@ void GetFile::onTrigger(core::ProcessContext *context, core::ProcessSession *ses
       const std::shared_ptr<core::FlowFile> flow_file;
       if (context->getProperty(Directory, directory, flow_file)) {
         logger_->log_warn("Resolved missing Input Directory property value");
-        performListing(directory, request_);
+        performIncrementalListing(directory, request_);
         last_listing_time_.store(getTimeMillis());
       } else {
         return;
@@ -170,12 +197,14 @@ void GetFile::onTrigger(core::ProcessContext *context, core::ProcessSession *ses
   logger_->log_debug("Is listing empty %i", isListingEmpty());
 
   if (!isListingEmpty()) {
+    std::queue<std::string> list;
+    pollListing(list, request_);
+    std::vector<std::string> files;
     try {
-      std::queue<std::string> list;
-      pollListing(list, request_);
       while (!list.empty()) {
         std::string fileName = list.front();
         list.pop();
+        files.push_back(fileName);
         logger_->log_info("GetFile process %s", fileName);
         std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
         if (flowFile == nullptr)
@@ -191,10 +220,29 @@ void GetFile::onTrigger(core::ProcessContext *context, core::ProcessSession *ses
       }
     } catch (std::exception &exception) {
       logger_->log_debug("GetFile Caught Exception %s", exception.what());
+      releaseFiles(files, list);
       throw;
     } catch (...) {
+      releaseFiles(files, list);
       throw;
     }
+    releaseFiles(files, list);
+  }
+}
+
+void GetFile::releaseFiles(std::vector<std::string> &files, std::queue<std::string> &unprocessed) {
+  while (!unprocessed.empty()) {
+    files.push_back(unprocessed.front());
+    unprocessed.pop();
+  }
+  std::lock_guard<std::mutex> watcher_lock(watcher_mutex_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &file : files) {
+    processing_files_.erase(file);
+    // imported files are gone by the next listing, but those of a rolled back session are not
+    if (watcher_ != nullptr) {
+      pending_files_.insert(file);
+    }
   }
 }
 
@@ -209,7 +257,9 @@ void GetFile::putListing(std::string fileName) {
 
   std::lock_guard<std::mutex> lock(mutex_);
 
-  _dirList.push(fileName);
+  if (listed_files_.insert(fileName).second) {
+    _dirList.push(fileName);
+  }
 }
 
 void GetFile::pollListing(std::queue<std::string> &list, const GetFileRequest &request) {
@@ -217,11 +267,13 @@ void GetFile::pollListing(std::queue<std::string> &list, const GetFileRequest &r
 
   while (!_dirList.empty() && (request.batchSize == 0 || list.size() < request.batchSize)) {
     list.push(_dirList.front());
+    processing_files_.insert(_dirList.front());
+    listed_files_.erase(_dirList.front());
     _dirList.pop();
   }
 }
 
-bool GetFile::acceptFile(std::string fullName, std::string name, const GetFileRequest &request) {
+bool GetFile::acceptFile(std::string fullName, std::string name, const GetFileRequest &request, bool *too_young) {
   logger_->log_trace("Checking file: %s", fullName);
 
   struct stat statbuf;
@@ -235,8 +287,6 @@ bool GetFile::acceptFile(std::string fullName, std::string name, const GetFileRe
 
     uint64_t modifiedTime = ((uint64_t) (statbuf.st_mtime) * 1000);
     uint64_t fileAge = getTimeMillis() - modifiedTime;
-    if (request.minAge > 0 && fileAge < request.minAge)
-      return false;
     if (request.maxAge > 0 && fileAge > request.maxAge)
       return false;
 
@@ -249,8 +299,15 @@ bool GetFile::acceptFile(std::string fullName, std::string name, const GetFileRe
     if (request.keepSourceFile == false && access(fullName.c_str(), W_OK) != 0)
       return false;
 
-    utils::Regex rgx(request.fileFilter);
-    if (!rgx.match(name)) {
+    if (!request.fileFilterRegex || !request.fileFilterRegex->search(name)) {
+      return false;
+    }
+
+    // checked last, as this is the only check that a file passes just by waiting
+    if (request.minAge > 0 && fileAge < request.minAge) {
+      if (too_young != nullptr && !S_ISDIR(statbuf.st_mode)) {
+        *too_young = true;
+      }
       return false;
     }
 
@@ -273,6 +330,57 @@ void GetFile::performListing(std::string dir, const GetFileRequest &request) {
   utils::file::FileUtils::list_dir(dir, callback, logger_, request.recursive);
 }
 
+void GetFile::performIncrementalListing(const std::string &dir, const GetFileRequest &request) {
+  std::lock_guard<std::mutex> lock(watcher_mutex_);
+  if (watcher_ == nullptr) {
+    performListing(dir, request);
+    return;
+  }
+
+  std::set<std::string> changed_files;
+  changed_files.swap(pending_files_);
+  bool complete = watcher_->poll([&changed_files](const utils::file::FileEvent &event) {
+    const std::string path = event.directory + utils::file::FileUtils::get_separator() + event.filename;
+    if (event.type == utils::file::FILE_REMOVED) {
+      changed_files.erase(path);
+    } else {
+      // files linked into the directory are only reported as created
+      changed_files.insert(path);
+    }
+  });
+  if (!complete || !watcher_listed_) {
+    // the initial listing, or changes were lost
+    changed_files.clear();
+    utils::file::FileUtils::list_dir(dir, [this, &changed_files](const std::string& dir, const std::string& filename) -> bool {
+      changed_files.insert(dir + utils::file::FileUtils::get_separator() + filename);
+      return isRunning();
+    }, logger_, request.recursive);
+    watcher_listed_ = true;
+    if (!watcher_->isWatching()) {
+      watcher_.reset();
+    }
+  }
+
+  for (const auto &path : changed_files) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (processing_files_.count(path) > 0) {
+        // handed back by releaseFiles once the running trigger is done with it
+        continue;
+      }
+    }
+    const std::string name = utils::file::FileUtils::get_child_path(path);
+    bool too_young = false;
+    if (acceptFile(path, name, request, &too_young)) {
+      putListing(path);
+    } else if (too_young && watcher_ != nullptr) {
+      // aging is not reported as an event. Files rejected for any other reason
+      // are dropped until the watcher reports them changed.
+      pending_files_.insert(path);
+    }
+  }
+}
+
 int16_t GetFile::getMetricNodes(std::vector<std::shared_ptr<state::response::ResponseNode>> &metric_vector) {
   metric_vector.push_back(metrics_);
   return 0;
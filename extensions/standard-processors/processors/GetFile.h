@@ -19,6 +19,11 @@
 #define __GET_FILE_H__
 
 #include <atomic>
+#include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "core/state/nodes/MetricsBase.h"
 #include "FlowFileRecord.h"
@@ -27,6 +32,8 @@
 #include "core/Core.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "utils/file/FileWatcher.h"
+#include "utils/RegexUtils.h"
 
 namespace org {
 namespace apache {
@@ -45,6 +52,9 @@ struct GetFileRequest {
   uint64_t pollInterval = 0;
   uint64_t batchSize = 10;
   std::string fileFilter = "[^\\.].*";
+  // compiled from fileFilter once per schedule, as it is matched against every listed file
+  std::shared_ptr<utils::Regex> fileFilterRegex;
+  bool watchDirectory = true;
 };
 
 class GetFileMetrics : public state::response::ResponseNode {
@@ -111,6 +121,7 @@ class GetFile : public core::Processor, public state::response::MetricsNodeSourc
    */
   explicit GetFile(std::string name, utils::Identifier uuid = utils::Identifier())
       : Processor(name, uuid),
+        watcher_listed_(false),
         logger_(logging::LoggerFactory<GetFile>::getLogger()) {
     metrics_ = std::make_shared<GetFileMetrics>();
   }
@@ -131,6 +142,7 @@ class GetFile : public core::Processor, public state::response::MetricsNodeSourc
   static core::Property PollInterval;
   static core::Property BatchSize;
   static core::Property FileFilter;
+  static core::Property WatchDirectory;
   // Supported Relationships
   static core::Relationship Success;
 
@@ -158,6 +170,14 @@ class GetFile : public core::Processor, public state::response::MetricsNodeSourc
    */
   void performListing(std::string dir, const GetFileRequest &request);
 
+  /**
+   * Checks the files that the directory watcher reported as changed since the last listing,
+   * listing the whole directory only if changes were lost.
+   * @param dir directory to list
+   * @param request get file request.
+   */
+  void performIncrementalListing(const std::string &dir, const GetFileRequest &request);
+
   int16_t getMetricNodes(std::vector<std::shared_ptr<state::response::ResponseNode>> &metric_vector);
 
  protected:
@@ -179,13 +199,29 @@ class GetFile : public core::Processor, public state::response::MetricsNodeSourc
   void putListing(std::string fileName);
   // Poll directory listing for files
   void pollListing(std::queue<std::string> &list, const GetFileRequest &request);
-  // Check whether file can be added to the directory listing
-  bool acceptFile(std::string fullName, std::string name, const GetFileRequest &request);
+  // Check whether file can be added to the directory listing, telling through too_young whether it was rejected only for its Min Age
+  bool acceptFile(std::string fullName, std::string name, const GetFileRequest &request, bool *too_young = nullptr);
+  // Hands the processed and unprocessed files of a finished trigger back to the watcher, which checks them again if they were not consumed
+  void releaseFiles(std::vector<std::string> &files, std::queue<std::string> &unprocessed);
   // Get file request object.
   GetFileRequest request_;
   // Mutex for protection of the directory listing
 
   std::mutex mutex_;
+  // files in the directory listing, to avoid listing a file twice
+  std::set<std::string> listed_files_;
+  // files taken from the directory listing by a running trigger
+  std::set<std::string> processing_files_;
+
+  // guards the watcher and the files it reported
+  std::mutex watcher_mutex_;
+  // reports changes to the input directory, if file system notifications are available
+  std::unique_ptr<utils::file::FileWatcher> watcher_;
+  // whether the directory was listed since the watcher started
+  bool watcher_listed_;
+  // reported files that were too young to be accepted, or whose processing did not consume them. They are
+  // checked again on every listing until they are queued or removed, as no further event may be reported for them.
+  std::set<std::string> pending_files_;
 
   // last listing time for root directory ( if recursive, we will consider the root
   // as the top level time.
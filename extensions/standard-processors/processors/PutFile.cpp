@@ -219,7 +219,16 @@ bool PutFile::putFile(core::ProcessSession *session, std::shared_ptr<FlowFileRec
 
   bool success = false;
 
-  if (flowFile->getSize() > 0) {
+  if (flowFile->getSize() > 0 && session->exportFile(tmpFile, flowFile)) {
+    // the content repository wrote the file without reading the content into the process
+    logger_->log_debug("Committing %s", destFile);
+    if (rename(tmpFile.c_str(), destFile.c_str())) {
+      logger_->log_info("PutFile commit put file operation to %s failed because rename() call failed", destFile);
+      unlink(tmpFile.c_str());
+    } else {
+      success = true;
+    }
+  } else if (flowFile->getSize() > 0) {
     ReadCallback cb(tmpFile, destFile);
     session->read(flowFile, &cb);
     logger_->log_debug("Committing %s", destFile);
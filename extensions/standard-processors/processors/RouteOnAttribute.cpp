@@ -20,9 +20,11 @@
 
 #include "RouteOnAttribute.h"
 
+#include <iterator>
 #include <memory>
 #include <string>
 #include <set>
+#include <vector>
 
 namespace org {
 namespace apache {
@@ -30,11 +32,24 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
+constexpr char const* RouteOnAttribute::ROUTE_TO_PROPERTY_NAME;
+constexpr char const* RouteOnAttribute::ROUTE_TO_FIRST_PROPERTY_NAME;
+
+core::Property RouteOnAttribute::RoutingStrategy(
+    core::PropertyBuilder::createProperty("Routing Strategy")
+        ->withDescription("Specifies how to determine which relationship to use when evaluating the Expression Language. "
+                          "\"Route to Property name\" routes a FlowFile to every route whose expression is true, "
+                          "\"Route to first matching Property name\" only to the first one, in the order of the route names, without evaluating the rest.")
+        ->isRequired(false)
+        ->withAllowableValues<std::string>({ROUTE_TO_PROPERTY_NAME, ROUTE_TO_FIRST_PROPERTY_NAME})
+        ->withDefaultValue(ROUTE_TO_PROPERTY_NAME)->build());
+
 core::Relationship RouteOnAttribute::Unmatched("unmatched", "Files which do not match any expression are routed here");
 core::Relationship RouteOnAttribute::Failure("failure", "Failed files are transferred to failure");
 
 void RouteOnAttribute::initialize() {
   std::set<core::Property> properties;
+  properties.insert(RoutingStrategy);
   setSupportedProperties(properties);
   std::set<core::Relationship> relationships;
   relationships.insert(Unmatched);
@@ -60,6 +75,16 @@ void RouteOnAttribute::onDynamicPropertyModified(const core::Property &orig_prop
   setSupportedRelationships(relationships);
 }
 
+void RouteOnAttribute::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  std::string strategy;
+  first_match_only_ = context->getProperty(RoutingStrategy.getName(), strategy) && strategy == ROUTE_TO_FIRST_PROPERTY_NAME;
+
+  routes_.clear();
+  for (const auto &route : route_properties_) {
+    routes_.push_back(Route { route.second, route_rels_[route.first] });
+  }
+}
+
 void RouteOnAttribute::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
   auto flow_file = session->get();
 
@@ -69,25 +94,31 @@ void RouteOnAttribute::onTrigger(core::ProcessContext *context, core::ProcessSes
   }
 
   try {
-    bool did_match = false;
+    std::vector<const core::Relationship*> matched_rels;
 
     // Perform dynamic routing logic
-    for (const auto &route : route_properties_) {
-      std::string do_route;
-      context->getDynamicProperty(route.second, do_route, flow_file);
-
-      if (do_route == "true") {
-        did_match = true;
-        auto clone = session->clone(flow_file);
-        session->transfer(clone, route_rels_[route.first]);
+    for (const auto &route : routes_) {
+      bool do_route = false;
+      context->getDynamicProperty(route.property, do_route, flow_file);
+
+      if (do_route) {
+        matched_rels.push_back(&route.relationship);
+        if (first_match_only_) {
+          break;
+        }
       }
     }
 
-    if (!did_match) {
+    if (matched_rels.empty()) {
       session->transfer(flow_file, Unmatched);
-    } else {
-      session->remove(flow_file);
+      return;
+    }
+    // every route but the last gets a clone, the last one gets the FlowFile itself
+    for (auto it = matched_rels.begin(); it != std::prev(matched_rels.end()); ++it) {
+      auto clone = session->clone(flow_file);
+      session->transfer(clone, **it);
     }
+    session->transfer(flow_file, *matched_rels.back());
   } catch (const std::exception &e) {
     logger_->log_error("Caught exception while updating attributes: %s", e.what());
     session->transfer(flow_file, Failure);
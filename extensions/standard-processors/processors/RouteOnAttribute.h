@@ -27,6 +27,10 @@
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace org {
 namespace apache {
 namespace nifi {
@@ -41,6 +45,15 @@ class RouteOnAttribute : public core::Processor {
         logger_(logging::LoggerFactory<RouteOnAttribute>::getLogger()) {
   }
 
+  static constexpr char const* ROUTE_TO_PROPERTY_NAME = "Route to Property name";
+  static constexpr char const* ROUTE_TO_FIRST_PROPERTY_NAME = "Route to first matching Property name";
+
+  /**
+   * Properties
+   */
+
+  static core::Property RoutingStrategy;
+
   /**
    * Relationships
    */
@@ -62,13 +75,22 @@ class RouteOnAttribute : public core::Processor {
   }
 
   virtual void onDynamicPropertyModified(const core::Property &orig_property, const core::Property &new_property);
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   virtual void initialize(void);
 
  private:
+  struct Route {
+    core::Property property;
+    core::Relationship relationship;
+  };
+
   std::shared_ptr<logging::Logger> logger_;
   std::map<std::string, core::Property> route_properties_;
   std::map<std::string, core::Relationship> route_rels_;
+  // routing table built from the routes when scheduled, in the order of their names
+  std::vector<Route> routes_;
+  bool first_match_only_ = false;
 };
 
 REGISTER_RESOURCE(RouteOnAttribute, "Routes FlowFiles based on their Attributes using the Attribute Expression Language.");
@@ -27,6 +27,7 @@
 #include <dirent.h>
 #include <unistd.h>
 #endif
+#include <cstring>
 #include <vector>
 #include <queue>
 #include <map>
@@ -86,6 +87,11 @@ core::Property TailFile::TailMode(
 
 core::Property TailFile::BaseDirectory(core::PropertyBuilder::createProperty("tail-base-directory", "Base Directory")->isRequired(false)->build());
 
+core::Property TailFile::BatchSize(
+    core::PropertyBuilder::createProperty("Batch Size")->withDescription(
+        "The maximum number of delimited entries written to a single flow file. The entries of a flow file are separated by the delimiter. "
+        "Only used when an Input Delimiter is set.")->isRequired(false)->withDefaultValue<int>(1)->build());
+
 core::Relationship TailFile::Success("success", "All files are routed to success");
 
 const char *TailFile::CURRENT_STR = "CURRENT.";
@@ -99,6 +105,7 @@ void TailFile::initialize() {
   properties.insert(Delimiter);
   properties.insert(TailMode);
   properties.insert(BaseDirectory);
+  properties.insert(BatchSize);
   setSupportedProperties(properties);
   // Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -111,13 +118,44 @@ void TailFile::onSchedule(const std::shared_ptr<core::ProcessContext> &context,
 
   // can perform these in notifyStop, but this has the same outcome
   tail_states_.clear();
-  state_recovered_ = false;
+  committed_states_.clear();
+  readers_.clear();
+  {
+    std::lock_guard<std::mutex> directory_lock(directory_mutex_);
+    watched_directories_.clear();
+  }
 
   std::string value;
 
   if (context->getProperty(Delimiter.getName(), value)) {
     delimiter_ = value;
   }
+  if (!delimiter_.empty()) {
+    delimiter_char_ = delimiter_.c_str()[0];
+    if (delimiter_char_ == '\\' && delimiter_.size() > 1) {
+      switch (delimiter_.c_str()[1]) {
+        case 'r':
+          delimiter_char_ = '\r';
+          break;
+        case 't':
+          delimiter_char_ = '\t';
+          break;
+        case 'n':
+          delimiter_char_ = '\n';
+          break;
+        case '\\':
+          delimiter_char_ = '\\';
+          break;
+        default:
+          // previous behavior
+          break;
+      }
+    }
+  }
+
+  if (!context->getProperty(BatchSize.getName(), batch_size_) || batch_size_ == 0) {
+    batch_size_ = 1;
+  }
 
   std::string mode;
   context->getProperty(TailMode.getName(), mode);
@@ -150,6 +188,17 @@ void TailFile::onSchedule(const std::shared_ptr<core::ProcessContext> &context,
       throw minifi::Exception(ExceptionType::PROCESSOR_EXCEPTION, "File to tail must be a fully qualified file");
     }
   }
+
+  std::string st_file;
+  if (context->getProperty(StateFile.getName(), st_file)) {
+    state_file_ = st_file + "." + getUUIDStr();
+  }
+  recoverState();
+
+  committed_states_ = tail_states_;
+  for (const auto &state : tail_states_) {
+    readers_[state.first] = std::unique_ptr<TailReader>(new TailReader());
+  }
 }
 
 bool TailFile::acceptFile(const std::string &fileFilter, const std::string &file) {
@@ -269,17 +318,34 @@ bool TailFile::recoverState() {
 }
 
 void TailFile::storeState() {
-  std::ofstream file(state_file_.c_str());
+  if (state_file_.empty()) {
+    return;
+  }
+  // write a new file and move it over the previous one, so that a crash never leaves a partial state behind
+  const std::string tmp_file = state_file_ + ".tmp";
+  std::ofstream file(tmp_file.c_str());
   if (!file.is_open()) {
     logger_->log_error("store state file failed %s", state_file_);
     return;
   }
-  for (const auto &state : tail_states_) {
+  for (const auto &state : committed_states_) {
     file << "FILENAME=" << state.first << "\n";
     file << CURRENT_STR << state.first << "=" << state.second.path_ << utils::file::FileUtils::get_separator() << state.second.current_file_name_ << "\n";
     file << POSITION_STR << state.first << "=" << state.second.currentTailFilePosition_ << "\n";
   }
   file.close();
+  if (file.fail()) {
+    logger_->log_error("store state file failed %s", state_file_);
+    std::remove(tmp_file.c_str());
+    return;
+  }
+#ifdef WIN32
+  std::remove(state_file_.c_str());
+#endif
+  if (std::rename(tmp_file.c_str(), state_file_.c_str()) != 0) {
+    logger_->log_error("store state file failed %s", state_file_);
+    std::remove(tmp_file.c_str());
+  }
 }
 
 static bool sortTailMatchedFileItem(TailMatchedFileItem i, TailMatchedFileItem j) {
@@ -297,29 +363,24 @@ void TailFile::checkRollOver(TailState &file, const std::string &base_file_name)
     if (found != std::string::npos)
       pattern = file.current_file_name_.substr(0, found);
 
-    // Callback, called for each file entry in the listed directory
-    // Return value is used to break (false) or continue (true) listing
-    auto lambda = [&](const std::string& path, const std::string& filename) -> bool {
-      struct stat sb;
-      std::string fileFullName = path + utils::file::FileUtils::get_separator() + filename;
-      if ((fileFullName.find(pattern) != std::string::npos) && stat(fileFullName.c_str(), &sb) == 0) {
-        uint64_t candidateModTime = ((uint64_t) (sb.st_mtime) * 1000);
+    listDirectory(file.path_, [&](const std::string &filename, const FileStatus &status) {
+      std::string fileFullName = file.path_ + utils::file::FileUtils::get_separator() + filename;
+      if (fileFullName.find(pattern) != std::string::npos) {
+        uint64_t candidateModTime = status.modifiedTime;
         if (candidateModTime >= file.currentTailFileModificationTime_) {
           logging::LOG_TRACE(logger_) << "File " << filename << " (short name " << file.current_file_name_ <<
-          ") disk mod time " << candidateModTime << ", struct mod time " << file.currentTailFileModificationTime_ << ", size on disk " << sb.st_size << ", position " << file.currentTailFilePosition_;
+          ") disk mod time " << candidateModTime << ", struct mod time " << file.currentTailFileModificationTime_ << ", size on disk " << status.size << ", position " << file.currentTailFilePosition_;
           if (filename == file.current_file_name_ && candidateModTime == file.currentTailFileModificationTime_ &&
-              sb.st_size == file.currentTailFilePosition_) {
-            return true;  // Skip the current file as a candidate in case it wasn't updated
+              status.size == file.currentTailFilePosition_) {
+            return;  // Skip the current file as a candidate in case it wasn't updated
+          }
+          TailMatchedFileItem item;
+          item.fileName = filename;
+          item.modifiedTime = candidateModTime;
+          matchedFiles.push_back(item);
+        }
       }
-      TailMatchedFileItem item;
-      item.fileName = filename;
-      item.modifiedTime = ((uint64_t) (sb.st_mtime) * 1000);
-      matchedFiles.push_back(item);
-    }
-  }
-  return true;};
-
-    utils::file::FileUtils::list_dir(file.path_, lambda, logger_, false);
+    });
 
     if (matchedFiles.size() < 1) {
       logger_->log_debug("No newer files found in directory!");
@@ -338,104 +399,270 @@ void TailFile::checkRollOver(TailState &file, const std::string &base_file_name)
     }
 
     file.current_file_name_ = item.fileName;
+  }
+}
 
-    storeState();
+void TailFile::listDirectory(const std::string &directory, const std::function<void(const std::string&, const FileStatus&)> &callback) {
+  std::lock_guard<std::mutex> lock(directory_mutex_);
+  auto &watched = watched_directories_[directory];
+  if (watched.watcher == nullptr) {
+    watched.watcher = std::unique_ptr<utils::file::FileWatcher>(new utils::file::FileWatcher(directory, false));
+    if (!watched.watcher->start()) {
+      logger_->log_debug("Cannot watch %s, it will be listed on every trigger", directory);
+    }
+  }
+
+  auto updateFile = [&](const std::string &filename) {
+    struct stat sb;
+    std::string fileFullName = directory + utils::file::FileUtils::get_separator() + filename;
+    if (stat(fileFullName.c_str(), &sb) == 0 && !S_ISDIR(sb.st_mode)) {
+      watched.files[filename] = FileStatus { (uint64_t) (sb.st_mtime) * 1000, (uint64_t) sb.st_size };
+    } else {
+      watched.files.erase(filename);
+    }
+  };
+
+  std::set<std::string> changed_files;
+  bool complete = watched.listed && watched.watcher->poll([&changed_files](const utils::file::FileEvent &event) {
+    changed_files.insert(event.filename);
+  });
+  if (complete) {
+    for (const auto &filename : changed_files) {
+      updateFile(filename);
+    }
+  } else {
+    watched.files.clear();
+    utils::file::FileUtils::list_dir(directory, [&](const std::string& path, const std::string& filename) -> bool {
+      updateFile(filename);
+      return true;
+    }, logger_, false);
+    watched.listed = true;
+  }
+  for (const auto &file : watched.files) {
+    callback(file.first, file.second);
   }
 }
 
-void TailFile::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
-  std::lock_guard<std::mutex> tail_lock(tail_file_mutex_);
-  std::string st_file;
-  if (context->getProperty(StateFile.getName(), st_file)) {
-    state_file_ = st_file + "." + getUUIDStr();
+int64_t TailFile::FileCopyCallback::process(std::shared_ptr<io::BaseStream> stream) {
+  uint64_t copied = 0;
+  while (copied < length_) {
+    input_.read(buffer_.data(), std::min<uint64_t>(buffer_.size(), length_ - copied));
+    const auto read = input_.gcount();
+    if (read <= 0) {
+      break;
+    }
+    if (stream->writeData(reinterpret_cast<uint8_t*>(buffer_.data()), static_cast<int>(read)) < 0) {
+      return -1;
+    }
+    copied += read;
   }
-  if (!this->state_recovered_) {
-    state_recovered_ = true;
-    // recover the state if we have not done so
-    this->recoverState();
+  return copied;
+}
+
+bool TailFile::openReader(TailReader &reader, const std::string &full_path, uint64_t inode, uint64_t position) {
+  if (reader.stream == nullptr || reader.path != full_path || reader.inode != inode) {
+    reader.stream = std::unique_ptr<std::ifstream>(new std::ifstream(full_path.c_str(), std::ifstream::in | std::ifstream::binary));
+    if (!reader.stream->is_open()) {
+      reader.stream = nullptr;
+      return false;
+    }
+    reader.path = full_path;
+    reader.inode = inode;
+    reader.buffer.resize(READ_BUFFER_SIZE);
+    reader.undelimited_from = 0;
+    reader.undelimited_to = 0;
   }
+  // clears the end of file reached by the previous trigger, seeking also drops the buffered data
+  reader.stream->clear();
+  reader.stream->seekg(position);
+  return reader.stream->good();
+}
 
-  /**
-   * iterate over file states. may modify them
-   */
-  for (auto &state : tail_states_) {
-    auto fileLocation = state.second.path_;
-
-    logger_->log_debug("Tailing file %s from %llu", fileLocation, state.second.currentTailFilePosition_);
-    checkRollOver(state.second, state.first);
-    std::string fullPath = fileLocation + utils::file::FileUtils::get_separator() + state.second.current_file_name_;
-    struct stat statbuf;
-
-    logger_->log_debug("Tailing file %s from %llu", fullPath, state.second.currentTailFilePosition_);
-    if (stat(fullPath.c_str(), &statbuf) == 0) {
-      if ((uint64_t) statbuf.st_size <= state.second.currentTailFilePosition_) {
-        logger_->log_trace("Current pos: %llu", state.second.currentTailFilePosition_);
-        logger_->log_trace("%s", "there are no new input for the current tail file");
-        context->yield();
-        return;
+bool TailFile::tailDelimited(const std::string &name, TailState &state, TailReader &reader, const std::shared_ptr<core::ProcessSession> &session) {
+  std::size_t found = name.find_last_of(".");
+  std::string baseName = name.substr(0, found);
+  std::string extension = name.substr(found + 1);
+  std::string fullPath = state.path_ + utils::file::FileUtils::get_separator() + state.current_file_name_;
+
+  logger_->log_debug("Looking for delimiter 0x%X", delimiter_char_);
+  // offset and length of the entries of each flow file, each followed by the delimiter but the last one
+  std::vector<std::pair<uint64_t, uint64_t>> batches;
+  uint64_t batch_start = state.currentTailFilePosition_;
+  uint64_t last_delimiter = 0;
+  uint64_t entries = 0;
+
+  std::istream &input = *reader.stream;
+  uint64_t offset = state.currentTailFilePosition_;
+  if (reader.undelimited_from == offset && reader.undelimited_to > offset) {
+    offset = reader.undelimited_to;
+    input.seekg(offset);
+  }
+  while (input) {
+    input.read(reader.buffer.data(), reader.buffer.size());
+    const size_t read = static_cast<size_t>(input.gcount());
+    const char *data = reader.buffer.data();
+    const char *begin = data;
+    const char *end = data + read;
+    while (begin < end) {
+      const char *delimiter = static_cast<const char*>(std::memchr(begin, delimiter_char_, end - begin));
+      if (delimiter == nullptr) {
+        break;
       }
-      std::size_t found = state.first.find_last_of(".");
-      std::string baseName = state.first.substr(0, found);
-      std::string extension = state.first.substr(found + 1);
-
-      if (!delimiter_.empty()) {
-        char delim = delimiter_.c_str()[0];
-        if (delim == '\\') {
-          if (delimiter_.size() > 1) {
-            switch (delimiter_.c_str()[1]) {
-              case 'r':
-                delim = '\r';
-                break;
-              case 't':
-                delim = '\t';
-                break;
-              case 'n':
-                delim = '\n';
-                break;
-              case '\\':
-                delim = '\\';
-                break;
-              default:
-                // previous behavior
-                break;
-            }
-          }
-        }
-        logger_->log_debug("Looking for delimiter 0x%X", delim);
-        std::vector<std::shared_ptr<FlowFileRecord>> flowFiles;
-        session->import(fullPath, flowFiles, state.second.currentTailFilePosition_, delim);
-        logger_->log_info("%u flowfiles were received from TailFile input", flowFiles.size());
-
-        for (auto ffr : flowFiles) {
-          logger_->log_info("TailFile %s for %u bytes", state.first, ffr->getSize());
-          std::string logName = baseName + "." + std::to_string(state.second.currentTailFilePosition_) + "-" + std::to_string(state.second.currentTailFilePosition_ + ffr->getSize()) + "." + extension;
-          ffr->updateKeyedAttribute(PATH, fileLocation);
-          ffr->addKeyedAttribute(ABSOLUTE_PATH, fullPath);
-          ffr->updateKeyedAttribute(FILENAME, logName);
-          session->transfer(ffr, Success);
-          state.second.currentTailFilePosition_ += ffr->getSize() + 1;
-          storeState();
-        }
+      last_delimiter = offset + (delimiter - data);
+      begin = delimiter + 1;
+      if (++entries == batch_size_) {
+        batches.push_back(std::make_pair(batch_start, last_delimiter - batch_start));
+        batch_start = last_delimiter + 1;
+        entries = 0;
+      }
+    }
+    offset += read;
+  }
+  if (entries > 0) {
+    batches.push_back(std::make_pair(batch_start, last_delimiter - batch_start));
+    batch_start = last_delimiter + 1;
+  }
+  reader.undelimited_from = batch_start;
+  reader.undelimited_to = offset;
+
+  for (const auto &batch : batches) {
+    input.clear();
+    input.seekg(batch.first);
+    std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
+    FileCopyCallback callback(input, batch.second, reader.buffer);
+    session->write(flowFile, &callback);
+    logger_->log_info("TailFile %s for %u bytes", name, flowFile->getSize());
+    std::string logName = baseName + "." + std::to_string(batch.first) + "-" + std::to_string(batch.first + batch.second) + "." + extension;
+    flowFile->updateKeyedAttribute(PATH, state.path_);
+    flowFile->addKeyedAttribute(ABSOLUTE_PATH, fullPath);
+    flowFile->updateKeyedAttribute(FILENAME, logName);
+    session->transfer(flowFile, Success);
+    state.currentTailFilePosition_ = batch.first + batch.second + 1;
+  }
+  logger_->log_info("%u flowfiles were received from TailFile input", batches.size());
+  return !batches.empty();
+}
 
-      } else {
-        std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
-        if (flowFile) {
-          flowFile->updateKeyedAttribute(PATH, fileLocation);
-          flowFile->addKeyedAttribute(ABSOLUTE_PATH, fullPath);
-          session->import(fullPath, flowFile, true, state.second.currentTailFilePosition_);
-          session->transfer(flowFile, Success);
-          logger_->log_info("TailFile %s for %llu bytes", state.first, flowFile->getSize());
-          std::string logName = baseName + "." + std::to_string(state.second.currentTailFilePosition_) + "-" + std::to_string(state.second.currentTailFilePosition_ + flowFile->getSize()) + "."
-              + extension;
-          flowFile->updateKeyedAttribute(FILENAME, logName);
-          state.second.currentTailFilePosition_ += flowFile->getSize();
-          storeState();
-        }
+bool TailFile::tailFile(const std::string &name, TailState &state, TailReader &reader, const std::shared_ptr<core::ProcessSession> &session) {
+  auto fileLocation = state.path_;
+
+  logger_->log_debug("Tailing file %s from %llu", fileLocation, state.currentTailFilePosition_);
+  checkRollOver(state, name);
+  std::string fullPath = fileLocation + utils::file::FileUtils::get_separator() + state.current_file_name_;
+  struct stat statbuf;
+
+  logger_->log_debug("Tailing file %s from %llu", fullPath, state.currentTailFilePosition_);
+  if (stat(fullPath.c_str(), &statbuf) != 0) {
+    logger_->log_warn("Unable to stat file %s", fullPath);
+    return false;
+  }
+  if ((uint64_t) statbuf.st_size <= state.currentTailFilePosition_) {
+    logger_->log_trace("Current pos: %llu", state.currentTailFilePosition_);
+    logger_->log_trace("%s", "there are no new input for the current tail file");
+    return false;
+  }
+  if (!openReader(reader, fullPath, (uint64_t) statbuf.st_ino, state.currentTailFilePosition_)) {
+    logger_->log_warn("Unable to read file %s", fullPath);
+    return false;
+  }
+
+  bool produced = false;
+  if (!delimiter_.empty()) {
+    produced = tailDelimited(name, state, reader, session);
+  } else {
+    std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
+    if (flowFile) {
+      std::size_t found = name.find_last_of(".");
+      std::string baseName = name.substr(0, found);
+      std::string extension = name.substr(found + 1);
+
+      flowFile->updateKeyedAttribute(PATH, fileLocation);
+      flowFile->addKeyedAttribute(ABSOLUTE_PATH, fullPath);
+      FileCopyCallback callback(*reader.stream, (uint64_t) statbuf.st_size - state.currentTailFilePosition_, reader.buffer);
+      session->write(flowFile, &callback);
+      session->transfer(flowFile, Success);
+      logger_->log_info("TailFile %s for %llu bytes", name, flowFile->getSize());
+      std::string logName = baseName + "." + std::to_string(state.currentTailFilePosition_) + "-" + std::to_string(state.currentTailFilePosition_ + flowFile->getSize()) + "."
+          + extension;
+      flowFile->updateKeyedAttribute(FILENAME, logName);
+      state.currentTailFilePosition_ += flowFile->getSize();
+      produced = true;
+    }
+  }
+  state.currentTailFileModificationTime_ = ((uint64_t) (statbuf.st_mtime) * 1000);
+  return produced;
+}
+
+void TailFile::restoreStates(const std::map<std::string, TailState> &states) {
+  for (const auto &state : states) {
+    TailReader &reader = *readers_.at(state.first);
+    std::lock_guard<std::mutex> file_lock(reader.mutex);
+    tail_states_[state.first] = state.second;
+    reader.in_flight = false;
+  }
+}
+
+void TailFile::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
+  // states of the files before this trigger, restored if the session is rolled back
+  std::map<std::string, TailState> previous_states;
+  std::vector<std::pair<std::string, TailState>> updated_states;
+  bool produced = false;
+
+  try {
+    for (auto &state : tail_states_) {
+      TailReader &reader = *readers_.at(state.first);
+      std::unique_lock<std::mutex> file_lock(reader.mutex, std::try_to_lock);
+      if (!file_lock.owns_lock()) {
+        logger_->log_trace("%s is tailed by another task", state.first);
+        continue;
       }
-      state.second.currentTailFileModificationTime_ = ((uint64_t) (statbuf.st_mtime) * 1000);
-    } else {
-      logger_->log_warn("Unable to stat file %s", fullPath);
+      if (reader.in_flight) {
+        logger_->log_trace("%s waits for the session of another task", state.first);
+        continue;
+      }
+      const TailState previous = state.second;
+      previous_states.insert(std::make_pair(state.first, previous));
+      if (tailFile(state.first, state.second, reader, session)) {
+        produced = true;
+      }
+      if (previous.current_file_name_ != state.second.current_file_name_ || previous.currentTailFilePosition_ != state.second.currentTailFilePosition_) {
+        updated_states.push_back(std::make_pair(state.first, state.second));
+        reader.in_flight = true;
+      }
+    }
+  } catch (...) {
+    restoreStates(previous_states);
+    throw;
+  }
+
+  if (!updated_states.empty()) {
+    // the data of a rolled back session is tailed again by the next trigger, the readers are positioned from the state
+    std::map<std::string, TailState> restored_states;
+    for (const auto &state : updated_states) {
+      restored_states.insert(std::make_pair(state.first, previous_states.at(state.first)));
     }
+    session->addRollbackCallback([this, restored_states]() {
+      restoreStates(restored_states);
+    });
+    // the state is persisted once the flow files are committed, so a crash in between tails the data again rather than losing it
+    session->addCommitCallback([this, updated_states]() {
+      {
+        std::lock_guard<std::mutex> tail_lock(tail_file_mutex_);
+        for (const auto &state : updated_states) {
+          committed_states_[state.first] = state.second;
+        }
+        storeState();
+      }
+      for (const auto &state : updated_states) {
+        TailReader &reader = *readers_.at(state.first);
+        std::lock_guard<std::mutex> file_lock(reader.mutex);
+        reader.in_flight = false;
+      }
+    });
+  }
+
+  if (!produced) {
+    context->yield();
   }
 }
 
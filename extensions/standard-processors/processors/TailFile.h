@@ -20,6 +20,14 @@
 #ifndef __TAIL_FILE_H__
 #define __TAIL_FILE_H__
 
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
@@ -27,6 +35,7 @@
 #include "core/Core.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "utils/file/FileWatcher.h"
 namespace org {
 namespace apache {
 namespace nifi {
@@ -60,10 +69,10 @@ class TailFile : public core::Processor {
   explicit TailFile(std::string name, utils::Identifier uuid = utils::Identifier())
       : core::Processor(name, uuid),
         logger_(logging::LoggerFactory<TailFile>::getLogger()) {
-    state_recovered_ = false;
   }
   // Destructor
   virtual ~TailFile() {
+    std::lock_guard<std::mutex> tail_lock(tail_file_mutex_);
     storeState();
   }
   // Processor Name
@@ -74,6 +83,7 @@ class TailFile : public core::Processor {
   static core::Property Delimiter;
   static core::Property TailMode;
   static core::Property BaseDirectory;
+  static core::Property BatchSize;
   // Supported Relationships
   static core::Relationship Success;
 
@@ -93,24 +103,90 @@ class TailFile : public core::Processor {
   void initialize(void) override;
   // recoverState
   bool recoverState();
-  // storeState
+  // storeState, requires tail_file_mutex_
   void storeState();
 
+  // Copies the next length bytes of the tailed file to a flow file
+  class FileCopyCallback : public OutputStreamCallback {
+   public:
+    FileCopyCallback(std::istream &input, uint64_t length, std::vector<char> &buffer)
+        : input_(input),
+          length_(length),
+          buffer_(buffer) {
+    }
+    int64_t process(std::shared_ptr<io::BaseStream> stream) override;
+
+   private:
+    std::istream &input_;
+    uint64_t length_;
+    std::vector<char> &buffer_;
+  };
+
  private:
 
   static const char *CURRENT_STR;
   static const char *POSITION_STR;
+  // guards the committed states and the state file
   std::mutex tail_file_mutex_;
   // File to save state
   std::string state_file_;
   // Delimiter for the data incoming from the tailed file.
   std::string delimiter_;
-  // determine if state is recovered;
-  bool state_recovered_;
+  char delimiter_char_ = '\n';
+
+  // number of delimited entries written to a single flow file
+  uint64_t batch_size_ = 1;
 
   std::map<std::string, TailState> tail_states_;
+  // states whose flow files were committed, these are persisted to the state file
+  std::map<std::string, TailState> committed_states_;
+
+  // open handle of a tailed file, kept across triggers so that the file is not reopened and
+  // reread from the start on every trigger. Its mutex also guards the TailState of the file,
+  // so that concurrent tasks tail different files.
+  struct TailReader {
+    std::mutex mutex;
+    std::unique_ptr<std::ifstream> stream;
+    std::string path;
+    uint64_t inode = 0;
+    std::vector<char> buffer;
+    // set while the flow files tailed from the file wait for their session to be committed or rolled back,
+    // other tasks skip the file until then, as a rollback rewinds its state
+    bool in_flight = false;
+    // data of the file from undelimited_from to undelimited_to holds no delimiter, so it is not scanned again
+    uint64_t undelimited_from = 0;
+    uint64_t undelimited_to = 0;
+  };
+
+  std::map<std::string, std::unique_ptr<TailReader>> readers_;
 
   static const int BUFFER_SIZE = 512;
+  static const size_t READ_BUFFER_SIZE = 64 * 1024;
+
+  /**
+   * Opens the reader on the file unless it is already open on it, and positions it.
+   * @return false if the file cannot be opened
+   */
+  bool openReader(TailReader &reader, const std::string &full_path, uint64_t inode, uint64_t position);
+
+  /**
+   * Ingests the data appended to a tailed file since the last trigger.
+   * @return whether any flow file was produced
+   */
+  bool tailFile(const std::string &name, TailState &state, TailReader &reader, const std::shared_ptr<core::ProcessSession> &session);
+
+  /**
+   * Resets the states of the tailed files to those before a failed or rolled back trigger,
+   * and makes the files available to other tasks again.
+   */
+  void restoreStates(const std::map<std::string, TailState> &states);
+
+  /**
+   * Splits the data after the current position at the delimiter, packing up to batch_size_
+   * entries in a flow file. Data after the last delimiter is left for a later trigger. Entries
+   * are copied from the file rather than buffered, so long lines are not held in memory.
+   */
+  bool tailDelimited(const std::string &name, TailState &state, TailReader &reader, const std::shared_ptr<core::ProcessSession> &session);
 
   // Utils functions for parse state file
   std::string trimLeft(const std::string& s);
@@ -120,6 +196,28 @@ class TailFile : public core::Processor {
    * Check roll over for the provided file.
    */
   void checkRollOver(TailState &file, const std::string &base_file_name);
+
+  struct FileStatus {
+    uint64_t modifiedTime;
+    uint64_t size;
+  };
+
+  // files of a directory containing tailed files, kept up to date by a watcher
+  struct WatchedDirectory {
+    std::unique_ptr<utils::file::FileWatcher> watcher;
+    std::map<std::string, FileStatus> files;
+    bool listed = false;
+  };
+
+  std::mutex directory_mutex_;
+  std::map<std::string, WatchedDirectory> watched_directories_;
+
+  /**
+   * Calls the callback for each file of the directory. The directory is listed only if its watcher
+   * cannot report the changes since the last call, otherwise only the changed files are checked.
+   */
+  void listDirectory(const std::string &directory, const std::function<void(const std::string&, const FileStatus&)> &callback);
+
   std::shared_ptr<logging::Logger> logger_;
 };
 
@@ -181,3 +181,55 @@ TEST_CASE("Test usage of ExtractText in regex mode", "[extracttextRegexTest]") {
 
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("Test ExtractText in regex mode with a pattern matching the empty string", "[extracttextRegexTest]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::ExtractText>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  char dirtemplate[] = "/tmp/gt.XXXXXX";
+
+  auto dir = testController.createTempDirectory(dirtemplate);
+  REQUIRE(!dir.empty());
+  std::shared_ptr<core::Processor> getfile = plan->addProcessor("GetFile", "getfileCreate2");
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::Directory.getName(), dir);
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::KeepSourceFile.getName(), "true");
+
+  std::shared_ptr<core::Processor> maprocessor = plan->addProcessor("ExtractText", "testExtractText", core::Relationship("success", "description"), true);
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::RegexMode.getName(), "true");
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::IgnoreCaptureGroupZero.getName(), "true");
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::EnableRepeatingCaptureGroup.getName(), "true");
+  plan->setProperty(maprocessor, "DigitsAttr", "([0-9]*)", true);
+
+  std::shared_ptr<core::Processor> laprocessor = plan->addProcessor("LogAttribute", "outputLogAttribute", core::Relationship("success", "description"), true);
+
+  std::stringstream ss;
+  ss << dir << utils::file::FileUtils::get_separator() << TEST_FILE;
+  std::ofstream test_file(ss.str());
+  test_file << "a12b3";
+  test_file.close();
+
+  plan->runNextProcessor();  // GetFile
+  plan->runNextProcessor();  // ExtractText
+
+  // empty matches advance by one character, so the loop ends and every match is captured once
+  std::map<std::string, std::string> attributes;
+  plan->runNextProcessor([&attributes](const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession> session) {
+    auto flowFile = session->get();
+    REQUIRE(flowFile != nullptr);
+    attributes = flowFile->getAttributes();
+    session->remove(flowFile);
+  });
+
+  const std::vector<std::string> expected_captures = { "", "12", "", "3", "" };
+  for (size_t i = 0; i < expected_captures.size(); i++) {
+    auto attribute = attributes.find("DigitsAttr." + std::to_string(i));
+    REQUIRE(attribute != attributes.end());
+    REQUIRE(attribute->second == expected_captures[i]);
+  }
+  REQUIRE(attributes.count("DigitsAttr." + std::to_string(expected_captures.size())) == 0);
+  REQUIRE(attributes["DigitsAttr"] == "");
+
+  LogTestController::getInstance().reset();
+}
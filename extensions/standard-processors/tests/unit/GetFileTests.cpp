@@ -26,9 +26,13 @@
 #include "LogAttribute.h"
 #include "GetFile.h"
 #include "utils/file/FileUtils.h"
+#include "core/repository/VolatileContentRepository.h"
 
 #ifdef WIN32
 #include <fileapi.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 /**
@@ -95,3 +99,131 @@ TEST_CASE("GetFile: MaxSize", "[getFileFifo]") {  // NOLINT
 #endif
 }
 
+
+#ifndef WIN32
+namespace {
+
+bool fileExists(const std::string &path) {
+  struct stat statbuf;
+  return stat(path.c_str(), &statbuf) == 0;
+}
+
+void writeFile(const std::string &path, const std::string &content) {
+  std::ofstream stream(path);
+  stream << content;
+}
+
+}  // namespace
+
+TEST_CASE("GetFile: watched directory checks rejected files again", "[getFileWatch]") {  // NOLINT
+  TestController testController;
+  LogTestController::getInstance().setTrace<processors::GetFile>();
+
+  auto plan = testController.createPlan();
+  char in_dir[] = "/tmp/gt.XXXXXX";
+  auto temp_path = testController.createTempDirectory(in_dir);
+  char other_dir[] = "/tmp/gt.XXXXXX";
+  auto other_path = testController.createTempDirectory(other_dir);
+
+  auto get_file = plan->addProcessor("GetFile", "Get");
+  plan->setProperty(get_file, processors::GetFile::Directory.getName(), temp_path);
+  plan->setProperty(get_file, processors::GetFile::KeepSourceFile.getName(), "false");
+  plan->setProperty(get_file, processors::GetFile::MaxSize.getName(), "50 B");
+  plan->setProperty(get_file, processors::GetFile::WatchDirectory.getName(), "true");
+  plan->runNextProcessor();  // initial listing of the empty directory
+
+  SECTION("a file that becomes acceptable without being written again") {
+    const std::string file = temp_path + utils::file::FileUtils::get_separator() + "large";
+    writeFile(file, std::string(100, 'x'));
+    plan->runCurrentProcessor();
+    REQUIRE(fileExists(file));
+
+    // truncation is only reported as a modification
+    REQUIRE(0 == truncate(file.c_str(), 10));
+    plan->runCurrentProcessor();
+    REQUIRE_FALSE(fileExists(file));
+  }
+
+  SECTION("a file linked into the directory") {
+    const std::string source = other_path + utils::file::FileUtils::get_separator() + "linked";
+    const std::string file = temp_path + utils::file::FileUtils::get_separator() + "linked";
+    writeFile(source, "linked content");
+    // a link is only reported as created
+    REQUIRE(0 == link(source.c_str(), file.c_str()));
+    plan->runCurrentProcessor();
+    REQUIRE_FALSE(fileExists(file));
+  }
+}
+
+TEST_CASE("GetFile: watched directory checks only files that can still be accepted again", "[getFileWatch]") {  // NOLINT
+  TestController testController;
+  LogTestController::getInstance().setTrace<processors::GetFile>();
+
+  auto plan = testController.createPlan();
+  char in_dir[] = "/tmp/gt.XXXXXX";
+  auto temp_path = testController.createTempDirectory(in_dir);
+
+  auto get_file = plan->addProcessor("GetFile", "Get");
+  plan->setProperty(get_file, processors::GetFile::Directory.getName(), temp_path);
+  plan->setProperty(get_file, processors::GetFile::KeepSourceFile.getName(), "false");
+  plan->setProperty(get_file, processors::GetFile::FileFilter.getName(), "accepted.*");
+  plan->setProperty(get_file, processors::GetFile::MinAge.getName(), "2 sec");
+  plan->setProperty(get_file, processors::GetFile::WatchDirectory.getName(), "true");
+  plan->runNextProcessor();  // initial listing of the empty directory
+
+  const std::string filtered = temp_path + utils::file::FileUtils::get_separator() + "filtered";
+  const std::string young = temp_path + utils::file::FileUtils::get_separator() + "accepted";
+  writeFile(filtered, "filtered content");
+  writeFile(young, "young content");
+  plan->runCurrentProcessor();
+  REQUIRE(LogTestController::getInstance().contains("Checking file: " + filtered, std::chrono::seconds(0)));
+  REQUIRE(LogTestController::getInstance().contains("Checking file: " + young, std::chrono::seconds(0)));
+  REQUIRE(fileExists(young));
+
+  LogTestController::getInstance().resetStream(LogTestController::getInstance().log_output);
+  plan->runCurrentProcessor();
+  REQUIRE_FALSE(LogTestController::getInstance().contains("Checking file: " + filtered, std::chrono::seconds(0)));
+  REQUIRE(LogTestController::getInstance().contains("Checking file: " + young, std::chrono::seconds(0)));
+
+  // the young file is accepted once it is old enough, without any further event
+  std::this_thread::sleep_for(std::chrono::seconds(3));
+  LogTestController::getInstance().resetStream(LogTestController::getInstance().log_output);
+  plan->runCurrentProcessor();
+  REQUIRE_FALSE(LogTestController::getInstance().contains("Checking file: " + filtered, std::chrono::seconds(0)));
+  REQUIRE_FALSE(fileExists(young));
+  REQUIRE(fileExists(filtered));
+}
+
+TEST_CASE("GetFile: watched directory retries files of a rolled back session", "[getFileWatch]") {  // NOLINT
+  TestController testController;
+  LogTestController::getInstance().setTrace<processors::GetFile>();
+
+  LogTestController::getInstance().setDebug<core::repository::VolatileContentRepository>();
+
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(std::string(minifi::Configure::nifi_volatile_repository_options) + core::getClassName<core::repository::VolatileContentRepository>() + ".max.count", "1");
+  auto plan = testController.createPlan(configuration);
+  char in_dir[] = "/tmp/gt.XXXXXX";
+  auto temp_path = testController.createTempDirectory(in_dir);
+
+  auto get_file = plan->addProcessor("GetFile", "Get");
+  plan->setProperty(get_file, processors::GetFile::Directory.getName(), temp_path);
+  plan->setProperty(get_file, processors::GetFile::KeepSourceFile.getName(), "false");
+  plan->setProperty(get_file, processors::GetFile::WatchDirectory.getName(), "true");
+  plan->runNextProcessor();  // initial listing of the empty directory
+
+  // fill the content repository, so that importing the file rolls the session back
+  auto claim = std::make_shared<minifi::ResourceClaim>(plan->getContentRepo());
+  REQUIRE(plan->getContentRepo()->write(claim) != nullptr);
+
+  const std::string file = temp_path + utils::file::FileUtils::get_separator() + "rolledback";
+  writeFile(file, "rolled back content");
+  plan->runCurrentProcessor();
+  REQUIRE(fileExists(file));
+  REQUIRE(LogTestController::getInstance().contains("Repo is full"));
+
+  REQUIRE(plan->getContentRepo()->remove(claim));
+  plan->runCurrentProcessor();
+  REQUIRE_FALSE(fileExists(file));
+}
+#endif
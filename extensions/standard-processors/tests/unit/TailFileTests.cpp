@@ -711,3 +711,143 @@ TEST_CASE("TailFileWithMultileRolledOverFiles", "[tailfiletest2]") {
 
   REQUIRE(LogTestController::getInstance().contains(std::string("Logged 2 flow files")));
 }
+
+TEST_CASE("TailFileBatchesDelimitedEntries", "[tailfiletest2]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<TestPlan>();
+  LogTestController::getInstance().setTrace<processors::TailFile>();
+  LogTestController::getInstance().setTrace<processors::LogAttribute>();
+
+  auto plan = testController.createPlan();
+
+  char format[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+
+  std::stringstream temp_file;
+  temp_file << dir << utils::file::FileUtils::get_separator() << TMP_FILE;
+  std::ofstream tmpfile;
+  tmpfile.open(temp_file.str(), std::ios::out | std::ios::binary);
+  tmpfile << "one\ntwo\nthree\nfour\nfive";
+  tmpfile.close();
+
+  std::stringstream state_file;
+  state_file << dir << utils::file::FileUtils::get_separator() << STATE_FILE;
+
+  auto tail_file = plan->addProcessor("TailFile", "Tail");
+  plan->setProperty(tail_file, processors::TailFile::FileName.getName(), temp_file.str());
+  plan->setProperty(tail_file, processors::TailFile::StateFile.getName(), state_file.str());
+  plan->setProperty(tail_file, processors::TailFile::Delimiter.getName(), "\n");
+  plan->setProperty(tail_file, processors::TailFile::BatchSize.getName(), "2");
+  auto log_attr = plan->addProcessor("LogAttribute", "Log", core::Relationship("success", "description"), true);
+  plan->setProperty(log_attr, processors::LogAttribute::FlowFilesToLog.getName(), "0");
+  plan->setProperty(log_attr, processors::LogAttribute::LogPayload.getName(), "true");
+
+  plan->runNextProcessor();  // Tail
+
+  // the state is stored once, when the session is committed
+  std::ifstream state(state_file.str() + "." + tail_file->getUUIDStr());
+  std::string state_content((std::istreambuf_iterator<char>(state)), std::istreambuf_iterator<char>());
+  REQUIRE(state_content.find(std::string("POSITION.") + TMP_FILE + "=19") != std::string::npos);
+
+  plan->runNextProcessor();  // Log
+
+  REQUIRE(LogTestController::getInstance().contains("Logged 2 flow files"));
+  REQUIRE(LogTestController::getInstance().contains("minifi-tmpfile.0-7.txt"));
+  REQUIRE(LogTestController::getInstance().contains("minifi-tmpfile.8-18.txt"));
+  REQUIRE(LogTestController::getInstance().contains("one\ntwo"));
+  REQUIRE(LogTestController::getInstance().contains("three\nfour"));
+
+  std::ofstream appendStream(temp_file.str(), std::ios_base::app | std::ios_base::binary);
+  appendStream << "\n";
+  appendStream.close();
+
+  plan->reset();
+  plan->runNextProcessor();  // Tail
+  plan->runNextProcessor();  // Log
+
+  // an incomplete batch is not held back
+  REQUIRE(LogTestController::getInstance().contains("minifi-tmpfile.19-23.txt"));
+
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("TailFileTailsRolledBackDataAgain", "[tailfiletest2]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<minifi::processors::TailFile>();
+  LogTestController::getInstance().setDebug<minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+  std::shared_ptr<core::Processor> tailfile = plan->addProcessor("TailFile", "tailfileProc");
+  plan->addProcessor("LogAttribute", "logattribute", core::Relationship("success", "description"), true);
+
+  char format[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+
+  std::string temp_file = dir + utils::file::FileUtils::get_separator() + TMP_FILE;
+  std::ofstream tmpfile(temp_file, std::ios::out | std::ios::binary);
+  tmpfile << NEWLINE_FILE;
+  tmpfile.close();
+
+  plan->setProperty(tailfile, org::apache::nifi::minifi::processors::TailFile::FileName.getName(), temp_file);
+  plan->setProperty(tailfile, org::apache::nifi::minifi::processors::TailFile::StateFile.getName(), dir + utils::file::FileUtils::get_separator() + STATE_FILE);
+  plan->setProperty(tailfile, org::apache::nifi::minifi::processors::TailFile::Delimiter.getName(), "\n");
+
+  plan->runNextProcessor([&tailfile](const std::shared_ptr<core::ProcessContext> context, const std::shared_ptr<core::ProcessSession> session) {
+    tailfile->onTrigger(context, session);
+    session->rollback();
+  });
+  REQUIRE(LogTestController::getInstance().contains("1 flowfiles were received from TailFile input"));
+  LogTestController::getInstance().reset();
+  LogTestController::getInstance().setTrace<minifi::processors::TailFile>();
+  LogTestController::getInstance().setDebug<minifi::processors::LogAttribute>();
+
+  plan->runCurrentProcessor();  // tails the rolled back line again
+  plan->runNextProcessor();  // Log
+
+  REQUIRE(LogTestController::getInstance().contains("Logged 1 flow files"));
+  REQUIRE(LogTestController::getInstance().contains("minifi-tmpfile.0-13.txt"));
+
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("TailFileSkipsFilesOfPendingSessions", "[tailfiletest2]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<minifi::processors::TailFile>();
+  LogTestController::getInstance().setDebug<minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+  std::shared_ptr<core::Processor> tailfile = plan->addProcessor("TailFile", "tailfileProc");
+  plan->addProcessor("LogAttribute", "logattribute", core::Relationship("success", "description"), true);
+
+  char format[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+
+  std::string temp_file = dir + utils::file::FileUtils::get_separator() + TMP_FILE;
+  std::ofstream tmpfile(temp_file, std::ios::out | std::ios::binary);
+  tmpfile << NEWLINE_FILE;
+  tmpfile.close();
+
+  plan->setProperty(tailfile, org::apache::nifi::minifi::processors::TailFile::FileName.getName(), temp_file);
+  plan->setProperty(tailfile, org::apache::nifi::minifi::processors::TailFile::StateFile.getName(), dir + utils::file::FileUtils::get_separator() + STATE_FILE);
+  plan->setProperty(tailfile, org::apache::nifi::minifi::processors::TailFile::Delimiter.getName(), "\n");
+
+  plan->runNextProcessor([&tailfile](const std::shared_ptr<core::ProcessContext> context, const std::shared_ptr<core::ProcessSession> session) {
+    tailfile->onTrigger(context, session);
+    // a concurrent task must not tail the file from the position of the uncommitted session
+    auto concurrent_session = std::make_shared<core::ProcessSession>(context);
+    tailfile->onTrigger(context, concurrent_session);
+    session->rollback();
+  });
+  REQUIRE(LogTestController::getInstance().contains("waits for the session of another task"));
+  LogTestController::getInstance().reset();
+  LogTestController::getInstance().setTrace<minifi::processors::TailFile>();
+  LogTestController::getInstance().setDebug<minifi::processors::LogAttribute>();
+
+  plan->runCurrentProcessor();  // the rollback made the file available again
+  plan->runNextProcessor();  // Log
+
+  REQUIRE(LogTestController::getInstance().contains("Logged 1 flow files"));
+  REQUIRE(LogTestController::getInstance().contains("minifi-tmpfile.0-13.txt"));
+
+  LogTestController::getInstance().reset();
+}
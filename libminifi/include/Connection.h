@@ -143,10 +143,9 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   bool isEmpty();
   // Check whether the queue is full to apply back pressure
   bool isFull();
-  // Get queue size
+  // Get queue size, read without taking the queue lock so that metrics can be sampled cheaply
   uint64_t getQueueSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
+    return queued_count_;
   }
   // Get queue data size
   uint64_t getQueueDataSize() {
@@ -209,6 +208,8 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   std::mutex mutex_;
   // Queued data size
   std::atomic<uint64_t> queued_data_size_;
+  // Number of queued flow files, maintained alongside queue_
+  std::atomic<uint64_t> queued_count_;
   // Queue for the Flow File
   std::queue<std::shared_ptr<core::FlowFile>> queue_;
   // flow repository
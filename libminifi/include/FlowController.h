@@ -47,6 +47,7 @@
 #include "core/Property.h"
 #include "core/state/nodes/MetricsBase.h"
 #include "utils/Id.h"
+#include "core/state/MetricsPublisher.h"
 #include "core/state/StateManager.h"
 #include "core/state/nodes/FlowInformation.h"
 namespace org {
@@ -309,8 +310,19 @@ class FlowController : public core::controller::ControllerServiceProvider, publi
 
   void initializeC2();
 
+  /**
+   * Creates the metrics publisher defined in the configuration, if any, and loads the metric
+   * nodes it serves when C2 does not.
+   */
+  void initializeMetricsPublisher();
+
  protected:
 
+  /**
+   * Builds the queue, repository and processor metric nodes of the current flow.
+   */
+  void loadMetricsNodes();
+
   void loadC2ResponseConfiguration();
 
   void loadC2ResponseConfiguration(const std::string &prefix);
@@ -394,6 +406,8 @@ class FlowController : public core::controller::ControllerServiceProvider, publi
   std::map<std::string, std::shared_ptr<state::response::ResponseNode>> component_metrics_;
 
   std::map<uint8_t, std::vector<std::shared_ptr<state::response::ResponseNode>>> component_metrics_by_id_;
+
+  std::shared_ptr<state::MetricsPublisher> metrics_publisher_;
   // metrics last run
   std::chrono::steady_clock::time_point last_metrics_capture_;
 
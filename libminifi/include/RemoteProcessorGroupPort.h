@@ -20,6 +20,8 @@
 #ifndef __REMOTE_PROCESSOR_GROUP_PORT_H__
 #define __REMOTE_PROCESSOR_GROUP_PORT_H__
 
+#include <chrono>
+#include <map>
 #include <mutex>
 #include <memory>
 #include <stack>
@@ -29,6 +31,7 @@
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
 #include "sitetosite/SiteToSiteClient.h"
+#include "sitetosite/PeerSelector.h"
 #include "io/StreamFactory.h"
 #include "controllers/SSLContextService.h"
 #include "core/logging/LoggerConfiguration.h"
@@ -86,6 +89,10 @@ class RemoteProcessorGroupPort : public core::Processor {
         timeout_(0),
         http_enabled_(false),
         bypass_rest_api_(false),
+        load_balanced_(false),
+        batch_count_(0),
+        batch_size_(0),
+        batch_duration_(0),
         ssl_service(nullptr),
         logger_(logging::LoggerFactory<RemoteProcessorGroupPort>::getLogger()) {
     client_type_ = sitetosite::CLIENT_TYPE::RAW;
@@ -108,6 +115,10 @@ class RemoteProcessorGroupPort : public core::Processor {
   static core::Property SSLContext;
   static core::Property port;
   static core::Property portUUID;
+  static core::Property batchCount;
+  static core::Property batchSize;
+  static core::Property batchDuration;
+  static core::Property loadBalancingStrategy;
   // Supported Relationships
   static core::Relationship relation;
  public:
@@ -169,7 +180,7 @@ class RemoteProcessorGroupPort : public core::Processor {
   // refresh remoteSite2SiteInfo via nifi rest api
   std::pair<std::string, int> refreshRemoteSite2SiteInfo();
 
-  // refresh site2site peer list
+  // refresh site2site peer list, must not be called while holding peer_mutex_
   void refreshPeerList();
 
   virtual void notifyStop();
@@ -197,6 +208,33 @@ class RemoteProcessorGroupPort : public core::Processor {
   std::unique_ptr<sitetosite::SiteToSiteClient> getNextProtocol(bool create);
   void returnProtocol(std::unique_ptr<sitetosite::SiteToSiteClient> protocol);
 
+  /**
+   * Obtains a protocol for the peer chosen by the peer selector, reusing an idle one when available.
+   */
+  std::unique_ptr<sitetosite::SiteToSiteClient> getNextLoadBalancedProtocol(bool create);
+
+  /**
+   * Creates a protocol from the configuration, applying the batch settings of this port.
+   */
+  std::unique_ptr<sitetosite::SiteToSiteClient> createProtocol(const sitetosite::SiteToSiteClientConfiguration &config);
+
+  /**
+   * Refreshes the peer list, and with it the FlowFile counts that weigh the peers, once they are older than the refresh period.
+   */
+  void refreshStalePeerList();
+
+  /**
+   * Queries the peers of the remote instance. Performs network I/O, so it must not be called while holding peer_mutex_.
+   * @param peers receives the peer statuses
+   * @return false if the remote instance could not be reached
+   */
+  bool fetchPeerList(std::vector<sitetosite::PeerStatus> &peers);
+
+  /**
+   * Excludes the peer of a protocol that failed its transaction from the load balanced selection for a while.
+   */
+  void penalizePeer(const std::unique_ptr<sitetosite::SiteToSiteClient> &protocol);
+
   moodycamel::ConcurrentQueue<std::unique_ptr<sitetosite::SiteToSiteClient>> available_protocols_;
 
   std::shared_ptr<Configure> configure_;
@@ -227,6 +265,16 @@ class RemoteProcessorGroupPort : public core::Processor {
   std::vector<sitetosite::PeerStatus> peers_;
   std::atomic<int> peer_index_;
   std::mutex peer_mutex_;
+  // distribute transactions across peers by their FlowFile counts rather than round robin
+  bool load_balanced_;
+  sitetosite::PeerSelector peer_selector_;
+  // idle protocols of the load balanced mode, keyed by peer
+  std::map<std::string, std::vector<std::unique_ptr<sitetosite::SiteToSiteClient>>> peer_protocols_;
+  std::chrono::steady_clock::time_point last_peer_refresh_;
+  // batch settings applied to every transaction
+  uint64_t batch_count_;
+  uint64_t batch_size_;
+  uint64_t batch_duration_;
   std::string rest_user_name_;
   std::string rest_password_;
 
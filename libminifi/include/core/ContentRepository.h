@@ -55,6 +55,31 @@ class ContentRepository : public StreamManager<minifi::ResourceClaim> {
    */
   virtual void stop() = 0;
 
+  /**
+   * Makes the file at source the content of the claim without streaming it through the process,
+   * for repositories that can adopt files directly.
+   * @param source path of the file to import
+   * @param claim claim that receives the content
+   * @param keep_source whether the file must remain at source. If false the repository may move it.
+   * @return false if the file was not imported, in which case the caller has to write the content
+   */
+  virtual bool importFile(const std::string &source, const std::shared_ptr<minifi::ResourceClaim> &claim, bool keep_source) {
+    return false;
+  }
+
+  /**
+   * Writes content of the claim to a new file without streaming it through the process, for
+   * repositories that can let the kernel copy it.
+   * @param claim claim whose content is exported
+   * @param offset offset of the content within the claim
+   * @param length length of the content
+   * @param destination path of the file to create
+   * @return false if the content was not exported, in which case the caller has to read it
+   */
+  virtual bool exportFile(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length, const std::string &destination) {
+    return false;
+  }
+
   /**
    * Removes an item if it was orphan
    */
@@ -102,6 +102,18 @@ class ProcessContext : public controller::ControllerServiceLookup, public core::
   virtual bool getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
     return getDynamicProperty(property.getName(), value);
   }
+  /**
+   * Evaluates a dynamic property as a predicate.
+   * @param value whether the property evaluated to "true"
+   */
+  virtual bool getDynamicProperty(const Property &property, bool &value, const std::shared_ptr<FlowFile> &flow_file) {
+    std::string str;
+    if (!getDynamicProperty(property, str, flow_file)) {
+      return false;
+    }
+    value = str == "true";
+    return true;
+  }
   std::vector<std::string> getDynamicPropertyKeys() const {
     return processor_node_->getDynamicPropertyKeys();
   }
@@ -199,6 +211,14 @@ class ProcessContext : public controller::ControllerServiceLookup, public core::
     return controller_service_provider_->getControllerServiceName(identifier);
   }
 
+  /**
+   * @return the controller service provider, which thread pools of the processor use to
+   * find the agent wide thread limits.
+   */
+  std::shared_ptr<core::controller::ControllerServiceProvider> getControllerServiceProvider() const {
+    return controller_service_provider_;
+  }
+
   void initializeContentRepository(const std::string& home) {
       configure_->setHome(home);
       content_repo_->initialize(configure_);
@@ -25,6 +25,7 @@
 #include <atomic>
 #include <algorithm>
 #include <set>
+#include <functional>
 
 #include "ProcessContext.h"
 #include "FlowFileRecord.h"
@@ -64,6 +65,20 @@ class ProcessSession : public ReferenceContainer {
   void commit();
   // Roll Back the session
   void rollback();
+  /**
+   * Registers a callback that runs once the session has been committed successfully.
+   * Callbacks are dropped when the session is rolled back.
+   */
+  void addCommitCallback(std::function<void()> callback) {
+    commit_callbacks_.push_back(std::move(callback));
+  }
+  /**
+   * Registers a callback that runs when the session is rolled back, e.g. to restore state that was
+   * advanced for the flow files of the session. Callbacks are dropped when the session is committed.
+   */
+  void addRollbackCallback(std::function<void()> callback) {
+    rollback_callbacks_.push_back(std::move(callback));
+  }
   // Get Provenance Report
   std::shared_ptr<provenance::ProvenanceReporter> getProvenanceReporter() {
     return provenance_report_;
@@ -127,6 +142,15 @@ class ProcessSession : public ReferenceContainer {
   bool exportContent(const std::string &destination, const std::string &tmpFileName, const std::shared_ptr<core::FlowFile> &flow,
   bool keepContent);
 
+  /**
+   * Lets the content repository write the content of the flow file to a new file, which avoids
+   * reading the content into the process where the repository supports it.
+   * @param destination file to create
+   * @param flow flow file
+   * @return false if the repository cannot export the content, in which case it has to be read
+   */
+  bool exportFile(const std::string &destination, const std::shared_ptr<core::FlowFile> &flow);
+
   // Stash the content to a key
   void stash(const std::string &key, const std::shared_ptr<core::FlowFile> &flow);
   // Restore content previously stashed to a key
@@ -160,6 +184,10 @@ class ProcessSession : public ReferenceContainer {
   std::shared_ptr<logging::Logger> logger_;
   // Provenance Report
   std::shared_ptr<provenance::ProvenanceReporter> provenance_report_;
+  // Callbacks to run after a successful commit
+  std::vector<std::function<void()>> commit_callbacks_;
+  // Callbacks to run when the session is rolled back
+  std::vector<std::function<void()>> rollback_callbacks_;
 
   static std::shared_ptr<utils::IdGenerator> id_generator_;
 };
@@ -42,6 +42,7 @@
 #include "ProcessContext.h"
 #include "ProcessSession.h"
 #include "ProcessSessionFactory.h"
+#include "ProcessorStatistics.h"
 #include "Scheduling.h"
 #include <stack>
 
@@ -207,6 +208,10 @@ class Processor : public Connectable, public ConfigurableComponent, public std::
     else
       return 0;
   }
+  // Get the counters of the work done by this processor
+  std::shared_ptr<ProcessorStatistics> getStatistics() const {
+    return statistics_;
+  }
   // Whether flow file queued in incoming connection
   bool flowFilesQueued();
   // Whether flow file queue full in any of the outgoin connection
@@ -296,6 +301,8 @@ class Processor : public Connectable, public ConfigurableComponent, public std::
 
   std::string cron_period_;
 
+  std::shared_ptr<ProcessorStatistics> statistics_;
+
  private:
 
   // Mutex for protection
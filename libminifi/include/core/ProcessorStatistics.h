@@ -0,0 +1,113 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_PROCESSORSTATISTICS_H_
+#define LIBMINIFI_INCLUDE_CORE_PROCESSORSTATISTICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "utils/LatencyHistogram.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Purpose: Counters of the work done by a single processor: how often it was triggered, how long
+ * its triggers and session commits took and how many FlowFiles and bytes its sessions consumed
+ * and produced. Latencies are recorded in microseconds.
+ */
+class ProcessorStatistics {
+ public:
+  ProcessorStatistics()
+      : invocations_(0),
+        flow_files_in_(0),
+        flow_files_out_(0),
+        bytes_in_(0),
+        bytes_out_(0) {
+  }
+
+  ProcessorStatistics(const ProcessorStatistics &other) = delete;
+  ProcessorStatistics &operator=(const ProcessorStatistics &other) = delete;
+
+  void recordTrigger(std::chrono::steady_clock::duration duration) {
+    invocations_.fetch_add(1, std::memory_order_relaxed);
+    trigger_latency_.record(toMicros(duration));
+  }
+
+  void recordCommit(std::chrono::steady_clock::duration duration, uint64_t flow_files_in, uint64_t bytes_in, uint64_t flow_files_out, uint64_t bytes_out) {
+    commit_latency_.record(toMicros(duration));
+    flow_files_in_.fetch_add(flow_files_in, std::memory_order_relaxed);
+    bytes_in_.fetch_add(bytes_in, std::memory_order_relaxed);
+    flow_files_out_.fetch_add(flow_files_out, std::memory_order_relaxed);
+    bytes_out_.fetch_add(bytes_out, std::memory_order_relaxed);
+  }
+
+  uint64_t getInvocations() const {
+    return invocations_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getFlowFilesIn() const {
+    return flow_files_in_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getFlowFilesOut() const {
+    return flow_files_out_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getBytesIn() const {
+    return bytes_in_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getBytesOut() const {
+    return bytes_out_.load(std::memory_order_relaxed);
+  }
+
+  const utils::LatencyHistogram &getTriggerLatency() const {
+    return trigger_latency_;
+  }
+
+  const utils::LatencyHistogram &getCommitLatency() const {
+    return commit_latency_;
+  }
+
+ private:
+  static uint64_t toMicros(std::chrono::steady_clock::duration duration) {
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    return micros > 0 ? static_cast<uint64_t>(micros) : 0;
+  }
+
+  std::atomic<uint64_t> invocations_;
+  std::atomic<uint64_t> flow_files_in_;
+  std::atomic<uint64_t> flow_files_out_;
+  std::atomic<uint64_t> bytes_in_;
+  std::atomic<uint64_t> bytes_out_;
+  utils::LatencyHistogram trigger_latency_;
+  utils::LatencyHistogram commit_latency_;
+};
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_PROCESSORSTATISTICS_H_ */
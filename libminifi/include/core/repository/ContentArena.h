@@ -0,0 +1,176 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_CONTENTARENA_H_
+#define LIBMINIFI_INCLUDE_CORE_REPOSITORY_CONTENTARENA_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+/**
+ * Chunk of arena memory holding part of the content of a claim.
+ */
+struct ContentChunk {
+  uint8_t *data;
+  size_t capacity;
+  void *slab;
+};
+
+/**
+ * Purpose: Allocator for in memory content.
+ *
+ * Memory is reserved in slabs of SLAB_SIZE bytes, each of which is cut into chunks of a single size
+ * class. The bytes reserved by slabs never exceed the maximum the arena was created with, so the
+ * memory used for content is bounded exactly rather than estimated. Slabs whose chunks are all free
+ * are returned to the system, except for one per size class that is kept to avoid allocator churn.
+ */
+class ContentArena {
+ public:
+  static constexpr size_t SLAB_SIZE = 64 * 1024;
+  static constexpr size_t SIZE_CLASS_COUNT = 3;
+  static const std::array<size_t, SIZE_CLASS_COUNT> CHUNK_SIZES;
+
+  explicit ContentArena(size_t max_bytes);
+
+  /**
+   * Allocates the smallest chunk that fits size bytes, or a chunk of the largest size class.
+   * @param size bytes requested
+   * @param chunk allocated chunk
+   * @return false if the arena is exhausted
+   */
+  bool allocate(size_t size, ContentChunk &chunk);
+
+  /**
+   * Returns a chunk to the arena.
+   */
+  void release(const ContentChunk &chunk);
+
+  /**
+   * Provides the bytes reserved by slabs.
+   */
+  size_t getReservedBytes() const {
+    return reserved_bytes_;
+  }
+
+  /**
+   * Provides the bytes of content stored in chunks.
+   */
+  size_t getUsedBytes() const {
+    return used_bytes_;
+  }
+
+  void addUsedBytes(size_t bytes) {
+    used_bytes_ += bytes;
+  }
+
+  void removeUsedBytes(size_t bytes) {
+    used_bytes_ -= bytes;
+  }
+
+  size_t getMaxBytes() const {
+    return max_bytes_;
+  }
+
+ private:
+  struct Slab {
+    std::unique_ptr<uint8_t[]> memory;
+    size_t size_class;
+    size_t chunk_count;
+    std::vector<uint8_t*> free_chunks;
+  };
+
+  struct SizeClass {
+    // slabs with at least one free chunk
+    std::vector<Slab*> available;
+    // slabs without used chunks
+    size_t empty_slabs;
+  };
+
+  Slab *createSlab(size_t size_class);
+
+  void releaseSlab(Slab *slab);
+
+  /**
+   * Returns the slabs without used chunks to the system.
+   */
+  void releaseEmptySlabs();
+
+  const size_t max_bytes_;
+
+  std::mutex mutex_;
+  std::atomic<size_t> reserved_bytes_;
+  std::atomic<size_t> used_bytes_;
+  std::array<SizeClass, SIZE_CLASS_COUNT> size_classes_;
+  std::unordered_map<Slab*, std::unique_ptr<Slab>> slabs_;
+};
+
+/**
+ * Purpose: Content of a single claim, stored as a list of arena chunks so that appending
+ * never reallocates or copies what was written before.
+ */
+class ArenaContent {
+ public:
+  explicit ArenaContent(const std::shared_ptr<ContentArena> &arena)
+      : arena_(arena),
+        length_(0),
+        capacity_(0) {
+  }
+
+  ~ArenaContent();
+
+  /**
+   * Appends size bytes. Either all bytes are appended or, if the arena is exhausted, none.
+   * @return whether the bytes were appended
+   */
+  bool append(const uint8_t *data, size_t size);
+
+  /**
+   * Copies up to size bytes starting at offset into buf.
+   * @return number of bytes copied
+   */
+  size_t read(size_t offset, uint8_t *buf, size_t size) const;
+
+  size_t getLength() const;
+
+ private:
+  std::shared_ptr<ContentArena> arena_;
+  mutable std::mutex mutex_;
+  std::vector<ContentChunk> chunks_;
+  size_t length_;
+  size_t capacity_;
+};
+
+} /* namespace repository */
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_REPOSITORY_CONTENTARENA_H_ */
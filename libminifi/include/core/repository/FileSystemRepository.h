@@ -59,8 +59,27 @@ class FileSystemRepository : public core::ContentRepository, public core::CoreCo
 
   virtual bool remove(const std::shared_ptr<minifi::ResourceClaim> &claim);
 
+  /**
+   * Imports the file by renaming it into the repository. Kept sources, files on other file
+   * systems and symbolic links are reflinked or copied by the kernel. Other special files are not imported.
+   */
+  virtual bool importFile(const std::string &source, const std::shared_ptr<minifi::ResourceClaim> &claim, bool keep_source);
+
+  /**
+   * Exports the content by reflinking it where the file system supports it, and otherwise by
+   * copying it in the kernel.
+   */
+  virtual bool exportFile(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length, const std::string &destination);
+
  private:
 
+  /**
+   * Copies length bytes starting at offset of source into a new file at destination without reading
+   * them into the process.
+   * @return false if the kernel cannot copy between the files. Nothing is left at destination then.
+   */
+  bool copyFile(const std::string &source, uint64_t offset, uint64_t length, const std::string &destination);
+
   std::shared_ptr<logging::Logger> logger_;
 };
 
@@ -18,9 +18,15 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_VolatileContentRepository_H_
 #define LIBMINIFI_INCLUDE_CORE_REPOSITORY_VolatileContentRepository_H_
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include "core/Core.h"
 #include "AtomicRepoEntries.h"
-#include "io/AtomicEntryStream.h"
+#include "ContentArena.h"
 #include "../ContentRepository.h"
 #include "core/repository/VolatileRepository.h"
 #include "properties/Configure.h"
@@ -36,29 +42,22 @@ namespace repository {
 /**
  * Purpose: Stages content into a volatile area of memory. Note that   when the maximum number
  * of entries is consumed we will rollback a session to wait for others to be freed.
+ *
+ * Content is stored in a ContentArena, so max.bytes bounds the memory reserved for content exactly.
  */
 class VolatileContentRepository : public core::ContentRepository, public virtual core::repository::VolatileRepository<std::shared_ptr<minifi::ResourceClaim>> {
  public:
 
-  static const char *minimal_locking;
-
   explicit VolatileContentRepository(std::string name = getClassName<VolatileContentRepository>())
       : core::SerializableComponent(name),
         core::repository::VolatileRepository<std::shared_ptr<minifi::ResourceClaim>>(name),
-        minimize_locking_(true),
+        claim_count_(0),
         logger_(logging::LoggerFactory<VolatileContentRepository>::getLogger()) {
     max_count_ = 15000;
+    arena_ = std::make_shared<ContentArena>(max_size_);
   }
   virtual ~VolatileContentRepository() {
     logger_->log_debug("Clearing repository");
-    if (!minimize_locking_) {
-      std::lock_guard<std::mutex> lock(map_mutex_);
-      for (const auto &item : master_list_) {
-        delete item.second;
-      }
-      master_list_.clear();
-    }
-
   }
 
   /**
@@ -75,6 +74,7 @@ class VolatileContentRepository : public core::ContentRepository, public virtual
   /**
    * Creates writable stream.
    * @param claim resource claim
+   * @param append whether to write after the existing content of the claim, otherwise the existing content is replaced
    * @return BaseStream shared pointer that represents the stream the consumer will write to.
    */
   virtual std::shared_ptr<io::BaseStream> write(const std::shared_ptr<minifi::ResourceClaim> &claim, bool append);
@@ -102,6 +102,13 @@ class VolatileContentRepository : public core::ContentRepository, public virtual
    */
   virtual bool remove(const std::shared_ptr<minifi::ResourceClaim> &claim);
 
+  /**
+   * Provides the bytes of content currently stored.
+   */
+  virtual uint64_t getRepoSize() {
+    return arena_->getUsedBytes();
+  }
+
  protected:
 
   virtual void start();
@@ -113,20 +120,32 @@ class VolatileContentRepository : public core::ContentRepository, public virtual
     return std::dynamic_pointer_cast<T2>(shared_from_this());
   }
 
+  /**
+   * Looks up the content of the claim.
+   * @return content or nullptr if the claim is not stored
+   */
+  std::shared_ptr<ArenaContent> getContent(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
  private:
 
-  bool minimize_locking_;
+  static constexpr size_t INDEX_SHARDS = 16;
+
+  // claims are spread over independently locked shards so that concurrent sessions rarely contend
+  struct IndexShard {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<ArenaContent>> contents;
+  };
+
+  IndexShard &getShard(const std::string &key) {
+    return index_shards_[std::hash<std::string>()(key) % INDEX_SHARDS];
+  }
 
-  // function pointers that are associated with the claims.
-  std::function<bool(std::shared_ptr<minifi::ResourceClaim>, std::shared_ptr<minifi::ResourceClaim>)> resource_claim_comparator_;
-  std::function<bool(std::shared_ptr<minifi::ResourceClaim>)> resource_claim_check_;
-  std::function<void(std::shared_ptr<minifi::ResourceClaim>)> claim_reclaimer_;
+  std::shared_ptr<ContentArena> arena_;
 
-  // mutex and master list that represent a cache of Atomic entries. this exists so that we don't have to walk the atomic entry list.
-  // The idea is to reduce the computational complexity while keeping access as maximally lock free as we can.
-  std::mutex map_mutex_;
+  std::array<IndexShard, INDEX_SHARDS> index_shards_;
 
-  std::map<std::string, AtomicEntry<std::shared_ptr<minifi::ResourceClaim>>*> master_list_;
+  // number of claims stored, bounded by max_count_
+  std::atomic<size_t> claim_count_;
 
   // logger
   std::shared_ptr<logging::Logger> logger_;
@@ -20,8 +20,10 @@
 
 #include "core/Repository.h"
 #include <chrono>
+#include <deque>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "core/SerializableComponent.h"
 #include "core/Core.h"
 #include "Connection.h"
@@ -41,6 +43,18 @@ namespace repository {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Woverloaded-virtual"
 #endif
+
+/**
+ * Provides the key under which volatile repositories index their entries.
+ */
+inline const std::string &getVolatileIndexKey(const std::string &key) {
+  return key;
+}
+
+inline std::string getVolatileIndexKey(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  return claim != nullptr ? claim->getContentFullPath() : "";
+}
+
 /**
  * Flow File repository
  * Design: Extends Repository and implements the run function, using RocksDB as the primary substrate.
@@ -59,7 +73,7 @@ class VolatileRepository : public core::Repository, public std::enable_shared_fr
       : core::SerializableComponent(repo_name),
         Repository(repo_name.length() > 0 ? repo_name : core::getClassName<VolatileRepository>(), "", maxPartitionMillis, maxPartitionBytes, purgePeriod),
         current_size_(0),
-        current_index_(0),
+        eviction_index_(0),
         max_count_(10000),
         max_size_(maxPartitionBytes * 0.75),
         logger_(logging::LoggerFactory<VolatileRepository>::getLogger())
@@ -147,6 +161,18 @@ class VolatileRepository : public core::Repository, public std::enable_shared_fr
     purge_list_.push_back(old_value.getKey());
   }
 
+  /**
+   * Moves the value stored for key out of its entry and frees the entry's slot.
+   * @return true if the key was stored
+   */
+  bool takeValue(const T &key, RepoValue<T> &value);
+
+  /**
+   * Moves the value stored in slot out of its entry and frees the slot.
+   * @return true if the slot held a value
+   */
+  bool takeValue(size_t slot, RepoValue<T> &value);
+
   /**
    * Tests whether or not the current size exceeds the capacity
    * if the new prospectiveSize is inserted.
@@ -162,12 +188,19 @@ class VolatileRepository : public core::Repository, public std::enable_shared_fr
   std::map<std::string, std::shared_ptr<minifi::Connection>> connectionMap;
   // current size of the volatile repo.
   std::atomic<size_t> current_size_;
-  // current index.
-  std::atomic<uint16_t> current_index_;
   // value vector that exists for non blocking iteration over
   // objects that store data for this repo instance.
   std::vector<AtomicEntry<T>*> value_vector_;
 
+  // guards index_, free_slots_ and eviction_index_. Held only for O(1) operations.
+  std::mutex index_mutex_;
+  // slot in value_vector_ of every stored key
+  std::unordered_map<std::string, size_t> index_;
+  // slots in value_vector_ that hold no value
+  std::deque<size_t> free_slots_;
+  // next slot to evict once every slot is in use
+  size_t eviction_index_;
+
   // max count we are allowed to store.
   uint32_t max_count_;
   // maximum estimated size
@@ -236,9 +269,12 @@ bool VolatileRepository<T>::initialize(const std::shared_ptr<Configure> &configu
   logging::LOG_INFO(logger_) << "Resizing value_vector_ for " << getName() << " count is " << max_count_;
   logging::LOG_INFO(logger_) << "Using a maximum size for " << getName() << " of  " << max_size_;
   value_vector_.reserve(max_count_);
+  std::lock_guard<std::mutex> lock(index_mutex_);
   for (uint32_t i = 0; i < max_count_; i++) {
+    free_slots_.push_back(value_vector_.size());
     value_vector_.emplace_back(new AtomicEntry<T>(&current_size_, &max_size_));
   }
+  index_.reserve(max_count_);
   return true;
 }
 
@@ -250,44 +286,61 @@ bool VolatileRepository<T>::initialize(const std::shared_ptr<Configure> &configu
 template<typename T>
 bool VolatileRepository<T>::Put(T key, const uint8_t *buf, size_t bufLen) {
   RepoValue<T> new_value(key, buf, bufLen);
+  const std::string index_key = getVolatileIndexKey(key);
 
   const size_t size = new_value.size();
-  bool updated = false;
+  bool evicted = false;
   size_t reclaimed_size = 0;
   RepoValue<T> old_value;
-  do {
-    uint16_t private_index = current_index_.fetch_add(1);
-    // round robin through the beginning
-    if (private_index >= max_count_) {
-      uint16_t new_index = 0;
-      if (current_index_.compare_exchange_weak(new_index, 0)) {
-        private_index = 0;
-      } else {
-        continue;
-      }
+  {
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    if (value_vector_.empty()) {
+      return false;
     }
-
-    updated = value_vector_.at(private_index)->setRepoValue(new_value, old_value, reclaimed_size);
-    logger_->log_debug("Set repo value at %u out of %u updated %u current_size %u, adding %u to  %u", private_index, max_count_, updated == true, reclaimed_size, size, current_size_.load());
-    if (updated && reclaimed_size > 0) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      emplace(old_value);
+    size_t slot;
+    auto indexed = index_.find(index_key);
+    if (indexed != index_.end()) {
+      // replace the value stored for this key
+      slot = indexed->second;
+    } else if (!free_slots_.empty()) {
+      slot = free_slots_.front();
+      free_slots_.pop_front();
+      index_[index_key] = slot;
+    } else {
+      // every slot is in use, so evict in round robin order
+      slot = eviction_index_++ % value_vector_.size();
+      evicted = true;
+      index_[index_key] = slot;
+    }
+    while (!value_vector_[slot]->setRepoValue(new_value, old_value, reclaimed_size)) {
+      // the entry is briefly locked by a reader
     }
-    if (reclaimed_size > 0) {
-      /**
-       * this is okay since current_size_ is really an estimate.
-       * we don't need precise counts.
-       */
-      if (current_size_ < reclaimed_size) {
-        current_size_ = 0;
-      } else {
-        current_size_ -= reclaimed_size;
+    if (evicted) {
+      auto old_index = index_.find(getVolatileIndexKey(old_value.getKey()));
+      if (old_index != index_.end() && old_index->second == slot) {
+        index_.erase(old_index);
       }
     }
-  } while (!updated);
+    logger_->log_debug("Set repo value at %u out of %u, evicted %u current_size %u, adding %u to  %u", slot, max_count_, evicted, reclaimed_size, size, current_size_.load());
+  }
+  if (evicted && reclaimed_size > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    emplace(old_value);
+  }
+  if (reclaimed_size > 0) {
+    /**
+     * this is okay since current_size_ is really an estimate.
+     * we don't need precise counts.
+     */
+    if (current_size_ < reclaimed_size) {
+      current_size_ = 0;
+    } else {
+      current_size_ -= reclaimed_size;
+    }
+  }
   current_size_ += size;
 
-  logger_->log_debug("VolatileRepository -- put %u %u", current_size_.load(), current_index_.load());
+  logger_->log_debug("VolatileRepository -- put %u", current_size_.load());
   return true;
 }
 
@@ -301,6 +354,33 @@ bool VolatileRepository<T>::MultiPut(const std::vector<std::pair<T, std::unique_
   return true;
 }
 
+template<typename T>
+bool VolatileRepository<T>::takeValue(const T &key, RepoValue<T> &value) {
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  auto indexed = index_.find(getVolatileIndexKey(key));
+  if (indexed == index_.end()) {
+    return false;
+  }
+  const size_t slot = indexed->second;
+  index_.erase(indexed);
+  free_slots_.push_back(slot);
+  return value_vector_[slot]->getValue(key, value);
+}
+
+template<typename T>
+bool VolatileRepository<T>::takeValue(size_t slot, RepoValue<T> &value) {
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  if (!value_vector_[slot]->getValue(value)) {
+    return false;
+  }
+  auto indexed = index_.find(getVolatileIndexKey(value.getKey()));
+  if (indexed != index_.end() && indexed->second == slot) {
+    index_.erase(indexed);
+  }
+  free_slots_.push_back(slot);
+  return true;
+}
+
 /**
  * Deletes the key
  * @return status of the delete operation
@@ -308,15 +388,13 @@ bool VolatileRepository<T>::MultiPut(const std::vector<std::pair<T, std::unique_
 template<typename T>
 bool VolatileRepository<T>::Delete(T key) {
   logger_->log_debug("Delete from volatile");
-  for (auto ent : value_vector_) {
-    // let the destructor do the cleanup
-    RepoValue<T> value;
-    if (ent->getValue(key, value)) {
-      current_size_ -= value.size();
-      logger_->log_debug("Delete and pushed into purge_list from volatile");
-      emplace(value);
-      return true;
-    }
+  // let the destructor do the cleanup
+  RepoValue<T> value;
+  if (takeValue(key, value)) {
+    current_size_ -= value.size();
+    logger_->log_debug("Delete and pushed into purge_list from volatile");
+    emplace(value);
+    return true;
   }
   return false;
 }
@@ -327,15 +405,12 @@ bool VolatileRepository<T>::Delete(T key) {
  */
 template<typename T>
 bool VolatileRepository<T>::Get(const T &key, std::string &value) {
-
-  for (auto ent : value_vector_) {
-    // let the destructor do the cleanup
-    RepoValue<T> repo_value;
-    if (ent->getValue(key, repo_value)) {
-      current_size_ -= value.size();
-      repo_value.emplace(value);
-      return true;
-    }
+  // let the destructor do the cleanup
+  RepoValue<T> repo_value;
+  if (takeValue(key, repo_value)) {
+    current_size_ -= repo_value.size();
+    repo_value.emplace(value);
+    return true;
   }
   return false;
 }
@@ -344,11 +419,11 @@ template<typename T>
 bool VolatileRepository<T>::DeSerialize(std::vector<std::shared_ptr<core::SerializableComponent>> &store, size_t &max_size, std::function<std::shared_ptr<core::SerializableComponent>()> lambda) {
   size_t requested_batch = max_size;
   max_size = 0;
-  for (auto ent : value_vector_) {
+  for (size_t slot = 0; slot < value_vector_.size(); slot++) {
     // let the destructor do the cleanup
     RepoValue<T> repo_value;
 
-    if (ent->getValue(repo_value)) {
+    if (takeValue(slot, repo_value)) {
       std::shared_ptr<core::SerializableComponent> newComponent = lambda();
       // we've taken ownership of this repo value
       newComponent->DeSerialize(repo_value.getBuffer(), repo_value.getBufferSize());
@@ -373,11 +448,11 @@ template<typename T>
 bool VolatileRepository<T>::DeSerialize(std::vector<std::shared_ptr<core::SerializableComponent>> &store, size_t &max_size) {
   logger_->log_debug("VolatileRepository -- DeSerialize %u", current_size_.load());
   max_size = 0;
-  for (auto ent : value_vector_) {
+  for (size_t slot = 0; slot < value_vector_.size(); slot++) {
     // let the destructor do the cleanup
     RepoValue<T> repo_value;
 
-    if (ent->getValue(repo_value)) {
+    if (takeValue(slot, repo_value)) {
       // we've taken ownership of this repo value
       store.at(max_size)->DeSerialize(repo_value.getBuffer(), repo_value.getBufferSize());
       current_size_ -= repo_value.getBufferSize();
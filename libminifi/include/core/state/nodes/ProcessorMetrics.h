@@ -0,0 +1,123 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_STATE_NODES_PROCESSORMETRICS_H_
+#define LIBMINIFI_INCLUDE_CORE_STATE_NODES_PROCESSORMETRICS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../nodes/MetricsBase.h"
+#include "core/Processor.h"
+#include "utils/LatencyHistogram.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+namespace response {
+
+/**
+ * Justification and Purpose: Provides the invocations, FlowFiles and bytes in and out, and the
+ * distribution of the onTrigger and session commit durations of every processor, so that the
+ * processors a flow spends its time in can be identified from the C2 server.
+ */
+class ProcessorMetrics : public ResponseNode {
+ public:
+
+  ProcessorMetrics(const std::string &name, utils::Identifier &uuid)
+      : ResponseNode(name, uuid) {
+  }
+
+  ProcessorMetrics(const std::string &name)
+      : ResponseNode(name) {
+  }
+
+  ProcessorMetrics()
+      : ResponseNode("ProcessorMetrics") {
+  }
+
+  virtual std::string getName() const {
+    return "ProcessorMetrics";
+  }
+
+  void addProcessor(const std::shared_ptr<core::Processor> &processor) {
+    if (nullptr != processor) {
+      // names need not be unique within a flow
+      processors_.insert(std::make_pair(processor->getUUIDStr(), processor));
+    }
+  }
+
+  std::vector<SerializedResponseNode> serialize() {
+    std::vector<SerializedResponseNode> serialized;
+    for (const auto &entry : processors_) {
+      const auto statistics = entry.second->getStatistics();
+      SerializedResponseNode parent;
+      parent.name = entry.first;
+
+      parent.children.push_back(serializeValue("name", entry.second->getName()));
+      parent.children.push_back(serializeValue("OnTriggerInvocations", statistics->getInvocations()));
+      parent.children.push_back(serializeValue("FlowFilesIn", statistics->getFlowFilesIn()));
+      parent.children.push_back(serializeValue("BytesIn", statistics->getBytesIn()));
+      parent.children.push_back(serializeValue("FlowFilesOut", statistics->getFlowFilesOut()));
+      parent.children.push_back(serializeValue("BytesOut", statistics->getBytesOut()));
+      parent.children.push_back(serializeLatency("OnTriggerMicros", statistics->getTriggerLatency()));
+      parent.children.push_back(serializeLatency("CommitMicros", statistics->getCommitLatency()));
+
+      serialized.push_back(parent);
+    }
+    return serialized;
+  }
+
+ protected:
+
+  template<typename T>
+  static SerializedResponseNode serializeValue(const std::string &name, const T &value) {
+    SerializedResponseNode node;
+    node.name = name;
+    node.value = value;
+    return node;
+  }
+
+  static SerializedResponseNode serializeLatency(const std::string &name, const utils::LatencyHistogram &histogram) {
+    SerializedResponseNode parent;
+    parent.name = name;
+    parent.children.push_back(serializeValue("count", histogram.getCount()));
+    parent.children.push_back(serializeValue("sum", histogram.getSum()));
+    parent.children.push_back(serializeValue("mean", histogram.getMean()));
+    parent.children.push_back(serializeValue("p50", histogram.getValueAtPercentile(50.0)));
+    parent.children.push_back(serializeValue("p90", histogram.getValueAtPercentile(90.0)));
+    parent.children.push_back(serializeValue("p99", histogram.getValueAtPercentile(99.0)));
+    parent.children.push_back(serializeValue("max", histogram.getMax()));
+    return parent;
+  }
+
+  // processors by UUID
+  std::map<std::string, std::shared_ptr<core::Processor>> processors_;
+};
+
+} /* namespace metrics */
+} /* namespace state */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_STATE_NODES_PROCESSORMETRICS_H_ */
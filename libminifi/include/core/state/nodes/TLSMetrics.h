@@ -0,0 +1,102 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_STATE_NODES_TLSMETRICS_H_
+#define LIBMINIFI_INCLUDE_CORE_STATE_NODES_TLSMETRICS_H_
+
+#include <string>
+#include <vector>
+
+#include "core/Resource.h"
+#include "io/tls/TLSStatistics.h"
+#include "../nodes/MetricsBase.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+namespace response {
+
+/**
+ * Justification and Purpose: Provides the number of TLS handshakes performed by the agent's sockets
+ * and how many of them resumed a cached session, so that the cost of reconnects can be monitored.
+ */
+class TLSMetrics : public ResponseNode {
+ public:
+
+  TLSMetrics(const std::string &name, utils::Identifier &uuid)
+      : ResponseNode(name, uuid) {
+  }
+
+  TLSMetrics(const std::string &name)
+      : ResponseNode(name) {
+  }
+
+  TLSMetrics()
+      : ResponseNode("TLSMetrics") {
+  }
+
+  virtual std::string getName() const {
+    return "TLSMetrics";
+  }
+
+  std::vector<SerializedResponseNode> serialize() {
+    std::vector<SerializedResponseNode> serialized;
+    const auto &statistics = io::TLSStatistics::getInstance();
+
+    serialized.push_back(serializeHandshakes("ClientHandshakes", statistics.getClientHandshakes(), statistics.getClientResumptions()));
+    serialized.push_back(serializeHandshakes("ServerHandshakes", statistics.getServerHandshakes(), statistics.getServerResumptions()));
+
+    return serialized;
+  }
+
+ protected:
+
+  SerializedResponseNode serializeHandshakes(const std::string &name, uint64_t handshakes, uint64_t resumptions) {
+    SerializedResponseNode parent;
+    parent.name = name;
+
+    SerializedResponseNode total;
+    total.name = "handshakes";
+    total.value = handshakes;
+
+    SerializedResponseNode resumed;
+    resumed.name = "resumed";
+    resumed.value = resumptions;
+
+    SerializedResponseNode rate;
+    rate.name = "resumedPercent";
+    rate.value = handshakes > 0 ? resumptions * 100 / handshakes : uint64_t(0);
+
+    parent.children.push_back(total);
+    parent.children.push_back(resumed);
+    parent.children.push_back(rate);
+    return parent;
+  }
+};
+
+REGISTER_RESOURCE(TLSMetrics, "Node part of an AST that defines the TLS handshake and session resumption metrics subtree");
+
+} /* namespace metrics */
+} /* namespace state */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_STATE_NODES_TLSMETRICS_H_ */
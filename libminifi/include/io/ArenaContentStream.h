@@ -0,0 +1,88 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_IO_ARENACONTENTSTREAM_H_
+#define LIBMINIFI_INCLUDE_IO_ARENACONTENTSTREAM_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "BaseStream.h"
+#include "core/repository/ContentArena.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+/**
+ * Purpose: Stream over the in memory content of a claim. Reads start at the current offset, while
+ * writes are appended to the end of the content.
+ *
+ * The stream shares ownership of the content, so content removed from the repository remains
+ * readable until the last stream referencing it is destroyed.
+ */
+class ArenaContentStream : public BaseStream {
+ public:
+  explicit ArenaContentStream(const std::shared_ptr<core::repository::ArenaContent> &content)
+      : content_(content),
+        offset_(0) {
+  }
+
+  virtual void closeStream() {
+  }
+
+  /**
+   * Skip to the specified offset.
+   * @param offset offset to which we will skip
+   */
+  void seek(uint64_t offset);
+
+  virtual const uint64_t getSize() const {
+    return content_->getLength();
+  }
+
+  virtual int readData(std::vector<uint8_t> &buf, int buflen);
+
+  virtual int readData(uint8_t *buf, int buflen);
+
+  virtual int writeData(std::vector<uint8_t> &buf, int buflen);
+
+  /**
+   * Appends the value to the content.
+   * @return size or -1 if the content repository is full
+   */
+  virtual int writeData(uint8_t *value, int size);
+
+  const uint8_t *getBuffer() const {
+    throw std::runtime_error("Stream does not support this operation");
+  }
+
+ protected:
+  std::shared_ptr<core::repository::ArenaContent> content_;
+  std::mutex offset_mutex_;
+  size_t offset_;
+};
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_IO_ARENACONTENTSTREAM_H_ */
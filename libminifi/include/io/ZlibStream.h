@@ -97,6 +97,12 @@ class ZlibDecompressStream : public ZlibBaseStream {
   int writeData(uint8_t *value, int size) override;
 
  private:
+  /**
+   * Prepares inflate for the next member of a multi-member GZIP stream.
+   */
+  bool startNextMember();
+
+  ZlibCompressionFormat format_;
   std::shared_ptr<logging::Logger> logger_{logging::LoggerFactory<ZlibDecompressStream>::getLogger()};
 };
 
@@ -23,6 +23,9 @@
 #include "controllers/SSLContextService.h"
 #include <atomic>
 #include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
 #include "io/ClientSocket.h"
 #include "core/expect.h"
 #include "properties/Configure.h"
@@ -72,10 +75,7 @@ class TLSContext : public SocketContext {
  public:
   TLSContext(const std::shared_ptr<Configure> &configure, const std::shared_ptr<minifi::controllers::SSLContextService> &ssl_service = nullptr);
 
-  virtual ~TLSContext() {
-    if (0 != ctx)
-      SSL_CTX_free(ctx);
-  }
+  virtual ~TLSContext();
 
   SSL_CTX *getContext() {
     return ctx;
@@ -87,8 +87,29 @@ class TLSContext : public SocketContext {
 
   int16_t initialize(bool server_method = false);
 
+  /**
+   * Offers the session cached for the given peer, if any, for resumption by ssl.
+   */
+  void applySession(SSL *ssl, const std::string &host, uint16_t port);
+
+  /**
+   * Caches the session negotiated by ssl so that later connections to the peer can resume it.
+   */
+  void storeSession(SSL *ssl, const std::string &host, uint16_t port);
+
+  /**
+   * Drops the session cached for the given peer.
+   */
+  void removeSession(const std::string &host, uint16_t port);
+
  private:
 
+  void configureSessionCache(bool server_method);
+
+  std::mutex context_mutex_;
+  std::mutex session_mutex_;
+  // client sessions, keyed by host:port
+  std::map<std::string, SSL_SESSION*> sessions_;
 
   std::shared_ptr<logging::Logger> logger_;
   std::shared_ptr<Configure> configure_;
@@ -189,6 +210,12 @@ class TLSSocket : public Socket {
   }
 
   void close_ssl(int fd);
+
+  /**
+   * Records the completed client handshake and caches its session for resumption.
+   */
+  void onHandshakeComplete();
+
   std::atomic<bool> connected_;
   std::shared_ptr<TLSContext> context_;
   SSL* ssl_;
@@ -0,0 +1,89 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_IO_TLS_TLSSTATISTICS_H_
+#define LIBMINIFI_INCLUDE_IO_TLS_TLSSTATISTICS_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+/**
+ * Purpose: Process wide counters of the TLS handshakes performed by TLSSockets, and of how many
+ * of them resumed a previous session instead of negotiating a new one.
+ */
+class TLSStatistics {
+ public:
+  static TLSStatistics &getInstance() {
+    static TLSStatistics statistics;
+    return statistics;
+  }
+
+  void recordClientHandshake(bool resumed) {
+    client_handshakes_++;
+    if (resumed)
+      client_resumptions_++;
+  }
+
+  void recordServerHandshake(bool resumed) {
+    server_handshakes_++;
+    if (resumed)
+      server_resumptions_++;
+  }
+
+  uint64_t getClientHandshakes() const {
+    return client_handshakes_;
+  }
+
+  uint64_t getClientResumptions() const {
+    return client_resumptions_;
+  }
+
+  uint64_t getServerHandshakes() const {
+    return server_handshakes_;
+  }
+
+  uint64_t getServerResumptions() const {
+    return server_resumptions_;
+  }
+
+ private:
+  TLSStatistics()
+      : client_handshakes_(0),
+        client_resumptions_(0),
+        server_handshakes_(0),
+        server_resumptions_(0) {
+  }
+
+  std::atomic<uint64_t> client_handshakes_;
+  std::atomic<uint64_t> client_resumptions_;
+  std::atomic<uint64_t> server_handshakes_;
+  std::atomic<uint64_t> server_resumptions_;
+};
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_IO_TLS_TLSSTATISTICS_H_ */
@@ -87,6 +87,8 @@ class Configure : public Properties {
   static const char *nifi_c2_flow_id;
   static const char *nifi_c2_flow_url;
   static const char *nifi_c2_flow_base_url;
+  // metrics publisher options
+  static const char *nifi_metrics_publisher_class;
 
  private:
   std::string agent_identifier_;
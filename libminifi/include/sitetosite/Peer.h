@@ -117,11 +117,11 @@ class PeerStatus {
     return peer_;
   }
 
-  uint32_t getFlowFileCount() {
+  uint32_t getFlowFileCount() const {
     return flow_file_count_;
   }
 
-  bool getQueryForPeers() {
+  bool getQueryForPeers() const {
     return query_for_peers_;
   }
  protected:
@@ -216,6 +216,10 @@ class SiteToSitePeer : public org::apache::nifi::minifi::io::BaseStream {
   std::string getHostName() {
     return host_;
   }
+  // getHost, the host this peer was created for, same as Peer::getHost
+  const std::string &getHost() const {
+    return host_;
+  }
   // getPort
   uint16_t getPort() {
     return port_;
@@ -0,0 +1,100 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_SITETOSITE_PEERSELECTOR_H_
+#define LIBMINIFI_INCLUDE_SITETOSITE_PEERSELECTOR_H_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Peer.h"
+#include "SiteToSite.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sitetosite {
+
+/**
+ * Purpose: Distributes site to site transactions across the peers of a NiFi cluster.
+ *
+ * Peers are weighted by the FlowFile counts they reported in their PeerStatus: when sending, peers with
+ * fewer queued FlowFiles receive more transactions; when receiving, peers with more queued FlowFiles are
+ * polled more often. Selection uses smooth weighted round robin, so that consecutive transactions are
+ * spread across peers instead of bursting to the heaviest one.
+ *
+ * Peers that failed a transaction are penalized and skipped until their penalization expires. If every
+ * peer is penalized, the one whose penalization expires first is returned, so that a single node
+ * cluster keeps working as before.
+ */
+class PeerSelector {
+ public:
+  explicit PeerSelector(std::chrono::milliseconds penalization_period = std::chrono::seconds(30))
+      : penalization_period_(penalization_period) {
+  }
+
+  /**
+   * Replaces the known peers. Penalizations of peers that remain in the cluster are retained.
+   * Peers are weighed by their share of the reported FlowFiles, capped at 80%: when sending, a peer
+   * holding no FlowFiles gets five times the weight of a peer holding most of them; when receiving,
+   * the peers holding more FlowFiles are favored.
+   * @param peers peer statuses as reported by the remote instance
+   * @param direction direction of the transactions we are going to select peers for
+   */
+  void setPeers(const std::vector<PeerStatus> &peers, TransferDirection direction);
+
+  /**
+   * Selects the peer for the next transaction.
+   * @return peer or nullptr if there are no peers.
+   */
+  std::shared_ptr<Peer> getNextPeer();
+
+  /**
+   * Penalizes the given peer, excluding it from the selection for the penalization period.
+   * @param host host of the peer
+   * @param port port of the peer
+   */
+  void penalize(const std::string &host, uint16_t port);
+
+  size_t size() const;
+
+ private:
+  struct PeerEntry {
+    std::shared_ptr<Peer> peer;
+    int64_t weight;
+    int64_t current_weight;
+    std::chrono::steady_clock::time_point penalized_until;
+  };
+
+  std::chrono::milliseconds penalization_period_;
+
+  mutable std::mutex mutex_;
+
+  std::vector<PeerEntry> peers_;
+};
+
+} /* namespace sitetosite */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_SITETOSITE_PEERSELECTOR_H_ */
@@ -69,9 +69,6 @@ class RawSiteToSiteClient : public sitetosite::SiteToSiteClient {
   RawSiteToSiteClient(std::unique_ptr<SiteToSitePeer> peer)
       : logger_(logging::LoggerFactory<RawSiteToSiteClient>::getLogger()) {
     peer_ = std::move(peer);
-    _batchSize = 0;
-    _batchCount = 0;
-    _batchDuration = 0;
     _batchSendNanos = 5000000000;  // 5 seconds
     _timeOut = 30000;  // 30 seconds
     _supportedVersion[0] = 5;
@@ -91,18 +88,6 @@ class RawSiteToSiteClient : public sitetosite::SiteToSiteClient {
   }
 
  public:
-  // setBatchSize
-  void setBatchSize(uint64_t size) {
-    _batchSize = size;
-  }
-  // setBatchCount
-  void setBatchCount(uint64_t count) {
-    _batchCount = count;
-  }
-  // setBatchDuration
-  void setBatchDuration(uint64_t duration) {
-    _batchDuration = duration;
-  }
   // setTimeOut
   void setTimeOut(uint64_t time) {
     _timeOut = time;
@@ -172,12 +157,6 @@ class RawSiteToSiteClient : public sitetosite::SiteToSiteClient {
  private:
   // Logger
   std::shared_ptr<logging::Logger> logger_;
-  // Batch Count
-  std::atomic<uint64_t> _batchCount;
-  // Batch Size
-  std::atomic<uint64_t> _batchSize;
-  // Batch Duration in msec
-  std::atomic<uint64_t> _batchDuration;
   // Timeout in msec
   std::atomic<uint64_t> _timeOut;
 
@@ -59,6 +59,9 @@ class SiteToSiteClient : public core::Connectable {
       : core::Connectable("SitetoSiteClient"),
         peer_state_(IDLE),
         _batchSendNanos(5000000000),
+        _batchCount(0),
+        _batchSize(0),
+        _batchDuration(0),
         ssl_context_service_(nullptr),
         logger_(logging::LoggerFactory<SiteToSiteClient>::getLogger()) {
     _supportedVersion[0] = 5;
@@ -81,6 +84,37 @@ class SiteToSiteClient : public core::Connectable {
     ssl_context_service_ = context_service;
   }
 
+  /**
+   * Sets the maximum number of FlowFiles transferred in a single transaction. 0 means unlimited.
+   */
+  void setBatchCount(uint64_t count) {
+    _batchCount = count;
+  }
+
+  /**
+   * Sets the maximum number of content bytes transferred in a single transaction. 0 means unlimited.
+   */
+  void setBatchSize(uint64_t size) {
+    _batchSize = size;
+  }
+
+  /**
+   * Sets the maximum duration of a single transaction in milliseconds. 0 keeps the default.
+   */
+  void setBatchDuration(uint64_t duration) {
+    _batchDuration = duration;
+    if (duration > 0) {
+      _batchSendNanos = duration * 1000000;
+    }
+  }
+
+  /**
+   * Provides the peer this client transfers with.
+   */
+  const std::unique_ptr<SiteToSitePeer> &getPeer() const {
+    return peer_;
+  }
+
   /**
    * Creates a transaction using the transaction ID and the direction
    * @param transactionID transaction identifier
@@ -257,6 +291,13 @@ class SiteToSiteClient : public core::Connectable {
   // BATCH_SEND_NANOS
   uint64_t _batchSendNanos;
 
+  // Batch Count
+  std::atomic<uint64_t> _batchCount;
+  // Batch Size
+  std::atomic<uint64_t> _batchSize;
+  // Batch Duration in msec
+  std::atomic<uint64_t> _batchDuration;
+
   /***
    * versioning
    */
@@ -275,6 +316,13 @@ class SiteToSiteClient : public core::Connectable {
 
 };
 
+/**
+ * Size of the chunks in which flow file content is moved between the content repository
+ * and the site to site stream. Kept on the heap, as streaming transports may hold on to
+ * a few of these while the other side catches up.
+ */
+static constexpr size_t SITE_TO_SITE_TRANSFER_CHUNK_SIZE = 64 * 1024;
+
 // Nest Callback Class for write stream
 class WriteCallback : public OutputStreamCallback {
  public:
@@ -284,22 +332,22 @@ class WriteCallback : public OutputStreamCallback {
   DataPacket *_packet;
   //void process(std::ofstream *stream) {
   int64_t process(std::shared_ptr<io::BaseStream> stream) {
-    uint8_t buffer[16384];
-    int len = _packet->_size;
-    int total = 0;
+    std::vector<uint8_t> buffer(SITE_TO_SITE_TRANSFER_CHUNK_SIZE);
+    uint64_t len = _packet->_size;
+    uint64_t total = 0;
     while (len > 0) {
-	  int size = len < 16384 ? len : 16384; 
-      int ret = _packet->transaction_->getStream().readData(buffer, size);
+      int size = static_cast<int>(len < buffer.size() ? len : buffer.size());
+      int ret = _packet->transaction_->getStream().readData(buffer.data(), size);
       if (ret != size) {
         logging::LOG_ERROR(_packet->logger_reference_) << "Site2Site Receive Flow Size " << size << " Failed " << ret << ", should have received " << len;
         return -1;
       }
-      stream->write(buffer, size);
+      stream->write(buffer.data(), size);
       len -= size;
       total += size;
     }
-    logging::LOG_INFO(_packet->logger_reference_) << "Received " << len << " from stream";
-    return len;
+    logging::LOG_INFO(_packet->logger_reference_) << "Received " << total << " from stream";
+    return total;
   }
 };
 // Nest Callback Class for read stream
@@ -311,11 +359,11 @@ class ReadCallback : public InputStreamCallback {
   DataPacket *_packet;
   int64_t process(std::shared_ptr<io::BaseStream> stream) {
     _packet->_size = 0;
-    uint8_t buffer[8192] = { 0 };
+    std::vector<uint8_t> buffer(SITE_TO_SITE_TRANSFER_CHUNK_SIZE);
     int readSize;
     size_t size = 0;
     do {
-      readSize = stream->read(buffer, 8192);
+      readSize = stream->read(buffer.data(), buffer.size());
 
       if (readSize == 0) {
         break;
@@ -323,7 +371,7 @@ class ReadCallback : public InputStreamCallback {
       if (readSize < 0) {
         return -1;
       }
-      int ret = _packet->transaction_->getStream().writeData(buffer, readSize);
+      int ret = _packet->transaction_->getStream().writeData(buffer.data(), readSize);
       if (ret != readSize) {
         logging::LOG_INFO(_packet->logger_reference_) << "Site2Site Send Flow Size " << readSize << " Failed " << ret;
         return -1;
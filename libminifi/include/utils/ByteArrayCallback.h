@@ -87,6 +87,9 @@ class ByteInputCallBack : public InputStreamCallback {
  *
  * While calls are thread safe, the class is intended to have
  * a single consumer.
+ *
+ * When constructed with wait_on_read the consumer is expected to read concurrently with
+ * the producer, so writes block while more than max_size bytes are waiting to be read.
  */
 class ByteOutputCallback : public OutputStreamCallback {
  public:
@@ -94,6 +97,7 @@ class ByteOutputCallback : public OutputStreamCallback {
 
   explicit ByteOutputCallback(size_t max_size, bool wait_on_read = false)
       : max_size_(max_size),
+        wait_on_read_(wait_on_read),
         read_started_(wait_on_read ? false : true),
         logger_(logging::LoggerFactory<ByteOutputCallback>::getLogger()) {
     current_str_pos = 0;
@@ -131,6 +135,7 @@ class ByteOutputCallback : public OutputStreamCallback {
 
   std::atomic<bool> is_alive_;
   size_t max_size_;
+  const bool wait_on_read_;
   std::condition_variable_any spinner_;
   std::recursive_mutex vector_lock_;
   std::atomic<size_t> size_;
@@ -0,0 +1,156 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_LATENCYHISTOGRAM_H_
+#define LIBMINIFI_INCLUDE_UTILS_LATENCYHISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * Purpose: Lock free histogram of latencies, bucketed in the manner of HdrHistogram.
+ *
+ * Every power of two range is split into SUB_BUCKET_COUNT linear buckets, so a recorded value is
+ * reported with a relative error of at most 1 / SUB_BUCKET_COUNT regardless of its magnitude, while
+ * recording remains a handful of relaxed atomic increments. Values are unitless; callers decide
+ * on the unit (e.g. microseconds) and keep to it.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr uint32_t SUB_BUCKET_BITS = 3;
+  static constexpr uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+  static constexpr uint32_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+  LatencyHistogram()
+      : count_(0),
+        sum_(0),
+        max_(0) {
+    for (auto &bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  LatencyHistogram(const LatencyHistogram &other) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &other) = delete;
+
+  void record(uint64_t value) {
+    buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  uint64_t getCount() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getSum() const {
+    return sum_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getMax() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getMean() const {
+    const uint64_t count = getCount();
+    return count > 0 ? getSum() / count : 0;
+  }
+
+  /**
+   * Provides the value below or at which the given percentage of the recorded values fall, reported
+   * as the highest value of its bucket and capped by the maximum recorded value.
+   * @param percentile percentage between 0 and 100
+   */
+  uint64_t getValueAtPercentile(double percentile) const {
+    const uint64_t count = getCount();
+    if (count == 0) {
+      return 0;
+    }
+    if (percentile > 100.0) {
+      percentile = 100.0;
+    }
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * count + 0.5);
+    if (target == 0) {
+      target = 1;
+    }
+    uint64_t seen = 0;
+    for (uint32_t index = 0; index < BUCKET_COUNT; index++) {
+      seen += buckets_[index].load(std::memory_order_relaxed);
+      if (seen >= target) {
+        const uint64_t max = getMax();
+        const uint64_t upper = bucketUpperBound(index);
+        return upper < max ? upper : max;
+      }
+    }
+    return getMax();
+  }
+
+  static uint32_t bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+      return static_cast<uint32_t>(value);
+    }
+    const uint32_t exponent = 63 - countLeadingZeros(value);
+    const uint32_t shift = exponent - SUB_BUCKET_BITS;
+    const uint32_t sub_bucket = static_cast<uint32_t>(value >> shift) & (SUB_BUCKET_COUNT - 1);
+    return (shift + 1) * SUB_BUCKET_COUNT + sub_bucket;
+  }
+
+  static uint64_t bucketUpperBound(uint32_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+      return index;
+    }
+    const uint32_t shift = index / SUB_BUCKET_COUNT - 1;
+    const uint64_t lower = static_cast<uint64_t>(SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+  }
+
+ private:
+  static uint32_t countLeadingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_clzll(value));
+#else
+    uint32_t zeros = 0;
+    for (uint64_t bit = uint64_t(1) << 63; (value & bit) == 0; bit >>= 1) {
+      zeros++;
+    }
+    return zeros;
+#endif
+  }
+
+  std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+};
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_UTILS_LATENCYHISTOGRAM_H_ */
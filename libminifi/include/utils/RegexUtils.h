@@ -19,6 +19,7 @@
 #ifndef LIBMINIFI_INCLUDE_IO_REGEXUTILS_H_
 #define LIBMINIFI_INCLUDE_IO_REGEXUTILS_H_
 
+#include <string>
 #include <vector>
 #include <regex>
 
@@ -53,8 +54,23 @@ public:
   const std::vector<std::string>& getResult() const;
   const std::string& getSuffix() const;
 
+  /**
+   * Searches subject for a match, starting at offset. Unlike match, search leaves the Regex untouched,
+   * so a Regex compiled once can be shared by threads matching concurrently.
+   * @param subject string to search
+   * @param offset position in subject the search starts at, which is treated as the beginning of the input
+   * @param results receives the whole match followed by the capture groups
+   * @param match_end receives the position in subject right after the match
+   * @return whether a match was found
+   */
+  bool search(const std::string &subject, size_t offset, std::vector<std::string> &results, size_t &match_end) const;
+
+  /**
+   * @return whether subject contains a match
+   */
+  bool search(const std::string &subject) const;
+
  private:
-  std::string pat_;
   std::string suffix_;
   std::string regexStr_;
   std::vector<std::string> results_;
@@ -64,13 +80,11 @@ public:
 
   std::regex compiledRegex_;
   std::regex_constants::syntax_option_type regex_mode_;
-  std::smatch matches_;
 
 #else
 
   regex_t compiledRegex_;
   int regex_mode_;
-  std::vector<regmatch_t> matches_;
 
 #endif
 };
@@ -17,6 +17,7 @@
 #ifndef LIBMINIFI_INCLUDE_UTILS_FILEUTILS_H_
 #define LIBMINIFI_INCLUDE_UTILS_FILEUTILS_H_
 
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <vector>
@@ -61,6 +62,10 @@
 #ifdef __APPLE__
 #include <mach-o/dyld.h>
 #endif
+#ifdef __linux__
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
 
 #include "core/logging/LoggerConfiguration.h"
 #include "utils/StringUtils.h"
@@ -243,6 +248,21 @@ class FileUtils {
     return 0;
   }
 
+  static uint64_t file_size(const std::string &path) {
+#ifdef WIN32
+    struct _stat result;
+    if (_stat(path.c_str(), &result) == 0) {
+      return result.st_size;
+    }
+#else
+    struct stat result;
+    if (stat(path.c_str(), &result) == 0) {
+      return result.st_size;
+    }
+#endif
+    return 0;
+  }
+
   static bool set_last_write_time(const std::string &path, uint64_t write_time) {
 #ifdef WIN32
     struct __utimbuf64 utim;
@@ -347,6 +367,52 @@ class FileUtils {
     return 0;
   }
 
+#ifndef WIN32
+  /**
+   * Copies up to length bytes, starting at offset in source_fd, to the current position of dest_fd
+   * without passing them through user space. copy_file_range is preferred, as it lets the file system
+   * share or offload the copy; sendfile is used where it is unavailable.
+   * @return number of bytes copied, less than length if the kernel cannot copy between the files
+   */
+  static uint64_t copy_range(int source_fd, uint64_t offset, int dest_fd, uint64_t length) {
+    uint64_t copied = 0;
+#ifdef __linux__
+    // limit each call so that the counts fit into ssize_t on 32-bit platforms
+    const uint64_t max_chunk = 1 << 30;
+#ifdef SYS_copy_file_range
+    bool use_copy_file_range = true;
+#else
+    bool use_copy_file_range = false;
+#endif
+    while (copied < length) {
+      const size_t chunk = static_cast<size_t>((std::min)(length - copied, max_chunk));
+      ssize_t ret = -1;
+      if (use_copy_file_range) {
+#ifdef SYS_copy_file_range
+        loff_t source_offset = offset + copied;
+        ret = syscall(SYS_copy_file_range, source_fd, &source_offset, dest_fd, nullptr, chunk, 0);
+        if (ret < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+          use_copy_file_range = false;
+          continue;
+        }
+#endif
+      } else {
+        off_t source_offset = offset + copied;
+        ret = sendfile(dest_fd, source_fd, &source_offset, chunk);
+      }
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ret <= 0) {
+        break;
+      }
+      copied += ret;
+    }
+#endif
+    return copied;
+  }
+#endif
+
   static void addFilesMatchingExtension(const std::shared_ptr<logging::Logger> &logger, const std::string &originalPath, const std::string &extension, std::vector<std::string> &accruedFiles) {
 #ifndef WIN32
 
@@ -0,0 +1,113 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_FILE_FILEWATCHER_H_
+#define LIBMINIFI_INCLUDE_UTILS_FILE_FILEWATCHER_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include "core/logging/Logger.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+namespace file {
+
+enum FileEventType {
+  // a file was created, it may not have been written yet
+  FILE_CREATED,
+  // a file was written to or its attributes changed
+  FILE_MODIFIED,
+  // a file was closed after being written to, or moved into the directory
+  FILE_WRITTEN,
+  // a file was deleted or moved out of the directory
+  FILE_REMOVED
+};
+
+struct FileEvent {
+  FileEventType type;
+  std::string directory;
+  std::string filename;
+};
+
+/**
+ * Purpose: Reports changes to the files of a directory, so that callers can maintain a listing
+ * incrementally instead of listing the directory again.
+ *
+ * Design: Uses inotify on Linux. Where notifications are unavailable start() fails and callers
+ * keep listing the directory periodically.
+ */
+class FileWatcher {
+ public:
+  /**
+   * @param directory directory to watch
+   * @param recursive whether to watch the subdirectories, including those created later
+   */
+  FileWatcher(const std::string &directory, bool recursive);
+
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher &other) = delete;
+  FileWatcher &operator=(const FileWatcher &other) = delete;
+
+  /**
+   * Starts watching the directory. Only changes made after this call are reported.
+   * @return false if changes cannot be watched
+   */
+  bool start();
+
+  bool isWatching() const {
+    return fd_ >= 0;
+  }
+
+  /**
+   * Reports the changes that occurred since the last call, without blocking.
+   * @param callback invoked for every change
+   * @return false if changes were lost, e.g. because too many occurred in between or the
+   * directory was removed. Callers have to list the directory again then.
+   */
+  bool poll(const std::function<void(const FileEvent &event)> &callback);
+
+ private:
+  bool addWatch(const std::string &directory);
+
+  /**
+   * Watches the subdirectories of a directory that was just created and reports the files that
+   * were created in them before the watches were in place.
+   */
+  void addNewDirectory(const std::string &directory, const std::function<void(const FileEvent &event)> &callback);
+
+  std::string directory_;
+  bool recursive_;
+  int fd_;
+  // watched directory of each watch descriptor
+  std::map<int, std::string> watches_;
+  std::shared_ptr<core::logging::Logger> logger_;
+};
+
+} /* namespace file */
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_UTILS_FILE_FILEWATCHER_H_ */
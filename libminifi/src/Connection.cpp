@@ -50,6 +50,7 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
   queued_data_size_ = 0;
+  queued_count_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -66,6 +67,7 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
   queued_data_size_ = 0;
+  queued_count_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -86,6 +88,7 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
   queued_data_size_ = 0;
+  queued_count_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -107,6 +110,7 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
   queued_data_size_ = 0;
+  queued_count_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -146,6 +150,8 @@ void Connection::put(std::shared_ptr<core::FlowFile> flow) {
 
     queued_data_size_ += flow->getSize();
 
+    queued_count_++;
+
     logger_->log_debug("Enqueue flow file UUID %s to connection %s", flow->getUUIDStr(), name_);
   }
 
@@ -181,6 +187,7 @@ void Connection::multiPut(std::vector<std::shared_ptr<core::FlowFile>>& flows) {
 
       queue_.push(ff);
       queued_data_size_ += ff->getSize();
+      queued_count_++;
 
       logger_->log_debug("Enqueue flow file UUID %s to connection %s", ff->getUUIDStr(), name_);
 
@@ -222,6 +229,7 @@ std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::
     std::shared_ptr<core::FlowFile> item = queue_.front();
     queue_.pop();
     queued_data_size_ -= item->getSize();
+    queued_count_--;
 
     if (expired_duration_ > 0) {
       // We need to check for flow expiration
@@ -238,6 +246,7 @@ std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::
           // Flow record was penalized
           queue_.push(item);
           queued_data_size_ += item->getSize();
+          queued_count_++;
           break;
         }
         std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
@@ -251,6 +260,7 @@ std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::
         // Flow record was penalized
         queue_.push(item);
         queued_data_size_ += item->getSize();
+        queued_count_++;
         break;
       }
       std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
@@ -275,6 +285,7 @@ void Connection::drain() {
     }
   }
   queued_data_size_ = 0;
+  queued_count_ = 0;
   logger_->log_debug("Drain connection %s", name_);
 }
 
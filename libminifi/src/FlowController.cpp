@@ -37,9 +37,11 @@
 #include "core/state/nodes/DeviceInformation.h"
 #include "core/state/nodes/FlowInformation.h"
 #include "core/state/nodes/ProcessMetrics.h"
+#include "core/state/nodes/ProcessorMetrics.h"
 #include "core/state/nodes/QueueMetrics.h"
 #include "core/state/nodes/RepositoryMetrics.h"
 #include "core/state/nodes/SystemMetrics.h"
+#include "core/state/nodes/TLSMetrics.h"
 #include "core/state/ProcessorController.h"
 #include "yaml-cpp/yaml.h"
 #include "c2/C2Agent.h"
@@ -394,6 +396,7 @@ int16_t FlowController::start() {
         this->root_->startProcessing(timer_scheduler_, event_scheduler_, cron_scheduler_);
       }
       initializeC2();
+      initializeMetricsPublisher();
       running_ = true;
       this->protocol_->start();
       this->provenance_repo_->start();
@@ -463,29 +466,9 @@ void FlowController::initializeC2() {
       return;
     }
   }
-  device_information_.clear();
-  component_metrics_.clear();
-  component_metrics_by_id_.clear();
-  std::string class_csv;
-
-  if (root_ != nullptr) {
-    std::shared_ptr<state::response::QueueMetrics> queueMetrics = std::make_shared<state::response::QueueMetrics>();
-
-    std::map<std::string, std::shared_ptr<Connection>> connections;
-    root_->getConnections(connections);
-    for (auto con : connections) {
-      queueMetrics->addConnection(con.second);
-    }
-    device_information_[queueMetrics->getName()] = queueMetrics;
-
-    std::shared_ptr<state::response::RepositoryMetrics> repoMetrics = std::make_shared<state::response::RepositoryMetrics>();
-
-    repoMetrics->addRepository(provenance_repo_);
-    repoMetrics->addRepository(flow_file_repo_);
-
-    device_information_[repoMetrics->getName()] = repoMetrics;
-  }
+  loadMetricsNodes();
 
+  std::string class_csv;
   if (configuration_->get("nifi.c2.root.classes", class_csv)) {
     std::vector<std::string> classes = utils::StringUtils::split(class_csv, ",");
 
@@ -532,6 +515,34 @@ void FlowController::initializeC2() {
     }
   }
 
+  loadC2ResponseConfiguration();
+}
+
+void FlowController::loadMetricsNodes() {
+  // the nodes are built aside and swapped in, as they are read concurrently by C2 and the metrics publisher
+  std::map<std::string, std::shared_ptr<state::response::ResponseNode>> device_information;
+  std::map<std::string, std::shared_ptr<state::response::ResponseNode>> component_metrics;
+  std::map<uint8_t, std::vector<std::shared_ptr<state::response::ResponseNode>>> component_metrics_by_id;
+  std::string class_csv;
+
+  if (root_ != nullptr) {
+    std::shared_ptr<state::response::QueueMetrics> queueMetrics = std::make_shared<state::response::QueueMetrics>();
+
+    std::map<std::string, std::shared_ptr<Connection>> connections;
+    root_->getConnections(connections);
+    for (auto con : connections) {
+      queueMetrics->addConnection(con.second);
+    }
+    device_information[queueMetrics->getName()] = queueMetrics;
+
+    std::shared_ptr<state::response::RepositoryMetrics> repoMetrics = std::make_shared<state::response::RepositoryMetrics>();
+
+    repoMetrics->addRepository(provenance_repo_);
+    repoMetrics->addRepository(flow_file_repo_);
+
+    device_information[repoMetrics->getName()] = repoMetrics;
+  }
+
   if (configuration_->get("nifi.flow.metrics.classes", class_csv)) {
     std::vector<std::string> classes = utils::StringUtils::split(class_csv, ",");
 
@@ -545,9 +556,7 @@ void FlowController::initializeC2() {
 
       std::shared_ptr<state::response::ResponseNode> processor = std::static_pointer_cast<state::response::ResponseNode>(ptr);
 
-      std::lock_guard<std::mutex> lock(metrics_mutex_);
-
-      device_information_[processor->getName()] = processor;
+      device_information[processor->getName()] = processor;
     }
   }
 
@@ -556,6 +565,13 @@ void FlowController::initializeC2() {
   std::vector<std::shared_ptr<core::Processor>> processors;
   if (root_ != nullptr) {
     root_->getAllProcessors(processors);
+    std::shared_ptr<state::response::ProcessorMetrics> processorMetrics = std::make_shared<state::response::ProcessorMetrics>();
+    for (const auto &processor : processors) {
+      processorMetrics->addProcessor(processor);
+    }
+    device_information[processorMetrics->getName()] = processorMetrics;
+    component_metrics[processorMetrics->getName()] = processorMetrics;
+
     for (const auto &processor : processors) {
       auto rep = std::dynamic_pointer_cast<state::response::ResponseNodeSource>(processor);
       // we have a metrics source.
@@ -563,7 +579,7 @@ void FlowController::initializeC2() {
         std::vector<std::shared_ptr<state::response::ResponseNode>> metric_vector;
         rep->getResponseNodes(metric_vector);
         for (auto metric : metric_vector) {
-          component_metrics_[metric->getName()] = metric;
+          component_metrics[metric->getName()] = metric;
         }
       }
     }
@@ -582,16 +598,21 @@ void FlowController::initializeC2() {
           std::vector<std::string> classes = utils::StringUtils::split(class_definitions, ",");
 
           for (std::string clazz : classes) {
-            std::lock_guard<std::mutex> lock(metrics_mutex_);
-            auto ret = component_metrics_[clazz];
-            if (nullptr == ret) {
-              ret = device_information_[clazz];
+            std::shared_ptr<state::response::ResponseNode> ret = nullptr;
+            auto component = component_metrics.find(clazz);
+            if (component != component_metrics.end()) {
+              ret = component->second;
+            } else {
+              auto device = device_information.find(clazz);
+              if (device != device_information.end()) {
+                ret = device->second;
+              }
             }
             if (nullptr == ret) {
               logger_->log_error("No metric defined for %s", clazz);
               continue;
             }
-            component_metrics_by_id_[id].push_back(ret);
+            component_metrics_by_id[id].push_back(ret);
           }
         }
       } catch (...) {
@@ -600,7 +621,29 @@ void FlowController::initializeC2() {
     }
   }
 
-  loadC2ResponseConfiguration();
+  std::lock_guard<std::mutex> lock(metrics_mutex_);
+  device_information_.swap(device_information);
+  component_metrics_.swap(component_metrics);
+  component_metrics_by_id_.swap(component_metrics_by_id);
+}
+
+void FlowController::initializeMetricsPublisher() {
+  if (metrics_publisher_ == nullptr) {
+    std::string class_str;
+    if (!configuration_->get(Configure::nifi_metrics_publisher_class, class_str) || class_str.empty()) {
+      return;
+    }
+    metrics_publisher_ = core::ClassLoader::getDefaultClassLoader().instantiate<state::MetricsPublisher>(class_str, class_str);
+    if (nullptr == metrics_publisher_) {
+      logger_->log_error("No metrics publisher defined for %s", class_str);
+      return;
+    }
+    metrics_publisher_->initialize(configuration_, std::dynamic_pointer_cast<state::response::NodeReporter>(shared_from_this()));
+  }
+  // initializeC2 has loaded the nodes already when C2 is enabled
+  if (!c2_enabled_) {
+    loadMetricsNodes();
+  }
 }
 
 void FlowController::loadC2ResponseConfiguration(const std::string &prefix) {
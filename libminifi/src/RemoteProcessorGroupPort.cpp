@@ -58,10 +58,89 @@ core::Property RemoteProcessorGroupPort::hostName("Host Name", "Remote Host Name
 core::Property RemoteProcessorGroupPort::SSLContext("SSL Context Service", "The SSL Context Service used to provide client certificate information for TLS/SSL (https) connections.", "");
 core::Property RemoteProcessorGroupPort::port("Port", "Remote Port", "");
 core::Property RemoteProcessorGroupPort::portUUID("Port UUID", "Specifies remote NiFi Port UUID.", "");
+core::Property RemoteProcessorGroupPort::batchCount(
+    core::PropertyBuilder::createProperty("Batch Count")->withDescription("Maximum number of FlowFiles transferred in a single transaction. 0 means no limit.")->withDefaultValue<uint64_t>(0)
+        ->build());
+core::Property RemoteProcessorGroupPort::batchSize(
+    core::PropertyBuilder::createProperty("Batch Size")->withDescription("Maximum amount of content transferred in a single transaction. 0 B means no limit.")->withDefaultValue<core::DataSizeValue>(
+        "0 B")->build());
+core::Property RemoteProcessorGroupPort::batchDuration(
+    core::PropertyBuilder::createProperty("Batch Duration")->withDescription("Maximum duration of a single transaction. 0 sec keeps the default of 5 seconds.")
+        ->withDefaultValue<core::TimePeriodValue>("0 sec")->build());
+core::Property RemoteProcessorGroupPort::loadBalancingStrategy(
+    core::PropertyBuilder::createProperty("Load Balancing Strategy")->withDescription(
+        "How transactions are distributed across the peers of the remote instance. Round Robin cycles through the peers, Flow File Count weighs them by the number of "
+        "FlowFiles they report, favoring the least loaded peers when sending and the most loaded peers when receiving, and penalizes peers that fail a transaction.")
+        ->withAllowableValues<std::string>( { "Round Robin", "Flow File Count" })->withDefaultValue("Round Robin")->build());
 core::Relationship RemoteProcessorGroupPort::relation;
 
+std::unique_ptr<sitetosite::SiteToSiteClient> RemoteProcessorGroupPort::createProtocol(const sitetosite::SiteToSiteClientConfiguration &config) {
+  auto protocol = sitetosite::createClient(config);
+  if (protocol) {
+    protocol->setBatchCount(batch_count_);
+    protocol->setBatchSize(batch_size_);
+    protocol->setBatchDuration(batch_duration_);
+  }
+  return protocol;
+}
+
+namespace {
+
+/**
+ * Identifies a peer among the idle protocols. Selected peers and returned protocols both build it
+ * from the host the connection was configured with, so that the keys always match.
+ */
+std::string peerKey(const std::string &host, uint16_t port) {
+  return host + ":" + std::to_string(port);
+}
+
+}  // namespace
+
+void RemoteProcessorGroupPort::refreshStalePeerList() {
+  static const auto PEER_REFRESH_PERIOD = std::chrono::seconds(60);
+  {
+    std::lock_guard<std::mutex> lock(peer_mutex_);
+    if (std::chrono::steady_clock::now() - last_peer_refresh_ <= PEER_REFRESH_PERIOD) {
+      return;
+    }
+    // claim the refresh, so that concurrent triggers keep using the current peers instead of querying as well
+    last_peer_refresh_ = std::chrono::steady_clock::now();
+  }
+  refreshPeerList();
+}
+
+std::unique_ptr<sitetosite::SiteToSiteClient> RemoteProcessorGroupPort::getNextLoadBalancedProtocol(bool create) {
+  refreshStalePeerList();
+  auto peer = peer_selector_.getNextPeer();
+  if (peer == nullptr) {
+    return nullptr;
+  }
+  const std::string peer_key = peerKey(peer->getHost(), peer->getPort());
+  {
+    std::lock_guard<std::mutex> lock(peer_mutex_);
+    auto &idle_protocols = peer_protocols_[peer_key];
+    if (!idle_protocols.empty()) {
+      auto protocol = std::move(idle_protocols.back());
+      idle_protocols.pop_back();
+      logger_->log_debug("Reusing client for peer %s", peer_key);
+      return protocol;
+    }
+  }
+  if (!create) {
+    return nullptr;
+  }
+  logger_->log_debug("Creating client for peer %s", peer_key);
+  sitetosite::SiteToSiteClientConfiguration config(stream_factory_, peer, this->getInterface(), client_type_);
+  config.setSecurityContext(ssl_service);
+  config.setHTTPProxy(this->proxy_);
+  return createProtocol(config);
+}
+
 std::unique_ptr<sitetosite::SiteToSiteClient> RemoteProcessorGroupPort::getNextProtocol(bool create = true) {
   std::unique_ptr<sitetosite::SiteToSiteClient> nextProtocol = nullptr;
+  if (load_balanced_ && peer_selector_.size() > 0) {
+    return getNextLoadBalancedProtocol(create);
+  }
   if (!available_protocols_.try_dequeue(nextProtocol)) {
     if (create) {
       // create
@@ -77,7 +156,7 @@ std::unique_ptr<sitetosite::SiteToSiteClient> RemoteProcessorGroupPort::getNextP
           sitetosite::SiteToSiteClientConfiguration config(stream_factory_, std::make_shared<sitetosite::Peer>(protocol_uuid_, host, rpg.port_, ssl_service != nullptr), this->getInterface(),
                                                            client_type_);
           config.setHTTPProxy(this->proxy_);
-          nextProtocol = sitetosite::createClient(config);
+          nextProtocol = createProtocol(config);
         }
       } else if (peer_index_ >= 0) {
         std::lock_guard<std::mutex> lock(peer_mutex_);
@@ -89,7 +168,7 @@ std::unique_ptr<sitetosite::SiteToSiteClient> RemoteProcessorGroupPort::getNextP
           peer_index_ = 0;
         }
         config.setHTTPProxy(this->proxy_);
-        nextProtocol = sitetosite::createClient(config);
+        nextProtocol = createProtocol(config);
       } else {
         logger_->log_debug("Refreshing the peer list since there are none configured.");
         refreshPeerList();
@@ -101,6 +180,16 @@ std::unique_ptr<sitetosite::SiteToSiteClient> RemoteProcessorGroupPort::getNextP
 }
 
 void RemoteProcessorGroupPort::returnProtocol(std::unique_ptr<sitetosite::SiteToSiteClient> return_protocol) {
+  if (load_balanced_ && return_protocol && return_protocol->getPeer()) {
+    const auto &peer = return_protocol->getPeer();
+    const std::string peer_key = peerKey(peer->getHost(), peer->getPort());
+    std::lock_guard<std::mutex> lock(peer_mutex_);
+    auto &idle_protocols = peer_protocols_[peer_key];
+    if (idle_protocols.size() < static_cast<size_t>(max_concurrent_tasks_)) {
+      idle_protocols.push_back(std::move(return_protocol));
+    }
+    return;
+  }
   auto count = peers_.size();
   if (max_concurrent_tasks_ > count)
     count = max_concurrent_tasks_;
@@ -120,6 +209,10 @@ void RemoteProcessorGroupPort::initialize() {
   properties.insert(port);
   properties.insert(SSLContext);
   properties.insert(portUUID);
+  properties.insert(batchCount);
+  properties.insert(batchSize);
+  properties.insert(batchDuration);
+  properties.insert(loadBalancingStrategy);
   setSupportedProperties(properties);
 // Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -135,6 +228,13 @@ void RemoteProcessorGroupPort::onSchedule(const std::shared_ptr<core::ProcessCon
     protocol_uuid_ = value;
   }
 
+  context->getProperty(batchCount.getName(), batch_count_);
+  context->getProperty(batchSize.getName(), batch_size_);
+  context->getProperty(batchDuration.getName(), batch_duration_);
+  if (context->getProperty(loadBalancingStrategy.getName(), value)) {
+    load_balanced_ = value == "Flow File Count";
+  }
+
   std::string http_enabled_str;
   if (configure_->get(Configure::nifi_remote_input_http, http_enabled_str)) {
     if (utils::StringUtils::StringToBool(http_enabled_str, http_enabled_)) {
@@ -160,12 +260,11 @@ void RemoteProcessorGroupPort::onSchedule(const std::shared_ptr<core::ProcessCon
     }
   }
 
-  std::lock_guard<std::mutex> lock(peer_mutex_);
   if (!nifi_instances_.empty()) {
     refreshPeerList();
-    if (peers_.size() > 0)
-      peer_index_ = 0;
   }
+
+  std::lock_guard<std::mutex> lock(peer_mutex_);
   /**
    * If at this point we have no peers and HTTP support is disabled this means
    * we must rely on the configured host/port
@@ -186,7 +285,10 @@ void RemoteProcessorGroupPort::onSchedule(const std::shared_ptr<core::ProcessCon
     }
   }
   // populate the site2site protocol for load balancing between them
-  if (peers_.size() > 0) {
+  if (load_balanced_ && peers_.size() > 0) {
+    // protocols are created on demand for the peers the selector picks
+    logger_->log_debug("Load balancing across %d peers by FlowFile count", peers_.size());
+  } else if (peers_.size() > 0) {
     auto count = peers_.size();
     if (max_concurrent_tasks_ > count)
       count = max_concurrent_tasks_;
@@ -200,7 +302,7 @@ void RemoteProcessorGroupPort::onSchedule(const std::shared_ptr<core::ProcessCon
       }
       logger_->log_trace("Creating client");
       config.setHTTPProxy(this->proxy_);
-      nextProtocol = sitetosite::createClient(config);
+      nextProtocol = createProtocol(config);
       logger_->log_trace("Created client, moving into available protocols");
       returnProtocol(std::move(nextProtocol));
     }
@@ -220,6 +322,8 @@ void RemoteProcessorGroupPort::notifyStop() {
   while (available_protocols_.try_dequeue(nextProtocol)) {
     // clear all protocols now
   }
+  std::lock_guard<std::mutex> lock(peer_mutex_);
+  peer_protocols_.clear();
 }
 
 void RemoteProcessorGroupPort::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
@@ -247,20 +351,30 @@ void RemoteProcessorGroupPort::onTrigger(const std::shared_ptr<core::ProcessCont
 
     if (!protocol_->transfer(direction_, context, session)) {
       logger_->log_warn("protocol transmission failed, yielding");
+      penalizePeer(protocol_);
       context->yield();
     }
 
     returnProtocol(std::move(protocol_));
     return;
   } catch (const minifi::Exception &ex2) {
+    penalizePeer(protocol_);
     context->yield();
     session->rollback();
   } catch (...) {
+    penalizePeer(protocol_);
     context->yield();
     session->rollback();
   }
 }
 
+void RemoteProcessorGroupPort::penalizePeer(const std::unique_ptr<sitetosite::SiteToSiteClient> &protocol) {
+  if (load_balanced_ && protocol && protocol->getPeer()) {
+    logger_->log_info("Penalizing peer %s:%d after a failed transaction", protocol->getPeer()->getHost(), protocol->getPeer()->getPort());
+    peer_selector_.penalize(protocol->getPeer()->getHost(), protocol->getPeer()->getPort());
+  }
+}
+
 std::pair<std::string, int> RemoteProcessorGroupPort::refreshRemoteSite2SiteInfo() {
   if (nifi_instances_.empty())
     return std::make_pair("", -1);
@@ -370,15 +484,13 @@ std::pair<std::string, int> RemoteProcessorGroupPort::refreshRemoteSite2SiteInfo
   return std::make_pair("", -1);
 }
 
-void RemoteProcessorGroupPort::refreshPeerList() {
+bool RemoteProcessorGroupPort::fetchPeerList(std::vector<sitetosite::PeerStatus> &peers) {
   auto connection = refreshRemoteSite2SiteInfo();
   if (connection.second == -1) {
     logger_->log_debug("No port configured");
-    return;
+    return false;
   }
 
-  this->peers_.clear();
-
   std::unique_ptr<sitetosite::SiteToSiteClient> protocol;
   sitetosite::SiteToSiteClientConfiguration config(stream_factory_, std::make_shared<sitetosite::Peer>(protocol_uuid_, connection.first, connection.second, ssl_service != nullptr),
                                                    this->getInterface(), client_type_);
@@ -387,10 +499,29 @@ void RemoteProcessorGroupPort::refreshPeerList() {
   protocol = sitetosite::createClient(config);
 
   if (protocol)
-    protocol->getPeerList(peers_);
+    protocol->getPeerList(peers);
+  return true;
+}
+
+void RemoteProcessorGroupPort::refreshPeerList() {
+  {
+    std::lock_guard<std::mutex> lock(peer_mutex_);
+    last_peer_refresh_ = std::chrono::steady_clock::now();
+  }
+
+  // the remote instance is queried without holding the lock, so that transactions to the known peers carry on meanwhile
+  std::vector<sitetosite::PeerStatus> peers;
+  if (!fetchPeerList(peers)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(peer_mutex_);
+  peers_ = std::move(peers);
 
   logging::LOG_INFO(logger_) << "Have " << peers_.size() << " peers";
 
+  peer_selector_.setPeers(peers_, direction_);
+
   if (peers_.size() > 0)
     peer_index_ = 0;
 }
@@ -119,6 +119,11 @@ bool SchedulingAgent::onTrigger(const std::shared_ptr<core::Processor> &processo
   });
 
   processor->incrementActiveTasks();
+  auto statistics = processor->getStatistics();
+  const auto trigger_start = std::chrono::steady_clock::now();
+  utils::ScopeGuard statistics_guard([&statistics, &trigger_start]() {
+    statistics->recordTrigger(std::chrono::steady_clock::now() - trigger_start);
+  });
   try {
     processor->onTrigger(processContext, sessionFactory);
     processor->decrementActiveTask();
@@ -19,6 +19,8 @@
  */
 #include "core/ProcessSession.h"
 #include "core/ProcessSessionReadCallback.h"
+#include "core/Processor.h"
+#include "utils/file/FileUtils.h"
 #include <ctime>
 #include <vector>
 #include <map>
@@ -448,6 +450,26 @@ void ProcessSession::import(std::string source, const std::shared_ptr<core::Flow
 
   try {
     auto startTime = getTimeMillis();
+    if (offset == 0 && process_context_->getContentRepository()->importFile(source, claim, keepSource)) {
+      // the content repository adopted the file, so nothing has to be copied
+      claim->increaseFlowFileRecordOwnedCount();
+      flow->setSize(utils::file::FileUtils::file_size(claim->getContentFullPath()));
+      flow->setOffset(0);
+      if (flow->getResourceClaim() != nullptr) {
+        // Remove the old claim
+        flow->getResourceClaim()->decreaseFlowFileRecordOwnedCount();
+        flow->clearResourceClaim();
+      }
+      flow->setResourceClaim(claim);
+
+      logger_->log_debug("Imported %s of length %" PRIu64 " into content %s for FlowFile UUID %s without copying", source, flow->getSize(), claim->getContentFullPath(), flow->getUUIDStr());
+
+      std::stringstream details;
+      details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
+      auto endTime = getTimeMillis();
+      provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+      return;
+    }
     std::ifstream input;
     input.open(source.c_str(), std::fstream::in | std::fstream::binary);
     claim->increaseFlowFileRecordOwnedCount();
@@ -657,6 +679,16 @@ void ProcessSession::import(std::string source, std::vector<std::shared_ptr<Flow
 bool ProcessSession::exportContent(const std::string &destination, const std::string &tmpFile, const std::shared_ptr<core::FlowFile> &flow, bool keepContent) {
   logger_->log_debug("Exporting content of %s to %s", flow->getUUIDStr(), destination);
 
+  if (exportFile(tmpFile, flow)) {
+    if (std::rename(tmpFile.c_str(), destination.c_str()) == 0) {
+      logger_->log_info("Commit OK.");
+      return true;
+    }
+    std::remove(tmpFile.c_str());
+    logger_->log_error("Commit of %s to %s failed!", flow->getUUIDStr(), destination);
+    return false;
+  }
+
   ProcessSessionReadCallback cb(tmpFile, destination, logger_);
   read(flow, &cb);
 
@@ -681,6 +713,14 @@ bool ProcessSession::exportContent(const std::string &destination, const std::sh
   return exportContent(destination, tmpFileName, flow, keepContent);
 }
 
+bool ProcessSession::exportFile(const std::string &destination, const std::shared_ptr<core::FlowFile> &flow) {
+  auto claim = flow->getResourceClaim();
+  if (claim == nullptr || flow->getSize() == 0) {
+    return false;
+  }
+  return process_context_->getContentRepository()->exportFile(claim, flow->getOffset(), flow->getSize(), destination);
+}
+
 void ProcessSession::stash(const std::string &key, const std::shared_ptr<core::FlowFile> &flow) {
   logger_->log_debug("Stashing content from %s to key %s", flow->getUUIDStr(), key);
 
@@ -723,6 +763,7 @@ void ProcessSession::restore(const std::string &key, const std::shared_ptr<core:
 }
 
 void ProcessSession::commit() {
+  const auto commit_start = std::chrono::steady_clock::now();
   try {
     // First we clone the flow record based on the transfered relationship for updated flow record
     for (auto && it : _updatedFlowFiles) {
@@ -853,7 +894,19 @@ void ProcessSession::commit() {
       }
     }
 
+    uint64_t flow_files_in = 0;
+    uint64_t bytes_in = 0;
+    for (const auto &it : _originalFlowFiles) {
+      flow_files_in++;
+      bytes_in += it.second->getSize();
+    }
+    uint64_t flow_files_out = 0;
+    uint64_t bytes_out = 0;
     for (auto& cq : connectionQueues) {
+      for (const auto &record : cq.second) {
+        flow_files_out++;
+        bytes_out += record->getSize();
+      }
       cq.first->multiPut(cq.second);
     }
 
@@ -868,6 +921,18 @@ void ProcessSession::commit() {
     // persistent the provenance report
     this->provenance_report_->commit();
     logger_->log_trace("ProcessSession committed for %s", process_context_->getProcessorNode()->getName());
+
+    auto processor = std::dynamic_pointer_cast<Processor>(process_context_->getProcessorNode()->getProcessor());
+    if (processor != nullptr) {
+      processor->getStatistics()->recordCommit(std::chrono::steady_clock::now() - commit_start, flow_files_in, bytes_in, flow_files_out, bytes_out);
+    }
+
+    rollback_callbacks_.clear();
+    std::vector<std::function<void()>> callbacks;
+    callbacks.swap(commit_callbacks_);
+    for (const auto &callback : callbacks) {
+      callback();
+    }
   } catch (std::exception &exception) {
     logger_->log_debug("Caught Exception %s", exception.what());
     throw;
@@ -904,6 +969,12 @@ void ProcessSession::rollback() {
     _addedFlowFiles.clear();
     _updatedFlowFiles.clear();
     _deletedFlowFiles.clear();
+    commit_callbacks_.clear();
+    std::vector<std::function<void()>> callbacks;
+    callbacks.swap(rollback_callbacks_);
+    for (const auto &callback : callbacks) {
+      callback();
+    }
     logger_->log_warn("ProcessSession rollback for %s executed", process_context_->getProcessorNode()->getName());
   } catch (std::exception &exception) {
     logger_->log_warn("Caught Exception during process session rollback: %s", exception.what());
@@ -47,6 +47,7 @@ namespace core {
 Processor::Processor(std::string name)
     : Connectable(name),
       ConfigurableComponent(),
+      statistics_(std::make_shared<ProcessorStatistics>()),
       logger_(logging::LoggerFactory<Processor>::getLogger()) {
   has_work_.store(false);
   // Setup the default values
@@ -68,6 +69,7 @@ Processor::Processor(std::string name)
 Processor::Processor(std::string name, utils::Identifier &uuid)
     : Connectable(name, uuid),
       ConfigurableComponent(),
+      statistics_(std::make_shared<ProcessorStatistics>()),
       logger_(logging::LoggerFactory<Processor>::getLogger()) {
   has_work_.store(false);
   // Setup the default values
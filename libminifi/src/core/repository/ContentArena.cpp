@@ -0,0 +1,231 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/repository/ContentArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+constexpr size_t ContentArena::SLAB_SIZE;
+constexpr size_t ContentArena::SIZE_CLASS_COUNT;
+const std::array<size_t, ContentArena::SIZE_CLASS_COUNT> ContentArena::CHUNK_SIZES = { { 1024, 8 * 1024, 64 * 1024 } };
+
+ContentArena::ContentArena(size_t max_bytes)
+    : max_bytes_(max_bytes),
+      reserved_bytes_(0),
+      used_bytes_(0) {
+  for (auto &size_class : size_classes_) {
+    size_class.empty_slabs = 0;
+  }
+}
+
+bool ContentArena::allocate(size_t size, ContentChunk &chunk) {
+  size_t size_class = 0;
+  while (size_class + 1 < SIZE_CLASS_COUNT && CHUNK_SIZES[size_class] < size) {
+    size_class++;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &available = size_classes_[size_class].available;
+  Slab *slab = nullptr;
+  if (!available.empty()) {
+    slab = available.back();
+  } else {
+    slab = createSlab(size_class);
+    if (slab == nullptr) {
+      // memory may be held by empty slabs of other size classes
+      releaseEmptySlabs();
+      slab = createSlab(size_class);
+      if (slab == nullptr) {
+        return false;
+      }
+    }
+    available.push_back(slab);
+  }
+
+  if (slab->free_chunks.size() == slab->chunk_count) {
+    size_classes_[size_class].empty_slabs--;
+  }
+  chunk.data = slab->free_chunks.back();
+  chunk.capacity = CHUNK_SIZES[size_class];
+  chunk.slab = slab;
+  slab->free_chunks.pop_back();
+  if (slab->free_chunks.empty()) {
+    available.pop_back();
+  }
+  return true;
+}
+
+void ContentArena::release(const ContentChunk &chunk) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Slab *slab = static_cast<Slab*>(chunk.slab);
+  auto &size_class = size_classes_[slab->size_class];
+  if (slab->free_chunks.empty()) {
+    size_class.available.push_back(slab);
+  }
+  slab->free_chunks.push_back(chunk.data);
+  if (slab->free_chunks.size() == slab->chunk_count) {
+    if (size_class.empty_slabs > 0) {
+      // one empty slab per size class is enough to absorb the next allocation
+      size_class.available.erase(std::find(size_class.available.begin(), size_class.available.end(), slab));
+      releaseSlab(slab);
+    } else {
+      size_class.empty_slabs++;
+    }
+  }
+}
+
+ContentArena::Slab *ContentArena::createSlab(size_t size_class) {
+  if (reserved_bytes_ + SLAB_SIZE > max_bytes_) {
+    return nullptr;
+  }
+  std::unique_ptr<Slab> slab(new Slab());
+  slab->memory.reset(new uint8_t[SLAB_SIZE]);
+  slab->size_class = size_class;
+  slab->chunk_count = SLAB_SIZE / CHUNK_SIZES[size_class];
+  slab->free_chunks.reserve(slab->chunk_count);
+  for (size_t i = slab->chunk_count; i > 0; i--) {
+    slab->free_chunks.push_back(slab->memory.get() + (i - 1) * CHUNK_SIZES[size_class]);
+  }
+  reserved_bytes_ += SLAB_SIZE;
+  size_classes_[size_class].empty_slabs++;
+
+  Slab *ptr = slab.get();
+  slabs_[ptr] = std::move(slab);
+  return ptr;
+}
+
+void ContentArena::releaseSlab(Slab *slab) {
+  reserved_bytes_ -= SLAB_SIZE;
+  slabs_.erase(slab);
+}
+
+void ContentArena::releaseEmptySlabs() {
+  for (auto &size_class : size_classes_) {
+    if (size_class.empty_slabs == 0) {
+      continue;
+    }
+    auto &available = size_class.available;
+    auto empty_begin = std::partition(available.begin(), available.end(), [](Slab *slab) {
+      return slab->free_chunks.size() != slab->chunk_count;
+    });
+    for (auto it = empty_begin; it != available.end(); ++it) {
+      releaseSlab(*it);
+    }
+    available.erase(empty_begin, available.end());
+    size_class.empty_slabs = 0;
+  }
+}
+
+ArenaContent::~ArenaContent() {
+  for (const auto &chunk : chunks_) {
+    arena_->release(chunk);
+  }
+  arena_->removeUsedBytes(length_);
+}
+
+bool ArenaContent::append(const uint8_t *data, size_t size) {
+  if (size == 0) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t capacity = capacity_;
+  const size_t first_new_chunk = chunks_.size();
+  while (capacity < length_ + size) {
+    ContentChunk chunk;
+    // grow geometrically, so that large content ends up in few large chunks
+    if (!arena_->allocate((std::max)(length_ + size - capacity, capacity), chunk)) {
+      for (size_t i = first_new_chunk; i < chunks_.size(); i++) {
+        arena_->release(chunks_[i]);
+      }
+      chunks_.resize(first_new_chunk);
+      return false;
+    }
+    chunks_.push_back(chunk);
+    capacity += chunk.capacity;
+  }
+  capacity_ = capacity;
+
+  // the write position lies in the last chunk written to, so search from the end
+  size_t index = chunks_.size() - 1;
+  size_t chunk_start = capacity_ - chunks_[index].capacity;
+  while (chunk_start > length_) {
+    index--;
+    chunk_start -= chunks_[index].capacity;
+  }
+
+  size_t written = 0;
+  size_t chunk_offset = length_ - chunk_start;
+  while (written < size) {
+    const ContentChunk &chunk = chunks_[index++];
+    const size_t len = (std::min)(size - written, chunk.capacity - chunk_offset);
+    std::memcpy(chunk.data + chunk_offset, data + written, len);
+    written += len;
+    chunk_offset = 0;
+  }
+  length_ += size;
+  arena_->addUsedBytes(size);
+  return true;
+}
+
+size_t ArenaContent::read(size_t offset, uint8_t *buf, size_t size) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (offset >= length_) {
+    return 0;
+  }
+  size = (std::min)(size, length_ - offset);
+
+  size_t index = 0;
+  size_t chunk_start = 0;
+  while (chunk_start + chunks_[index].capacity <= offset) {
+    chunk_start += chunks_[index].capacity;
+    index++;
+  }
+
+  size_t copied = 0;
+  size_t chunk_offset = offset - chunk_start;
+  while (copied < size) {
+    const ContentChunk &chunk = chunks_[index++];
+    const size_t len = (std::min)(size - copied, chunk.capacity - chunk_offset);
+    std::memcpy(buf + copied, chunk.data + chunk_offset, len);
+    copied += len;
+    chunk_offset = 0;
+  }
+  return copied;
+}
+
+size_t ArenaContent::getLength() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return length_;
+}
+
+} /* namespace repository */
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -17,6 +17,10 @@
  */
 
 #include "core/repository/FileSystemRepository.h"
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
 #include <memory>
 #include <string>
 #include "io/FileStream.h"
@@ -60,6 +64,90 @@ bool FileSystemRepository::remove(const std::shared_ptr<minifi::ResourceClaim> &
   return true;
 }
 
+bool FileSystemRepository::importFile(const std::string &source, const std::shared_ptr<minifi::ResourceClaim> &claim, bool keep_source) {
+  const std::string destination = claim->getContentFullPath();
+#ifndef WIN32
+  struct stat source_stat;
+  if (lstat(source.c_str(), &source_stat) != 0) {
+    return false;
+  }
+  // a moved symbolic link would still refer to data outside of the repository
+  const bool regular = S_ISREG(source_stat.st_mode);
+#else
+  const bool regular = true;
+#endif
+  if (!keep_source && regular && std::rename(source.c_str(), destination.c_str()) == 0) {
+    logger_->log_debug("Moved %s into %s", source, destination);
+    return true;
+  }
+#ifndef WIN32
+  // kept sources may still be written to, e.g. by a tailed application, so they are never hard
+  // linked. Copying lets the file system reflink them, or the kernel copy them across file systems.
+  if (!regular && (stat(source.c_str(), &source_stat) != 0 || !S_ISREG(source_stat.st_mode))) {
+    logger_->log_debug("%s is not a regular file, it is not imported in the kernel", source);
+    return false;
+  }
+  if (!copyFile(source, 0, source_stat.st_size, destination)) {
+    logger_->log_debug("Could not copy %s into the repository in the kernel", source);
+    return false;
+  }
+  if (!keep_source) {
+    std::remove(source.c_str());
+  }
+  logger_->log_debug("Copied %s into %s", source, destination);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool FileSystemRepository::exportFile(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length, const std::string &destination) {
+#ifndef WIN32
+  if (copyFile(claim->getContentFullPath(), offset, length, destination)) {
+    logger_->log_debug("Exported %s to %s in the kernel", claim->getContentFullPath(), destination);
+    return true;
+  }
+#endif
+  return false;
+}
+
+bool FileSystemRepository::copyFile(const std::string &source, uint64_t offset, uint64_t length, const std::string &destination) {
+#ifndef WIN32
+  int source_fd = ::open(source.c_str(), O_RDONLY);
+  if (source_fd < 0) {
+    return false;
+  }
+  int destination_fd = ::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (destination_fd < 0) {
+    ::close(source_fd);
+    return false;
+  }
+  bool copied = length == 0;
+#if defined(__linux__) && defined(FICLONERANGE)
+  if (!copied) {
+    // on copy on write file systems the destination can share the extents of the source
+    struct file_clone_range range;
+    range.src_fd = source_fd;
+    range.src_offset = offset;
+    range.src_length = length;
+    range.dest_offset = 0;
+    copied = ioctl(destination_fd, FICLONERANGE, &range) == 0;
+  }
+#endif
+  if (!copied) {
+    copied = utils::file::FileUtils::copy_range(source_fd, offset, destination_fd, length) == length;
+  }
+  ::close(source_fd);
+  if (::close(destination_fd) != 0 || !copied) {
+    std::remove(destination.c_str());
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 } /* namespace repository */
 } /* namespace core */
 } /* namespace minifi */
@@ -17,13 +17,11 @@
  */
 
 #include "core/repository/VolatileContentRepository.h"
-#include "core/expect.h"
 #include <cstdio>
 #include <string>
 #include <memory>
 #include <thread>
-#include "utils/StringUtils.h"
-#include "io/FileStream.h"
+#include "io/ArenaContentStream.h"
 
 namespace org {
 namespace apache {
@@ -32,38 +30,18 @@ namespace minifi {
 namespace core {
 namespace repository {
 
-const char *VolatileContentRepository::minimal_locking = "minimal.locking";
-
 bool VolatileContentRepository::initialize(const std::shared_ptr<Configure> &configure) {
   VolatileRepository::initialize(configure);
-  resource_claim_comparator_ = [](std::shared_ptr<minifi::ResourceClaim> lhsPtr, std::shared_ptr<minifi::ResourceClaim> rhsPtr) {
-    if (lhsPtr == nullptr || rhsPtr == nullptr) {
-      return false;
-    }
-    return lhsPtr->getContentFullPath() == rhsPtr->getContentFullPath();};
-  resource_claim_check_ = [](std::shared_ptr<minifi::ResourceClaim> claim) {
-    return claim->getFlowFileRecordOwnedCount() <= 0;};
-  claim_reclaimer_ = [&](std::shared_ptr<minifi::ResourceClaim> claim) {if (claim->getFlowFileRecordOwnedCount() <= 0) {
-      remove(claim);
-    }
-  };
-
-  if (configure != nullptr) {
-    bool minimize_locking = false;
-    std::string value;
-    std::stringstream strstream;
-    strstream << Configure::nifi_volatile_repository_options << getName() << "." << minimal_locking;
-    if (configure->get(strstream.str(), value)) {
-      utils::StringUtils::StringToBool(value, minimize_locking);
-      minimize_locking_ = minimize_locking;
-    }
-  }
-  if (!minimize_locking_) {
+  {
+    // content is kept in the arena rather than in the entries of the VolatileRepository
+    std::lock_guard<std::mutex> lock(index_mutex_);
     for (auto ent : value_vector_) {
       delete ent;
     }
     value_vector_.clear();
+    free_slots_.clear();
   }
+  arena_ = std::make_shared<ContentArena>(max_size_);
   start();
 
   return true;
@@ -88,110 +66,74 @@ void VolatileContentRepository::start() {
 }
 
 std::shared_ptr<io::BaseStream> VolatileContentRepository::write(const std::shared_ptr<minifi::ResourceClaim> &claim, bool append) {
-  logger_->log_info("enter write for %s", claim->getContentFullPath());
-  {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    auto claim_check = master_list_.find(claim->getContentFullPath());
-    if (claim_check != master_list_.end()) {
-      logger_->log_info("Creating copy of atomic entry");
-      auto ent = claim_check->second->takeOwnership();
-      if (ent == nullptr) {
-        return nullptr;
-      }
-      return std::make_shared<io::AtomicEntryStream<std::shared_ptr<minifi::ResourceClaim>>>(claim, ent);
+  const std::string key = claim->getContentFullPath();
+  logger_->log_debug("enter write for %s", key);
+  auto &shard = getShard(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto claim_check = shard.contents.find(key);
+  if (claim_check != shard.contents.end()) {
+    if (!append) {
+      // overwriting starts from empty content, streams still reading the previous content keep it until they are done
+      claim_check->second = std::make_shared<ArenaContent>(arena_);
+      return std::make_shared<io::ArenaContentStream>(claim_check->second);
     }
+    auto stream = std::make_shared<io::ArenaContentStream>(claim_check->second);
+    stream->seek(claim_check->second->getLength());
+    return stream;
   }
-
-  int size = 0;
-  if (LIKELY(minimize_locking_ == true)) {
-    for (auto ent : value_vector_) {
-      if (ent->testAndSetKey(claim, nullptr, nullptr, resource_claim_comparator_)) {
-        std::lock_guard<std::mutex> lock(map_mutex_);
-        master_list_[claim->getContentFullPath()] = ent;
-        logger_->log_info("Minimize locking, return stream for %s", claim->getContentFullPath());
-        return std::make_shared<io::AtomicEntryStream<std::shared_ptr<minifi::ResourceClaim>>>(claim, ent);
-      }
-      size++;
-    }
-  } else {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    auto claim_check = master_list_.find(claim->getContentFullPath());
-    if (claim_check != master_list_.end()) {
-      return std::make_shared<io::AtomicEntryStream<std::shared_ptr<minifi::ResourceClaim>>>(claim, claim_check->second);
-    } else {
-      AtomicEntry<std::shared_ptr<minifi::ResourceClaim>> *ent = new AtomicEntry<std::shared_ptr<minifi::ResourceClaim>>(&current_size_, &max_size_);
-      if (ent->testAndSetKey(claim, nullptr, nullptr, resource_claim_comparator_)) {
-        master_list_[claim->getContentFullPath()] = ent;
-        return std::make_shared<io::AtomicEntryStream<std::shared_ptr<minifi::ResourceClaim>>>(claim, ent);
-      }
+  size_t count = claim_count_;
+  do {
+    if (count >= max_count_) {
+      logger_->log_info("Cannot write %s, returning nullptr to roll back session. Repo is full", key);
+      return nullptr;
     }
+  } while (!claim_count_.compare_exchange_weak(count, count + 1));
+  auto content = std::make_shared<ArenaContent>(arena_);
+  shard.contents[key] = content;
+  return std::make_shared<io::ArenaContentStream>(content);
+}
+
+std::shared_ptr<ArenaContent> VolatileContentRepository::getContent(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  const std::string key = claim->getContentFullPath();
+  auto &shard = getShard(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto claim_check = shard.contents.find(key);
+  if (claim_check != shard.contents.end()) {
+    return claim_check->second;
   }
-  logger_->log_info("Cannot write %s %d, returning nullptr to roll back session. Repo is either full or locked", claim->getContentFullPath(), size);
   return nullptr;
 }
 
 bool VolatileContentRepository::exists(const std::shared_ptr<minifi::ResourceClaim> &claim) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto claim_check = master_list_.find(claim->getContentFullPath());
-  if (claim_check != master_list_.end()) {
-    auto ent = claim_check->second->takeOwnership();
-    if (ent == nullptr) {
-      return false;
-    }
-    return true;
-  }
-
-  return false;
+  return getContent(claim) != nullptr;
 }
 
 std::shared_ptr<io::BaseStream> VolatileContentRepository::read(const std::shared_ptr<minifi::ResourceClaim> &claim) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto claim_check = master_list_.find(claim->getContentFullPath());
-  if (claim_check != master_list_.end()) {
-    auto ent = claim_check->second->takeOwnership();
-    if (ent == nullptr) {
-      return nullptr;
-    }
-    return std::make_shared<io::AtomicEntryStream<std::shared_ptr<minifi::ResourceClaim>>>(claim, ent);
+  auto content = getContent(claim);
+  if (content == nullptr) {
+    return nullptr;
   }
-
-  return nullptr;
+  return std::make_shared<io::ArenaContentStream>(content);
 }
 
 bool VolatileContentRepository::remove(const std::shared_ptr<minifi::ResourceClaim> &claim) {
-  if (LIKELY(minimize_locking_ == true)) {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    auto ent = master_list_.find(claim->getContentFullPath());
-    if (ent != master_list_.end()) {
-      auto ptr = ent->second;
-      // if we cannot remove the entry we will let the owner's destructor
-      // decrement the reference count and free it
-      master_list_.erase(claim->getContentFullPath());
-      // because of the test and set we need to decrement ownership
-      ptr->decrementOwnership();
-      if (ptr->freeValue(claim)) {
-        logger_->log_info("Removed %s", claim->getContentFullPath());
-        return true;
-      } else {
-        logger_->log_info("free failed for %s", claim->getContentFullPath());
-      }
-    } else {
-      logger_->log_info("Could not remove %s", claim->getContentFullPath());
-    }
-  } else {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    auto claim_item = master_list_.find(claim->getContentFullPath());
-    if (claim_item != master_list_.end()) {
-      auto size = claim_item->second->getLength();
-      delete claim_item->second;
-      master_list_.erase(claim->getContentFullPath());
-      current_size_ -= size;
+  const std::string key = claim->getContentFullPath();
+  std::shared_ptr<ArenaContent> content;
+  {
+    auto &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto claim_check = shard.contents.find(key);
+    if (claim_check == shard.contents.end()) {
+      logger_->log_info("Could not remove %s, may not exist", key);
+      return false;
     }
-    return true;
+    content = std::move(claim_check->second);
+    shard.contents.erase(claim_check);
   }
-
-  logger_->log_info("Could not remove %s, may not exist", claim->getContentFullPath());
-  return false;
+  claim_count_--;
+  // streams that still read the content keep its chunks until they are destroyed
+  logger_->log_debug("Removed %s", key);
+  return true;
 }
 
 } /* namespace repository */
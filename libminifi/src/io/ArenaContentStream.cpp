@@ -0,0 +1,88 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io/ArenaContentStream.h"
+
+#include <algorithm>
+#include <vector>
+#include "Exception.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+void ArenaContentStream::seek(uint64_t offset) {
+  std::lock_guard<std::mutex> lock(offset_mutex_);
+  offset_ = offset;
+}
+
+int ArenaContentStream::writeData(std::vector<uint8_t> &buf, int buflen) {
+  if (buflen < 0) {
+    throw minifi::Exception{ExceptionType::GENERAL_EXCEPTION, "negative buflen"};
+  }
+
+  if (buf.size() < static_cast<size_t>(buflen))
+    return -1;
+  return writeData(buf.data(), buflen);
+}
+
+int ArenaContentStream::writeData(uint8_t *value, int size) {
+  if (nullptr == value || size < 0) {
+    return -1;
+  }
+  if (!content_->append(value, size)) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(offset_mutex_);
+  offset_ += size;
+  return size;
+}
+
+int ArenaContentStream::readData(std::vector<uint8_t> &buf, int buflen) {
+  if (buflen < 0) {
+    throw minifi::Exception{ExceptionType::GENERAL_EXCEPTION, "negative buflen"};
+  }
+
+  if (buf.size() < static_cast<size_t>(buflen)) {
+    buf.resize(buflen);
+  }
+  int ret = readData(buf.data(), buflen);
+
+  if (ret < buflen) {
+    buf.resize((std::max)(ret, 0));
+  }
+  return ret;
+}
+
+int ArenaContentStream::readData(uint8_t *buf, int buflen) {
+  if (nullptr == buf || buflen < 0) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(offset_mutex_);
+  size_t len = content_->read(offset_, buf, buflen);
+  offset_ += len;
+  return static_cast<int>(len);
+}
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
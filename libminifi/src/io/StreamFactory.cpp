@@ -17,6 +17,7 @@
  */
 #include "io/StreamFactory.h"
 #include <atomic>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -76,7 +77,7 @@ class SocketCreator : public AbstractStreamFactory {
   std::unique_ptr<Socket> createSecureSocket(const std::string &host, const uint16_t port, const std::shared_ptr<minifi::controllers::SSLContextService> &ssl_service) {
 #ifdef OPENSSL_SUPPORT
     if (ssl_service != nullptr) {
-      auto ptr = std::make_shared<TLSContext>(configuration_, ssl_service);
+      auto ptr = getSecureContext(ssl_service);
       TLSSocket *socket = new TLSSocket(ptr, host, port);
       return std::unique_ptr<Socket>(socket);
     } else {
@@ -88,6 +89,30 @@ class SocketCreator : public AbstractStreamFactory {
   }
 
  private:
+#ifdef OPENSSL_SUPPORT
+  /**
+   * Provides the TLS context of the SSL context service. Contexts are shared by all sockets created
+   * for the same service, so that certificates are loaded once and sessions can be resumed on reconnect.
+   */
+  std::shared_ptr<TLSContext> getSecureContext(const std::shared_ptr<minifi::controllers::SSLContextService> &ssl_service) {
+    std::lock_guard<std::mutex> lock(secure_context_mutex_);
+    for (auto it = secure_contexts_.begin(); it != secure_contexts_.end();) {
+      if (it->first.expired()) {
+        it = secure_contexts_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    auto &context = secure_contexts_[ssl_service];
+    if (context == nullptr) {
+      context = std::make_shared<TLSContext>(configuration_, ssl_service);
+    }
+    return context;
+  }
+
+  std::mutex secure_context_mutex_;
+  std::map<std::weak_ptr<minifi::controllers::SSLContextService>, std::shared_ptr<TLSContext>, std::owner_less<std::weak_ptr<minifi::controllers::SSLContextService>>> secure_contexts_;
+#endif
   std::shared_ptr<V> context_;
   std::shared_ptr<Configure> configuration_;
 };
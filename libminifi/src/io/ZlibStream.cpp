@@ -131,7 +131,8 @@ ZlibDecompressStream::ZlibDecompressStream(ZlibCompressionFormat format)
 }
 
 ZlibDecompressStream::ZlibDecompressStream(DataStream* other, ZlibCompressionFormat format)
-    : ZlibBaseStream(other) {
+    : ZlibBaseStream(other)
+    , format_(format) {
   int ret = inflateInit2(&strm_, 15 + (format == ZlibCompressionFormat::GZIP ? 16 : 0) /* windowBits */);
   if (ret != Z_OK) {
     logger_->log_error("Failed to initialize z_stream with inflateInit2, error code: %d", ret);
@@ -148,6 +149,11 @@ ZlibDecompressStream::~ZlibDecompressStream() {
 }
 
 int ZlibDecompressStream::writeData(uint8_t* value, int size) {
+  if (state_ == ZlibStreamState::FINISHED && format_ == ZlibCompressionFormat::GZIP && size > 0) {
+    if (!startNextMember()) {
+      return -1;
+    }
+  }
   if (state_ != ZlibStreamState::INITIALIZED) {
     logger_->log_error("writeData called in invalid ZlibDecompressStream state, state is %hhu", state_);
     return -1;
@@ -160,9 +166,11 @@ int ZlibDecompressStream::writeData(uint8_t* value, int size) {
    * inflate works similarly to deflate in that it will not leave input data unconsumed, and we have to watch avail_out,
    * but in this case we do not have to close the stream, because it will detect the end of the compressed format
    * and signal that it is ended by returning Z_STREAM_END and not accepting any more input data.
+   * A GZIP file may consist of several concatenated members (e.g. when it was compressed in parallel), so
+   * if input data remains after the end of a GZIP member, inflate is reset to decompress the next one.
    */
   int ret;
-  do {
+  while (true) {
     logger_->log_trace("writeData has %u B of input data left", strm_.avail_in);
 
     strm_.next_out = outputBuffer_.data();
@@ -184,15 +192,33 @@ int ZlibDecompressStream::writeData(uint8_t* value, int size) {
       state_ = ZlibStreamState::ERRORED;
       return -1;
     }
-  } while (strm_.avail_out == 0);
-
-  if (ret == Z_STREAM_END) {
-    state_ = ZlibStreamState::FINISHED;
+    if (ret == Z_STREAM_END) {
+      state_ = ZlibStreamState::FINISHED;
+      if (strm_.avail_in == 0 || format_ != ZlibCompressionFormat::GZIP) {
+        break;
+      }
+      if (!startNextMember()) {
+        return -1;
+      }
+    } else if (strm_.avail_out != 0) {
+      break;
+    }
   }
 
   return size;
 }
 
+bool ZlibDecompressStream::startNextMember() {
+  int ret = inflateReset(&strm_);
+  if (ret != Z_OK) {
+    logger_->log_error("inflateReset failed, error code: %d", ret);
+    state_ = ZlibStreamState::ERRORED;
+    return false;
+  }
+  state_ = ZlibStreamState::INITIALIZED;
+  return true;
+}
+
 } /* namespace io */
 } /* namespace minifi */
 } /* namespace nifi */
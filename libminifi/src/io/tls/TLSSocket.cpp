@@ -24,6 +24,7 @@
 #include <vector>
 #include <Exception.h>
 #include "io/tls/TLSSocket.h"
+#include "io/tls/TLSStatistics.h"
 #include "io/tls/TLSUtils.h"
 #include "properties/Configure.h"
 #include "utils/ScopeGuard.h"
@@ -49,10 +50,20 @@ TLSContext::TLSContext(const std::shared_ptr<Configure> &configure, const std::s
       ssl_service_(ssl_service) {
 }
 
+TLSContext::~TLSContext() {
+  for (auto &session : sessions_) {
+    SSL_SESSION_free(session.second);
+  }
+  if (0 != ctx)
+    SSL_CTX_free(ctx);
+}
+
 /**
  * The memory barrier is defined by the singleton
  */
 int16_t TLSContext::initialize(bool server_method) {
+  // contexts are shared by the sockets of a stream factory, so they may be initialized concurrently
+  std::lock_guard<std::mutex> lock(context_mutex_);
   if (ctx != 0) {
     return error_value;
   }
@@ -82,6 +93,8 @@ int16_t TLSContext::initialize(bool server_method) {
     ctx = nullptr;
   });
 
+  configureSessionCache(server_method);
+
   if (needClientCert) {
     std::string certificate;
     std::string privatekey;
@@ -93,6 +106,8 @@ int16_t TLSContext::initialize(bool server_method) {
         error_value = TLS_ERROR_CERT_ERROR;
         return error_value;
       }
+      // the service is not needed once the context is configured; releasing it lets cached contexts expire with their service
+      ssl_service_ = nullptr;
       ctxGuard.disable();
       error_value = TLS_GOOD;
       return 0;
@@ -151,6 +166,49 @@ int16_t TLSContext::initialize(bool server_method) {
   return 0;
 }
 
+void TLSContext::configureSessionCache(bool server_method) {
+  if (server_method) {
+    // sessions of clients that presented a certificate can only be resumed within a session id context
+    static const unsigned char SESSION_ID_CONTEXT[] = "minifi";
+    SSL_CTX_set_session_id_context(ctx, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ctx, 1024);
+  } else {
+    // sessions are cached per peer by the context itself, see storeSession
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
+  }
+}
+
+void TLSContext::applySession(SSL *ssl, const std::string &host, uint16_t port) {
+  std::lock_guard<std::mutex> lock(session_mutex_);
+  auto session = sessions_.find(host + ":" + std::to_string(port));
+  if (session != sessions_.end()) {
+    SSL_set_session(ssl, session->second);
+  }
+}
+
+void TLSContext::storeSession(SSL *ssl, const std::string &host, uint16_t port) {
+  SSL_SESSION *session = SSL_get1_session(ssl);
+  if (session == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(session_mutex_);
+  SSL_SESSION *&cached = sessions_[host + ":" + std::to_string(port)];
+  if (cached != nullptr) {
+    SSL_SESSION_free(cached);
+  }
+  cached = session;
+}
+
+void TLSContext::removeSession(const std::string &host, uint16_t port) {
+  std::lock_guard<std::mutex> lock(session_mutex_);
+  auto session = sessions_.find(host + ":" + std::to_string(port));
+  if (session != sessions_.end()) {
+    SSL_SESSION_free(session->second);
+    sessions_.erase(session);
+  }
+}
+
 TLSSocket::~TLSSocket() {
   closeStream();
 }
@@ -215,6 +273,7 @@ int16_t TLSSocket::initialize(bool blocking) {
     // we have s2s secure config
     ssl_ = SSL_new(context_->getContext());
     SSL_set_fd(ssl_, socket_file_descriptor_);
+    context_->applySession(ssl_, requested_hostname_, port_);
     connected_ = false;
     int rez = SSL_connect(ssl_);
     if (rez < 0) {
@@ -228,12 +287,14 @@ int16_t TLSSocket::initialize(bool blocking) {
         return 0;
       } else {
         logger_->log_error("SSL socket connect failed to %s %d", requested_hostname_, port_);
+        // the cached session may be what the peer rejected
+        context_->removeSession(requested_hostname_, port_);
         closeStream();
         return -1;
       }
     } else {
       connected_ = true;
-      logger_->log_debug("SSL socket connect success to %s %d, on fd %d", requested_hostname_, port_, socket_file_descriptor_);
+      onHandshakeComplete();
       return 0;
     }
   }
@@ -241,6 +302,15 @@ int16_t TLSSocket::initialize(bool blocking) {
   return ret;
 }
 
+void TLSSocket::onHandshakeComplete() {
+  bool resumed = SSL_session_reused(ssl_) != 0;
+  TLSStatistics::getInstance().recordClientHandshake(resumed);
+  if (!resumed) {
+    context_->storeSession(ssl_, requested_hostname_, port_);
+  }
+  logger_->log_debug("SSL socket connect success to %s %d, on fd %d, session %s", requested_hostname_, port_, socket_file_descriptor_, resumed ? "resumed" : "negotiated");
+}
+
 void TLSSocket::close_ssl(int fd) {
   FD_CLR(fd, &total_list_);  // add to master set
   if (UNLIKELY(listeners_ > 0)) {
@@ -288,6 +358,7 @@ int16_t TLSSocket::select_descriptor(const uint16_t msec) {
           SSL_set_fd(ssl, newfd);
           auto accept_value = SSL_accept(ssl);
           if (accept_value != -1) {
+            TLSStatistics::getInstance().recordServerHandshake(SSL_session_reused(ssl) != 0);
             logger_->log_trace("Accepted on %d", newfd);
             ssl_map_[newfd] = ssl;
             return newfd;
@@ -312,12 +383,13 @@ int16_t TLSSocket::select_descriptor(const uint16_t msec) {
                 return socket_file_descriptor_;
               } else {
                 logger_->log_error("SSL socket connect failed to %s %d", requested_hostname_, port_);
+                context_->removeSession(requested_hostname_, port_);
                 closeStream();
                 return -1;
               }
             } else {
               connected_ = true;
-              logger_->log_debug("SSL socket connect success to %s %d, on fd %d", requested_hostname_, port_, socket_file_descriptor_);
+              onHandshakeComplete();
               return socket_file_descriptor_;
             }
           }
@@ -0,0 +1,123 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sitetosite/PeerSelector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sitetosite {
+
+namespace {
+
+// as in NiFi, the share of the FlowFiles held by a single peer counts as at most 80%,
+// so that even the most loaded peer keeps a fifth of the weight when sending
+constexpr double MAX_FLOW_FILE_SHARE = 0.8;
+// weight of a peer that is selected as if it held no FlowFiles (sending) or all of them (receiving)
+constexpr double FULL_WEIGHT = 100.0;
+
+}  // namespace
+
+void PeerSelector::setPeers(const std::vector<PeerStatus> &peers, TransferDirection direction) {
+  int64_t total_flow_files = 0;
+  for (const auto &status : peers) {
+    total_flow_files += status.getFlowFileCount();
+  }
+
+  std::vector<PeerEntry> entries;
+  entries.reserve(peers.size());
+  for (const auto &status : peers) {
+    if (status.getPeer() == nullptr) {
+      continue;
+    }
+    const double share = total_flow_files > 0 ? (std::min)(MAX_FLOW_FILE_SHARE, static_cast<double>(status.getFlowFileCount()) / total_flow_files) : 0.0;
+    const double relative_weight = direction == SEND ? 1.0 - share : share;
+    // every peer keeps a weight of at least one, as the reported counts are only a snapshot
+    const int64_t weight = (std::max)(int64_t{1}, static_cast<int64_t>(std::lround(relative_weight * FULL_WEIGHT)));
+    entries.push_back( { status.getPeer(), weight, 0, std::chrono::steady_clock::time_point() });
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &entry : entries) {
+    auto previous = std::find_if(peers_.begin(), peers_.end(), [&entry](const PeerEntry &known) {
+      return known.peer->getHost() == entry.peer->getHost() && known.peer->getPort() == entry.peer->getPort();
+    });
+    if (previous != peers_.end()) {
+      entry.penalized_until = previous->penalized_until;
+    }
+  }
+  peers_ = std::move(entries);
+}
+
+std::shared_ptr<Peer> PeerSelector::getNextPeer() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (peers_.empty()) {
+    return nullptr;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  PeerEntry *selected = nullptr;
+  int64_t total_weight = 0;
+  for (auto &entry : peers_) {
+    if (entry.penalized_until > now) {
+      continue;
+    }
+    entry.current_weight += entry.weight;
+    total_weight += entry.weight;
+    if (selected == nullptr || entry.current_weight > selected->current_weight) {
+      selected = &entry;
+    }
+  }
+
+  if (selected == nullptr) {
+    // everyone is penalized, fall back to the peer that recovers first
+    return std::min_element(peers_.begin(), peers_.end(), [](const PeerEntry &a, const PeerEntry &b) {
+      return a.penalized_until < b.penalized_until;
+    })->peer;
+  }
+
+  selected->current_weight -= total_weight;
+  return selected->peer;
+}
+
+void PeerSelector::penalize(const std::string &host, uint16_t port) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &entry : peers_) {
+    if (entry.peer->getHost() == host && entry.peer->getPort() == port) {
+      entry.penalized_until = std::chrono::steady_clock::now() + penalization_period_;
+      entry.current_weight = 0;
+    }
+  }
+}
+
+size_t PeerSelector::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return peers_.size();
+}
+
+} /* namespace sitetosite */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -163,6 +163,10 @@ bool SiteToSiteClient::transferFlowFiles(const std::shared_ptr<core::ProcessCont
       uint64_t transferNanos = getTimeNano() - startSendingNanos;
       if (transferNanos > _batchSendNanos)
         break;
+      if (_batchCount > 0 && static_cast<uint64_t>(transaction->total_transfers_) >= _batchCount)
+        break;
+      if (_batchSize > 0 && transaction->_bytes >= _batchSize)
+        break;
 
       flow = std::static_pointer_cast<FlowFileRecord>(session->get());
 
@@ -83,10 +83,19 @@ void ByteOutputCallback::write(char *data, size_t size) {
     if (!is_alive_)
       return;
   }
+  if (wait_on_read_ && size_ > max_size_) {
+    // apply back pressure until the consumer catches up
+    std::unique_lock<std::recursive_mutex> lock(vector_lock_);
+    spinner_.wait(lock, [&] {
+      return size_ <= max_size_ || !is_alive_;});
+    if (!is_alive_)
+      return;
+  }
   write_and_notify(data, size);
 }
 
 void ByteOutputCallback::write_and_notify(char *data, size_t size) {
+  // the writer (libcURL's write callback) reuses data once we return, so it is copied into the queued string
   queue_.enqueue(std::string(data, size));
   size_ += size;
   total_written_ += size;
@@ -127,18 +136,18 @@ size_t ByteOutputCallback::read_current_str(char *buffer, size_t size) {
         if (current_str.length() - current_str_read <= 0) {
           // we have no more data after copying, so preload the next string
           if (!preload_next_str())
-            return 0;
+            return size - amount_to_read;
         }
       } else {
         // no data left from the previous copy, so preload the next string
         if (!preload_next_str())
-          return 0;
+          return size - amount_to_read;
       }
       continue;
     } else {
       // no more data left from a previous copy or another thread, so preload the next string.
       if (!preload_next_str())
-        return 0;
+        return size - amount_to_read;
     }
   } while (amount_to_read > 0 && (is_alive_ || size_ > 0 || (current_str.size() - current_str_pos > 0)));
 
@@ -163,6 +172,8 @@ bool ByteOutputCallback::preload_next_str() {
   queue_.try_dequeue(current_str);
   current_str_pos = 0;
   size_ -= current_str.size();
+  // wake up a writer waiting for space
+  spinner_.notify_all();
   return true;
 }
 } /* namespace utils */
@@ -72,8 +72,6 @@ Regex::Regex(const std::string &value,
     throw Exception(REGEX_EXCEPTION, std::string(msg.begin(), msg.end()));
   }
   valid_ = true;
-  int maxGroups = std::count(regexStr_.begin(), regexStr_.end(), '(') + 1;
-  matches_.resize(maxGroups);
 #endif
 }
 
@@ -91,20 +89,17 @@ Regex& Regex::operator=(Regex&& other) {
     return *this;
   }
 
-  pat_ = std::move(other.pat_);
   suffix_ = std::move(other.suffix_);
   regexStr_ = std::move(other.regexStr_);
   results_ = std::move(other.results_);
 #ifdef NO_MORE_REGFREEE
   compiledRegex_ = std::move(other.compiledRegex_);
   regex_mode_ = other.regex_mode_;
-  matches_ = std::move(other.matches_);
 #else
   if (valid_)
     regfree(&compiledRegex_);
   compiledRegex_ = other.compiledRegex_;
   regex_mode_ = other.regex_mode_;
-  matches_ = std::move(other.matches_);
 #endif
   valid_ = other.valid_;
   other.valid_ = false;
@@ -119,38 +114,54 @@ Regex::~Regex() {
 }
 
 bool Regex::match(const std::string &pattern) {
-  if (!valid_) {
+  size_t match_end = 0;
+  if (!search(pattern, 0, results_, match_end)) {
+    return false;
+  }
+  suffix_ = pattern.substr(match_end);
+  return true;
+}
+
+bool Regex::search(const std::string &subject, size_t offset, std::vector<std::string> &results, size_t &match_end) const {
+  results.clear();
+  if (!valid_ || offset > subject.size()) {
     return false;
   }
-  results_.clear();
-  pat_ = pattern;
 #ifdef NO_MORE_REGFREEE
-  if (std::regex_search(pattern, matches_, compiledRegex_)) {
-    for (const auto &m : matches_) {
-      results_.push_back(m.str());
-    }
-    suffix_ = matches_.suffix();
-    return true;
+  std::smatch matches;
+  if (!std::regex_search(subject.begin() + offset, subject.end(), matches, compiledRegex_)) {
+    return false;
+  }
+  for (const auto &m : matches) {
+    results.push_back(m.str());
   }
-  return false;
+  match_end = offset + matches.position(0) + matches.length(0);
+  return true;
 #else
-  if (regexec(&compiledRegex_, pattern.c_str(), matches_.size(),
-              matches_.data(), 0) == 0) {
-    for (const auto &m : matches_) {
-      if (m.rm_so == -1) {
-        break;
-      }
-      std::string s(pattern.begin() + m.rm_so, pattern.begin() + m.rm_eo);
-      results_.push_back(s);
-    }
-    if ((size_t) matches_[0].rm_eo >= pattern.size()) {
-      suffix_ = "";
-    } else {
-      suffix_ = pattern.substr(matches_[0].rm_eo);
+  std::vector<regmatch_t> matches(compiledRegex_.re_nsub + 1);
+  const char *start = subject.c_str() + offset;
+  if (regexec(&compiledRegex_, start, matches.size(), matches.data(), 0) != 0) {
+    return false;
+  }
+  for (const auto &m : matches) {
+    if (m.rm_so == -1) {
+      break;
     }
-    return true;
+    results.emplace_back(start + m.rm_so, start + m.rm_eo);
+  }
+  match_end = offset + matches[0].rm_eo;
+  return true;
+#endif
+}
+
+bool Regex::search(const std::string &subject) const {
+  if (!valid_) {
+    return false;
   }
-  return false;
+#ifdef NO_MORE_REGFREEE
+  return std::regex_search(subject, compiledRegex_);
+#else
+  return regexec(&compiledRegex_, subject.c_str(), 0, nullptr, 0) == 0;
 #endif
 }
 
@@ -0,0 +1,218 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/file/FileWatcher.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+#include <string>
+#include <vector>
+#include "core/logging/LoggerConfiguration.h"
+#include "utils/file/FileUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+namespace file {
+
+#ifdef __linux__
+namespace {
+const uint32_t WATCH_MASK = IN_CREATE | IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF;
+}  // namespace
+#endif
+
+FileWatcher::FileWatcher(const std::string &directory, bool recursive)
+    : directory_(directory),
+      recursive_(recursive),
+      fd_(-1),
+      logger_(core::logging::LoggerFactory<FileWatcher>::getLogger()) {
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+#endif
+}
+
+bool FileWatcher::start() {
+#ifdef __linux__
+  if (fd_ >= 0) {
+    return true;
+  }
+  fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd_ < 0) {
+    logger_->log_warn("Cannot watch %s: %s", directory_, std::strerror(errno));
+    return false;
+  }
+  if (!addWatch(directory_)) {
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  if (recursive_) {
+    addNewDirectory(directory_, nullptr);
+  }
+  logger_->log_debug("Watching %s", directory_);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool FileWatcher::addWatch(const std::string &directory) {
+#ifdef __linux__
+  int wd = inotify_add_watch(fd_, directory.c_str(), WATCH_MASK);
+  if (wd < 0) {
+    logger_->log_warn("Cannot watch %s: %s", directory, std::strerror(errno));
+    return false;
+  }
+  watches_[wd] = directory;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void FileWatcher::addNewDirectory(const std::string &directory, const std::function<void(const FileEvent &event)> &callback) {
+#ifdef __linux__
+  DIR *dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  std::vector<std::string> subdirectories;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    const std::string path = FileUtils::concat_path(directory, entry->d_name);
+    struct stat statbuf;
+    if (stat(path.c_str(), &statbuf) != 0) {
+      continue;
+    }
+    if (S_ISDIR(statbuf.st_mode)) {
+      subdirectories.push_back(path);
+    } else if (callback) {
+      callback(FileEvent { FILE_WRITTEN, directory, entry->d_name });
+    }
+  }
+  closedir(dir);
+  for (const auto &subdirectory : subdirectories) {
+    if (addWatch(subdirectory)) {
+      addNewDirectory(subdirectory, callback);
+    }
+  }
+#endif
+}
+
+bool FileWatcher::poll(const std::function<void(const FileEvent &event)> &callback) {
+#ifdef __linux__
+  if (fd_ < 0) {
+    return false;
+  }
+  bool complete = true;
+  alignas(struct inotify_event) char buffer[64 * 1024];
+  while (true) {
+    ssize_t length = read(fd_, buffer, sizeof(buffer));
+    if (length < 0 && errno == EINTR) {
+      continue;
+    }
+    if (length <= 0) {
+      break;
+    }
+    for (char *ptr = buffer; ptr < buffer + length;) {
+      const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(ptr);
+      ptr += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        logger_->log_debug("Changes to %s were lost", directory_);
+        complete = false;
+        continue;
+      }
+      auto watch = watches_.find(event->wd);
+      if (watch == watches_.end()) {
+        continue;
+      }
+      const std::string directory = watch->second;
+      if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+        if (directory == directory_) {
+          // without the watched directory no further changes can be reported
+          logger_->log_debug("%s is no longer watched", directory_);
+          close(fd_);
+          fd_ = -1;
+          watches_.clear();
+          return false;
+        }
+        if (event->mask & IN_MOVE_SELF) {
+          // the subdirectory is watched again under its new name, if it was moved within the directory
+          inotify_rm_watch(fd_, event->wd);
+        }
+        watches_.erase(watch);
+        continue;
+      }
+      if (event->len == 0) {
+        continue;
+      }
+      const std::string filename = event->name;
+      if (event->mask & IN_ISDIR) {
+        if (recursive_ && (event->mask & IN_MOVED_FROM)) {
+          // the files of the subdirectory were moved along with it
+          complete = false;
+        } else if (recursive_ && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+          const std::string path = FileUtils::concat_path(directory, filename);
+          if (addWatch(path)) {
+            addNewDirectory(path, callback);
+          } else {
+            complete = false;
+          }
+        }
+        continue;
+      }
+      if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        callback(FileEvent { FILE_REMOVED, directory, filename });
+      } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+        callback(FileEvent { FILE_WRITTEN, directory, filename });
+      } else if (event->mask & (IN_MODIFY | IN_ATTRIB)) {
+        callback(FileEvent { FILE_MODIFIED, directory, filename });
+      } else if (event->mask & IN_CREATE) {
+        callback(FileEvent { FILE_CREATED, directory, filename });
+      }
+    }
+  }
+  return complete;
+#else
+  return false;
+#endif
+}
+
+} /* namespace file */
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
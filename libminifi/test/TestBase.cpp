@@ -39,12 +39,14 @@ TestPlan::TestPlan(std::shared_ptr<core::ContentRepository> content_repo, std::s
       content_repo_(content_repo),
       flow_repo_(flow_repo),
       prov_repo_(prov_repo),
+      controller_services_(std::make_shared<core::controller::ControllerServiceMap>()),
       finalized(false),
       location(-1),
       current_flowfile_(nullptr),
       flow_version_(flow_version),
       logger_(logging::LoggerFactory<TestPlan>::getLogger()) {
   stream_factory = org::apache::nifi::minifi::io::StreamFactory::getInstance(std::make_shared<minifi::Configure>());
+  controller_services_provider_ = std::make_shared<core::controller::StandardControllerServiceProvider>(controller_services_, nullptr, configuration_);
 }
 
 std::shared_ptr<core::Processor> TestPlan::addProcessor(const std::shared_ptr<core::Processor> &processor, const std::string &name, const std::initializer_list<core::Relationship>& relationships,
@@ -172,6 +174,27 @@ bool TestPlan::setProperty(const std::shared_ptr<core::Processor> proc, const st
   }
 }
 
+std::shared_ptr<core::controller::ControllerServiceNode> TestPlan::addController(const std::string &controller_name, const std::string &name) {
+  if (finalized) {
+    return nullptr;
+  }
+  std::lock_guard<std::recursive_mutex> guard(mutex);
+
+  auto node = std::static_pointer_cast<core::controller::StandardControllerServiceProvider>(controller_services_provider_)->createControllerService(controller_name, controller_name, name, true);
+  if (nullptr == node) {
+    throw std::exception();
+  }
+  node->setName(name);
+  controller_service_nodes_.push_back(node);
+  return node;
+}
+
+bool TestPlan::setProperty(const std::shared_ptr<core::controller::ControllerServiceNode> controller_service_node, const std::string &prop, const std::string &value) {
+  std::lock_guard<std::recursive_mutex> guard(mutex);
+  logger_->log_info("Attempting to set property %s %s for %s", prop, value, controller_service_node->getName());
+  return controller_service_node->getControllerServiceImplementation()->setProperty(prop, value);
+}
+
 void TestPlan::reset(bool reschedule) {
   std::lock_guard<std::recursive_mutex> guard(mutex);
   process_sessions_.clear();
@@ -283,6 +306,10 @@ void TestPlan::finalize() {
     }
   }
 
+  for (const auto& node : controller_service_nodes_) {
+    node->enable();
+  }
+
   finalized = true;
 }
 
@@ -44,6 +44,9 @@
 #include "core/ProcessContextBuilder.h"
 #include "core/ProcessSession.h"
 #include "core/ProcessorNode.h"
+#include "core/controller/ControllerServiceMap.h"
+#include "core/controller/ControllerServiceNode.h"
+#include "core/controller/StandardControllerServiceProvider.h"
 #include "core/reporting/SiteToSiteProvenanceReportingTask.h"
 #include "core/state/nodes/FlowInformation.h"
 #include "properties/Configure.h"
@@ -251,6 +254,13 @@ class TestPlan {
 
   bool setProperty(const std::shared_ptr<core::Processor> proc, const std::string &prop, const std::string &value, bool dynamic = false);
 
+  /**
+   * Adds a controller service, which processors of the plan reference by its name. The service is enabled when the plan is finalized.
+   */
+  std::shared_ptr<core::controller::ControllerServiceNode> addController(const std::string &controller_name, const std::string &name);
+
+  bool setProperty(const std::shared_ptr<core::controller::ControllerServiceNode> controller_service_node, const std::string &prop, const std::string &value);
+
   void reset(bool reschedule = false);
 
   bool runNextProcessor(std::function<void(const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession>)> verify = nullptr);
@@ -292,7 +302,9 @@ class TestPlan {
   std::shared_ptr<core::Repository> flow_repo_;
   std::shared_ptr<core::Repository> prov_repo_;
 
+  std::shared_ptr<core::controller::ControllerServiceMap> controller_services_;
   std::shared_ptr<core::controller::ControllerServiceProvider> controller_services_provider_;
+  std::vector<std::shared_ptr<core::controller::ControllerServiceNode>> controller_service_nodes_;
 
   std::recursive_mutex mutex;
 
@@ -40,6 +40,8 @@
 #include "processors/LogAttribute.h"
 #include "processors/PutFile.h"
 #include "utils/file/FileUtils.h"
+#include "controllers/ThreadManagementService.h"
+#include "core/Resource.h"
 
 static const char* EXPECT_COMPRESS_CONTENT = "/tmp/minifi-expect-compresscontent.txt";
 static const char* COMPRESS_CONTENT = "/tmp/minifi-compresscontent";
@@ -1042,3 +1044,352 @@ TEST_CASE("RawGzipCompressionDecompression", "[compressfiletest8]") {
 
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("ParallelGzipCompressionDecompression", "[compressfiletest9]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::CompressContent>();
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::PutFile>();
+
+  char format_src[] = "/tmp/archives.XXXXXX";
+  std::string src_dir = testController.createTempDirectory(format_src);
+  REQUIRE(!src_dir.empty());
+
+  char format_dst[] = "/tmp/archived.XXXXXX";
+  std::string dst_dir = testController.createTempDirectory(format_dst);
+  REQUIRE(!dst_dir.empty());
+
+  std::string src_file = utils::file::FileUtils::concat_path(src_dir, "src.txt");
+  std::string compressed_file = utils::file::FileUtils::concat_path(dst_dir, "src.txt.gz");
+  std::string decompressed_file = utils::file::FileUtils::concat_path(dst_dir, "src.txt");
+
+  auto plan = testController.createPlan();
+  auto get_file = plan->addProcessor("GetFile", "GetFile");
+  auto compress_content = plan->addProcessor("CompressContent", "CompressContent", core::Relationship("success", "d"), true);
+  auto put_compressed = plan->addProcessor("PutFile", "PutFile", core::Relationship("success", "d"), true);
+  auto decompress_content = plan->addProcessor("CompressContent", "CompressContent", core::Relationship("success", "d"), true);
+  auto put_decompressed = plan->addProcessor("PutFile", "PutFile", core::Relationship("success", "d"), true);
+
+  plan->setProperty(get_file, "Input Directory", src_dir);
+
+  plan->setProperty(compress_content, "Mode", MODE_COMPRESS);
+  plan->setProperty(compress_content, "Compression Format", COMPRESSION_FORMAT_GZIP);
+  plan->setProperty(compress_content, "Update Filename", "true");
+  plan->setProperty(compress_content, "Encapsulate in TAR", "false");
+  plan->setProperty(compress_content, "Compression Threads", "4");
+  plan->setProperty(compress_content, "Compression Block Size", "64 KB");
+
+  plan->setProperty(put_compressed, "Directory", dst_dir);
+
+  plan->setProperty(decompress_content, "Mode", MODE_DECOMPRESS);
+  plan->setProperty(decompress_content, "Compression Format", COMPRESSION_FORMAT_GZIP);
+  plan->setProperty(decompress_content, "Update Filename", "true");
+  plan->setProperty(decompress_content, "Encapsulate in TAR", "false");
+
+  plan->setProperty(put_decompressed, "Directory", dst_dir);
+
+  std::stringstream content_ss;
+  std::mt19937 gen(std::random_device { }());
+  for (size_t i = 0U; i < 256 * 1024U; i++) {
+    content_ss << "foobar" << gen() % 100;
+  }
+  std::string content = content_ss.str();
+
+  std::fstream file;
+  file.open(src_file, std::ios::out);
+  file << content;
+  file.close();
+
+  testController.runSession(plan, true);
+
+  std::ifstream compressed(compressed_file, std::ios::in | std::ios::binary);
+  std::vector<uint8_t> compressed_content((std::istreambuf_iterator<char>(compressed)), std::istreambuf_iterator<char>());
+  REQUIRE(2 < compressed_content.size());
+  REQUIRE(0x1f == compressed_content[0]);
+  REQUIRE(0x8b == compressed_content[1]);
+
+  // the first GZIP member ends before the compressed content does
+  z_stream strm{};
+  REQUIRE(Z_OK == inflateInit2(&strm, 15 + 16));
+  std::vector<uint8_t> output(content.size());
+  strm.next_in = compressed_content.data();
+  strm.avail_in = compressed_content.size();
+  strm.next_out = output.data();
+  strm.avail_out = output.size();
+  REQUIRE(Z_STREAM_END == inflate(&strm, Z_FINISH));
+  REQUIRE(64 * 1024U == strm.total_out);
+  REQUIRE(0U < strm.avail_in);
+  inflateEnd(&strm);
+
+  std::ifstream decompressed(decompressed_file, std::ios::in | std::ios::binary);
+  std::string decompressed_content((std::istreambuf_iterator<char>(decompressed)), std::istreambuf_iterator<char>());
+  REQUIRE(content == decompressed_content);
+
+  LogTestController::getInstance().reset();
+}
+
+/**
+ * ThreadPoolManager that allows two threads in all.
+ */
+class TwoThreadsPoolManager : public minifi::controllers::ThreadManagementService {
+ public:
+  explicit TwoThreadsPoolManager(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : ThreadManagementService(name, uuid) {
+  }
+
+  bool isAboveMax(const int new_tasks) override {
+    return new_tasks > getMaxThreads();
+  }
+
+  uint16_t getMaxThreads() override {
+    return 2;
+  }
+
+  bool shouldReduce() override {
+    return false;
+  }
+
+  void reduce() override {
+  }
+
+  bool canIncrease() override {
+    return true;
+  }
+};
+
+REGISTER_RESOURCE(TwoThreadsPoolManager, "ThreadPoolManager that allows two threads in all");
+
+TEST_CASE("ParallelXzCompressionDecompression", "[compressfiletest12]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::CompressContent>();
+
+  char format_src[] = "/tmp/archives.XXXXXX";
+  std::string src_dir = testController.createTempDirectory(format_src);
+  REQUIRE(!src_dir.empty());
+
+  char format_dst[] = "/tmp/archived.XXXXXX";
+  std::string dst_dir = testController.createTempDirectory(format_dst);
+  REQUIRE(!dst_dir.empty());
+
+  std::string src_file = utils::file::FileUtils::concat_path(src_dir, "src.txt");
+  std::string compressed_file = utils::file::FileUtils::concat_path(dst_dir, "src.txt.xz");
+  std::string decompressed_file = utils::file::FileUtils::concat_path(dst_dir, "src.txt");
+
+  auto plan = testController.createPlan();
+  auto get_file = plan->addProcessor("GetFile", "GetFile");
+  auto compress_content = plan->addProcessor("CompressContent", "CompressContent", core::Relationship("success", "d"), true);
+  auto put_compressed = plan->addProcessor("PutFile", "PutFile", core::Relationship("success", "d"), true);
+  auto decompress_content = plan->addProcessor("CompressContent", "CompressContent", core::Relationship("success", "d"), true);
+  auto put_decompressed = plan->addProcessor("PutFile", "PutFile", core::Relationship("success", "d"), true);
+
+  plan->setProperty(get_file, "Input Directory", src_dir);
+
+  plan->setProperty(compress_content, "Mode", MODE_COMPRESS);
+  plan->setProperty(compress_content, "Compression Format", COMPRESSION_FORMAT_XZ_LZMA2);
+  plan->setProperty(compress_content, "Update Filename", "true");
+  plan->setProperty(compress_content, "Encapsulate in TAR", "false");
+  plan->setProperty(compress_content, "Compression Threads", "4");
+
+  plan->setProperty(put_compressed, "Directory", dst_dir);
+
+  plan->setProperty(decompress_content, "Mode", MODE_DECOMPRESS);
+  plan->setProperty(decompress_content, "Compression Format", COMPRESSION_FORMAT_XZ_LZMA2);
+  plan->setProperty(decompress_content, "Update Filename", "true");
+  plan->setProperty(decompress_content, "Encapsulate in TAR", "false");
+
+  plan->setProperty(put_decompressed, "Directory", dst_dir);
+
+  std::string expected_threads;
+  SECTION("without a ThreadPoolManager the xz threads are the configured ones") {
+    expected_threads = "Threads [4] xz Threads [4]";
+  }
+  SECTION("a ThreadPoolManager caps the xz threads") {
+    plan->addController("TwoThreadsPoolManager", "ThreadPoolManager");
+    expected_threads = "Threads [4] xz Threads [2]";
+  }
+
+  std::stringstream content_ss;
+  std::mt19937 gen(std::random_device { }());
+  for (size_t i = 0U; i < 256 * 1024U; i++) {
+    content_ss << "foobar" << gen() % 100;
+  }
+  std::string content = content_ss.str();
+
+  std::fstream file;
+  file.open(src_file, std::ios::out);
+  file << content;
+  file.close();
+
+  testController.runSession(plan, true);
+
+  REQUIRE(LogTestController::getInstance().contains(expected_threads, std::chrono::seconds(0)));
+
+  std::ifstream compressed(compressed_file, std::ios::in | std::ios::binary);
+  std::vector<uint8_t> compressed_content((std::istreambuf_iterator<char>(compressed)), std::istreambuf_iterator<char>());
+  const std::vector<uint8_t> xz_magic = { 0xfd, '7', 'z', 'X', 'Z', 0x00 };
+  REQUIRE(xz_magic.size() < compressed_content.size());
+  REQUIRE(std::equal(xz_magic.begin(), xz_magic.end(), compressed_content.begin()));
+
+  std::ifstream decompressed(decompressed_file, std::ios::in | std::ios::binary);
+  std::string decompressed_content((std::istreambuf_iterator<char>(decompressed)), std::istreambuf_iterator<char>());
+  REQUIRE(content == decompressed_content);
+
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("ZstdAndLz4CompressionDecompression", "[compressfiletest10]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::CompressContent>();
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::PutFile>();
+
+  char format_src[] = "/tmp/archives.XXXXXX";
+  std::string src_dir = testController.createTempDirectory(format_src);
+  REQUIRE(!src_dir.empty());
+
+  char format_dst[] = "/tmp/archived.XXXXXX";
+  std::string dst_dir = testController.createTempDirectory(format_dst);
+  REQUIRE(!dst_dir.empty());
+
+  auto plan = testController.createPlan();
+  auto get_file = plan->addProcessor("GetFile", "GetFile");
+  auto compress_content = plan->addProcessor("CompressContent", "CompressContent", core::Relationship("success", "d"), true);
+  auto put_compressed = plan->addProcessor("PutFile", "PutFile", core::Relationship("success", "d"), true);
+  auto decompress_content = plan->addProcessor("CompressContent", "CompressContent", core::Relationship("success", "d"), true);
+  auto put_decompressed = plan->addProcessor("PutFile", "PutFile", core::Relationship("success", "d"), true);
+
+  std::string format;
+  std::string extension;
+  std::vector<uint8_t> magic;
+  std::string encapsulate = "false";
+  SECTION("zstd") {
+    format = COMPRESSION_FORMAT_ZSTD;
+    extension = ".zst";
+    magic = { 0x28, 0xb5, 0x2f, 0xfd };
+  }
+  SECTION("zstd with long distance matching") {
+    format = COMPRESSION_FORMAT_ZSTD;
+    extension = ".zst";
+    magic = { 0x28, 0xb5, 0x2f, 0xfd };
+    plan->setProperty(compress_content, "Zstd Long Window Log", "28");
+    plan->setProperty(decompress_content, "Zstd Long Window Log", "28");
+  }
+  SECTION("lz4-framed") {
+    format = COMPRESSION_FORMAT_LZ4;
+    extension = ".lz4";
+    magic = { 0x04, 0x22, 0x4d, 0x18 };
+  }
+  SECTION("zstd in TAR") {
+    format = COMPRESSION_FORMAT_ZSTD;
+    extension = ".zst";
+    magic = { 0x28, 0xb5, 0x2f, 0xfd };
+    encapsulate = "true";
+  }
+
+  std::string src_file = utils::file::FileUtils::concat_path(src_dir, "src.txt");
+  std::string compressed_file = utils::file::FileUtils::concat_path(dst_dir, "src.txt" + extension);
+  std::string decompressed_file = utils::file::FileUtils::concat_path(dst_dir, "src.txt");
+
+  plan->setProperty(get_file, "Input Directory", src_dir);
+
+  plan->setProperty(compress_content, "Mode", MODE_COMPRESS);
+  plan->setProperty(compress_content, "Compression Format", format);
+  plan->setProperty(compress_content, "Compression Level", "3");
+  plan->setProperty(compress_content, "Update Filename", "true");
+  plan->setProperty(compress_content, "Encapsulate in TAR", encapsulate);
+
+  plan->setProperty(put_compressed, "Directory", dst_dir);
+
+  plan->setProperty(decompress_content, "Mode", MODE_DECOMPRESS);
+  plan->setProperty(decompress_content, "Compression Format", format);
+  plan->setProperty(decompress_content, "Update Filename", "true");
+  plan->setProperty(decompress_content, "Encapsulate in TAR", encapsulate);
+
+  plan->setProperty(put_decompressed, "Directory", dst_dir);
+
+  std::stringstream content_ss;
+  for (size_t i = 0U; i < 256 * 1024U; i++) {
+    content_ss << "foobar" << i % 100;
+  }
+  std::string content = content_ss.str();
+
+  std::fstream file;
+  file.open(src_file, std::ios::out);
+  file << content;
+  file.close();
+
+  testController.runSession(plan, true);
+
+  std::ifstream compressed(compressed_file, std::ios::in | std::ios::binary);
+  std::vector<uint8_t> compressed_content((std::istreambuf_iterator<char>(compressed)), std::istreambuf_iterator<char>());
+  REQUIRE(magic.size() < compressed_content.size());
+  REQUIRE(compressed_content.size() < content.size());
+  REQUIRE(magic == std::vector<uint8_t>(compressed_content.begin(), compressed_content.begin() + magic.size()));
+
+  std::ifstream decompressed(decompressed_file, std::ios::in | std::ios::binary);
+  std::string decompressed_content((std::istreambuf_iterator<char>(decompressed)), std::istreambuf_iterator<char>());
+  REQUIRE(content == decompressed_content);
+
+  LogTestController::getInstance().reset();
+}
+
+#ifdef ZSTD_SUPPORT
+TEST_CASE("ZstdDictionaryCompressionDecompression", "[compressfiletest11]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::CompressContent>();
+
+  char format_out[] = "/tmp/archives.XXXXXX";
+  std::string output_dir = testController.createTempDirectory(format_out);
+  REQUIRE(!output_dir.empty());
+
+  char format_in[] = "/tmp/archived.XXXXXX";
+  std::string input_dir = testController.createTempDirectory(format_in);
+  REQUIRE(!input_dir.empty());
+
+  // a raw content dictionary holding the parts the records share
+  std::string dictionary_file = utils::file::FileUtils::concat_path(output_dir, "records.dict");
+  std::string record = "{\"sensor\":\"temperature\",\"unit\":\"celsius\",\"location\":\"building-1/floor-2\",\"value\":";
+  std::ofstream dictionary(dictionary_file, std::ios::out | std::ios::binary);
+  for (int i = 0; i < 16; i++) {
+    dictionary << record << i << "}";
+  }
+  dictionary.close();
+
+  std::string input_file = utils::file::FileUtils::concat_path(input_dir, "record.json");
+  std::string content = record + "42}";
+  std::ofstream src(input_file, std::ios::out | std::ios::binary);
+  src << content;
+  src.close();
+
+  auto plan = testController.createPlan();
+  auto get_file = plan->addProcessor("GetFile", "GetFile");
+  auto compress_content = plan->addProcessor("CompressContent", "CompressContent", core::Relationship("success", "d"), true);
+  auto put_compressed = plan->addProcessor("PutFile", "PutFile", core::Relationship("success", "d"), true);
+  auto decompress_content = plan->addProcessor("CompressContent", "CompressContent", core::Relationship("success", "d"), true);
+  auto put_decompressed = plan->addProcessor("PutFile", "PutFile", core::Relationship("success", "d"), true);
+
+  plan->setProperty(get_file, "Input Directory", input_dir);
+  plan->setProperty(compress_content, "Mode", MODE_COMPRESS);
+  plan->setProperty(compress_content, "Compression Format", COMPRESSION_FORMAT_ZSTD);
+  plan->setProperty(compress_content, "Update Filename", "true");
+  plan->setProperty(compress_content, "Zstd Dictionary File", dictionary_file);
+  plan->setProperty(put_compressed, "Directory", output_dir);
+  plan->setProperty(decompress_content, "Mode", MODE_DECOMPRESS);
+  plan->setProperty(decompress_content, "Compression Format", COMPRESSION_FORMAT_ZSTD);
+  plan->setProperty(decompress_content, "Update Filename", "true");
+  plan->setProperty(decompress_content, "Zstd Dictionary File", dictionary_file);
+  plan->setProperty(put_decompressed, "Directory", output_dir);
+
+  testController.runSession(plan, true);
+
+  std::ifstream compressed(utils::file::FileUtils::concat_path(output_dir, "record.json.zst"), std::ios::in | std::ios::binary);
+  std::string compressed_content((std::istreambuf_iterator<char>(compressed)), std::istreambuf_iterator<char>());
+  REQUIRE(0U < compressed_content.size());
+  // the shared prefix is referenced from the dictionary instead of being stored
+  REQUIRE(compressed_content.size() < record.size() / 2);
+
+  std::ifstream decompressed(utils::file::FileUtils::concat_path(output_dir, "record.json"), std::ios::in | std::ios::binary);
+  std::string decompressed_content((std::istreambuf_iterator<char>(decompressed)), std::istreambuf_iterator<char>());
+  REQUIRE(content == decompressed_content);
+
+  LogTestController::getInstance().reset();
+}
+#endif
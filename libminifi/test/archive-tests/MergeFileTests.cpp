@@ -22,6 +22,8 @@
 #include <utility>
 #include <string>
 #include <set>
+#include <thread>
+#include <chrono>
 #include "FlowController.h"
 #include "../TestBase.h"
 #include "core/Core.h"
@@ -32,6 +34,7 @@
 #include "core/ProcessSession.h"
 #include "core/ProcessorNode.h"
 #include "MergeContent.h"
+#include "CompressContent.h"
 #include <sstream>
 #include <iostream>
 #include "processors/LogAttribute.h"
@@ -1058,3 +1061,167 @@ TEST_CASE("MergeFileZip", "[mergefiletest5]") {
 
 
 
+
+namespace {
+
+std::shared_ptr<core::FlowFile> createBinnedFlow(uint64_t size) {
+  std::shared_ptr<TestRepository> repo = std::make_shared<TestRepository>();
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  auto flow = std::make_shared<minifi::FlowFileRecord>(repo, content_repo, std::map<std::string, std::string>());
+  flow->setSize(size);
+  return flow;
+}
+
+}  // namespace
+
+TEST_CASE("MergeFileCompressedTar", "[mergefiletest6]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::MergeContent>();
+
+  std::string compressFormat;
+  std::string mimeType;
+  std::string extension;
+  SECTION("gzip") {
+    compressFormat = COMPRESSION_FORMAT_GZIP;
+    mimeType = "application/gzip";
+    extension = ".tar.gz";
+  }
+#ifdef ZSTD_SUPPORT
+  SECTION("zstd") {
+    compressFormat = COMPRESSION_FORMAT_ZSTD;
+    mimeType = "application/zstd";
+    extension = ".tar.zst";
+  }
+#endif
+
+  std::shared_ptr<TestRepository> repo = std::make_shared<TestRepository>();
+  std::shared_ptr<core::Processor> processor = std::make_shared<org::apache::nifi::minifi::processors::MergeContent>("mergecontent");
+  processor->initialize();
+  utils::Identifier processoruuid;
+  REQUIRE(true == processor->getUUID(processoruuid));
+
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  content_repo->initialize(std::make_shared<org::apache::nifi::minifi::Configure>());
+  std::shared_ptr<minifi::Connection> connection = std::make_shared<minifi::Connection>(repo, content_repo, "mergedconnection");
+  connection->addRelationship(core::Relationship("merged", "Merge successful output"));
+  connection->setSource(processor);
+  connection->setSourceUUID(processoruuid);
+  processor->addConnection(connection);
+  std::shared_ptr<minifi::Connection> mergeconnection = std::make_shared<minifi::Connection>(repo, content_repo, "mergeconnection");
+  mergeconnection->setDestination(processor);
+  mergeconnection->setDestinationUUID(processoruuid);
+  processor->addConnection(mergeconnection);
+
+  std::set<core::Relationship> autoTerminatedRelationships;
+  autoTerminatedRelationships.insert(core::Relationship("original", ""));
+  autoTerminatedRelationships.insert(core::Relationship("failure", ""));
+  processor->setAutoTerminatedRelationships(autoTerminatedRelationships);
+  processor->incrementActiveTasks();
+  processor->setScheduledState(core::ScheduledState::RUNNING);
+
+  std::shared_ptr<core::ProcessorNode> node = std::make_shared<core::ProcessorNode>(processor);
+  std::shared_ptr<core::controller::ControllerServiceProvider> controller_services_provider = nullptr;
+  auto context = std::make_shared<core::ProcessContext>(node, controller_services_provider, repo, repo, content_repo);
+  context->setProperty(org::apache::nifi::minifi::processors::MergeContent::MergeFormat, MERGE_FORMAT_TAR_VALUE);
+  context->setProperty(org::apache::nifi::minifi::processors::MergeContent::MergeStrategy, MERGE_STRATEGY_BIN_PACK);
+  context->setProperty(org::apache::nifi::minifi::processors::MergeContent::MinEntries, "3");
+  context->setProperty(org::apache::nifi::minifi::processors::MergeContent::CompressFormat, compressFormat);
+  context->setProperty(org::apache::nifi::minifi::processors::MergeContent::CompressLevel, "3");
+
+  core::ProcessSession sessionGenFlowFile(context);
+  std::shared_ptr<minifi::Connection> income_connection = std::static_pointer_cast<minifi::Connection>(node->getNextIncomingConnection());
+  std::vector<std::string> contents;
+  for (int i = 0; i < 3; i++) {
+    contents.push_back(std::string(1024, static_cast<char>('a' + i)));
+    std::string flowFileName = std::string(FLOW_FILE) + "." + std::to_string(i) + ".txt";
+    std::ofstream tmpfile(flowFileName.c_str());
+    tmpfile << contents.back();
+    tmpfile.close();
+    std::shared_ptr<core::FlowFile> flow = std::static_pointer_cast<core::FlowFile>(sessionGenFlowFile.create());
+    sessionGenFlowFile.import(flowFileName, flow, true, 0);
+    income_connection->put(flow);
+  }
+
+  auto factory = std::make_shared<core::ProcessSessionFactory>(context);
+  processor->onSchedule(context, factory);
+  for (int i = 0; i < 3; i++) {
+    auto session = std::make_shared<core::ProcessSession>(context);
+    processor->onTrigger(context, session);
+    session->commit();
+  }
+
+  std::set<std::shared_ptr<core::FlowFile>> expiredFlowRecords;
+  std::shared_ptr<core::FlowFile> flow = connection->poll(expiredFlowRecords);
+  REQUIRE(flow);
+  // the merged TAR is smaller than its uncompressed entries
+  REQUIRE(flow->getSize() > 0);
+  REQUIRE(flow->getSize() < 3 * 1024);
+  std::string value;
+  REQUIRE(flow->getAttribute(org::apache::nifi::minifi::FlowAttributeKey(org::apache::nifi::minifi::MIME_TYPE), value));
+  REQUIRE(mimeType == value);
+  REQUIRE(flow->getAttribute(org::apache::nifi::minifi::FlowAttributeKey(org::apache::nifi::minifi::FILENAME), value));
+  REQUIRE(value.size() > extension.size());
+  REQUIRE(extension == value.substr(value.size() - extension.size()));
+
+  ReadCallback callback(flow->getSize());
+  sessionGenFlowFile.read(flow, &callback);
+  callback.archive_read();
+  REQUIRE(callback.archive_buffer_num_ == 3);
+  for (int i = 0; i < 3; i++) {
+    REQUIRE(contents[i] == std::string(callback.archive_buffer_[i], callback.archive_buffer_size_[i]));
+  }
+
+  LogTestController::getInstance().reset();
+  for (int i = 0; i < 3; i++) {
+    std::string flowFileName = std::string(FLOW_FILE) + "." + std::to_string(i) + ".txt";
+    unlink(flowFileName.c_str());
+  }
+}
+
+TEST_CASE("BinManager moves full bins when they are offered", "[binmanager]") {
+  processors::BinManager binManager;
+  binManager.setMinEntries(2);
+  binManager.setMaxEntries(2);
+
+  for (int i = 0; i < 100; i++) {
+    REQUIRE(binManager.offer("group" + std::to_string(i), createBinnedFlow(10)));
+  }
+  REQUIRE(100 == binManager.getBinCount());
+  REQUIRE(0 == binManager.getReadyBinCount());
+
+  REQUIRE(binManager.offer("group42", createBinnedFlow(10)));
+  REQUIRE(99 == binManager.getBinCount());
+  REQUIRE(1 == binManager.getReadyBinCount());
+
+  std::unique_ptr<processors::Bin> bin;
+  REQUIRE(binManager.getReadyBin(bin));
+  REQUIRE("group42" == bin->getGroupId());
+  REQUIRE(2 == bin->getSize());
+  REQUIRE_FALSE(binManager.getReadyBin(bin));
+}
+
+TEST_CASE("BinManager moves the oldest bin", "[binmanager]") {
+  processors::BinManager binManager;
+  binManager.setMinEntries(10);
+
+  REQUIRE(binManager.offer("first", createBinnedFlow(10)));
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  REQUIRE(binManager.offer("second", createBinnedFlow(10)));
+  REQUIRE(binManager.offer("first", createBinnedFlow(10)));
+
+  binManager.removeOldestBin();
+  std::unique_ptr<processors::Bin> bin;
+  REQUIRE(binManager.getReadyBin(bin));
+  REQUIRE("first" == bin->getGroupId());
+  REQUIRE(2 == bin->getSize());
+  REQUIRE(1 == binManager.getBinCount());
+
+  SECTION("expired bins are gathered") {
+    binManager.setBinAge(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    binManager.gatherReadyBins();
+    REQUIRE(binManager.getReadyBin(bin));
+    REQUIRE("second" == bin->getGroupId());
+    REQUIRE(0 == binManager.getBinCount());
+  }
+}
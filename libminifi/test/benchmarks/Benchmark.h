@@ -0,0 +1,147 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_TEST_BENCHMARKS_BENCHMARK_H_
+#define LIBMINIFI_TEST_BENCHMARKS_BENCHMARK_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Purpose: Provides the state of a single benchmark thread. The body of a benchmark loops on
+ * keepRunning(). Timing and allocation counting cover the whole call to Benchmark::run, so
+ * anything that should not be measured belongs in Benchmark::setUp.
+ */
+class BenchmarkState {
+ public:
+  BenchmarkState(uint64_t iterations, int thread_index, int threads)
+      : iterations_(iterations),
+        remaining_(iterations),
+        thread_index_(thread_index),
+        threads_(threads),
+        bytes_processed_(0) {
+  }
+
+  bool keepRunning() {
+    if (remaining_ == 0) {
+      return false;
+    }
+    remaining_--;
+    return true;
+  }
+
+  uint64_t getIterations() const {
+    return iterations_;
+  }
+
+  int getThreadIndex() const {
+    return thread_index_;
+  }
+
+  int getThreads() const {
+    return threads_;
+  }
+
+  /**
+   * Adds to the bytes processed by this thread, which are reported as throughput.
+   */
+  void addBytesProcessed(uint64_t bytes) {
+    bytes_processed_ += bytes;
+  }
+
+  uint64_t getBytesProcessed() const {
+    return bytes_processed_;
+  }
+
+ private:
+  uint64_t iterations_;
+  uint64_t remaining_;
+  int thread_index_;
+  int threads_;
+  uint64_t bytes_processed_;
+};
+
+/**
+ * Purpose: Base class of the microbenchmarks. A fresh instance is created for every measured run:
+ * setUp is called once with the number of threads, run is called concurrently from each of
+ * them, and tearDown is called once they have all finished.
+ */
+class Benchmark {
+ public:
+  virtual ~Benchmark() = default;
+
+  virtual void setUp(int threads) {
+  }
+
+  virtual void run(BenchmarkState &state) = 0;
+
+  virtual void tearDown() {
+  }
+};
+
+struct BenchmarkDefinition {
+  std::string name;
+  std::function<std::unique_ptr<Benchmark>()> factory;
+  std::vector<int> threads;
+};
+
+class BenchmarkRegistry {
+ public:
+  static BenchmarkRegistry &getInstance() {
+    static BenchmarkRegistry registry;
+    return registry;
+  }
+
+  void add(const BenchmarkDefinition &definition) {
+    benchmarks_.push_back(definition);
+  }
+
+  const std::vector<BenchmarkDefinition> &getBenchmarks() const {
+    return benchmarks_;
+  }
+
+ private:
+  BenchmarkRegistry() = default;
+
+  std::vector<BenchmarkDefinition> benchmarks_;
+};
+
+template<typename T>
+class BenchmarkRegistrar {
+ public:
+  BenchmarkRegistrar(const std::string &name, std::vector<int> threads) {
+    BenchmarkRegistry::getInstance().add(BenchmarkDefinition { name, []() {return std::unique_ptr<Benchmark>(new T());}, threads });
+  }
+};
+
+/**
+ * Registers a Benchmark subclass, to be run once for each of the given thread counts.
+ */
+#define REGISTER_BENCHMARK(CLASSNAME, ...) static BenchmarkRegistrar<CLASSNAME> CLASSNAME##_registrar(#CLASSNAME, { __VA_ARGS__ });
+
+/**
+ * Prevents the compiler from optimizing away the computation of value.
+ */
+template<typename T>
+inline void doNotOptimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif /* LIBMINIFI_TEST_BENCHMARKS_BENCHMARK_H_ */
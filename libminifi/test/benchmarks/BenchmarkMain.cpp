@@ -0,0 +1,201 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../TestBase.h"
+
+namespace {
+
+// counted by the replaced global operator new below
+thread_local uint64_t thread_allocations = 0;
+
+struct Measurement {
+  int threads;
+  // operations run across all threads
+  uint64_t iterations;
+  std::chrono::nanoseconds wall_time;
+  // average time taken by a thread
+  std::chrono::nanoseconds thread_time;
+  uint64_t allocations;
+  uint64_t bytes_processed;
+};
+
+struct Options {
+  std::string filter;
+  double min_time = 1.0;
+  bool list = false;
+};
+
+/**
+ * Runs a fresh instance of the benchmark with iterations iterations on each of the threads. The
+ * threads are started before the clock is, and are released together once they are all ready.
+ */
+Measurement measure(const BenchmarkDefinition &definition, int threads, uint64_t iterations) {
+  std::unique_ptr<Benchmark> benchmark = definition.factory();
+  benchmark->setUp(threads);
+
+  std::atomic<int> ready(0);
+  std::atomic<bool> start(false);
+  std::atomic<uint64_t> allocations(0);
+  std::atomic<uint64_t> thread_nanos(0);
+  std::atomic<uint64_t> bytes_processed(0);
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; i++) {
+    workers.emplace_back([&, i]() {
+      BenchmarkState state(iterations, i, threads);
+      ready++;
+      while (!start) {
+        std::this_thread::yield();
+      }
+      const uint64_t allocations_before = thread_allocations;
+      const auto begin = std::chrono::steady_clock::now();
+      benchmark->run(state);
+      const auto elapsed = std::chrono::steady_clock::now() - begin;
+      allocations += thread_allocations - allocations_before;
+      thread_nanos += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+      bytes_processed += state.getBytesProcessed();
+    });
+  }
+  while (ready < threads) {
+    std::this_thread::yield();
+  }
+  const auto begin = std::chrono::steady_clock::now();
+  start = true;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  const auto wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+  benchmark->tearDown();
+
+  return Measurement { threads, iterations * threads, wall_time, std::chrono::nanoseconds(thread_nanos.load() / threads), allocations, bytes_processed };
+}
+
+/**
+ * Grows the iteration count until a run takes at least min_time seconds, estimating the count
+ * needed from the previous run the same way Google Benchmark does.
+ */
+Measurement runBenchmark(const BenchmarkDefinition &definition, int threads, double min_time) {
+  static const uint64_t MAX_ITERATIONS = 1000000000;
+  uint64_t iterations = 1;
+  while (true) {
+    Measurement measurement = measure(definition, threads, iterations);
+    const double seconds = std::chrono::duration<double>(measurement.thread_time).count();
+    if (seconds >= min_time || iterations >= MAX_ITERATIONS) {
+      return measurement;
+    }
+    double multiplier = 10.0;
+    if (seconds / min_time > 0.1) {
+      multiplier = min_time * 1.4 / seconds;
+    }
+    const uint64_t next = static_cast<uint64_t>(iterations * multiplier);
+    iterations = std::min(MAX_ITERATIONS, std::max(next, iterations + 1));
+  }
+}
+
+void report(const std::string &name, const Measurement &measurement) {
+  const double ops = static_cast<double>(measurement.iterations);
+  const double wall_seconds = std::chrono::duration<double>(measurement.wall_time).count();
+  // each thread ran iterations / threads of the operations
+  const double ns_per_op = static_cast<double>(measurement.thread_time.count()) * measurement.threads / ops;
+  std::printf("%-48s %12llu %12.1f %14.0f %10.2f", name.c_str(), static_cast<unsigned long long>(measurement.iterations), ns_per_op, ops / wall_seconds, measurement.allocations / ops);
+  if (measurement.bytes_processed > 0) {
+    std::printf(" %10.1f MB/s", measurement.bytes_processed / wall_seconds / (1024 * 1024));
+  }
+  std::printf("\n");
+  std::fflush(stdout);
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg.find("--filter=") == 0) {
+      options.filter = arg.substr(std::strlen("--filter="));
+    } else if (arg.find("--min-time=") == 0) {
+      options.min_time = std::atof(arg.substr(std::strlen("--min-time=")).c_str());
+      if (options.min_time <= 0) {
+        return false;
+      }
+    } else if (arg == "--list") {
+      options.list = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void *operator new(std::size_t size) {
+  thread_allocations++;
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    std::fprintf(stderr, "Usage: %s [--filter=<substring>] [--min-time=<seconds>] [--list]\n", argv[0]);
+    return 1;
+  }
+
+  TestController controller;
+
+  if (!options.list) {
+    std::printf("%-48s %12s %12s %14s %10s\n", "Benchmark", "Iterations", "ns/op", "ops/s", "allocs/op");
+  }
+  for (const auto &definition : BenchmarkRegistry::getInstance().getBenchmarks()) {
+    for (int threads : definition.threads) {
+      const std::string name = definition.name + "/threads:" + std::to_string(threads);
+      if (name.find(options.filter) == std::string::npos) {
+        continue;
+      }
+      if (options.list) {
+        std::printf("%s\n", name.c_str());
+        continue;
+      }
+      report(name, runBenchmark(definition, threads, options.min_time));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../TestBase.h"
+#include "Connection.h"
+#include "FlowFileRecord.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "core/repository/VolatileFlowFileRepository.h"
+
+namespace {
+
+class ConnectionBenchmark : public Benchmark {
+ public:
+  void setUp(int threads) override {
+    auto configuration = std::make_shared<minifi::Configure>();
+    content_repo_ = std::make_shared<core::repository::VolatileContentRepository>();
+    content_repo_->initialize(configuration);
+    flow_repo_ = std::make_shared<core::repository::VolatileFlowFileRepository>("benchmarkflowrepo");
+    flow_repo_->initialize(configuration);
+    connection_ = std::make_shared<minifi::Connection>(flow_repo_, content_repo_, "benchmark");
+
+    std::map<std::string, std::string> attributes { { "filename", "benchmark.txt" }, { "path", "/tmp/" } };
+    for (int i = 0; i < threads; i++) {
+      auto flow_file = std::make_shared<minifi::FlowFileRecord>(flow_repo_, content_repo_, attributes);
+      flow_file->setStoredToRepository(isStored());
+      flow_files_.push_back(flow_file);
+    }
+  }
+
+  void tearDown() override {
+    flow_files_.clear();
+    connection_ = nullptr;
+  }
+
+ protected:
+  virtual bool isStored() const = 0;
+
+  std::shared_ptr<core::ContentRepository> content_repo_;
+  std::shared_ptr<core::Repository> flow_repo_;
+  std::shared_ptr<minifi::Connection> connection_;
+  std::vector<std::shared_ptr<core::FlowFile>> flow_files_;
+};
+
+/**
+ * Enqueues and dequeues FlowFiles that are already persisted, which measures the queue alone.
+ */
+class ConnectionPutPoll : public ConnectionBenchmark {
+ public:
+  void run(BenchmarkState &state) override {
+    std::shared_ptr<core::FlowFile> flow_file = flow_files_[state.getThreadIndex()];
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+    while (state.keepRunning()) {
+      connection_->put(flow_file);
+      flow_file = connection_->poll(expired);
+    }
+  }
+
+ protected:
+  bool isStored() const override {
+    return true;
+  }
+};
+
+/**
+ * Enqueues and dequeues FlowFiles that have to be serialized to the FlowFile repository on every put.
+ */
+class ConnectionPutPollPersisted : public ConnectionBenchmark {
+ public:
+  void run(BenchmarkState &state) override {
+    std::shared_ptr<core::FlowFile> flow_file = flow_files_[state.getThreadIndex()];
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+    while (state.keepRunning()) {
+      connection_->put(flow_file);
+      flow_file = connection_->poll(expired);
+      flow_file->setStoredToRepository(false);
+    }
+  }
+
+ protected:
+  bool isStored() const override {
+    return false;
+  }
+};
+
+/**
+ * Enqueues batches of persisted FlowFiles with a single multiPut. An iteration moves BATCH_SIZE FlowFiles.
+ */
+class ConnectionMultiPut : public ConnectionBenchmark {
+ public:
+  static constexpr int BATCH_SIZE = 100;
+
+  void setUp(int threads) override {
+    ConnectionBenchmark::setUp(threads * BATCH_SIZE);
+  }
+
+  void run(BenchmarkState &state) override {
+    std::vector<std::shared_ptr<core::FlowFile>> batch(flow_files_.begin() + state.getThreadIndex() * BATCH_SIZE, flow_files_.begin() + (state.getThreadIndex() + 1) * BATCH_SIZE);
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+    while (state.keepRunning()) {
+      connection_->multiPut(batch);
+      for (auto &flow_file : batch) {
+        flow_file = connection_->poll(expired);
+      }
+    }
+  }
+
+ protected:
+  bool isStored() const override {
+    return true;
+  }
+};
+
+}  // namespace
+
+REGISTER_BENCHMARK(ConnectionPutPoll, 1, 4)
+REGISTER_BENCHMARK(ConnectionPutPollPersisted, 1, 4)
+REGISTER_BENCHMARK(ConnectionMultiPut, 1, 4)
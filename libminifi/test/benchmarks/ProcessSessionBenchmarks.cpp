@@ -0,0 +1,126 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../TestBase.h"
+#include "FlowFileRecord.h"
+#include "core/Processor.h"
+#include "core/ProcessContext.h"
+#include "core/ProcessSession.h"
+#include "core/ProcessorNode.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "core/repository/VolatileFlowFileRepository.h"
+#include "core/repository/VolatileProvenanceRepository.h"
+
+namespace {
+
+class ContentWriter : public minifi::OutputStreamCallback {
+ public:
+  explicit ContentWriter(size_t size)
+      : content_(size, 'x') {
+  }
+
+  int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) override {
+    return stream->writeData(reinterpret_cast<uint8_t*>(&content_[0]), content_.size());
+  }
+
+ private:
+  std::string content_;
+};
+
+/**
+ * Creates FlowFiles with 1 KiB of content in a session, transfers them to an auto terminated
+ * relationship and commits, which covers the content, FlowFile and provenance repository work
+ * of a commit. The repositories are volatile so that disk I/O is not measured.
+ */
+class ProcessSessionBenchmark : public Benchmark {
+ public:
+  explicit ProcessSessionBenchmark(int flow_files_per_session)
+      : flow_files_per_session_(flow_files_per_session),
+        success_("success", "All FlowFiles"),
+        writer_(1024) {
+  }
+
+  void setUp(int threads) override {
+    auto configuration = std::make_shared<minifi::Configure>();
+    std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+    content_repo->initialize(configuration);
+    std::shared_ptr<core::Repository> flow_repo = std::make_shared<core::repository::VolatileFlowFileRepository>("benchmarkflowrepo");
+    flow_repo->initialize(configuration);
+    std::shared_ptr<core::Repository> provenance_repo = std::make_shared<core::repository::VolatileProvenanceRepository>("benchmarkprovrepo");
+    provenance_repo->initialize(configuration);
+
+    processor_ = std::make_shared<core::Processor>("benchmark");
+    processor_->setSupportedRelationships( { success_ });
+    processor_->setAutoTerminatedRelationships( { success_ });
+    auto node = std::make_shared<core::ProcessorNode>(processor_);
+    std::shared_ptr<core::controller::ControllerServiceProvider> controller_services_provider = nullptr;
+    context_ = std::make_shared<core::ProcessContext>(node, controller_services_provider, provenance_repo, flow_repo, configuration, content_repo);
+  }
+
+  void run(BenchmarkState &state) override {
+    while (state.keepRunning()) {
+      core::ProcessSession session(context_);
+      for (int i = 0; i < flow_files_per_session_; i++) {
+        auto flow_file = session.create();
+        session.write(flow_file, &writer_);
+        session.putAttribute(flow_file, "benchmark.index", "1");
+        session.transfer(flow_file, success_);
+      }
+      session.commit();
+    }
+  }
+
+  void tearDown() override {
+    context_ = nullptr;
+    processor_ = nullptr;
+  }
+
+ private:
+  const int flow_files_per_session_;
+  core::Relationship success_;
+  ContentWriter writer_;
+  std::shared_ptr<core::Processor> processor_;
+  std::shared_ptr<core::ProcessContext> context_;
+};
+
+class ProcessSessionCommit : public ProcessSessionBenchmark {
+ public:
+  ProcessSessionCommit()
+      : ProcessSessionBenchmark(1) {
+  }
+};
+
+/**
+ * An iteration commits a session of 100 FlowFiles.
+ */
+class ProcessSessionCommitBatch : public ProcessSessionBenchmark {
+ public:
+  ProcessSessionCommitBatch()
+      : ProcessSessionBenchmark(100) {
+  }
+};
+
+}  // namespace
+
+REGISTER_BENCHMARK(ProcessSessionCommit, 1, 4)
+REGISTER_BENCHMARK(ProcessSessionCommitBatch, 1, 4)
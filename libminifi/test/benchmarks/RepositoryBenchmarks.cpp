@@ -0,0 +1,91 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../TestBase.h"
+#include "core/repository/VolatileFlowFileRepository.h"
+
+namespace {
+
+/**
+ * Stores 256 byte values in a VolatileFlowFileRepository. Every thread cycles through its own
+ * 20000 keys, more than the repository holds, so the measurement covers the steady state of a
+ * full repository that evicts its oldest entries.
+ */
+class VolatileRepositoryBenchmark : public Benchmark {
+ public:
+  static constexpr int KEYS_PER_THREAD = 20000;
+
+  void setUp(int threads) override {
+    repo_ = std::make_shared<core::repository::VolatileFlowFileRepository>("benchmarkflowrepo");
+    repo_->initialize(std::make_shared<minifi::Configure>());
+    for (int i = 0; i < threads * KEYS_PER_THREAD; i++) {
+      keys_.push_back("benchmark-key-" + std::to_string(i));
+    }
+    value_.assign(256, 'x');
+  }
+
+  void tearDown() override {
+    repo_ = nullptr;
+  }
+
+ protected:
+  const std::string &getKey(const BenchmarkState &state, uint64_t index) const {
+    return keys_[state.getThreadIndex() * KEYS_PER_THREAD + index % KEYS_PER_THREAD];
+  }
+
+  std::shared_ptr<core::Repository> repo_;
+  std::vector<std::string> keys_;
+  std::string value_;
+};
+
+class VolatileRepositoryPut : public VolatileRepositoryBenchmark {
+ public:
+  void run(BenchmarkState &state) override {
+    uint64_t index = 0;
+    while (state.keepRunning()) {
+      repo_->Put(getKey(state, index++), reinterpret_cast<const uint8_t*>(value_.data()), value_.size());
+      state.addBytesProcessed(value_.size());
+    }
+  }
+};
+
+/**
+ * Stores and deletes an entry, as a FlowFile passing through a single connection does.
+ */
+class VolatileRepositoryPutDelete : public VolatileRepositoryBenchmark {
+ public:
+  void run(BenchmarkState &state) override {
+    uint64_t index = 0;
+    while (state.keepRunning()) {
+      const std::string &key = getKey(state, index++);
+      repo_->Put(key, reinterpret_cast<const uint8_t*>(value_.data()), value_.size());
+      repo_->Delete(key);
+      state.addBytesProcessed(value_.size());
+    }
+  }
+};
+
+}  // namespace
+
+REGISTER_BENCHMARK(VolatileRepositoryPut, 1, 4)
+REGISTER_BENCHMARK(VolatileRepositoryPutDelete, 1, 4)
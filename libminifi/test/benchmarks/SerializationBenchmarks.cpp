@@ -0,0 +1,134 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../TestBase.h"
+#include "FlowFileRecord.h"
+#include "io/DataStream.h"
+#include "provenance/Provenance.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "core/repository/VolatileFlowFileRepository.h"
+
+namespace {
+
+/**
+ * Provides a FlowFile with the attributes of a typical file based flow, and its serialized form.
+ */
+class SerializationBenchmark : public Benchmark {
+ public:
+  void setUp(int threads) override {
+    auto configuration = std::make_shared<minifi::Configure>();
+    content_repo_ = std::make_shared<core::repository::VolatileContentRepository>();
+    content_repo_->initialize(configuration);
+    flow_repo_ = std::make_shared<core::repository::VolatileFlowFileRepository>("benchmarkflowrepo");
+    flow_repo_->initialize(configuration);
+
+    std::map<std::string, std::string> attributes { { "filename", "benchmark.txt" }, { "path", "/var/data/benchmark/" }, { "absolute.path", "/var/data/benchmark/benchmark.txt" }, {
+        "file.lastModifiedTime", "2019-10-18T10:00:00Z" }, { "mime.type", "text/plain" } };
+    flow_file_ = std::make_shared<minifi::FlowFileRecord>(flow_repo_, content_repo_, attributes);
+  }
+
+  void tearDown() override {
+    flow_file_ = nullptr;
+  }
+
+ protected:
+  std::shared_ptr<core::ContentRepository> content_repo_;
+  std::shared_ptr<core::Repository> flow_repo_;
+  std::shared_ptr<core::FlowFile> flow_file_;
+};
+
+class FlowFileRecordSerialize : public SerializationBenchmark {
+ public:
+  void run(BenchmarkState &state) override {
+    minifi::FlowFileRecord record(flow_repo_, content_repo_, flow_file_);
+    while (state.keepRunning()) {
+      minifi::io::DataStream stream;
+      record.Serialize(stream);
+      state.addBytesProcessed(stream.getSize());
+    }
+  }
+};
+
+class FlowFileRecordDeSerialize : public SerializationBenchmark {
+ public:
+  void setUp(int threads) override {
+    SerializationBenchmark::setUp(threads);
+    minifi::FlowFileRecord record(flow_repo_, content_repo_, flow_file_);
+    record.Serialize(serialized_);
+  }
+
+  void run(BenchmarkState &state) override {
+    while (state.keepRunning()) {
+      minifi::FlowFileRecord record(flow_repo_, content_repo_);
+      record.DeSerialize(serialized_.getBuffer(), serialized_.getSize());
+      state.addBytesProcessed(serialized_.getSize());
+    }
+  }
+
+ private:
+  minifi::io::DataStream serialized_;
+};
+
+class ProvenanceEventSerialize : public SerializationBenchmark {
+ public:
+  void run(BenchmarkState &state) override {
+    provenance::ProvenanceEventRecord event(provenance::ProvenanceEventRecord::CREATE, "benchmark", "GetFile");
+    event.fromFlowFile(flow_file_);
+    event.setDetails("file created from /var/data/benchmark/benchmark.txt");
+    while (state.keepRunning()) {
+      minifi::io::DataStream stream;
+      event.Serialize(stream);
+      state.addBytesProcessed(stream.getSize());
+    }
+  }
+};
+
+class ProvenanceEventDeSerialize : public SerializationBenchmark {
+ public:
+  void setUp(int threads) override {
+    SerializationBenchmark::setUp(threads);
+    provenance::ProvenanceEventRecord event(provenance::ProvenanceEventRecord::CREATE, "benchmark", "GetFile");
+    event.fromFlowFile(flow_file_);
+    event.setDetails("file created from /var/data/benchmark/benchmark.txt");
+    event.Serialize(serialized_);
+  }
+
+  void run(BenchmarkState &state) override {
+    while (state.keepRunning()) {
+      provenance::ProvenanceEventRecord event;
+      event.DeSerialize(serialized_.getBuffer(), serialized_.getSize());
+      state.addBytesProcessed(serialized_.getSize());
+    }
+  }
+
+ private:
+  minifi::io::DataStream serialized_;
+};
+
+}  // namespace
+
+REGISTER_BENCHMARK(FlowFileRecordSerialize, 1, 4)
+REGISTER_BENCHMARK(FlowFileRecordDeSerialize, 1, 4)
+REGISTER_BENCHMARK(ProvenanceEventSerialize, 1, 4)
+REGISTER_BENCHMARK(ProvenanceEventDeSerialize, 1, 4)
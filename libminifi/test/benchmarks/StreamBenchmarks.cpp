@@ -0,0 +1,93 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../TestBase.h"
+#include "ResourceClaim.h"
+#include "io/BaseStream.h"
+#include "core/repository/VolatileContentRepository.h"
+
+namespace {
+
+/**
+ * Writes and reads back the fields of a typical record header through a BaseStream.
+ */
+class BaseStreamWriteRead : public Benchmark {
+ public:
+  void run(BenchmarkState &state) override {
+    const std::string text = "benchmark.txt";
+    while (state.keepRunning()) {
+      minifi::io::BaseStream stream;
+      stream.write(static_cast<uint64_t>(state.getIterations()));
+      stream.write(static_cast<uint32_t>(42));
+      stream.writeUTF(text);
+
+      uint64_t value64;
+      uint32_t value32;
+      std::string read_text;
+      stream.read(value64);
+      stream.read(value32);
+      stream.readUTF(read_text);
+      doNotOptimize(value64);
+      doNotOptimize(value32);
+      state.addBytesProcessed(stream.getSize());
+    }
+  }
+};
+
+/**
+ * Writes 4 KiB of content to a VolatileContentRepository claim, reads it back and removes the claim.
+ */
+class ContentRepositoryWriteRead : public Benchmark {
+ public:
+  static constexpr int CONTENT_SIZE = 4096;
+
+  void setUp(int threads) override {
+    auto configuration = std::make_shared<minifi::Configure>();
+    content_repo_ = std::make_shared<core::repository::VolatileContentRepository>();
+    content_repo_->initialize(configuration);
+  }
+
+  void run(BenchmarkState &state) override {
+    std::vector<uint8_t> content(CONTENT_SIZE, 'x');
+    std::vector<uint8_t> buffer(CONTENT_SIZE);
+    while (state.keepRunning()) {
+      auto claim = std::make_shared<minifi::ResourceClaim>(content_repo_);
+      content_repo_->write(claim)->writeData(content.data(), CONTENT_SIZE);
+      content_repo_->read(claim)->readData(buffer.data(), CONTENT_SIZE);
+      content_repo_->remove(claim);
+      state.addBytesProcessed(CONTENT_SIZE);
+    }
+  }
+
+  void tearDown() override {
+    content_repo_ = nullptr;
+  }
+
+ private:
+  std::shared_ptr<core::ContentRepository> content_repo_;
+};
+
+}  // namespace
+
+REGISTER_BENCHMARK(BaseStreamWriteRead, 1, 4)
+REGISTER_BENCHMARK(ContentRepositoryWriteRead, 1, 4)
@@ -16,16 +16,21 @@
  * limitations under the License.
  */
 #include <memory>
+#include <set>
+#include <string>
 
 #include "../../include/core/state/nodes/ProcessMetrics.h"
+#include "../../include/core/state/nodes/ProcessorMetrics.h"
 #include "../../include/core/state/nodes/QueueMetrics.h"
 #include "../../include/core/state/nodes/RepositoryMetrics.h"
 #include "../../include/core/state/nodes/SystemMetrics.h"
+#include "../../include/core/state/nodes/TLSMetrics.h"
 #include "../TestBase.h"
 #include "io/ClientSocket.h"
 #include "core/Processor.h"
 #include "core/ClassLoader.h"
 #include "core/yaml/YamlConfiguration.h"
+#include "SchedulingAgent.h"
 
 TEST_CASE("TestProcessMetrics", "[c2m1]") {
   minifi::state::response::ProcessMetrics metrics;
@@ -52,6 +57,145 @@ TEST_CASE("TestSystemMetrics", "[c2m5]") {
 #endif
 }
 
+TEST_CASE("TestTLSMetrics", "[c2m6]") {
+  minifi::state::response::TLSMetrics metrics;
+
+  REQUIRE("TLSMetrics" == metrics.getName());
+
+  minifi::io::TLSStatistics::getInstance().recordClientHandshake(false);
+  minifi::io::TLSStatistics::getInstance().recordClientHandshake(true);
+
+  auto serialized = metrics.serialize();
+  REQUIRE(2 == serialized.size());
+  REQUIRE("ClientHandshakes" == serialized.at(0).name);
+  REQUIRE("ServerHandshakes" == serialized.at(1).name);
+  REQUIRE(3 == serialized.at(0).children.size());
+  REQUIRE("resumedPercent" == serialized.at(0).children.at(2).name);
+  REQUIRE(minifi::io::TLSStatistics::getInstance().getClientResumptions() >= 1);
+}
+
+TEST_CASE("TestProcessorMetrics", "[c2m7]") {
+  minifi::state::response::ProcessorMetrics metrics;
+
+  REQUIRE("ProcessorMetrics" == metrics.getName());
+  REQUIRE(0 == metrics.serialize().size());
+
+  auto processor = std::make_shared<core::Processor>("testprocessor");
+  metrics.addProcessor(processor);
+
+  auto statistics = processor->getStatistics();
+  statistics->recordTrigger(std::chrono::microseconds(100));
+  statistics->recordTrigger(std::chrono::microseconds(300));
+  statistics->recordCommit(std::chrono::microseconds(50), 2, 1024, 3, 4096);
+
+  auto serialized = metrics.serialize();
+  REQUIRE(1 == serialized.size());
+  minifi::state::response::SerializedResponseNode resp = serialized.at(0);
+  REQUIRE(processor->getUUIDStr() == resp.name);
+  REQUIRE(8 == resp.children.size());
+
+  REQUIRE("name" == resp.children.at(0).name);
+  REQUIRE("testprocessor" == resp.children.at(0).value.to_string());
+  REQUIRE("OnTriggerInvocations" == resp.children.at(1).name);
+  REQUIRE("2" == resp.children.at(1).value.to_string());
+  REQUIRE("FlowFilesIn" == resp.children.at(2).name);
+  REQUIRE("2" == resp.children.at(2).value.to_string());
+  REQUIRE("BytesIn" == resp.children.at(3).name);
+  REQUIRE("1024" == resp.children.at(3).value.to_string());
+  REQUIRE("FlowFilesOut" == resp.children.at(4).name);
+  REQUIRE("3" == resp.children.at(4).value.to_string());
+  REQUIRE("BytesOut" == resp.children.at(5).name);
+  REQUIRE("4096" == resp.children.at(5).value.to_string());
+
+  minifi::state::response::SerializedResponseNode trigger = resp.children.at(6);
+  REQUIRE("OnTriggerMicros" == trigger.name);
+  REQUIRE(7 == trigger.children.size());
+  REQUIRE("count" == trigger.children.at(0).name);
+  REQUIRE("2" == trigger.children.at(0).value.to_string());
+  REQUIRE("sum" == trigger.children.at(1).name);
+  REQUIRE("400" == trigger.children.at(1).value.to_string());
+  REQUIRE("mean" == trigger.children.at(2).name);
+  REQUIRE("200" == trigger.children.at(2).value.to_string());
+  REQUIRE("max" == trigger.children.at(6).name);
+  REQUIRE("300" == trigger.children.at(6).value.to_string());
+
+  minifi::state::response::SerializedResponseNode commit = resp.children.at(7);
+  REQUIRE("CommitMicros" == commit.name);
+  REQUIRE("1" == commit.children.at(0).value.to_string());
+}
+
+TEST_CASE("TestProcessorMetricsOfProcessorsWithTheSameName", "[c2m7]") {
+  minifi::state::response::ProcessorMetrics metrics;
+
+  auto first = std::make_shared<core::Processor>("LogAttribute");
+  auto second = std::make_shared<core::Processor>("LogAttribute");
+  metrics.addProcessor(first);
+  metrics.addProcessor(second);
+
+  auto serialized = metrics.serialize();
+  REQUIRE(2 == serialized.size());
+  std::set<std::string> ids { serialized.at(0).name, serialized.at(1).name };
+  REQUIRE(1 == ids.count(first->getUUIDStr()));
+  REQUIRE(1 == ids.count(second->getUUIDStr()));
+  REQUIRE("LogAttribute" == serialized.at(0).children.at(0).value.to_string());
+  REQUIRE("LogAttribute" == serialized.at(1).children.at(0).value.to_string());
+}
+
+namespace {
+
+class FlowFileProducer : public core::Processor {
+ public:
+  explicit FlowFileProducer(const std::string &name)
+      : Processor(name) {
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    session->transfer(session->create(), core::Relationship("success", "description"));
+    session->transfer(session->create(), core::Relationship("success", "description"));
+  }
+};
+
+// runs processors like the scheduling agents of a flow do, without scheduling them
+class ImmediateSchedulingAgent : public minifi::SchedulingAgent {
+ public:
+  ImmediateSchedulingAgent(const std::shared_ptr<TestPlan> &plan, utils::ThreadPool<utils::TaskRescheduleInfo> &thread_pool)
+      : SchedulingAgent(nullptr, plan->getProvenanceRepo(), plan->getFlowRepo(), plan->getContentRepo(), std::make_shared<minifi::Configure>(), thread_pool) {
+  }
+
+  void schedule(std::shared_ptr<core::Processor> processor) override {
+  }
+
+  void unschedule(std::shared_ptr<core::Processor> processor) override {
+  }
+};
+
+}  // namespace
+
+TEST_CASE("TestProcessorMetricsOfTriggeredProcessor", "[c2m7]") {
+  TestController testController;
+  auto plan = testController.createPlan();
+  auto producer = plan->addProcessor(std::make_shared<FlowFileProducer>("producer"), "producer");
+  plan->addProcessor(std::make_shared<core::Processor>("consumer"), "consumer", core::Relationship("success", "description"), true);
+
+  utils::ThreadPool<utils::TaskRescheduleInfo> thread_pool;
+  ImmediateSchedulingAgent agent(plan, thread_pool);
+  plan->runNextProcessor([&agent, &producer](const std::shared_ptr<core::ProcessContext> context, const std::shared_ptr<core::ProcessSession> session) {
+    agent.onTrigger(producer, context, std::make_shared<core::ProcessSessionFactory>(context));
+  });
+
+  minifi::state::response::ProcessorMetrics metrics;
+  metrics.addProcessor(producer);
+  minifi::state::response::SerializedResponseNode resp = metrics.serialize().at(0);
+  REQUIRE("OnTriggerInvocations" == resp.children.at(1).name);
+  REQUIRE("1" == resp.children.at(1).value.to_string());
+  REQUIRE("FlowFilesIn" == resp.children.at(2).name);
+  REQUIRE("0" == resp.children.at(2).value.to_string());
+  REQUIRE("FlowFilesOut" == resp.children.at(4).name);
+  REQUIRE("2" == resp.children.at(4).value.to_string());
+  REQUIRE("OnTriggerMicros" == resp.children.at(6).name);
+  REQUIRE("1" == resp.children.at(6).children.at(0).value.to_string());
+}
+
 TEST_CASE("QueueMetricsTestNoConnections", "[c2m2]") {
   minifi::state::response::QueueMetrics metrics;
 
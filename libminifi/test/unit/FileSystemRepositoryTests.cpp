@@ -0,0 +1,112 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include "../TestBase.h"
+#include "core/repository/FileSystemRepository.h"
+#include "properties/Configure.h"
+#include "ResourceClaim.h"
+#include "utils/file/FileUtils.h"
+
+#ifndef WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string readFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+TEST_CASE("FileSystemRepository imports files without copying them", "[filesystemrepo]") {
+  TestController testController;
+  char format_repo[] = "/tmp/fsrepo.XXXXXX";
+  std::string repo_dir = testController.createTempDirectory(format_repo);
+  char format_src[] = "/tmp/fssrc.XXXXXX";
+  std::string src_dir = testController.createTempDirectory(format_src);
+
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, repo_dir);
+  auto content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  REQUIRE(content_repo->initialize(configuration));
+
+  const std::string source = utils::file::FileUtils::concat_path(src_dir, "source.txt");
+  {
+    std::ofstream file(source, std::ios::binary);
+    file << "imported content";
+  }
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+
+  SECTION("the source file is moved") {
+    REQUIRE(content_repo->importFile(source, claim, false));
+    REQUIRE_FALSE(std::ifstream(source).good());
+  }
+
+  SECTION("the source file is kept") {
+    REQUIRE(content_repo->importFile(source, claim, true));
+    REQUIRE("imported content" == readFile(source));
+  }
+
+#ifndef WIN32
+  SECTION("a symbolic link is imported as a copy of its target") {
+    const std::string link = utils::file::FileUtils::concat_path(src_dir, "link.txt");
+    REQUIRE(0 == symlink(source.c_str(), link.c_str()));
+    REQUIRE(content_repo->importFile(link, claim, false));
+    struct stat claim_stat;
+    REQUIRE(0 == lstat(claim->getContentFullPath().c_str(), &claim_stat));
+    REQUIRE(S_ISREG(claim_stat.st_mode));
+    REQUIRE("imported content" == readFile(source));
+  }
+#endif
+
+  REQUIRE("imported content" == readFile(claim->getContentFullPath()));
+  auto stream = content_repo->read(claim);
+  REQUIRE(16 == stream->getSize());
+}
+
+TEST_CASE("FileSystemRepository exports ranges of content to files", "[filesystemrepo]") {
+  TestController testController;
+  char format_repo[] = "/tmp/fsrepo.XXXXXX";
+  std::string repo_dir = testController.createTempDirectory(format_repo);
+  char format_dst[] = "/tmp/fsdst.XXXXXX";
+  std::string dst_dir = testController.createTempDirectory(format_dst);
+
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, repo_dir);
+  auto content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  REQUIRE(content_repo->initialize(configuration));
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  {
+    std::string content = "first|second|third";
+    auto stream = content_repo->write(claim);
+    REQUIRE(static_cast<int>(content.size()) == stream->writeData(reinterpret_cast<uint8_t*>(&content[0]), content.size()));
+  }
+
+  const std::string destination = utils::file::FileUtils::concat_path(dst_dir, "exported.txt");
+  REQUIRE(content_repo->exportFile(claim, 6, 6, destination));
+  REQUIRE("second" == readFile(destination));
+}
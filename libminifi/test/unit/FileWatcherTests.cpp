@@ -0,0 +1,92 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include "../TestBase.h"
+#include "utils/file/FileUtils.h"
+#include "utils/file/FileWatcher.h"
+
+#ifdef __linux__
+
+using utils::file::FileEvent;
+using utils::file::FileUtils;
+using utils::file::FileWatcher;
+
+namespace {
+
+void writeFile(const std::string &path) {
+  std::ofstream file(path);
+  file << "content";
+}
+
+std::set<std::string> pollWritten(FileWatcher &watcher, bool &complete) {
+  std::set<std::string> written;
+  complete = watcher.poll([&written](const FileEvent &event) {
+    if (event.type == utils::file::FILE_WRITTEN) {
+      written.insert(FileUtils::concat_path(event.directory, event.filename));
+    } else if (event.type == utils::file::FILE_REMOVED) {
+      written.erase(FileUtils::concat_path(event.directory, event.filename));
+    }
+  });
+  return written;
+}
+
+}  // namespace
+
+TEST_CASE("FileWatcher reports written and moved files", "[filewatcher]") {
+  TestController testController;
+  char format[] = "/tmp/fwatch.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+  const std::string subdir = FileUtils::concat_path(dir, "sub");
+  FileUtils::create_dir(subdir);
+
+  FileWatcher watcher(dir, true);
+  REQUIRE(watcher.start());
+
+  writeFile(FileUtils::concat_path(dir, "first.txt"));
+  writeFile(FileUtils::concat_path(subdir, "second.txt"));
+  std::rename(FileUtils::concat_path(dir, "first.txt").c_str(), FileUtils::concat_path(subdir, "moved.txt").c_str());
+
+  bool complete = false;
+  auto written = pollWritten(watcher, complete);
+  REQUIRE(complete);
+  const std::set<std::string> expected { FileUtils::concat_path(subdir, "second.txt"), FileUtils::concat_path(subdir, "moved.txt") };
+  REQUIRE(expected == written);
+
+  SECTION("files of new subdirectories are reported") {
+    const std::string new_dir = FileUtils::concat_path(dir, "new");
+    FileUtils::create_dir(new_dir);
+    writeFile(FileUtils::concat_path(new_dir, "third.txt"));
+    written = pollWritten(watcher, complete);
+    REQUIRE(complete);
+    REQUIRE(written.count(FileUtils::concat_path(new_dir, "third.txt")) == 1);
+  }
+
+  SECTION("removing the watched directory ends watching") {
+    FileUtils::delete_dir(dir, true);
+    pollWritten(watcher, complete);
+    REQUIRE_FALSE(complete);
+    REQUIRE_FALSE(watcher.isWatching());
+  }
+}
+
+#endif
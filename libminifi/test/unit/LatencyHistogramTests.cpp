@@ -0,0 +1,82 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "../TestBase.h"
+#include "utils/LatencyHistogram.h"
+
+using org::apache::nifi::minifi::utils::LatencyHistogram;
+
+TEST_CASE("LatencyHistogram without values", "[latencyhistogram]") {
+  LatencyHistogram histogram;
+  REQUIRE(0 == histogram.getCount());
+  REQUIRE(0 == histogram.getMean());
+  REQUIRE(0 == histogram.getMax());
+  REQUIRE(0 == histogram.getValueAtPercentile(99.0));
+}
+
+TEST_CASE("LatencyHistogram buckets are contiguous", "[latencyhistogram]") {
+  for (uint64_t value = 0; value < 100000; value++) {
+    const uint32_t index = LatencyHistogram::bucketIndex(value);
+    REQUIRE(index < LatencyHistogram::BUCKET_COUNT);
+    REQUIRE(value <= LatencyHistogram::bucketUpperBound(index));
+    if (index > 0) {
+      REQUIRE(value > LatencyHistogram::bucketUpperBound(index - 1));
+    }
+  }
+  REQUIRE(LatencyHistogram::BUCKET_COUNT - 1 == LatencyHistogram::bucketIndex(UINT64_MAX));
+  REQUIRE(UINT64_MAX == LatencyHistogram::bucketUpperBound(LatencyHistogram::BUCKET_COUNT - 1));
+}
+
+TEST_CASE("LatencyHistogram percentiles stay within the bucket precision", "[latencyhistogram]") {
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 1000; value++) {
+    histogram.record(value);
+  }
+  REQUIRE(1000 == histogram.getCount());
+  REQUIRE(500 == histogram.getMean());
+  REQUIRE(1000 == histogram.getMax());
+
+  const uint64_t median = histogram.getValueAtPercentile(50.0);
+  REQUIRE(median >= 500);
+  REQUIRE(median <= 500 + 500 / LatencyHistogram::SUB_BUCKET_COUNT);
+
+  const uint64_t p99 = histogram.getValueAtPercentile(99.0);
+  REQUIRE(p99 >= 990);
+  REQUIRE(p99 <= 1000);
+  REQUIRE(1000 == histogram.getValueAtPercentile(100.0));
+}
+
+TEST_CASE("LatencyHistogram records from several threads", "[latencyhistogram]") {
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&histogram, i]() {
+      for (uint64_t value = 0; value < 10000; value++) {
+        histogram.record(value + i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  REQUIRE(40000 == histogram.getCount());
+  REQUIRE(10002 == histogram.getMax());
+}
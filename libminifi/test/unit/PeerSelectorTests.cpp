@@ -0,0 +1,136 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../TestBase.h"
+#include "sitetosite/PeerSelector.h"
+
+using org::apache::nifi::minifi::sitetosite::Peer;
+using org::apache::nifi::minifi::sitetosite::PeerSelector;
+using org::apache::nifi::minifi::sitetosite::PeerStatus;
+
+namespace {
+
+std::vector<PeerStatus> createPeers(const std::vector<uint32_t> &flow_file_counts) {
+  std::vector<PeerStatus> peers;
+  uint16_t port = 8000;
+  for (auto count : flow_file_counts) {
+    peers.emplace_back(std::make_shared<Peer>("localhost", port++), count, false);
+  }
+  return peers;
+}
+
+std::map<uint16_t, int> select(PeerSelector &selector, int times) {
+  std::map<uint16_t, int> selections;
+  for (int i = 0; i < times; i++) {
+    auto peer = selector.getNextPeer();
+    REQUIRE(peer != nullptr);
+    selections[peer->getPort()]++;
+  }
+  return selections;
+}
+
+}  // namespace
+
+TEST_CASE("PeerSelector without peers", "[peerselector]") {
+  PeerSelector selector;
+  REQUIRE(0 == selector.size());
+  REQUIRE(nullptr == selector.getNextPeer());
+}
+
+TEST_CASE("PeerSelector spreads evenly loaded peers", "[peerselector]") {
+  PeerSelector selector;
+  selector.setPeers(createPeers( { 0, 0, 0 }), org::apache::nifi::minifi::sitetosite::SEND);
+  REQUIRE(3 == selector.size());
+
+  auto selections = select(selector, 30);
+  REQUIRE(10 == selections[8000]);
+  REQUIRE(10 == selections[8001]);
+  REQUIRE(10 == selections[8002]);
+}
+
+TEST_CASE("PeerSelector weighs peers by FlowFile count", "[peerselector]") {
+  PeerSelector selector;
+
+  SECTION("sending favors the least loaded peer") {
+    // weights are 100 and 20, as the share of the loaded peer counts as 80%
+    selector.setPeers(createPeers( { 0, 100 }), org::apache::nifi::minifi::sitetosite::SEND);
+    auto selections = select(selector, 120);
+    REQUIRE(100 == selections[8000]);
+    REQUIRE(20 == selections[8001]);
+  }
+
+  SECTION("sending spreads the FlowFiles by the share of the peers") {
+    // weights are 100, 75 and 25
+    selector.setPeers(createPeers( { 0, 100, 300 }), org::apache::nifi::minifi::sitetosite::SEND);
+    auto selections = select(selector, 200);
+    REQUIRE(100 == selections[8000]);
+    REQUIRE(75 == selections[8001]);
+    REQUIRE(25 == selections[8002]);
+  }
+
+  SECTION("the weights do not depend on the magnitude of the counts") {
+    // weights are 100 and 20, as with 100 FlowFiles
+    selector.setPeers(createPeers( { 0, 1000000 }), org::apache::nifi::minifi::sitetosite::SEND);
+    auto selections = select(selector, 120);
+    REQUIRE(100 == selections[8000]);
+    REQUIRE(20 == selections[8001]);
+  }
+
+  SECTION("receiving favors the most loaded peer") {
+    // weights are 1 and 80
+    selector.setPeers(createPeers( { 0, 100 }), org::apache::nifi::minifi::sitetosite::RECEIVE);
+    auto selections = select(selector, 81);
+    REQUIRE(1 == selections[8000]);
+    REQUIRE(80 == selections[8001]);
+  }
+}
+
+TEST_CASE("PeerSelector skips penalized peers", "[peerselector]") {
+  PeerSelector selector(std::chrono::milliseconds(100));
+  selector.setPeers(createPeers( { 0, 0 }), org::apache::nifi::minifi::sitetosite::SEND);
+
+  selector.penalize("localhost", 8000);
+  auto selections = select(selector, 10);
+  REQUIRE(0 == selections[8000]);
+  REQUIRE(10 == selections[8001]);
+
+  SECTION("penalization survives a peer list refresh") {
+    selector.setPeers(createPeers( { 0, 0 }), org::apache::nifi::minifi::sitetosite::SEND);
+    selections = select(selector, 10);
+    REQUIRE(0 == selections[8000]);
+  }
+
+  SECTION("falls back to the peer recovering first when every peer is penalized") {
+    selector.penalize("localhost", 8001);
+    REQUIRE(8000 == selector.getNextPeer()->getPort());
+  }
+
+  SECTION("penalized peers are selected again once the penalization expires") {
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    selections = select(selector, 10);
+    REQUIRE(5 == selections[8000]);
+    REQUIRE(5 == selections[8001]);
+  }
+}
@@ -70,3 +70,27 @@ TEST_CASE("TestRegexUtils::check_mode", "[regex4]") {
   Regex r2(rgx1, mode);
   REQUIRE(r2.match(pat));
 }
+
+TEST_CASE("TestRegexUtils::search_from_offset", "[regex5]") {
+  std::string pat = "Speed limit 130 | Speed limit 80";
+  const Regex r1("Speed limit ([0-9]+)");
+  std::vector<std::string> results;
+  size_t match_end = 0;
+  REQUIRE(r1.search(pat, 0, results, match_end));
+  REQUIRE((std::vector<std::string>{"Speed limit 130", "130"}) == results);
+  REQUIRE(15 == match_end);
+  REQUIRE(r1.search(pat, match_end, results, match_end));
+  REQUIRE((std::vector<std::string>{"Speed limit 80", "80"}) == results);
+  REQUIRE(pat.size() == match_end);
+  REQUIRE(!r1.search(pat, match_end, results, match_end));
+  REQUIRE(results.empty());
+  REQUIRE(!r1.search(pat, pat.size() + 1, results, match_end));
+}
+
+TEST_CASE("TestRegexUtils::search_without_results", "[regex6]") {
+  const Regex r1("[0-9]+");
+  REQUIRE(r1.search("Speed limit 80"));
+  REQUIRE(!r1.search("Speed limit"));
+  const Regex r2;
+  REQUIRE(!r2.search("Speed limit 80"));
+}
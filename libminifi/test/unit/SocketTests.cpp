@@ -27,6 +27,7 @@
 #include "io/StreamFactory.h"
 #include "io/Sockets.h"
 #include "utils/ThreadPool.h"
+#include "io/tls/TLSStatistics.h"
 using Sockets = org::apache::nifi::minifi::io::Socket;
 
 TEST_CASE("TestSocket", "[TestSocket1]") {
@@ -239,4 +240,60 @@ TEST_CASE("TestTLSContextCreationNullptr", "[TestSocket10]") {
   minifi::io::TLSSocket *tls = dynamic_cast<minifi::io::TLSSocket*>(socket);
   REQUIRE(tls == nullptr);
 }
+
+std::shared_ptr<minifi::Configure> createTLSConfiguration() {
+  std::shared_ptr<minifi::Configure> configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_security_client_certificate, "resources/cn.crt.pem");
+  configuration->set(minifi::Configure::nifi_security_client_private_key, "resources/cn.ckey.pem");
+  configuration->set(minifi::Configure::nifi_security_client_pass_phrase, "resources/cn.pass");
+  configuration->set(minifi::Configure::nifi_security_client_ca_certificate, "resources/nifi-cert.pem");
+  return configuration;
+}
+
+/**
+ * Reconnecting to the same peer with the same context must resume the
+ * session negotiated by the first connection on both ends.
+ */
+TEST_CASE("TestTLSSessionResumption", "[TestSocket11]") {
+  std::string host = Sockets::getMyHostName();
+  auto server_context = std::make_shared<minifi::io::TLSContext>(createTLSConfiguration());
+  minifi::io::TLSSocket server(server_context, host, 10011, 2);
+  REQUIRE(-1 != server.initialize());
+
+  // the server accepts, and thereby handshakes, within select_descriptor
+  std::atomic<bool> running(true);
+  std::thread server_thread([&server, &running]() {
+    while (running) {
+      server.select_descriptor(100);
+    }
+  });
+
+  auto &statistics = minifi::io::TLSStatistics::getInstance();
+  auto client_context = std::make_shared<minifi::io::TLSContext>(createTLSConfiguration());
+
+  minifi::io::TLSSocket first(client_context, host, 10011);
+  bool first_connected = first.initialize() == 0;
+  first.closeStream();
+
+  uint64_t client_resumptions = statistics.getClientResumptions();
+  uint64_t server_resumptions = statistics.getServerResumptions();
+
+  minifi::io::TLSSocket second(client_context, host, 10011);
+  bool second_connected = second.initialize() == 0;
+
+  // the server records its side once it has read the client's finished message
+  for (int i = 0; i < 50 && statistics.getServerResumptions() == server_resumptions; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  second.closeStream();
+
+  running = false;
+  server_thread.join();
+  server.closeStream();
+
+  REQUIRE(first_connected);
+  REQUIRE(second_connected);
+  REQUIRE(statistics.getClientResumptions() > client_resumptions);
+  REQUIRE(statistics.getServerResumptions() > server_resumptions);
+}
 #endif
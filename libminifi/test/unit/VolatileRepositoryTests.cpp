@@ -0,0 +1,229 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../TestBase.h"
+#include "core/repository/ContentArena.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "core/repository/VolatileProvenanceRepository.h"
+#include "properties/Configure.h"
+#include "ResourceClaim.h"
+
+namespace {
+
+std::shared_ptr<minifi::Configure> createConfiguration(const std::string &repo_name, const std::string &max_count) {
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(std::string(minifi::Configure::nifi_volatile_repository_options) + repo_name + ".max.count", max_count);
+  return configuration;
+}
+
+bool put(core::Repository &repo, const std::string &key, const std::string &value) {
+  return repo.Put(key, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+}  // namespace
+
+TEST_CASE("VolatileRepository stores and consumes values by key", "[volatilerepo]") {
+  core::repository::VolatileProvenanceRepository repo("volatiletest");
+  REQUIRE(repo.initialize(createConfiguration("volatiletest", "3")));
+
+  REQUIRE(put(repo, "a", "first"));
+  REQUIRE(put(repo, "b", "second"));
+
+  std::string value;
+  REQUIRE(repo.Get("b", value));
+  REQUIRE("second" == value);
+
+  value.clear();
+  REQUIRE_FALSE(repo.Get("b", value));
+  REQUIRE_FALSE(repo.Get("c", value));
+
+  REQUIRE(repo.Delete("a"));
+  REQUIRE_FALSE(repo.Delete("a"));
+  REQUIRE(0 == repo.getRepoSize());
+}
+
+TEST_CASE("VolatileRepository replaces the value of a stored key", "[volatilerepo]") {
+  core::repository::VolatileProvenanceRepository repo("volatiletest");
+  REQUIRE(repo.initialize(createConfiguration("volatiletest", "2")));
+
+  REQUIRE(put(repo, "a", "first"));
+  REQUIRE(put(repo, "a", "updated"));
+  REQUIRE(put(repo, "b", "second"));
+
+  std::string value;
+  REQUIRE(repo.Get("a", value));
+  REQUIRE("updated" == value);
+  value.clear();
+  REQUIRE(repo.Get("b", value));
+  REQUIRE("second" == value);
+}
+
+TEST_CASE("VolatileRepository reuses freed slots before evicting", "[volatilerepo]") {
+  core::repository::VolatileProvenanceRepository repo("volatiletest");
+  REQUIRE(repo.initialize(createConfiguration("volatiletest", "3")));
+
+  REQUIRE(put(repo, "a", "1"));
+  REQUIRE(put(repo, "b", "2"));
+  REQUIRE(put(repo, "c", "3"));
+  REQUIRE(repo.Delete("b"));
+  REQUIRE(put(repo, "d", "4"));
+
+  std::string value;
+  for (const auto &key : std::vector<std::string> { "a", "c", "d" }) {
+    REQUIRE(repo.Get(key, value));
+  }
+
+  SECTION("a full repository evicts the oldest slot") {
+    REQUIRE(put(repo, "a", "1"));
+    REQUIRE(put(repo, "b", "2"));
+    REQUIRE(put(repo, "c", "3"));
+    REQUIRE(put(repo, "e", "5"));
+    REQUIRE_FALSE(repo.Get("a", value));
+    REQUIRE(repo.Get("e", value));
+  }
+}
+
+TEST_CASE("VolatileContentRepository reuses the slots of removed claims", "[volatilerepo]") {
+  auto content_repo = std::make_shared<core::repository::VolatileContentRepository>("volatilecontent");
+  REQUIRE(content_repo->initialize(createConfiguration("volatilecontent", "1")));
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  std::string content = "content";
+  {
+    auto stream = content_repo->write(claim, false);
+    REQUIRE(stream != nullptr);
+    REQUIRE(static_cast<int>(content.size()) == stream->writeData(reinterpret_cast<uint8_t*>(&content[0]), content.size()));
+  }
+  REQUIRE(content_repo->read(claim) != nullptr);
+
+  auto other_claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  REQUIRE(content_repo->write(other_claim, false) == nullptr);
+
+  REQUIRE(content_repo->remove(claim));
+  REQUIRE(content_repo->read(claim) == nullptr);
+  REQUIRE(content_repo->write(other_claim, false) != nullptr);
+}
+
+TEST_CASE("VolatileContentRepository appends or replaces the content of existing claims", "[volatilerepo]") {
+  auto content_repo = std::make_shared<core::repository::VolatileContentRepository>("volatilecontent");
+  REQUIRE(content_repo->initialize(createConfiguration("volatilecontent", "1")));
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  auto write_content = [&](const std::string &content, bool append) {
+    auto stream = content_repo->write(claim, append);
+    REQUIRE(stream != nullptr);
+    std::string data = content;
+    REQUIRE(static_cast<int>(data.size()) == stream->writeData(reinterpret_cast<uint8_t*>(&data[0]), data.size()));
+  };
+  auto read_content = [&]() -> std::string {
+    auto stream = content_repo->read(claim);
+    REQUIRE(stream != nullptr);
+    std::vector<uint8_t> buffer;
+    stream->readData(buffer, stream->getSize());
+    return std::string(buffer.begin(), buffer.end());
+  };
+
+  write_content("first", false);
+  write_content(" second", true);
+  REQUIRE("first second" == read_content());
+  REQUIRE(12 == content_repo->getRepoSize());
+
+  auto previous_stream = content_repo->read(claim);
+  write_content("third", false);
+  REQUIRE("third" == read_content());
+  REQUIRE(5 + 12 == content_repo->getRepoSize());
+
+  // a stream opened before the content was replaced still reads the previous content
+  std::vector<uint8_t> buffer;
+  REQUIRE(12 == previous_stream->readData(buffer, 12));
+  REQUIRE("first second" == std::string(buffer.begin(), buffer.end()));
+  previous_stream = nullptr;
+  REQUIRE(5 == content_repo->getRepoSize());
+
+  // replacing does not count as another claim
+  auto other_claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  REQUIRE(content_repo->write(other_claim, false) == nullptr);
+}
+
+TEST_CASE("ArenaContent appends across chunks", "[volatilerepo]") {
+  auto arena = std::make_shared<core::repository::ContentArena>(1024 * 1024);
+  std::vector<uint8_t> data(100000);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i % 251);
+  }
+  {
+    core::repository::ArenaContent content(arena);
+    REQUIRE(content.append(data.data(), 1000));
+    REQUIRE(content.append(data.data() + 1000, data.size() - 1000));
+    REQUIRE(data.size() == content.getLength());
+    REQUIRE(data.size() == arena->getUsedBytes());
+
+    std::vector<uint8_t> buffer(data.size() + 10);
+    REQUIRE(data.size() == content.read(0, buffer.data(), buffer.size()));
+    buffer.resize(data.size());
+    REQUIRE(data == buffer);
+    REQUIRE(10 == content.read(data.size() - 10, buffer.data(), 100));
+    REQUIRE(0 == content.read(data.size(), buffer.data(), 100));
+  }
+  REQUIRE(0 == arena->getUsedBytes());
+}
+
+TEST_CASE("ContentArena enforces its maximum size", "[volatilerepo]") {
+  auto arena = std::make_shared<core::repository::ContentArena>(2 * core::repository::ContentArena::SLAB_SIZE);
+  std::vector<uint8_t> data(core::repository::ContentArena::SLAB_SIZE);
+  {
+    core::repository::ArenaContent first(arena);
+    REQUIRE(first.append(data.data(), data.size()));
+    core::repository::ArenaContent second(arena);
+    REQUIRE(second.append(data.data(), data.size()));
+    core::repository::ArenaContent third(arena);
+    REQUIRE_FALSE(third.append(data.data(), 1));
+    REQUIRE(0 == third.getLength());
+    REQUIRE(arena->getReservedBytes() <= arena->getMaxBytes());
+  }
+  core::repository::ArenaContent content(arena);
+  REQUIRE(content.append(data.data(), data.size()));
+}
+
+TEST_CASE("VolatileContentRepository releases the memory of removed claims", "[volatilerepo]") {
+  auto content_repo = std::make_shared<core::repository::VolatileContentRepository>("volatilecontent");
+  auto configuration = createConfiguration("volatilecontent", "10");
+  configuration->set(std::string(minifi::Configure::nifi_volatile_repository_options) + "volatilecontent.max.bytes", "1000000");
+  REQUIRE(content_repo->initialize(configuration));
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  std::string content(200000, 'x');
+  {
+    auto stream = content_repo->write(claim, false);
+    REQUIRE(static_cast<int>(content.size()) == stream->writeData(reinterpret_cast<uint8_t*>(&content[0]), content.size()));
+  }
+  REQUIRE(content.size() == content_repo->getRepoSize());
+
+  auto stream = content_repo->read(claim);
+  REQUIRE(content_repo->remove(claim));
+  REQUIRE(content.size() == content_repo->getRepoSize());
+
+  std::vector<uint8_t> buffer;
+  REQUIRE(static_cast<int>(content.size()) == stream->readData(buffer, content.size()));
+  stream = nullptr;
+  REQUIRE(0 == content_repo->getRepoSize());
+}
@@ -103,3 +103,32 @@ TEST_CASE("gzip compression and decompression pipeline", "[basic]") {
   REQUIRE(decompressStream.isFinished());
   REQUIRE(original == std::string(reinterpret_cast<const char*>(decompressStream.getBuffer()), decompressStream.getSize()));
 }
+
+TEST_CASE("multi-member gzip decompression", "[basic]") {
+  std::string original;
+  std::vector<uint8_t> compressed;
+  for (const std::string member : {"foo", "", "bar", "baz"}) {
+    io::ZlibCompressStream compressStream;
+    if (!member.empty()) {
+      REQUIRE(member.size() == compressStream.writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(member.data())), member.size()));
+    }
+    compressStream.closeStream();
+    REQUIRE(compressStream.isFinished());
+    compressed.insert(compressed.end(), compressStream.getBuffer(), compressStream.getBuffer() + compressStream.getSize());
+    original += member;
+  }
+
+  io::ZlibDecompressStream decompressStream;
+
+  SECTION("in one write") {
+    REQUIRE(compressed.size() == decompressStream.writeData(compressed.data(), compressed.size()));
+  }
+  SECTION("one byte at a time") {
+    for (auto& byte : compressed) {
+      REQUIRE(1 == decompressStream.writeData(&byte, 1));
+    }
+  }
+
+  REQUIRE(decompressStream.isFinished());
+  REQUIRE(original == std::string(reinterpret_cast<const char*>(decompressStream.getBuffer()), decompressStream.getSize()));
+}
@@ -32,6 +32,7 @@ typedef struct proc_properties {
     char * file_path;
     char delimiter;
     uint64_t chunk_size;
+    char * read_buffer; /* chunk_size + 1 bytes, reused by every trigger */
 } proc_properties;
 
 typedef struct processor_params {
@@ -267,6 +267,8 @@ flow_file_record *invoke_file(standalone_processor* proc, const char* path);
 
 /**
  * Invoke a standalone processor with some in-memory data
+ * The buffer is only borrowed for the duration of the call: it is written to the content of the input flow file directly,
+ * without being copied first.
  * @param buf specifies the beginning of the input buffer
  * @param size specifies the size of the buffer
  * @return a flow file record or nullptr in case no flowfile was generated
@@ -405,6 +407,16 @@ int8_t remove_attribute(flow_file_record*, const char * key);
 
 int transmit_flowfile(flow_file_record *, nifi_instance *);
 
+/**
+ * Transmits several flow files to the remote port of the instance. The flow files are sent in as few
+ * site-to-site transactions as the batch settings of the port allow, rather than in one transaction each.
+ * @param ffs array of flow file records
+ * @param count number of flow file records in ffs
+ * @param instance nifi instance structure
+ * @return 0 if every flow file was sent, -1 otherwise
+ **/
+int transmit_flowfiles(flow_file_record **ffs, size_t count, nifi_instance *instance);
+
 
 /****
  * ##################################################################
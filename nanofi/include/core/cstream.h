@@ -38,8 +38,19 @@ int write_uint8_t(uint8_t value, cstream * stream);
 
 int write_char(char value, cstream * stream);
 
+/**
+ * Writes to the stream. Small writes are combined in the buffer of the stream,
+ * which is sent once it is full, before reading from the stream, or when the stream is flushed or closed.
+ * @return len on success, a value <= 0 if sending failed, in which case the stream is closed
+ */
 int write_buffer(const uint8_t *value, int len, cstream * stream);
 
+/**
+ * Sends the buffered writes of the stream.
+ * @return 0 on success, -1 if sending failed, in which case the stream is closed
+ */
+int flush_stream(cstream * stream);
+
 int writeUTF(const char * cstr, uint64_t len, enum Bool widen, cstream * stream);
 
 int read_char(char *value, cstream * stream);
@@ -146,8 +146,13 @@ typedef struct file_buffer {
 typedef int SOCKET;
 #endif
 
+/* Size of the buffer small writes to a cstream are combined in */
+#define CSTREAM_WRITE_BUFFER_SIZE 4096
+
 typedef struct cstream {
   SOCKET socket_;
+  uint8_t write_buffer_[CSTREAM_WRITE_BUFFER_SIZE];
+  size_t write_buffer_len_;
 } cstream;
 
 /****
@@ -21,6 +21,8 @@
 #include <memory>
 #include <type_traits>
 #include <string>
+#include <utility>
+#include <vector>
 #include "core/Property.h"
 #include "properties/Configure.h"
 #include "io/StreamFactory.h"
@@ -136,13 +138,8 @@ class Instance {
   }
 
   void transfer(const std::shared_ptr<FlowFileRecord> &ff, const std::shared_ptr<minifi::io::DataStream> &stream = nullptr) {
-    std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider = nullptr;
-    auto processContext = std::make_shared<core::ProcessContext>(proc_node_, controller_service_provider, no_op_repo_, no_op_repo_, configure_, content_repo_);
-    auto sessionFactory = std::make_shared<core::ProcessSessionFactory>(processContext);
-
-    rpg_->onSchedule(processContext, sessionFactory);
-
-    auto session = std::make_shared<core::ReflexiveSession>(processContext);
+    std::shared_ptr<core::ProcessContext> processContext;
+    auto session = createTransferSession(processContext);
 
     session->add(ff);
     if (stream) {
@@ -151,8 +148,59 @@ class Instance {
     rpg_->onTrigger(processContext, session);
   }
 
+  /**
+   * Transfers the FlowFiles in as few site-to-site transactions as the batch settings of the remote port allow,
+   * instead of one transaction per FlowFile.
+   * @param ffs FlowFiles paired with the path of the file their content is imported from. FlowFiles without a path
+   * and without a resource claim are sent with empty content.
+   * @return number of FlowFiles that could not be sent
+   */
+  size_t transfer(const std::vector<std::pair<std::shared_ptr<FlowFileRecord>, std::string>> &ffs) {
+    std::shared_ptr<core::ProcessContext> processContext;
+    auto session = createTransferSession(processContext);
+
+    for (const auto &ff : ffs) {
+      session->add(ff.first);
+      if (!ff.second.empty()) {
+        session->import(ff.second, ff.first, true /*keepSource*/);
+      } else if (ff.first->getResourceClaim() == nullptr) {
+        minifi::io::DataStream empty_stream;
+        session->importFrom(empty_stream, ff.first);
+      }
+    }
+
+    // every trigger sends one transaction, stop as soon as one of them fails or makes no progress
+    size_t remaining = session->getFlowFileCount();
+    while (remaining > 0) {
+      rpg_->clearYield();
+      rpg_->onTrigger(processContext, session);
+      if (rpg_->isYield()) {
+        // the port yields when a transaction fails, nothing it took from the session was sent
+        session->restoreTaken();
+        break;
+      }
+      session->commitTaken();
+      const size_t previously_remaining = remaining;
+      remaining = session->getFlowFileCount();
+      if (remaining >= previously_remaining) {
+        break;
+      }
+    }
+    return session->getFlowFileCount();
+  }
+
  protected:
 
+  std::shared_ptr<core::ReflexiveSession> createTransferSession(std::shared_ptr<core::ProcessContext> &processContext) {
+    std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider = nullptr;
+    processContext = std::make_shared<core::ProcessContext>(proc_node_, controller_service_provider, no_op_repo_, no_op_repo_, configure_, content_repo_);
+    auto sessionFactory = std::make_shared<core::ProcessSessionFactory>(processContext);
+
+    rpg_->onSchedule(processContext, sessionFactory);
+
+    return std::make_shared<core::ReflexiveSession>(processContext);
+  }
+
   bool registerUpdateListener(const std::shared_ptr<state::UpdateController> &updateController, const int64_t &delay) {
     auto functions = updateController->getFunctions();
     // run all functions independently
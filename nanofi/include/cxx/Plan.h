@@ -54,9 +54,34 @@ using content_repo_sptr = std::shared_ptr<core::ContentRepository>;
 
 struct flowfile_input_params {
   std::shared_ptr<minifi::io::DataStream> content_stream;
+  // content lent by the caller, used when there is no content stream
+  const uint8_t *content_buffer = nullptr;
+  size_t content_size = 0;
   std::map<std::string, std::string> attributes;
 };
 
+/**
+ * Writes a buffer owned by the caller to the content of a flow file without copying it first.
+ */
+class LentBufferCallback : public minifi::OutputStreamCallback {
+ public:
+  LentBufferCallback(const uint8_t *buffer, size_t size)
+      : buffer_(buffer),
+        size_(size) {
+  }
+
+  int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) override {
+    if (size_ == 0) {
+      return 0;
+    }
+    return stream->writeData(const_cast<uint8_t*>(buffer_), size_);
+  }
+
+ private:
+  const uint8_t *buffer_;
+  size_t size_;
+};
+
 namespace {
 
   void failureStrategyAsIs(core::ProcessSession *session, failure_callback_type user_callback, content_repo_sptr cr_ptr) {
@@ -18,6 +18,7 @@
 #ifndef __REFLEXIVE_SESSION_H__
 #define __REFLEXIVE_SESSION_H__
 
+#include <deque>
 #include <vector>
 #include <queue>
 #include <map>
@@ -50,21 +51,49 @@ class ReflexiveSession : public ProcessSession{
   }
 
    virtual std::shared_ptr<core::FlowFile> get(){
-     auto prevff = ff;
-     ff = nullptr;
+     if (flow_files_.empty()) {
+       return nullptr;
+     }
+     auto prevff = flow_files_.front();
+     flow_files_.pop_front();
+     taken_.push_back(prevff);
      return prevff;
    }
 
    virtual void add(const std::shared_ptr<core::FlowFile> &flow){
-     ff = flow;
+     flow_files_.push_back(flow);
+   }
+
+   /**
+    * Returns the number of added FlowFiles that have not been taken by get() yet.
+    */
+   size_t getFlowFileCount() const {
+     return flow_files_.size();
+   }
+
+   /**
+    * Forgets the FlowFiles taken by get() so far, they are no longer restored by restoreTaken().
+    */
+   void commitTaken() {
+     taken_.clear();
+   }
+
+   /**
+    * Puts the FlowFiles taken by get() since the last commitTaken() back at the front, in their original order.
+    */
+   void restoreTaken() {
+     flow_files_.insert(flow_files_.begin(), taken_.begin(), taken_.end());
+     taken_.clear();
    }
    virtual void transfer(const std::shared_ptr<core::FlowFile> &flow, Relationship relationship){
      // no op
    }
  protected:
   //
-  // Get the FlowFile from the highest priority queue
-  std::shared_ptr<core::FlowFile> ff;
+  // FlowFiles handed out by get() in the order they were added
+  std::deque<std::shared_ptr<core::FlowFile>> flow_files_;
+  // FlowFiles handed out by get() since the last commitTaken()
+  std::vector<std::shared_ptr<core::FlowFile>> taken_;
 
 };
 
@@ -24,6 +24,7 @@ void free_proc_params(const char * uuid) {
     if (pp) {
         free_flow_file_list(&pp->ff_list);
         free(pp->properties->file_path);
+        free(pp->properties->read_buffer);
         free(pp->properties);
         HASH_DEL(procparams, pp);
         free(pp);
@@ -274,6 +275,12 @@ void on_trigger_tailfilechunk(processor_session * ps, processor_context * ctx) {
         strncpy(props->file_path, file_path, len);
         props->file_path[len] = '\0';
         props->chunk_size = chunk_size_value;
+        props->read_buffer = (char *)malloc((chunk_size_value + 1) * sizeof(char));
+        if (!props->read_buffer) {
+            free(props->file_path);
+            free(props);
+            return;
+        }
         add_processor_properties(uuid_str, props);
     }
 
@@ -284,7 +291,7 @@ void on_trigger_tailfilechunk(processor_session * ps, processor_context * ctx) {
         return;
     }
 
-    char * buff = (char *)malloc((props->chunk_size +1 ) * sizeof(char));
+    char * buff = props->read_buffer;
     size_t bytes_read = 0;
 
     uint64_t curr_offset = get_current_offset(uuid_str);
@@ -299,7 +306,6 @@ void on_trigger_tailfilechunk(processor_session * ps, processor_context * ctx) {
         add_attributes(ffr, props->file_path, curr_offset);
         add_to_hash_table(ffr, curr_offset, uuid_str);
     }
-    free(buff);
     fclose(fp);
 }
 
@@ -19,8 +19,12 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 #include <exception>
+#include <functional>
+#include <mutex>
 #include <stdio.h>
+#include <string.h>
 
 #include "api/nanofi.h"
 #include "core/Core.h"
@@ -41,6 +45,83 @@ class API_INITIALIZER {
   static int initialized;
 };
 
+namespace {
+
+/**
+ * Keeps a bounded number of released objects for reuse, so that creating and freeing
+ * flow file records at high rates does not churn the heap. Released objects are reset
+ * before they are kept, so nothing of their previous use is handed out again.
+ */
+template<typename T>
+class ObjectPool {
+ public:
+  ObjectPool(size_t max_size, std::function<T*()> create, std::function<void(T*)> reset, std::function<void(T*)> destroy)
+      : max_size_(max_size),
+        create_(std::move(create)),
+        reset_(std::move(reset)),
+        destroy_(std::move(destroy)) {
+    objects_.reserve(max_size_);
+  }
+
+  ~ObjectPool() {
+    for (auto object : objects_) {
+      destroy_(object);
+    }
+  }
+
+  T *acquire() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!objects_.empty()) {
+        T *object = objects_.back();
+        objects_.pop_back();
+        return object;
+      }
+    }
+    return create_();
+  }
+
+  void release(T *object) {
+    reset_(object);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (objects_.size() < max_size_) {
+        objects_.push_back(object);
+        return;
+      }
+    }
+    destroy_(object);
+  }
+
+ private:
+  const size_t max_size_;
+  std::function<T*()> create_;
+  std::function<void(T*)> reset_;
+  std::function<void(T*)> destroy_;
+  std::mutex mutex_;
+  std::vector<T*> objects_;
+};
+
+constexpr size_t MAX_POOLED_RECORDS = 64;
+
+ObjectPool<flow_file_record> &getRecordPool() {
+  static ObjectPool<flow_file_record> pool(MAX_POOLED_RECORDS,
+      []() { return static_cast<flow_file_record *>(malloc(sizeof(flow_file_record))); },
+      [](flow_file_record *record) { memset(record, 0, sizeof(flow_file_record)); },
+      [](flow_file_record *record) { free(record); });
+  return pool;
+}
+
+ObjectPool<string_map> &getAttributeMapPool() {
+  static ObjectPool<string_map> pool(MAX_POOLED_RECORDS,
+      []() { return new string_map(); },
+      [](string_map *attributes) { attributes->clear(); },
+      [](string_map *attributes) { delete attributes; });
+  return pool;
+}
+
+}  // namespace
+
 //Just an internal utility func., not to be published via API!
 file_buffer file_to_buffer(const char *path) {
   file_buffer fb;
@@ -245,12 +326,12 @@ flow_file_record* create_flowfile(const char *file, const size_t len) {
 flow_file_record* create_ff_object(const char *file, const size_t len, const uint64_t size) {
   NULL_CHECK(nullptr, file);
   flow_file_record *new_ff = create_ff_object_na(file, len, size);
-  new_ff->attributes = new string_map();
+  new_ff->attributes = getAttributeMapPool().acquire();
   return new_ff;
 }
 
 flow_file_record* create_ff_object_na(const char *file, const size_t len, const uint64_t size) {
-  flow_file_record *new_ff = (flow_file_record *) malloc(sizeof(flow_file_record));
+  flow_file_record *new_ff = getRecordPool().acquire();
   new_ff->attributes = nullptr;
   if (file != nullptr) {
     new_ff->contentLocation = (char *) malloc(sizeof(char) * (len + 1));
@@ -269,7 +350,7 @@ flow_file_record* create_ff_object_na(const char *file, const size_t len, const
 
 flow_file_record* create_ff_object_nc() {
   flow_file_record* new_ff = create_ff_object_na(nullptr, 0, 0);
-  new_ff->attributes = new string_map();
+  new_ff->attributes = getAttributeMapPool().acquire();
   return new_ff;
 }
 
@@ -344,13 +425,15 @@ void free_flowfile(flow_file_record *ff) {
   }
   if (ff->ffp == nullptr) {
     auto map = static_cast<string_map*>(ff->attributes);
-    delete map;
+    if (map) {
+      getAttributeMapPool().release(map);
+    }
   } else {
     auto ff_sptr = reinterpret_cast<std::shared_ptr<core::FlowFile>*>(ff->ffp);
     delete ff_sptr;
   }
   free(ff->contentLocation);
-  free(ff);
+  getRecordPool().release(ff);
 }
 
 /**
@@ -463,53 +546,68 @@ int get_content(const flow_file_record* ff, uint8_t* target, int size) {
  * @param instance nifi instance structure
  */
 int transmit_flowfile(flow_file_record *ff, nifi_instance *instance) {
-  static string_map empty_attribute_map;
-
   NULL_CHECK(-1, ff, instance);
+  return transmit_flowfiles(&ff, 1, instance);
+}
+
+/**
+ * Transmits the flowfiles in as few site-to-site transactions as possible
+ * @param ffs flow file records
+ * @param count number of flow file records
+ * @param instance nifi instance structure
+ */
+int transmit_flowfiles(flow_file_record **ffs, size_t count, nifi_instance *instance) {
+  NULL_CHECK(-1, ffs, instance);
+  for (size_t i = 0; i < count; i++) {
+    NULL_CHECK(-1, ffs[i]);
+  }
+  if (count == 0) {
+    return 0;
+  }
   auto minifi_instance_ref = static_cast<minifi::Instance*>(instance->instance_ptr);
   // in the unlikely event the user forgot to initialize the instance, we shall do it for them.
   if (UNLIKELY(minifi_instance_ref->isRPGConfigured() == false)) {
     minifi_instance_ref->setRemotePort(instance->port.port_id);
   }
 
-  string_map& attribute_map = empty_attribute_map;
-  if(ff->attributes) {
-    attribute_map = *(static_cast<string_map *>(ff->attributes));
-  }
+  static const string_map empty_attribute_map;
 
   auto no_op = minifi_instance_ref->getNoOpRepository();
 
-  auto content_repo = minifi_instance_ref->getContentRepository();
-
-  std::shared_ptr<minifi::ResourceClaim> claim = nullptr;
-  std::shared_ptr<minifi::io::DataStream> stream = nullptr; //Used when content is not in content repo
-
-  if(ff->contentLocation) {
-    auto ff_content_repo_ptr = (static_cast<std::shared_ptr<minifi::core::ContentRepository>*>(ff->crp));
-    if (ff->crp && (*ff_content_repo_ptr)) {
-      content_repo = *ff_content_repo_ptr;
-      claim = std::make_shared<minifi::ResourceClaim>(ff->contentLocation, content_repo);
-      claim->increaseFlowFileRecordOwnedCount();
-      claim->increaseFlowFileRecordOwnedCount();
-    } else {
-      file_buffer fb = file_to_buffer(ff->contentLocation);
-      stream = std::make_shared<minifi::io::DataStream>();
-      stream->writeData(fb.buffer, fb.file_len);
-      free(fb.buffer);
+  std::vector<std::pair<std::shared_ptr<minifi::FlowFileRecord>, std::string>> flow_files;
+  flow_files.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    flow_file_record *ff = ffs[i];
+    const string_map *attribute_map = ff->attributes ? static_cast<string_map *>(ff->attributes) : &empty_attribute_map;
+
+    auto content_repo = minifi_instance_ref->getContentRepository();
+
+    std::shared_ptr<minifi::ResourceClaim> claim = nullptr;
+    std::string content_path;  // Used when content is not in content repo
+
+    if (ff->contentLocation) {
+      auto ff_content_repo_ptr = (static_cast<std::shared_ptr<minifi::core::ContentRepository>*>(ff->crp));
+      if (ff->crp && (*ff_content_repo_ptr)) {
+        content_repo = *ff_content_repo_ptr;
+        claim = std::make_shared<minifi::ResourceClaim>(ff->contentLocation, content_repo);
+        claim->increaseFlowFileRecordOwnedCount();
+        claim->increaseFlowFileRecordOwnedCount();
+      } else {
+        // imported straight from the file instead of being read into memory first
+        content_path = ff->contentLocation;
+      }
     }
-  } else {
-    //The flowfile has no content - create an empty stream to create empty content
-    stream = std::make_shared<minifi::io::DataStream>();
-  }
+    // a flowfile without claim and content path is sent with empty content
 
-  auto ffr = std::make_shared<minifi::FlowFileRecord>(no_op, content_repo, attribute_map, claim);
-  ffr->addAttribute("nanofi.version", API_VERSION);
-  ffr->setSize(ff->size);
-
-  std::string port_uuid = instance->port.port_id;
-
-  minifi_instance_ref->transfer(ffr, stream);
+    auto ffr = std::make_shared<minifi::FlowFileRecord>(no_op, content_repo, *attribute_map, claim);
+    ffr->addAttribute("nanofi.version", API_VERSION);
+    ffr->setSize(ff->size);
+    flow_files.emplace_back(std::move(ffr), std::move(content_path));
+  }
 
+  if (minifi_instance_ref->transfer(flow_files) > 0) {
+    return -1;
+  }
   return 0;
 }
 
@@ -723,9 +821,10 @@ flow_file_record *invoke_chunk(standalone_processor* proc, uint8_t* buf, uint64_
 
   plan->reset();
 
+  // the content is written to the flow file straight from the caller's buffer
   auto ff_data = std::make_shared<flowfile_input_params>();
-  ff_data->content_stream = std::make_shared<minifi::io::DataStream>();
-  ff_data->content_stream->writeData(buf, size);
+  ff_data->content_buffer = buf;
+  ff_data->content_size = size;
 
   plan->runNextProcessor(nullptr, ff_data);
   while (plan->runNextProcessor()) {
@@ -44,7 +44,7 @@ int write_uint16_t(uint16_t value, cstream * stream) {
   return write_buffer((uint8_t*)(&value), sizeof(uint16_t), stream);
 }
 
-int write_buffer(const uint8_t *value, int len, cstream * stream) {
+static int send_buffer(const uint8_t *value, int len, cstream * stream) {
   int ret = 0, bytes = 0;
 
   while (bytes < len) {
@@ -55,7 +55,6 @@ int write_buffer(const uint8_t *value, int len, cstream * stream) {
         continue;
       }
       logc(err, "Could not send to %d, error: %s", stream->socket_, strerror(errno));
-      close_stream(stream);
       return ret;
     }
     bytes += ret;
@@ -66,7 +65,49 @@ int write_buffer(const uint8_t *value, int len, cstream * stream) {
   return bytes;
 }
 
+int flush_stream(cstream * stream) {
+  if (stream->write_buffer_len_ == 0) {
+    return 0;
+  }
+  int len = stream->write_buffer_len_;
+  stream->write_buffer_len_ = 0;
+  if (send_buffer(stream->write_buffer_, len, stream) != len) {
+    close_stream(stream);
+    return -1;
+  }
+  return 0;
+}
+
+int write_buffer(const uint8_t *value, int len, cstream * stream) {
+  if (len <= 0) {
+    return 0;
+  }
+
+  if (stream->write_buffer_len_ + len > CSTREAM_WRITE_BUFFER_SIZE) {
+    if (flush_stream(stream) < 0) {
+      return -1;
+    }
+  }
+
+  // writes not fitting in the buffer are sent directly instead of being copied piecewise
+  if (len >= CSTREAM_WRITE_BUFFER_SIZE) {
+    int ret = send_buffer(value, len, stream);
+    if (ret != len) {
+      close_stream(stream);
+    }
+    return ret;
+  }
+
+  memcpy(stream->write_buffer_ + stream->write_buffer_len_, value, len);
+  stream->write_buffer_len_ += len;
+  return len;
+}
+
 int read_buffer(uint8_t *buf, int len, cstream * stream) {
+  // the other side can only answer what it has received
+  if (flush_stream(stream) < 0) {
+    return -1;
+  }
   int32_t total_read = 0;
   while (len) {
     int bytes_read = recv(stream->socket_, buf, len, 0);
@@ -160,6 +201,10 @@ int readUTF(char * buf, uint64_t buflen, cstream * stream) {
 
 void close_stream(cstream * stream) {
   if(stream != NULL && stream->socket_ != -1) {
+    if (stream->write_buffer_len_ > 0) {
+      send_buffer(stream->write_buffer_, stream->write_buffer_len_, stream);
+      stream->write_buffer_len_ = 0;
+    }
 #ifdef _WIN32
     shutdown(stream->socket_, SD_BOTH);
     closesocket(stream->socket_);
@@ -224,6 +269,7 @@ cstream * create_socket(const char * host, uint16_t portnum) {
 
   cstream *stream = (cstream *) malloc(sizeof(cstream));
   stream->socket_ = sock;
+  stream->write_buffer_len_ = 0;
   logc(debug, "%s", "Socket successfully connected");
   return stream;
 }
@@ -74,12 +74,23 @@ void transmit_flow_files(nifi_instance * instance, flow_file_list * ff_list, int
     if (!instance || !ff_list) {
         return;
     }
+    size_t count = 0;
     flow_file_list * el = NULL;
+    LL_FOREACH(ff_list, el) {
+        count++;
+    }
+    flow_file_record ** records = (flow_file_record **)malloc(count * sizeof(flow_file_record *));
+    if (!records) {
+        return;
+    }
+    count = 0;
     LL_FOREACH(ff_list, el) {
         if (!complete || el->complete) {
-            transmit_flowfile(el->ff_record, instance);
+            records[count++] = el->ff_record;
         }
     }
+    transmit_flowfiles(records, count, instance);
+    free(records);
 }
 
 void read_payload_and_transmit(struct flow_file_list * ffl, struct CRawSiteToSiteClient * client) {
@@ -170,7 +170,12 @@ bool ExecutionPlan::runNextProcessor(std::function<void(const std::shared_ptr<co
     for(const auto& kv : input_ff_params->attributes) {
       flowFile->setAttribute(kv.first, kv.second);
     }
-    current_session->importFrom(*(input_ff_params->content_stream.get()), flowFile);
+    if (input_ff_params->content_stream) {
+      current_session->importFrom(*(input_ff_params->content_stream.get()), flowFile);
+    } else {
+      LentBufferCallback callback(input_ff_params->content_buffer, input_ff_params->content_size);
+      current_session->write(flowFile, &callback);
+    }
     current_session->transfer(flowFile, core::Relationship("success", "success"));
     relationships_[relationships_.size()-1]->put(std::static_pointer_cast<core::FlowFile>(flowFile));
   }
@@ -469,7 +469,8 @@ int complete(struct CRawSiteToSiteClient * client, const char * transactionID) {
       return 0;
     } else {
       logc(debug, "Site2Site transaction %s send finished", transactionID);
-      if(writeResponse(client, TRANSACTION_FINISHED, "Finished") <= 0) {
+      // nothing is read after the last response, so push it out of the write buffer
+      if(writeResponse(client, TRANSACTION_FINISHED, "Finished") <= 0 || flush_stream(client->_peer->_stream) < 0) {
         return -1;
       } else {
         transaction->_state = TRANSACTION_COMPLETED;
@@ -29,6 +29,7 @@
 #include <chrono>
 #include <thread>
 #include "api/nanofi.h"
+#include "cxx/Instance.h"
 
 std::string test_file_content = "C API raNdOMcaSe test d4t4 th1s is!";
 std::string test_file_name = "tstFile.ext";
@@ -88,6 +89,87 @@ void custom_ontrigger_logic(processor_session *ps, processor_context *ctx) {
   free(buffer);
 }
 
+/**
+ * Remote port that records the contents taken in each trigger as one transaction instead of sending them.
+ */
+class RecordingRemotePort : public minifi::RemoteProcessorGroupPort {
+ public:
+  enum class Mode {
+    SEND,
+    // takes a FlowFile, then fails the transaction the way the site-to-site client does
+    FAIL,
+    // takes nothing and reports no error
+    STALL
+  };
+
+  RecordingRemotePort(const std::shared_ptr<minifi::io::StreamFactory> &stream_factory, const std::shared_ptr<minifi::Configure> &configure, size_t batch_count)
+      : RemoteProcessorGroupPort(stream_factory, "RecordingRemotePort", "", configure),
+        mode_(Mode::SEND),
+        batch_count_(batch_count),
+        triggers_(0) {
+  }
+
+  void onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) override {
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    triggers_++;
+    if (mode_ == Mode::STALL) {
+      return;
+    }
+    std::vector<std::string> transaction;
+    while (transaction.size() < batch_count_) {
+      auto flow = session->get();
+      if (!flow) {
+        break;
+      }
+      if (mode_ == Mode::FAIL) {
+        context->yield();
+        return;
+      }
+      ContentReader reader;
+      session->read(flow, &reader);
+      transaction.push_back(reader.content_);
+    }
+    if (!transaction.empty()) {
+      transactions_.push_back(transaction);
+    }
+  }
+
+  Mode mode_;
+  size_t batch_count_;
+  size_t triggers_;
+  std::vector<std::vector<std::string>> transactions_;
+
+ private:
+  class ContentReader : public minifi::InputStreamCallback {
+   public:
+    int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) override {
+      std::vector<uint8_t> buffer(stream->getSize());
+      const int read = buffer.empty() ? 0 : stream->readData(buffer.data(), buffer.size());
+      content_.assign(buffer.begin(), buffer.begin() + (read > 0 ? read : 0));
+      return read;
+    }
+    std::string content_;
+  };
+};
+
+/**
+ * Instance whose site-to-site port is a RecordingRemotePort.
+ */
+class RecordingInstance : public minifi::Instance {
+ public:
+  explicit RecordingInstance(size_t batch_count)
+      : Instance("http://localhost:8080/nifi", "12345") {
+    port_ = std::make_shared<RecordingRemotePort>(stream_factory_, configure_, batch_count);
+    rpg_ = port_;
+    proc_node_ = std::make_shared<core::ProcessorNode>(rpg_);
+    rpgInitialized_ = true;
+  }
+
+  std::shared_ptr<RecordingRemotePort> port_;
+};
+
 std::string create_testfile_for_getfile(const char* sourcedir, const std::string& filename = test_file_name) {
   std::fstream file;
   std::stringstream ss;
@@ -532,6 +614,15 @@ TEST_CASE("C API robustness test", "[TestRobustness]") {
 
   REQUIRE(transmit_flowfile(ffr, nullptr) == -1);
 
+  REQUIRE(transmit_flowfiles(nullptr, 1, instance) == -1);
+
+  REQUIRE(transmit_flowfiles(&ffr, 1, nullptr) == -1);
+
+  flow_file_record *ffrs[] = { ffr, nullptr };
+  REQUIRE(transmit_flowfiles(ffrs, 2, instance) == -1);
+
+  REQUIRE(transmit_flowfiles(ffrs, 0, instance) == 0);
+
   REQUIRE(create_new_flow(nullptr) == nullptr);
 
   flow *test_flow = create_new_flow(instance);
@@ -546,3 +637,167 @@ TEST_CASE("C API robustness test", "[TestRobustness]") {
 
   free_instance(instance);
 }
+
+TEST_CASE("Test standalone processors with chunk input", "[testStandaloneWithChunk]") {
+  TestController testController;
+
+  char src_format[] = "/tmp/gt.XXXXXX";
+  auto sourcedir = testController.createTempDirectory(src_format);
+  std::string path = create_testfile_for_getfile(sourcedir.c_str());
+
+  standalone_processor* extract_test = create_processor("ExtractText", NULL);
+  REQUIRE(extract_test != nullptr);
+  REQUIRE(set_standalone_property(extract_test, "Attribute", "TestAttr") == 0);
+
+  std::vector<uint8_t> chunk(test_file_content.begin(), test_file_content.end());
+  flow_file_record* chunk_ffr = invoke_chunk(extract_test, chunk.data(), chunk.size());
+  REQUIRE(chunk_ffr != nullptr);
+
+  // the flow file must not keep referring to the lent buffer
+  std::fill(chunk.begin(), chunk.end(), 'x');
+
+  flow_file_record* file_ffr = invoke_file(extract_test, path.c_str());
+  REQUIRE(file_ffr != nullptr);
+
+  REQUIRE(chunk_ffr->size == test_file_content.size());
+  REQUIRE(chunk_ffr->size == file_ffr->size);
+
+  std::vector<uint8_t> chunk_content(chunk_ffr->size);
+  REQUIRE(get_content(chunk_ffr, chunk_content.data(), chunk_content.size()) == static_cast<int>(chunk_content.size()));
+  std::vector<uint8_t> file_content(file_ffr->size);
+  REQUIRE(get_content(file_ffr, file_content.data(), file_content.size()) == static_cast<int>(file_content.size()));
+
+  REQUIRE(std::string(chunk_content.begin(), chunk_content.end()) == test_file_content);
+  REQUIRE(chunk_content == file_content);
+
+  attribute attr;
+  char test_attr[] = "TestAttr";
+  attr.key = test_attr;
+  attr.value_size = 0;
+  REQUIRE(get_attribute(chunk_ffr, &attr) == 0);
+  REQUIRE(std::string(static_cast<char*>(attr.value), attr.value_size) == test_file_content);
+
+  free_flowfile(chunk_ffr);
+  free_flowfile(file_ffr);
+  free_standalone_processor(extract_test);
+}
+
+TEST_CASE("Test transmitting several flow files", "[testTransmitFlowFiles]") {
+  TestController testController;
+
+  char src_format[] = "/tmp/gt.XXXXXX";
+  auto sourcedir = testController.createTempDirectory(src_format);
+
+  std::vector<std::string> contents;
+  std::vector<flow_file_record*> records;
+  for (int i = 0; i < 5; i++) {
+    std::string filename = "file" + std::to_string(i);
+    std::string path = sourcedir + "/" + filename;
+    std::ofstream file(path);
+    file << "content " << i;
+    file.close();
+    contents.push_back("content " + std::to_string(i));
+    records.push_back(create_flowfile(path.c_str(), path.size()));
+    REQUIRE(records.back() != nullptr);
+  }
+
+  auto instance = create_instance_obj();
+  REQUIRE(instance != nullptr);
+  void *original_instance = instance->instance_ptr;
+
+  SECTION("All records fit in one transaction") {
+    RecordingInstance recording(100);
+    instance->instance_ptr = &recording;
+
+    REQUIRE(transmit_flowfiles(records.data(), records.size(), instance) == 0);
+
+    REQUIRE(recording.port_->triggers_ == 1);
+    REQUIRE(recording.port_->transactions_.size() == 1);
+    REQUIRE(recording.port_->transactions_[0] == contents);
+    instance->instance_ptr = original_instance;
+  }
+
+  SECTION("Records are split across transactions by the batch count") {
+    RecordingInstance recording(2);
+    instance->instance_ptr = &recording;
+
+    REQUIRE(transmit_flowfiles(records.data(), records.size(), instance) == 0);
+
+    REQUIRE(recording.port_->transactions_.size() == 3);
+    const std::vector<std::string> first = { contents[0], contents[1] };
+    const std::vector<std::string> second = { contents[2], contents[3] };
+    const std::vector<std::string> last = { contents[4] };
+    REQUIRE(recording.port_->transactions_[0] == first);
+    REQUIRE(recording.port_->transactions_[1] == second);
+    REQUIRE(recording.port_->transactions_[2] == last);
+    instance->instance_ptr = original_instance;
+  }
+
+  SECTION("Transfer stops when a trigger makes no progress") {
+    RecordingInstance recording(100);
+    recording.port_->mode_ = RecordingRemotePort::Mode::STALL;
+    instance->instance_ptr = &recording;
+
+    REQUIRE(transmit_flowfiles(records.data(), records.size(), instance) == -1);
+
+    REQUIRE(recording.port_->triggers_ == 1);
+    REQUIRE(recording.port_->transactions_.empty());
+    instance->instance_ptr = original_instance;
+  }
+
+  SECTION("FlowFiles taken by a failed transaction are reported as unsent") {
+    RecordingInstance recording(100);
+    recording.port_->mode_ = RecordingRemotePort::Mode::FAIL;
+    instance->instance_ptr = &recording;
+
+    REQUIRE(transmit_flowfiles(records.data(), records.size(), instance) == -1);
+    REQUIRE(recording.port_->triggers_ == 1);
+
+    auto no_op = recording.getNoOpRepository();
+    std::vector<std::pair<std::shared_ptr<minifi::FlowFileRecord>, std::string>> flow_files;
+    for (size_t i = 0; i < contents.size(); i++) {
+      auto ffr = std::make_shared<minifi::FlowFileRecord>(no_op, recording.getContentRepository());
+      flow_files.emplace_back(ffr, std::string());
+    }
+    REQUIRE(recording.transfer(flow_files) == contents.size());
+    instance->instance_ptr = original_instance;
+  }
+
+  for (auto record : records) {
+    free_flowfile(record);
+  }
+  free_instance(instance);
+}
+
+TEST_CASE("Test pooled flow file records are handed out cleared", "[testRecordPool]") {
+  flow_file_record *ffr = create_ff_object_nc();
+  REQUIRE(ffr != nullptr);
+
+  const char *value = "value";
+  REQUIRE(add_attribute(ffr, "key", (void*)value, strlen(value)) == 0);
+  REQUIRE(get_attribute_quantity(ffr) == 1);
+  ffr->keepContent = 1;
+  ffr->size = 42;
+
+  const uintptr_t released_record = reinterpret_cast<uintptr_t>(ffr);
+  const uintptr_t released_attributes = reinterpret_cast<uintptr_t>(ffr->attributes);
+  free_flowfile(ffr);
+
+  // the pool hands out the last released objects first
+  flow_file_record *reused = create_ff_object_nc();
+  REQUIRE(reinterpret_cast<uintptr_t>(reused) == released_record);
+  REQUIRE(reinterpret_cast<uintptr_t>(reused->attributes) == released_attributes);
+
+  REQUIRE(get_attribute_quantity(reused) == 0);
+  attribute attr;
+  char key[] = "key";
+  attr.key = key;
+  attr.value_size = 0;
+  REQUIRE(get_attribute(reused, &attr) == -1);
+  REQUIRE(reused->keepContent == 0);
+  REQUIRE(reused->size == 0);
+  REQUIRE(reused->contentLocation == nullptr);
+  REQUIRE(reused->ffp == nullptr);
+
+  free_flowfile(reused);
+}
@@ -0,0 +1,157 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string>
+#include <vector>
+
+#include "TestBase.h"
+#include "core/cstructs.h"
+#include "core/cstream.h"
+
+/**
+ * Connects a cstream to one end of a socket pair, the other end plays the peer.
+ */
+class StreamPair {
+ public:
+  StreamPair() {
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds_) == 0);
+    stream_ = static_cast<cstream *>(malloc(sizeof(cstream)));
+    stream_->socket_ = fds_[0];
+    stream_->write_buffer_len_ = 0;
+  }
+
+  ~StreamPair() {
+    free_socket(stream_);
+    close(fds_[1]);
+  }
+
+  /**
+   * Returns whatever the peer received so far without waiting for more.
+   */
+  std::string received() {
+    std::string data;
+    char buf[1024];
+    ssize_t ret;
+    while ((ret = recv(fds_[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+      data.append(buf, ret);
+    }
+    return data;
+  }
+
+  bool peerClosed() {
+    char buf;
+    return recv(fds_[1], &buf, 1, MSG_DONTWAIT) == 0;
+  }
+
+  void reply(const std::string &data) {
+    REQUIRE(send(fds_[1], data.data(), data.size(), 0) == static_cast<ssize_t>(data.size()));
+  }
+
+  cstream *stream_;
+
+ private:
+  int fds_[2];
+};
+
+static std::vector<uint8_t> pattern(size_t size, uint8_t offset = 0) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++) {
+    data[i] = static_cast<uint8_t>(i + offset);
+  }
+  return data;
+}
+
+TEST_CASE("Small writes stay in the buffer until flushed", "[testCStreamBuffer]") {
+  StreamPair pair;
+  auto first = pattern(100);
+  auto second = pattern(200, 7);
+
+  REQUIRE(write_buffer(first.data(), first.size(), pair.stream_) == 100);
+  REQUIRE(write_buffer(second.data(), second.size(), pair.stream_) == 200);
+  REQUIRE(pair.stream_->write_buffer_len_ == 300);
+  REQUIRE(pair.received().empty());
+
+  REQUIRE(flush_stream(pair.stream_) == 0);
+  REQUIRE(pair.stream_->write_buffer_len_ == 0);
+
+  std::string expected(first.begin(), first.end());
+  expected.append(second.begin(), second.end());
+  REQUIRE(pair.received() == expected);
+
+  // nothing left to send
+  REQUIRE(flush_stream(pair.stream_) == 0);
+  REQUIRE(pair.received().empty());
+}
+
+TEST_CASE("Writes filling the buffer are sent", "[testCStreamBuffer]") {
+  StreamPair pair;
+  auto small = pattern(10);
+
+  REQUIRE(write_buffer(small.data(), small.size(), pair.stream_) == 10);
+
+  SECTION("A write of at least the buffer size is sent directly after the buffered data") {
+    auto large = pattern(CSTREAM_WRITE_BUFFER_SIZE + 904, 3);
+    REQUIRE(write_buffer(large.data(), large.size(), pair.stream_) == static_cast<int>(large.size()));
+    REQUIRE(pair.stream_->write_buffer_len_ == 0);
+
+    std::string expected(small.begin(), small.end());
+    expected.append(large.begin(), large.end());
+    REQUIRE(pair.received() == expected);
+  }
+
+  SECTION("A write overflowing the buffer sends the buffered data and keeps the new write") {
+    auto medium = pattern(CSTREAM_WRITE_BUFFER_SIZE - 5, 11);
+    REQUIRE(write_buffer(medium.data(), medium.size(), pair.stream_) == static_cast<int>(medium.size()));
+    REQUIRE(pair.stream_->write_buffer_len_ == medium.size());
+    REQUIRE(pair.received() == std::string(small.begin(), small.end()));
+
+    REQUIRE(flush_stream(pair.stream_) == 0);
+    REQUIRE(pair.received() == std::string(medium.begin(), medium.end()));
+  }
+}
+
+TEST_CASE("Reading sends the buffered writes first", "[testCStreamBuffer]") {
+  StreamPair pair;
+
+  REQUIRE(write_uint32_t(42, pair.stream_) == 4);
+  REQUIRE(pair.received().empty());
+
+  pair.reply(std::string("\x00\x00\x00\x07", 4));
+  uint32_t answer = 0;
+  REQUIRE(read_uint32_t(&answer, pair.stream_) == 4);
+  REQUIRE(answer == 7);
+
+  REQUIRE(pair.stream_->write_buffer_len_ == 0);
+  REQUIRE(pair.received() == std::string("\x00\x00\x00\x2a", 4));
+}
+
+TEST_CASE("Closing sends the buffered writes", "[testCStreamBuffer]") {
+  StreamPair pair;
+  auto data = pattern(50);
+
+  REQUIRE(write_buffer(data.data(), data.size(), pair.stream_) == 50);
+  REQUIRE(pair.received().empty());
+
+  close_stream(pair.stream_);
+  REQUIRE(pair.stream_->socket_ == -1);
+  REQUIRE(pair.received() == std::string(data.begin(), data.end()));
+  REQUIRE(pair.peerClosed());
+}